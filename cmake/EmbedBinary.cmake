@@ -0,0 +1,11 @@
+# 将二进制文件转换为C++头文件中的字节数组
+# 用法：cmake -DINPUT=<file> -DOUTPUT=<header> -DSYMBOL=<name> -P EmbedBinary.cmake
+file(READ ${INPUT} content HEX)
+string(LENGTH "${content}" hexLength)
+math(EXPR byteCount "${hexLength} / 2")
+string(REGEX REPLACE "([0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f])" "\\1\n    " content "${content}")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${content}")
+file(WRITE ${OUTPUT}
+"#pragma once\n// 由EmbedBinary.cmake生成，请勿手动修改\n#include <cstddef>\n\n"
+"static const unsigned char ${SYMBOL}[] = {\n    ${bytes}\n};\n"
+"static const size_t ${SYMBOL}_SIZE = ${byteCount};\n")
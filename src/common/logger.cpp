@@ -2,9 +2,26 @@
 #include <iomanip>
 #include <sstream>
 
+namespace {
+
+// 记录队列上限：超过后新记录被丢弃，防止日志风暴耗尽内存
+constexpr size_t MAX_PENDING_CHARS = 4 * 1024 * 1024;
+constexpr size_t MAX_PENDING_RECORDS = 64 * 1024;
+
+} // namespace
+
 Logger& Logger::GetInstance() {
-    static Logger instance;
-    return instance;
+    // 有意不析构：静态析构可能在加载器锁下运行，不能在其中等待输出线程，
+    // 退出前由宿主显式调用Shutdown输出剩余记录
+    static Logger* instance = new Logger();
+    return *instance;
+}
+
+Logger::~Logger() {
+    // 不在析构中等待输出线程；未经Shutdown时放弃该线程
+    if (writerThread_.joinable()) {
+        writerThread_.detach();
+    }
 }
 
 void Logger::SetLogFile(const std::wstring& filePath) {
@@ -33,21 +50,151 @@ void Logger::Log(LogLevel level, const std::wstring& message, const char* file,
     
     logEntry << message;
     
-    // 输出到控制台
-    std::wcout << logEntry.str() << std::endl;
-    
     // 输出到文件（如果设置了日志文件）
     if (!logFilePath_.empty()) {
-        std::wofstream logFile(logFilePath_, std::ios::app);
-        if (logFile.is_open()) {
-            logFile << logEntry.str() << std::endl;
-            logFile.close();
+        std::ofstream logFile(Platform::ToFilesystemPath(logFilePath_), std::ios::app);
+        WriteEntry(logEntry.str(), logFile.is_open() ? &logFile : nullptr);
+    } else {
+        WriteEntry(logEntry.str(), nullptr);
+    }
+}
+
+void Logger::Submit(LogLevel level, const wchar_t* text, size_t length, const wchar_t* prefix) {
+    if (level < logLevel_ || (!text && length > 0)) {
+        return;
+    }
+    
+    size_t prefixLength = prefix ? wcslen(prefix) : 0;
+    size_t totalLength = prefixLength + length;
+    
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    
+    if (pendingText_.size() + totalLength > MAX_PENDING_CHARS || pendingRecords_.size() >= MAX_PENDING_RECORDS) {
+        ++droppedRecords_;
+        return;
+    }
+    
+    // 延迟启动输出线程
+    if (!writerRunning_) {
+        try {
+            writerRunning_ = true;
+            writerThread_ = std::thread(&Logger::WriterThreadFunc, this);
+        } catch (...) {
+            writerRunning_ = false;
+            lock.unlock();
+            Log(level, (prefix ? std::wstring(prefix) : std::wstring()) + std::wstring(text, length));
+            return;
+        }
+    }
+    
+    // 队列缓冲区在输出线程中被交换复用，稳态下append不会重新分配
+    PendingRecord record{level, std::chrono::system_clock::now(), pendingText_.size(), totalLength};
+    if (prefixLength > 0) {
+        pendingText_.insert(pendingText_.end(), prefix, prefix + prefixLength);
+    }
+    pendingText_.insert(pendingText_.end(), text, text + length);
+    pendingRecords_.push_back(record);
+    ++submittedRecords_;
+    
+    lock.unlock();
+    queueCondition_.notify_one();
+}
+
+void Logger::Flush() {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    if (!writerRunning_) {
+        return;
+    }
+    
+    // 被丢弃的记录不计入submittedRecords_，只需等待已入队的记录输出
+    uint64_t target = submittedRecords_;
+    flushCondition_.wait(lock, [this, target]() {
+        return writtenRecords_ >= target || !writerRunning_;
+    });
+}
+
+void Logger::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!writerRunning_) {
+            return;
         }
+        writerRunning_ = false;
+    }
+    
+    queueCondition_.notify_all();
+    if (writerThread_.joinable()) {
+        writerThread_.join();
+    }
+    flushCondition_.notify_all();
+}
+
+void Logger::WriterThreadFunc() {
+    std::vector<PendingRecord> records;
+    std::vector<wchar_t> text;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCondition_.wait(lock, [this]() {
+                return !pendingRecords_.empty() || !writerRunning_;
+            });
+            
+            if (pendingRecords_.empty() && !writerRunning_) {
+                break;
+            }
+            
+            // 整批交换，提交方继续使用上一轮已分配好的缓冲区
+            records.swap(pendingRecords_);
+            text.swap(pendingText_);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(logMutex_);
+            
+            // 每批只打开一次日志文件
+            std::ofstream logFile;
+            if (!logFilePath_.empty()) {
+                logFile.open(Platform::ToFilesystemPath(logFilePath_), std::ios::app);
+            }
+            
+            for (const auto& record : records) {
+                std::wstring entry = GetTimestamp(record.time) + L" [" + LogLevelToString(record.level) + L"] ";
+                entry.append(text.data() + record.offset, record.length);
+                WriteEntry(entry, logFile.is_open() ? &logFile : nullptr);
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            writtenRecords_ += records.size();
+        }
+        flushCondition_.notify_all();
+        
+        records.clear();
+        text.clear();
+    }
+}
+
+void Logger::WriteEntry(const std::wstring& entry, std::ofstream* logFile) {
+    // 输出到控制台；POSIX的宽字符流在默认locale下遇到非ASCII字符会失效，改为输出UTF-8
+#ifdef _WIN32
+    std::wcout << entry << std::endl;
+#else
+    std::cout << WStringToString(entry) << std::endl;
+#endif
+    
+    // 日志文件统一为UTF-8
+    if (logFile) {
+        *logFile << WStringToString(entry) << std::endl;
     }
 }
 
 std::wstring Logger::GetTimestamp() {
-    auto now = std::chrono::system_clock::now();
+    return GetTimestamp(std::chrono::system_clock::now());
+}
+
+std::wstring Logger::GetTimestamp(std::chrono::system_clock::time_point now) {
     auto time_t = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
@@ -68,4 +215,4 @@ std::wstring Logger::LogLevelToString(LogLevel level) {
         case LogLevel::CRITICAL: return L"CRITICAL";
         default: return L"UNKNOWN";
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,321 @@
+// 平台层的POSIX实现（Linux）
+#include "../include/platform.h"
+#include <cerrno>
+#include <cstdint>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Platform {
+
+namespace {
+
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+void AppendUtf8(std::string& out, char32_t code) {
+    if (code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+        code = REPLACEMENT_CHARACTER;
+    }
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+} // namespace
+
+std::wstring Utf8ToWide(const std::string& text) {
+    std::wstring result;
+    result.reserve(text.size());
+    
+    size_t i = 0;
+    while (i < text.size()) {
+        uint8_t lead = static_cast<uint8_t>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        char32_t code = length == 1 ? lead : length == 2 ? (lead & 0x1F) : length == 3 ? (lead & 0x0F) : (lead & 0x07);
+        
+        bool valid = length != 0 && i + length <= text.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            uint8_t next = static_cast<uint8_t>(text[i + k]);
+            valid = (next & 0xC0) == 0x80;
+            code = (code << 6) | (next & 0x3F);
+        }
+        
+        // 拒绝过长编码、代理区与超出范围的码点
+        static const char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (!valid || code < minimum[length] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+            result += static_cast<wchar_t>(REPLACEMENT_CHARACTER);
+            ++i;
+            continue;
+        }
+        result += static_cast<wchar_t>(code);
+        i += length;
+    }
+    return result;
+}
+
+std::string WideToUtf8(const std::wstring& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (wchar_t c : text) {
+        AppendUtf8(result, static_cast<char32_t>(c));
+    }
+    return result;
+}
+
+size_t Utf16ToWide(const char16_t* source, size_t length, wchar_t* target) {
+    size_t written = 0;
+    for (size_t i = 0; i < length; ++i) {
+        char32_t code = source[i];
+        if (code >= 0xD800 && code <= 0xDBFF && i + 1 < length && source[i + 1] >= 0xDC00 && source[i + 1] <= 0xDFFF) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (source[i + 1] - 0xDC00);
+            ++i;
+        } else if (code >= 0xD800 && code <= 0xDFFF) {
+            code = REPLACEMENT_CHARACTER;
+        }
+        target[written++] = static_cast<wchar_t>(code);
+    }
+    return written;
+}
+
+std::u16string WideToUtf16(const std::wstring& text) {
+    std::u16string result;
+    result.reserve(text.size());
+    for (wchar_t c : text) {
+        char32_t code = static_cast<char32_t>(c);
+        if (code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+            code = REPLACEMENT_CHARACTER;
+        }
+        if (code >= 0x10000) {
+            code -= 0x10000;
+            result += static_cast<char16_t>(0xD800 + (code >> 10));
+            result += static_cast<char16_t>(0xDC00 + (code & 0x3FF));
+        } else {
+            result += static_cast<char16_t>(code);
+        }
+    }
+    return result;
+}
+
+std::filesystem::path ToFilesystemPath(const std::wstring& path) {
+    return std::filesystem::path(WideToUtf8(path));
+}
+
+std::wstring FromFilesystemPath(const std::filesystem::path& path) {
+    return Utf8ToWide(path.native());
+}
+
+bool FileNameEquals(const std::wstring& left, const std::wstring& right) {
+    return left == right;
+}
+
+uint32_t GetCurrentProcessId() {
+    return static_cast<uint32_t>(getpid());
+}
+
+uint32_t GetCurrentThreadId() {
+    return static_cast<uint32_t>(syscall(SYS_gettid));
+}
+
+SystemInfo QuerySystemInfo() {
+    SystemInfo info = {};
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long totalPages = sysconf(_SC_PHYS_PAGES);
+    long availablePages = sysconf(_SC_AVPHYS_PAGES);
+    info.processorCount = processors > 0 ? static_cast<uint32_t>(processors) : 0;
+    info.pageSize = pageSize > 0 ? static_cast<uint32_t>(pageSize) : 0;
+    info.totalPhysicalMemory = totalPages > 0 ? static_cast<uint64_t>(totalPages) * info.pageSize : 0;
+    info.availablePhysicalMemory = availablePages > 0 ? static_cast<uint64_t>(availablePages) * info.pageSize : 0;
+    return info;
+}
+
+uint32_t GetLastSystemError() {
+    return static_cast<uint32_t>(errno);
+}
+
+std::wstring GetModulePath(const void* address) {
+    Dl_info info = {};
+    if (!dladdr(address, &info) || !info.dli_fname) {
+        return std::wstring();
+    }
+    
+    // 通过相对路径加载的库dli_fname也是相对路径，转换为绝对路径
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::absolute(info.dli_fname, error);
+    return error ? Utf8ToWide(info.dli_fname) : FromFilesystemPath(path);
+}
+
+bool QueryFileIdentity(const std::wstring& path, FileIdentity& identity) {
+    struct stat status;
+    if (stat(WideToUtf8(path).c_str(), &status) != 0 || S_ISDIR(status.st_mode)) {
+        return false;
+    }
+    
+    identity.device = static_cast<uint64_t>(status.st_dev);
+    identity.fileId = static_cast<uint64_t>(status.st_ino);
+    identity.size = static_cast<uint64_t>(status.st_size);
+    identity.modifyTime = static_cast<uint64_t>(status.st_mtim.tv_sec) * 1000000000ull +
+                          static_cast<uint64_t>(status.st_mtim.tv_nsec);
+    return true;
+}
+
+bool CloneFile(const std::wstring& sourcePath, const std::wstring& targetPath) {
+    int source = open(WideToUtf8(sourcePath).c_str(), O_RDONLY | O_CLOEXEC);
+    if (source < 0) {
+        return false;
+    }
+    
+    std::string target = WideToUtf8(targetPath);
+    int destination = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (destination < 0) {
+        close(source);
+        return false;
+    }
+    
+    // 来源与目标不在同一文件系统或文件系统不支持引用链接时返回EXDEV/EOPNOTSUPP等
+    bool cloned = ioctl(destination, FICLONE, source) == 0;
+    int error = errno;
+    close(destination);
+    close(source);
+    
+    if (!cloned) {
+        unlink(target.c_str());
+        errno = error;
+    }
+    return cloned;
+}
+
+void* AllocatePages(size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+bool ProtectPagesReadOnly(void* memory, size_t size) {
+    return mprotect(memory, size, PROT_READ) == 0;
+}
+
+void FreePages(void* memory, size_t size) {
+    if (memory) {
+        munmap(memory, size);
+    }
+}
+
+struct DirectoryMonitor::State {
+    int stopRead = -1;
+    int stopWrite = -1;
+    int notify = -1;
+    
+    ~State() {
+        for (int fd : { stopRead, stopWrite, notify }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+};
+
+DirectoryMonitor::DirectoryMonitor() : state_(new State()) {}
+
+DirectoryMonitor::~DirectoryMonitor() = default;
+
+bool DirectoryMonitor::Create() {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) != 0) {
+        return false;
+    }
+    state_->stopRead = fds[0];
+    state_->stopWrite = fds[1];
+    return true;
+}
+
+bool DirectoryMonitor::Watch(const std::wstring& directory) {
+    int notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify < 0) {
+        return false;
+    }
+    
+    // 与Windows的FILE_NOTIFY_CHANGE_FILE_NAME | SIZE | LAST_WRITE对应，重命名覆盖产生IN_MOVED_TO
+    uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB;
+    if (inotify_add_watch(notify, WideToUtf8(directory).c_str(), mask) < 0) {
+        int error = errno;
+        close(notify);
+        errno = error;
+        return false;
+    }
+    state_->notify = notify;
+    return true;
+}
+
+bool DirectoryMonitor::IsWatching() const {
+    return state_->notify >= 0;
+}
+
+DirectoryMonitor::WaitResult DirectoryMonitor::Wait(uint32_t timeoutMs) {
+    pollfd fds[2] = { { state_->stopRead, POLLIN, 0 }, { state_->notify, POLLIN, 0 } };
+    int count;
+    do {
+        count = poll(fds, state_->notify >= 0 ? 2 : 1, static_cast<int>(timeoutMs));
+    } while (count < 0 && errno == EINTR);
+    
+    if (count < 0 || fds[0].revents != 0) {
+        return WaitResult::STOPPED;
+    }
+    if (count == 0) {
+        return WaitResult::TIMEOUT;
+    }
+    
+    // 读空事件队列，多个事件合并为一次通知；出错时改为只按超时轮询
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(state_->notify, buffer, sizeof(buffer));
+        if (length > 0) {
+            continue;
+        }
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close(state_->notify);
+            state_->notify = -1;
+        }
+        break;
+    }
+    return WaitResult::CHANGED;
+}
+
+bool DirectoryMonitor::WaitForStop(uint32_t timeoutMs) {
+    pollfd stop = { state_->stopRead, POLLIN, 0 };
+    int count;
+    do {
+        count = poll(&stop, 1, static_cast<int>(timeoutMs));
+    } while (count < 0 && errno == EINTR);
+    return count != 0;
+}
+
+void DirectoryMonitor::Stop() {
+    // 管道不再读取，之后所有等待都立即返回
+    char signal = 1;
+    ssize_t ignored = write(state_->stopWrite, &signal, 1);
+    (void)ignored;
+}
+
+} // namespace Platform
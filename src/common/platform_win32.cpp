@@ -0,0 +1,280 @@
+// 平台层的Windows实现
+#include "../include/platform.h"
+#include <windows.h>
+#include <winioctl.h>
+#include <algorithm>
+
+namespace Platform {
+
+std::wstring Utf8ToWide(const std::string& text) {
+    if (text.empty()) {
+        return std::wstring();
+    }
+    
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring result(length, 0);
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &result[0], length);
+    return result;
+}
+
+std::string WideToUtf8(const std::wstring& text) {
+    if (text.empty()) {
+        return std::string();
+    }
+    
+    int length = WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+    std::string result(length, 0);
+    WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &result[0], length, nullptr, nullptr);
+    return result;
+}
+
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be a UTF-16 code unit on Windows");
+
+size_t Utf16ToWide(const char16_t* source, size_t length, wchar_t* target) {
+    wmemcpy(target, reinterpret_cast<const wchar_t*>(source), length);
+    return length;
+}
+
+std::u16string WideToUtf16(const std::wstring& text) {
+    return std::u16string(reinterpret_cast<const char16_t*>(text.data()), text.size());
+}
+
+namespace {
+
+// 单次块克隆的最大字节数（必须是簇大小的整数倍）
+constexpr uint64_t CLONE_CHUNK_BYTES = 1ull << 30;
+
+uint64_t CombineHighLow(DWORD high, DWORD low) {
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+} // namespace
+
+std::filesystem::path ToFilesystemPath(const std::wstring& path) {
+    return std::filesystem::path(path);
+}
+
+std::wstring FromFilesystemPath(const std::filesystem::path& path) {
+    return path.wstring();
+}
+
+bool FileNameEquals(const std::wstring& left, const std::wstring& right) {
+    return CompareStringOrdinal(left.c_str(), static_cast<int>(left.size()),
+                                right.c_str(), static_cast<int>(right.size()), TRUE) == CSTR_EQUAL;
+}
+
+uint32_t GetCurrentProcessId() {
+    return ::GetCurrentProcessId();
+}
+
+uint32_t GetCurrentThreadId() {
+    return ::GetCurrentThreadId();
+}
+
+SystemInfo QuerySystemInfo() {
+    SystemInfo info = {};
+    SYSTEM_INFO sysInfo;
+    ::GetSystemInfo(&sysInfo);
+    info.processorCount = sysInfo.dwNumberOfProcessors;
+    info.pageSize = sysInfo.dwPageSize;
+    
+    MEMORYSTATUSEX memInfo;
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    if (GlobalMemoryStatusEx(&memInfo)) {
+        info.totalPhysicalMemory = memInfo.ullTotalPhys;
+        info.availablePhysicalMemory = memInfo.ullAvailPhys;
+    }
+    return info;
+}
+
+uint32_t GetLastSystemError() {
+    return ::GetLastError();
+}
+
+std::wstring GetModulePath(const void* address) {
+    HMODULE module = NULL;
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast<LPCWSTR>(address), &module)) {
+        return std::wstring();
+    }
+    
+    // 长路径可能超过MAX_PATH，缓冲区不足时加倍重试
+    std::wstring path(MAX_PATH, L'\0');
+    while (true) {
+        DWORD length = GetModuleFileNameW(module, &path[0], static_cast<DWORD>(path.size()));
+        if (length == 0) {
+            return std::wstring();
+        }
+        if (length < path.size()) {
+            path.resize(length);
+            return path;
+        }
+        path.resize(path.size() * 2);
+    }
+}
+
+bool QueryFileIdentity(const std::wstring& path, FileIdentity& identity) {
+    // 句柄立即关闭，不会固定住被替换前的文件
+    HANDLE file = CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    BY_HANDLE_FILE_INFORMATION info;
+    BOOL success = GetFileInformationByHandle(file, &info);
+    DWORD error = ::GetLastError();
+    CloseHandle(file);
+    if (!success || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        SetLastError(error);
+        return false;
+    }
+    
+    identity.device = info.dwVolumeSerialNumber;
+    identity.fileId = CombineHighLow(info.nFileIndexHigh, info.nFileIndexLow);
+    identity.size = CombineHighLow(info.nFileSizeHigh, info.nFileSizeLow);
+    identity.modifyTime = CombineHighLow(info.ftLastWriteTime.dwHighDateTime, info.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+bool CloneFile(const std::wstring& sourcePath, const std::wstring& targetPath) {
+    HANDLE source = CreateFileW(sourcePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (source == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    // 只有支持块引用计数的卷（ReFS、Dev Drive）才能克隆
+    LARGE_INTEGER fileSize = {};
+    DWORD fileSystemFlags = 0;
+    FSCTL_GET_INTEGRITY_INFORMATION_BUFFER integrity = {};
+    DWORD bytesReturned = 0;
+    if (!GetFileSizeEx(source, &fileSize) || fileSize.QuadPart == 0 ||
+        !GetVolumeInformationByHandleW(source, nullptr, 0, nullptr, nullptr, &fileSystemFlags, nullptr, 0) ||
+        !(fileSystemFlags & FILE_SUPPORTS_BLOCK_REFCOUNTING) ||
+        !DeviceIoControl(source, FSCTL_GET_INTEGRITY_INFORMATION, nullptr, 0, &integrity, sizeof(integrity),
+                         &bytesReturned, nullptr) || integrity.ClusterSizeInBytes == 0) {
+        CloseHandle(source);
+        return false;
+    }
+    
+    HANDLE target = CreateFileW(targetPath.c_str(), GENERIC_READ | GENERIC_WRITE | DELETE, 0,
+                                nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (target == INVALID_HANDLE_VALUE) {
+        CloseHandle(source);
+        return false;
+    }
+    
+    // 目标文件需预先设置为相同长度，克隆范围按簇对齐（末尾可越过文件结尾）
+    bool cloned = false;
+    FILE_END_OF_FILE_INFO endOfFile;
+    endOfFile.EndOfFile = fileSize;
+    if (SetFileInformationByHandle(target, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile))) {
+        uint64_t size = static_cast<uint64_t>(fileSize.QuadPart);
+        uint64_t clusterSize = integrity.ClusterSizeInBytes;
+        uint64_t alignedSize = (size + clusterSize - 1) / clusterSize * clusterSize;
+        cloned = true;
+        
+        for (uint64_t offset = 0; offset < alignedSize; offset += CLONE_CHUNK_BYTES) {
+            DUPLICATE_EXTENTS_DATA extents = {};
+            extents.FileHandle = source;
+            extents.SourceFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+            extents.TargetFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+            extents.ByteCount.QuadPart = static_cast<LONGLONG>(std::min(CLONE_CHUNK_BYTES, alignedSize - offset));
+            if (!DeviceIoControl(target, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents),
+                                 nullptr, 0, &bytesReturned, nullptr)) {
+                cloned = false;
+                break;
+            }
+        }
+    }
+    
+    DWORD error = ::GetLastError();
+    CloseHandle(target);
+    CloseHandle(source);
+    if (!cloned) {
+        DeleteFileW(targetPath.c_str());
+        SetLastError(error);
+    }
+    return cloned;
+}
+
+void* AllocatePages(size_t size) {
+    return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+}
+
+bool ProtectPagesReadOnly(void* memory, size_t size) {
+    DWORD oldProtect = 0;
+    return VirtualProtect(memory, size, PAGE_READONLY, &oldProtect) != FALSE;
+}
+
+void FreePages(void* memory, size_t size) {
+    if (memory) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+}
+
+struct DirectoryMonitor::State {
+    HANDLE stopEvent = nullptr;                     // 手动重置事件
+    HANDLE changeHandle = INVALID_HANDLE_VALUE;
+    
+    ~State() {
+        if (changeHandle != INVALID_HANDLE_VALUE) {
+            FindCloseChangeNotification(changeHandle);
+        }
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+        }
+    }
+};
+
+DirectoryMonitor::DirectoryMonitor() : state_(new State()) {}
+
+DirectoryMonitor::~DirectoryMonitor() = default;
+
+bool DirectoryMonitor::Create() {
+    state_->stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    return state_->stopEvent != nullptr;
+}
+
+bool DirectoryMonitor::Watch(const std::wstring& directory) {
+    // 重命名覆盖只改变目录项，因此监控文件名、大小与写入变化
+    state_->changeHandle = FindFirstChangeNotificationW(
+        directory.c_str(), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    return state_->changeHandle != INVALID_HANDLE_VALUE;
+}
+
+bool DirectoryMonitor::IsWatching() const {
+    return state_->changeHandle != INVALID_HANDLE_VALUE;
+}
+
+DirectoryMonitor::WaitResult DirectoryMonitor::Wait(uint32_t timeoutMs) {
+    HANDLE handles[2] = { state_->stopEvent, state_->changeHandle };
+    DWORD handleCount = state_->changeHandle != INVALID_HANDLE_VALUE ? 2 : 1;
+    DWORD waitResult = WaitForMultipleObjects(handleCount, handles, FALSE, timeoutMs);
+    if (waitResult == WAIT_TIMEOUT) {
+        return WaitResult::TIMEOUT;
+    }
+    if (waitResult != WAIT_OBJECT_0 + 1) {
+        return WaitResult::STOPPED;
+    }
+    
+    // 重新挂起通知；失败时改为只按超时轮询
+    if (!FindNextChangeNotification(state_->changeHandle)) {
+        FindCloseChangeNotification(state_->changeHandle);
+        state_->changeHandle = INVALID_HANDLE_VALUE;
+    }
+    return WaitResult::CHANGED;
+}
+
+bool DirectoryMonitor::WaitForStop(uint32_t timeoutMs) {
+    return WaitForSingleObject(state_->stopEvent, timeoutMs) != WAIT_TIMEOUT;
+}
+
+void DirectoryMonitor::Stop() {
+    SetEvent(state_->stopEvent);
+}
+
+} // namespace Platform
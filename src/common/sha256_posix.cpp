@@ -0,0 +1,39 @@
+// SHA-256的POSIX实现（OpenSSL EVP）
+#include "../include/sha256.h"
+#include <openssl/evp.h>
+
+Sha256::Sha256() : state_(nullptr) {
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if (context && EVP_DigestInit_ex(context, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(context);
+        context = nullptr;
+    }
+    state_ = context;
+}
+
+Sha256::~Sha256() {
+    EVP_MD_CTX_free(static_cast<EVP_MD_CTX*>(state_));
+}
+
+bool Sha256::Update(const uint8_t* data, size_t size) {
+    return state_ && (size == 0 || EVP_DigestUpdate(static_cast<EVP_MD_CTX*>(state_), data, size) == 1);
+}
+
+bool Sha256::Finish(Digest& digest) {
+    if (!state_) {
+        return false;
+    }
+    
+    EVP_MD_CTX* context = static_cast<EVP_MD_CTX*>(state_);
+    unsigned int length = 0;
+    bool success = EVP_DigestFinal_ex(context, digest.data(), &length) == 1 && length == digest.size();
+    
+    // 重新初始化以便计算下一个摘要
+    return EVP_DigestInit_ex(context, EVP_sha256(), nullptr) == 1 && success;
+}
+
+bool Sha256::Hash(const uint8_t* data, size_t size, Digest& digest) {
+    unsigned int length = 0;
+    return EVP_Digest(data, size, digest.data(), &length, EVP_sha256(), nullptr) == 1 &&
+           length == digest.size();
+}
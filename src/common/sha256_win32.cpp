@@ -0,0 +1,65 @@
+// SHA-256的Windows实现（CNG）
+#include "../include/sha256.h"
+#include <windows.h>
+#include <bcrypt.h>
+#include <algorithm>
+
+namespace {
+
+constexpr size_t MAX_HASH_CHUNK = 1u << 30;    // BCryptHashData的长度参数为ULONG
+
+// 可复用哈希对象的SHA-256提供者，进程内共享，不关闭
+BCRYPT_ALG_HANDLE GetProvider() {
+    static BCRYPT_ALG_HANDLE provider = [] {
+        BCRYPT_ALG_HANDLE handle = nullptr;
+        if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&handle, BCRYPT_SHA256_ALGORITHM, nullptr,
+                                                        BCRYPT_HASH_REUSABLE_FLAG))) {
+            handle = nullptr;
+        }
+        return handle;
+    }();
+    return provider;
+}
+
+} // namespace
+
+Sha256::Sha256() : state_(nullptr) {
+    BCRYPT_ALG_HANDLE provider = GetProvider();
+    BCRYPT_HASH_HANDLE hash = nullptr;
+    if (provider && BCRYPT_SUCCESS(BCryptCreateHash(provider, &hash, nullptr, 0, nullptr, 0, BCRYPT_HASH_REUSABLE_FLAG))) {
+        state_ = hash;
+    }
+}
+
+Sha256::~Sha256() {
+    if (state_) {
+        BCryptDestroyHash(static_cast<BCRYPT_HASH_HANDLE>(state_));
+    }
+}
+
+bool Sha256::Update(const uint8_t* data, size_t size) {
+    if (!state_) {
+        return false;
+    }
+    
+    while (size > 0) {
+        ULONG chunk = static_cast<ULONG>(std::min(size, MAX_HASH_CHUNK));
+        if (!BCRYPT_SUCCESS(BCryptHashData(static_cast<BCRYPT_HASH_HANDLE>(state_), const_cast<PUCHAR>(data), chunk, 0))) {
+            return false;
+        }
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool Sha256::Finish(Digest& digest) {
+    // 可复用的哈希对象在BCryptFinishHash之后自动重置
+    return state_ && BCRYPT_SUCCESS(BCryptFinishHash(static_cast<BCRYPT_HASH_HANDLE>(state_), digest.data(),
+                                                     static_cast<ULONG>(digest.size()), 0));
+}
+
+bool Sha256::Hash(const uint8_t* data, size_t size, Digest& digest) {
+    Sha256 hash;
+    return hash.Update(data, size) && hash.Finish(digest);
+}
@@ -1,30 +1,47 @@
 #include "../include/common.h"
-#include <codecvt>
-#include <locale>
+#include <filesystem>
 
 std::wstring StringToWString(const std::string& str) {
-    if (str.empty()) return std::wstring();
-    
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), NULL, 0);
-    std::wstring wstrTo(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), &wstrTo[0], size_needed);
-    return wstrTo;
+    return Platform::Utf8ToWide(str);
 }
 
 std::string WStringToString(const std::wstring& wstr) {
-    if (wstr.empty()) return std::string();
-    
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
-    return strTo;
+    return Platform::WideToUtf8(wstr);
 }
 
 bool FileExists(const std::wstring& path) {
-    DWORD dwAttrib = GetFileAttributesW(path.c_str());
-    return (dwAttrib != INVALID_FILE_ATTRIBUTES && !(dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
+    std::error_code error;
+    return std::filesystem::is_regular_file(Platform::ToFilesystemPath(path), error);
 }
 
+namespace {
+
+template<typename Char>
+bool EqualsIgnoreAsciiCase(const std::basic_string<Char>& left, const std::basic_string<Char>& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.size(); ++i) {
+        Char a = (left[i] >= 'A' && left[i] <= 'Z') ? static_cast<Char>(left[i] - 'A' + 'a') : left[i];
+        Char b = (right[i] >= 'A' && right[i] <= 'Z') ? static_cast<Char>(right[i] - 'A' + 'a') : right[i];
+        if (a != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool EqualsIgnoreCase(const std::string& left, const std::string& right) {
+    return EqualsIgnoreAsciiCase(left, right);
+}
+
+bool EqualsIgnoreCase(const std::wstring& left, const std::wstring& right) {
+    return EqualsIgnoreAsciiCase(left, right);
+}
+
+#ifdef _WIN32
 FILETIME GetFileModifyTime(const std::wstring& path) {
     FILETIME ft = {0};
     HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
@@ -33,4 +50,5 @@ FILETIME GetFileModifyTime(const std::wstring& path) {
         CloseHandle(hFile);
     }
     return ft;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
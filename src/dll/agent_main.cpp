@@ -0,0 +1,180 @@
+#include "../include/injection_runtime.h"
+#include "../include/agent_options.h"
+#include <jvmti.h>
+#include <atomic>
+#include <thread>
+
+// JVMTI代理入口
+//
+// 与inject.dll共用注入运行时，由JVM自身的代理机制加载：
+//   -agentpath:<库路径>=<选项>       启动时加载，在VMInit中同步完成注入
+//   jcmd <pid> JVMTI.agent_load      运行时附加，在新线程中完成注入
+//   System.load(<库路径>)            选项来自系统属性dllinject.agent.options
+
+namespace {
+
+// 同一进程只注入一次（例如-agentpath加载后又被System.load）
+std::atomic<bool> g_agentStarted(false);
+
+const char* const AGENT_OPTIONS_PROPERTY = "dllinject.agent.options";
+
+// 解析选项并设置注入参数
+bool ConfigureAgent(const char* options) {
+    if (g_agentStarted.exchange(true)) {
+        LOG_WARNING(L"Injection agent already loaded, ignoring: " << StringToWString(options ? options : ""));
+        return false;
+    }
+    
+    InjectionData data;
+    if (AgentOptions::Parse(options ? options : "", data) != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Usage: -agentpath:<agent>=jar=<path>[,class=<name>][,method=<name>][,hotReload=true|false]");
+        g_agentStarted = false;
+        return false;
+    }
+    
+    // 以代理库中的函数地址定位代理库本身
+    SetJarInjectionModule(reinterpret_cast<const void*>(&ConfigureAgent));
+    SetJarInjectionData(data);
+    return true;
+}
+
+void JNICALL OnVMInit(jvmtiEnv* jvmti, JNIEnv* env, jthread thread) {
+    // 在主类执行之前完成注入，JVM启动时间包含完整的注入耗时
+    if (InitializeJarInjection() != 0) {
+        LOG_ERROR(L"JAR injection failed during VM initialization");
+    }
+}
+
+void JNICALL OnVMDeath(jvmtiEnv* jvmti, JNIEnv* env) {
+    // VMDeath之后不能再调用JNI，这里只停止后台线程，JAR随进程退出释放
+    try {
+        StopJarInjectionMonitoring();
+        Logger::GetInstance().Flush();
+    } catch (...) {
+        LOG_ERROR(L"Exception while stopping injection agent");
+    }
+}
+
+// 注册VM生命周期事件，onLoad为true时同时在VMInit中执行注入
+bool RegisterLifecycleEvents(JavaVM* vm, bool onLoad) {
+    jvmtiEnv* jvmti = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&jvmti), JVMTI_VERSION_1_2) != JNI_OK || !jvmti) {
+        LOG_ERROR(L"Failed to get JVMTI environment");
+        return false;
+    }
+    
+    jvmtiEventCallbacks callbacks = {};
+    callbacks.VMInit = &OnVMInit;
+    callbacks.VMDeath = &OnVMDeath;
+    if (jvmti->SetEventCallbacks(&callbacks, static_cast<jint>(sizeof(callbacks))) != JVMTI_ERROR_NONE) {
+        LOG_ERROR(L"Failed to set JVMTI event callbacks");
+        return false;
+    }
+    
+    if (onLoad && jvmti->SetEventNotificationMode(JVMTI_ENABLE, JVMTI_EVENT_VM_INIT, nullptr) != JVMTI_ERROR_NONE) {
+        LOG_ERROR(L"Failed to enable VMInit event");
+        return false;
+    }
+    
+    if (jvmti->SetEventNotificationMode(JVMTI_ENABLE, JVMTI_EVENT_VM_DEATH, nullptr) != JVMTI_ERROR_NONE) {
+        LOG_ERROR(L"Failed to enable VMDeath event");
+        return false;
+    }
+    
+    return true;
+}
+
+// 在独立线程中注入，避免阻塞Attach监听线程或System.load的调用者
+// 线程结束前从JVM分离，否则JVM会一直保留这个已结束线程的java.lang.Thread
+bool StartInjectionThread() {
+    try {
+        std::thread([]() {
+            if (InitializeJarInjection() != 0) {
+                LOG_ERROR(L"JAR injection failed in agent thread");
+            }
+            DetachJarInjectionThread();
+        }).detach();
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR(L"Failed to create injection thread: " << StringToWString(e.what()));
+        return false;
+    }
+}
+
+// 读取系统属性，不存在时返回空字符串
+std::string GetSystemProperty(JNIEnv* env, const char* name) {
+    std::string value;
+    jclass systemClass = env->FindClass("java/lang/System");
+    jmethodID getProperty = systemClass ?
+        env->GetStaticMethodID(systemClass, "getProperty", "(Ljava/lang/String;)Ljava/lang/String;") : nullptr;
+    if (!getProperty) {
+        env->ExceptionClear();
+        return value;
+    }
+    
+    jstring key = env->NewStringUTF(name);
+    jstring result = static_cast<jstring>(env->CallStaticObjectMethod(systemClass, getProperty, key));
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    } else if (result) {
+        const char* chars = env->GetStringUTFChars(result, nullptr);
+        if (chars) {
+            value = chars;
+            env->ReleaseStringUTFChars(result, chars);
+        }
+        env->DeleteLocalRef(result);
+    }
+    env->DeleteLocalRef(key);
+    env->DeleteLocalRef(systemClass);
+    return value;
+}
+
+} // namespace
+
+// -agentpath/-agentlib启动时加载：VM尚未初始化，注入推迟到VMInit
+extern "C" JNIEXPORT jint JNICALL Agent_OnLoad(JavaVM* vm, char* options, void* reserved) {
+    if (!ConfigureAgent(options)) {
+        return JNI_ERR;
+    }
+    return RegisterLifecycleEvents(vm, true) ? JNI_OK : JNI_ERR;
+}
+
+// 通过Attach API在运行中的JVM里加载
+extern "C" JNIEXPORT jint JNICALL Agent_OnAttach(JavaVM* vm, char* options, void* reserved) {
+    if (!ConfigureAgent(options)) {
+        return JNI_ERR;
+    }
+    if (!RegisterLifecycleEvents(vm, false)) {
+        LOG_WARNING(L"Hot reload monitoring will not be stopped at VM shutdown");
+    }
+    return StartInjectionThread() ? JNI_OK : JNI_ERR;
+}
+
+// 作为普通JNI库被System.load加载
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK || !env) {
+        return JNI_ERR;
+    }
+    
+    std::string options = GetSystemProperty(env, AGENT_OPTIONS_PROPERTY);
+    if (options.empty()) {
+        // 没有设置选项时只作为库加载，例如已由-agentpath加载过
+        LOG_INFO(L"No " << StringToWString(AGENT_OPTIONS_PROPERTY) << L" property, skipping injection");
+        return JNI_VERSION_1_8;
+    }
+    
+    if (ConfigureAgent(options.c_str())) {
+        RegisterLifecycleEvents(vm, false);
+        StartInjectionThread();
+    }
+    return JNI_VERSION_1_8;
+}
+
+// 代理卸载（JVM退出）时输出剩余日志；后台线程已在VMDeath中停止，
+// JVM已销毁，放弃加载器等对象，避免静态析构调用JNI或等待线程
+extern "C" JNIEXPORT void JNICALL Agent_OnUnload(JavaVM* vm) {
+    StopJarInjectionMonitoring();
+    AbandonJarInjection();
+    Logger::GetInstance().Shutdown();
+}
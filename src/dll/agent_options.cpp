@@ -0,0 +1,78 @@
+#include "../include/agent_options.h"
+#include "../include/security_utils.h"
+#include <set>
+
+namespace {
+
+// 把值复制到定长缓冲区，超出时返回false
+template<size_t N>
+bool CopyValue(const std::string& value, wchar_t (&target)[N]) {
+    std::wstring wide = StringToWString(value);
+    if (wide.empty() || wide.length() >= N) {
+        return false;
+    }
+    wcsncpy(target, wide.c_str(), N - 1);
+    target[N - 1] = L'\0';
+    return true;
+}
+
+} // namespace
+
+ErrorCode AgentOptions::Parse(const std::string& options, InjectionData& data) {
+    InjectionData parsed;
+    wcsncpy(parsed.className, L"Main", MAX_CLASS_NAME_LENGTH - 1);
+    wcsncpy(parsed.methodName, L"main", MAX_METHOD_NAME_LENGTH - 1);
+    parsed.enableHotReload = true;
+    
+    std::set<std::string> seenKeys;
+    size_t begin = 0;
+    while (begin <= options.size()) {
+        size_t end = options.find(',', begin);
+        if (end == std::string::npos) {
+            end = options.size();
+        }
+        std::string option = options.substr(begin, end - begin);
+        begin = end + 1;
+        
+        size_t separator = option.find('=');
+        if (separator == std::string::npos || separator == 0 || separator + 1 == option.size()) {
+            LOG_ERROR(L"Invalid agent option: " << StringToWString(option));
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        std::string key = option.substr(0, separator);
+        std::string value = option.substr(separator + 1);
+        
+        if (!seenKeys.insert(key).second) {
+            LOG_ERROR(L"Duplicate agent option: " << StringToWString(key));
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        
+        bool valid;
+        if (key == "jar") {
+            valid = CopyValue(value, parsed.jarPath);
+        } else if (key == "class") {
+            valid = SecurityUtils::ValidateClassName(value) && CopyValue(value, parsed.className);
+        } else if (key == "method") {
+            valid = SecurityUtils::ValidateMethodName(value) && CopyValue(value, parsed.methodName);
+        } else if (key == "hotReload") {
+            valid = EqualsIgnoreCase(value, "true") || EqualsIgnoreCase(value, "false");
+            parsed.enableHotReload = EqualsIgnoreCase(value, "true");
+        } else {
+            LOG_ERROR(L"Unknown agent option: " << StringToWString(key));
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        
+        if (!valid) {
+            LOG_ERROR(L"Invalid value for agent option " << StringToWString(key) << L": " << StringToWString(value));
+            return ErrorCode::INVALID_PARAMETER;
+        }
+    }
+    
+    if (!parsed.IsValid()) {
+        LOG_ERROR(L"Agent options must include jar=<path>");
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    data = parsed;
+    return ErrorCode::SUCCESS;
+}
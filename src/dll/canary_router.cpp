@@ -0,0 +1,194 @@
+#include "../include/canary_router.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+void LatencyHistogram::Record(uint64_t micros) {
+    ++buckets_[BucketIndex(micros)];
+    ++count_;
+    max_ = std::max(max_, micros);
+}
+
+void LatencyHistogram::Reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    max_ = 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double quantile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    
+    quantile = std::min(1.0, std::max(0.0, quantile));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * count_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(BucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros) {
+    if (micros < SUB_BUCKETS) {
+        return static_cast<size_t>(micros);
+    }
+    
+    // 最高位决定区间，其后的3位决定子桶
+    size_t msb = 0;
+    for (uint64_t value = micros; value > 1; value >>= 1) {
+        ++msb;
+    }
+    size_t shift = msb - 3;
+    size_t sub = static_cast<size_t>(micros >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    
+    size_t shift = index / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+CanaryRouter::CanaryRouter()
+    : active_(false), credit_(0), verdict_(CanaryVerdict::PENDING) {
+}
+
+void CanaryRouter::Start(const CanaryOptions& options, uint64_t baselineGeneration, uint64_t canaryGeneration) {
+    options_ = options;
+    options_.fraction = std::min(1.0, std::max(0.0, options.fraction));
+    baseline_ = Arm();
+    canary_ = Arm();
+    baseline_.generation = baselineGeneration;
+    canary_.generation = canaryGeneration;
+    start_ = std::chrono::steady_clock::now();
+    credit_ = 0;
+    verdict_ = CanaryVerdict::PENDING;
+    reason_.clear();
+    active_ = true;
+}
+
+void CanaryRouter::Stop() {
+    active_ = false;
+}
+
+bool CanaryRouter::RouteToCanary() {
+    credit_ += options_.fraction;
+    if (credit_ >= 1.0) {
+        credit_ -= 1.0;
+        return true;
+    }
+    return false;
+}
+
+void CanaryRouter::Record(bool canary, uint64_t micros, bool succeeded) {
+    Arm& arm = canary ? canary_ : baseline_;
+    ++arm.calls;
+    if (!succeeded) {
+        ++arm.errors;
+    }
+    arm.latency.Record(micros);
+}
+
+bool CanaryRouter::ExceedsBudget(std::string& reason) const {
+    if (canary_.calls < options_.minCalls) {
+        return false;
+    }
+    
+    std::ostringstream text;
+    CanaryArmStats baseline = Summarize(baseline_);
+    CanaryArmStats canary = Summarize(canary_);
+    if (canary.ErrorRate() > baseline.ErrorRate() + options_.maxErrorRateDelta) {
+        text << "error rate " << canary.ErrorRate() << " exceeds baseline " << baseline.ErrorRate()
+             << " + " << options_.maxErrorRateDelta;
+        reason = text.str();
+        return true;
+    }
+    
+    // 旧的一代样本不足时无法比较延迟，只检查错误率
+    if (baseline_.calls >= options_.minCalls) {
+        uint64_t budget = std::max(static_cast<uint64_t>(baseline.p99Us * options_.maxLatencyRatio),
+                                   baseline.p99Us + options_.latencySlackUs);
+        if (canary.p99Us > budget) {
+            text << "p99 " << canary.p99Us << " us exceeds budget " << budget << " us (baseline "
+                 << baseline.p99Us << " us)";
+            reason = text.str();
+            return true;
+        }
+    }
+    return false;
+}
+
+CanaryVerdict CanaryRouter::Evaluate(bool force) {
+    if (!active_ || verdict_ != CanaryVerdict::PENDING) {
+        return verdict_;
+    }
+    
+    if (ExceedsBudget(reason_)) {
+        verdict_ = CanaryVerdict::ROLLBACK;
+        return verdict_;
+    }
+    
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    if (!force && elapsedMs < options_.windowMs) {
+        return verdict_;
+    }
+    
+    if (canary_.calls >= options_.minCalls) {
+        verdict_ = CanaryVerdict::PROMOTE;
+        reason_ = "within budget";
+        return verdict_;
+    }
+    
+    // 样本不足时延长窗口等待更多调用，到期或被强制结束时保留旧的一代
+    double deadlineMs = static_cast<double>(options_.windowMs) * (1.0 + options_.maxWindowExtensions);
+    if (!force && elapsedMs < deadlineMs) {
+        return verdict_;
+    }
+    std::ostringstream text;
+    text << "insufficient samples: " << canary_.calls << " canary calls, " << options_.minCalls << " required";
+    verdict_ = CanaryVerdict::ROLLBACK;
+    reason_ = text.str();
+    return verdict_;
+}
+
+CanaryVerdict CanaryRouter::Supersede() {
+    if (!active_ || Evaluate(false) != CanaryVerdict::PENDING) {
+        return verdict_;
+    }
+    
+    std::ostringstream text;
+    text << "superseded by a newer version after " << canary_.calls << " canary calls";
+    verdict_ = CanaryVerdict::SUPERSEDED;
+    reason_ = text.str();
+    return verdict_;
+}
+
+CanaryReport CanaryRouter::GetReport() const {
+    CanaryReport report;
+    report.active = active_;
+    report.verdict = verdict_;
+    report.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    report.baseline = Summarize(baseline_);
+    report.canary = Summarize(canary_);
+    report.reason = reason_;
+    return report;
+}
+
+CanaryArmStats CanaryRouter::Summarize(const Arm& arm) {
+    CanaryArmStats stats;
+    stats.generation = arm.generation;
+    stats.calls = arm.calls;
+    stats.errors = arm.errors;
+    stats.p50Us = arm.latency.Percentile(0.5);
+    stats.p99Us = arm.latency.Percentile(0.99);
+    stats.maxUs = arm.latency.GetMax();
+    return stats;
+}
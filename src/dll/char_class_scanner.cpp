@@ -0,0 +1,291 @@
+#include "../include/char_class_scanner.h"
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CHAR_CLASS_SCANNER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC无需为单个函数开启指令集，GCC/Clang需要按函数指定目标
+#if defined(CHAR_CLASS_SCANNER_X86) && !defined(_MSC_VER)
+#define SCANNER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SCANNER_TARGET(isa)
+#endif
+
+namespace {
+
+enum class ScanLevel {
+    SCALAR,
+    SSSE3,
+    AVX2
+};
+
+inline unsigned CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#ifdef CHAR_CLASS_SCANNER_X86
+
+ScanLevel DetectScanLevel() {
+    int info[4] = {0, 0, 0, 0};
+#ifdef _MSC_VER
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+#else
+    unsigned a, b, c, d;
+    int maxLeaf = static_cast<int>(__get_cpuid_max(0, nullptr));
+    __cpuid(1, a, b, c, d);
+    info[1] = static_cast<int>(b);
+    info[2] = static_cast<int>(c);
+#endif
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx) {
+        // 操作系统需保存YMM寄存器状态（XCR0的第1、2位）
+#ifdef _MSC_VER
+        unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+#else
+        unsigned eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+        __cpuid_count(7, 0, a, b, c, d);
+        info[1] = static_cast<int>(b);
+#endif
+        avx2 = (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+    }
+    
+    if (avx2) {
+        return ScanLevel::AVX2;
+    }
+    return ssse3 ? ScanLevel::SSSE3 : ScanLevel::SCALAR;
+}
+
+// 高4位到位图中位号的映射，高4位不小于8（非ASCII）时为0
+alignas(16) const uint8_t HIGH_NIBBLE_BITS[16] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// 返回16个字节中不属于该类的字节掩码
+SCANNER_TARGET("ssse3")
+inline uint32_t NonMemberMask16(__m128i bytes, __m128i bitmap, __m128i highBits) {
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    __m128i low = _mm_and_si128(bytes, nibbleMask);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask);
+    __m128i hit = _mm_and_si128(_mm_shuffle_epi8(bitmap, low), _mm_shuffle_epi8(highBits, high));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hit, _mm_setzero_si128())));
+}
+
+// 返回32个字节中不属于该类的字节掩码
+SCANNER_TARGET("avx2")
+inline uint32_t NonMemberMask32(__m256i bytes, __m256i bitmap, __m256i highBits) {
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(bytes, nibbleMask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask);
+    __m256i hit = _mm256_and_si256(_mm256_shuffle_epi8(bitmap, low), _mm256_shuffle_epi8(highBits, high));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hit, _mm256_setzero_si256())));
+}
+
+// 以下函数返回已扫描的长度；找到目标时通过found返回位置，否则剩余部分交给逐字符扫描
+
+template<bool Negate>
+SCANNER_TARGET("ssse3")
+size_t ScanBytesSsse3(const uint8_t* bitmapTable, const uint8_t* data, size_t length, size_t& found) {
+    const __m128i bitmap = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmapTable));
+    const __m128i highBits = _mm_load_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_BITS));
+    size_t offset = 0;
+    for (; offset + 16 <= length; offset += 16) {
+        uint32_t nonMembers = NonMemberMask16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)),
+                                              bitmap, highBits);
+        uint32_t mask = Negate ? nonMembers : (~nonMembers & 0xFFFF);
+        if (mask) {
+            found = offset + CountTrailingZeros(mask);
+            return offset;
+        }
+    }
+    return offset;
+}
+
+template<bool Negate>
+SCANNER_TARGET("avx2")
+size_t ScanBytesAvx2(const uint8_t* bitmapTable, const uint8_t* data, size_t length, size_t& found) {
+    const __m256i bitmap = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmapTable)));
+    const __m256i highBits = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_BITS)));
+    size_t offset = 0;
+    for (; offset + 32 <= length; offset += 32) {
+        uint32_t nonMembers = NonMemberMask32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)),
+                                              bitmap, highBits);
+        uint32_t mask = Negate ? nonMembers : ~nonMembers;
+        if (mask) {
+            found = offset + CountTrailingZeros(mask);
+            return offset;
+        }
+    }
+    return offset;
+}
+
+// 宽字符按有符号16位饱和压缩：0x0100..0x7FFF变为0xFF，0x8000..0xFFFF变为0x00，
+// 两者都不属于任何字符类（构造时已排除'\0'），ASCII字符保持不变
+template<bool Negate>
+SCANNER_TARGET("ssse3")
+size_t ScanWideSsse3(const uint8_t* bitmapTable, const uint16_t* data, size_t length, size_t& found) {
+    const __m128i bitmap = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmapTable));
+    const __m128i highBits = _mm_load_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_BITS));
+    size_t offset = 0;
+    for (; offset + 16 <= length; offset += 16) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + 8));
+        uint32_t nonMembers = NonMemberMask16(_mm_packus_epi16(first, second), bitmap, highBits);
+        uint32_t mask = Negate ? nonMembers : (~nonMembers & 0xFFFF);
+        if (mask) {
+            found = offset + CountTrailingZeros(mask);
+            return offset;
+        }
+    }
+    return offset;
+}
+
+template<bool Negate>
+SCANNER_TARGET("avx2")
+size_t ScanWideAvx2(const uint8_t* bitmapTable, const uint16_t* data, size_t length, size_t& found) {
+    const __m256i bitmap = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bitmapTable)));
+    const __m256i highBits = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_BITS)));
+    size_t offset = 0;
+    for (; offset + 32 <= length; offset += 32) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + 16));
+        // packus按128位通道交错，重排64位块恢复原顺序
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+        uint32_t nonMembers = NonMemberMask32(packed, bitmap, highBits);
+        uint32_t mask = Negate ? nonMembers : ~nonMembers;
+        if (mask) {
+            found = offset + CountTrailingZeros(mask);
+            return offset;
+        }
+    }
+    return offset;
+}
+
+#else
+
+ScanLevel DetectScanLevel() {
+    return ScanLevel::SCALAR;
+}
+
+#endif
+
+ScanLevel GetScanLevel() {
+    static const ScanLevel level = DetectScanLevel();
+    return level;
+}
+
+} // namespace
+
+const char* CharClassScanner::GetInstructionSet() {
+    switch (GetScanLevel()) {
+    case ScanLevel::AVX2:
+        return "AVX2";
+    case ScanLevel::SSSE3:
+        return "SSSE3";
+    default:
+        return "scalar";
+    }
+}
+
+template<bool Negate, typename CharT>
+size_t CharClassScanner::FindScalar(const CharT* data, size_t begin, size_t length) const {
+    for (size_t i = begin; i < length; ++i) {
+        uint32_t value = static_cast<uint32_t>(static_cast<std::make_unsigned_t<CharT>>(data[i]));
+        if (IsMember(value) != Negate) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+template<bool Negate>
+size_t CharClassScanner::FindBytes(const uint8_t* data, size_t length) const {
+    size_t scanned = 0;
+#ifdef CHAR_CLASS_SCANNER_X86
+    size_t found = npos;
+    ScanLevel level = GetScanLevel();
+    if (level == ScanLevel::AVX2) {
+        scanned = ScanBytesAvx2<Negate>(bitmap_.data(), data, length, found);
+    }
+    if (found == npos && level != ScanLevel::SCALAR) {
+        // AVX2剩余的不足32字节仍可按16字节处理一次
+        size_t base = scanned;
+        scanned += ScanBytesSsse3<Negate>(bitmap_.data(), data + base, length - base, found);
+        if (found != npos) {
+            found += base;
+        }
+    }
+    if (found != npos) {
+        return found;
+    }
+#endif
+    return FindScalar<Negate>(data, scanned, length);
+}
+
+template<bool Negate>
+size_t CharClassScanner::FindWide(const uint16_t* data, size_t length) const {
+    size_t scanned = 0;
+#ifdef CHAR_CLASS_SCANNER_X86
+    size_t found = npos;
+    ScanLevel level = GetScanLevel();
+    if (level == ScanLevel::AVX2) {
+        scanned = ScanWideAvx2<Negate>(bitmap_.data(), data, length, found);
+    }
+    if (found == npos && level != ScanLevel::SCALAR) {
+        size_t base = scanned;
+        scanned += ScanWideSsse3<Negate>(bitmap_.data(), data + base, length - base, found);
+        if (found != npos) {
+            found += base;
+        }
+    }
+    if (found != npos) {
+        return found;
+    }
+#endif
+    return FindScalar<Negate>(data, scanned, length);
+}
+
+size_t CharClassScanner::FindFirstOf(std::string_view text) const {
+    return FindBytes<false>(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+size_t CharClassScanner::FindFirstNotOf(std::string_view text) const {
+    return FindBytes<true>(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+size_t CharClassScanner::FindFirstOf(std::wstring_view text) const {
+    if constexpr (sizeof(wchar_t) == sizeof(uint16_t)) {
+        return FindWide<false>(reinterpret_cast<const uint16_t*>(text.data()), text.size());
+    } else {
+        return FindScalar<false>(text.data(), 0, text.size());
+    }
+}
+
+size_t CharClassScanner::FindFirstNotOf(std::wstring_view text) const {
+    if constexpr (sizeof(wchar_t) == sizeof(uint16_t)) {
+        return FindWide<true>(reinterpret_cast<const uint16_t*>(text.data()), text.size());
+    } else {
+        return FindScalar<true>(text.data(), 0, text.size());
+    }
+}
@@ -0,0 +1,200 @@
+#include "../include/class_index.h"
+#include <algorithm>
+
+namespace {
+
+constexpr std::string_view CLASS_SUFFIX = ".class";
+constexpr std::string_view META_INF_PREFIX = "META-INF/";
+constexpr std::string_view VERSIONS_PREFIX = "META-INF/versions/";
+constexpr size_t MIN_SLOT_COUNT = 16;
+
+size_t NextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// 将条目名转换为类名（仍为斜杠形式），非类条目返回空
+std::string_view EntryToClassName(std::string_view entryName) {
+    if (entryName.size() <= CLASS_SUFFIX.size() ||
+        entryName.compare(entryName.size() - CLASS_SUFFIX.size(), CLASS_SUFFIX.size(), CLASS_SUFFIX) != 0) {
+        return {};
+    }
+    entryName.remove_suffix(CLASS_SUFFIX.size());
+    
+    // 多版本JAR：META-INF/versions/<N>/com/example/Foo.class 视为 com.example.Foo
+    if (entryName.compare(0, VERSIONS_PREFIX.size(), VERSIONS_PREFIX) == 0) {
+        size_t slash = entryName.find('/', VERSIONS_PREFIX.size());
+        if (slash == std::string_view::npos) {
+            return {};
+        }
+        return entryName.substr(slash + 1);
+    }
+    
+    if (entryName.compare(0, META_INF_PREFIX.size(), META_INF_PREFIX) == 0) {
+        return {};
+    }
+    return entryName;
+}
+
+} // namespace
+
+ClassIndex::ClassIndex() : classCount_(0), packageCount_(0), built_(false) {
+}
+
+void ClassIndex::Build(const JarArchive& archive) {
+    Clear();
+    
+    size_t classEntries = 0;
+    size_t nameBytes = 0;
+    for (const auto& entry : archive) {
+        if (entry.IsClass()) {
+            ++classEntries;
+            nameBytes += entry.name.size();
+        }
+    }
+    
+    // 类名与包名总数不超过2 * 类数 + 1，负载因子保持在0.5以下
+    slots_.assign(NextPowerOfTwo(std::max(MIN_SLOT_COUNT, (classEntries + 1) * 4)),
+                  Slot{EMPTY_SLOT, 0, 0, 0, 0});
+    arena_.reserve(nameBytes);
+    classOrder_.reserve(classEntries);
+    
+    std::string scratch;
+    for (const auto& entry : archive) {
+        std::string_view className = EntryToClassName(entry.name);
+        if (className.empty()) {
+            continue;
+        }
+        
+        std::string_view dotted = Normalize(className, scratch);
+        uint32_t slotIndex = Insert(dotted, KIND_CLASS);
+        if (slotIndex == EMPTY_SLOT) {
+            continue;
+        }
+        Insert(PackageOf(dotted), KIND_PACKAGE);
+    }
+    
+    built_ = true;
+    LOG_DEBUG(L"Class index built: " << classCount_ << L" classes, " << packageCount_
+              << L" packages, " << GetMemoryUsage() << L" bytes");
+}
+
+void ClassIndex::Clear() {
+    arena_.clear();
+    slots_.clear();
+    classOrder_.clear();
+    classCount_ = 0;
+    packageCount_ = 0;
+    built_ = false;
+}
+
+bool ClassIndex::ContainsClass(std::string_view className) const {
+    std::string scratch;
+    uint32_t slotIndex = Find(Normalize(className, scratch));
+    return slotIndex != EMPTY_SLOT && (slots_[slotIndex].kinds & KIND_CLASS) != 0;
+}
+
+bool ClassIndex::ContainsPackage(std::string_view packageName) const {
+    std::string scratch;
+    uint32_t slotIndex = Find(Normalize(packageName, scratch));
+    return slotIndex != EMPTY_SLOT && (slots_[slotIndex].kinds & KIND_PACKAGE) != 0;
+}
+
+std::vector<std::string> ClassIndex::GetEntryPointCandidates() const {
+    std::vector<std::string> candidates;
+    ForEachClass([&candidates](std::string_view name) {
+        if (name.find('$') != std::string_view::npos) {
+            return;
+        }
+        
+        std::string_view simpleName = name.substr(name.rfind('.') + 1);
+        if (simpleName == "module-info" || simpleName == "package-info") {
+            return;
+        }
+        candidates.emplace_back(name);
+    });
+    
+    std::sort(candidates.begin(), candidates.end());
+    return candidates;
+}
+
+size_t ClassIndex::GetMemoryUsage() const {
+    return arena_.capacity() + slots_.capacity() * sizeof(Slot) + classOrder_.capacity() * sizeof(uint32_t);
+}
+
+std::string_view ClassIndex::PackageOf(std::string_view className) {
+    size_t separator = className.find_last_of("./");
+    return separator == std::string_view::npos ? std::string_view() : className.substr(0, separator);
+}
+
+uint32_t ClassIndex::Insert(std::string_view name, uint8_t kind) {
+    if (name.size() > UINT16_MAX || arena_.size() + name.size() > EMPTY_SLOT - 1) {
+        return EMPTY_SLOT;
+    }
+    
+    uint32_t hash = Hash(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        Slot& slot = slots_[index];
+        if (slot.nameOffset == EMPTY_SLOT) {
+            slot.nameOffset = static_cast<uint32_t>(arena_.size());
+            slot.nameLength = static_cast<uint16_t>(name.size());
+            slot.hash = hash;
+            arena_.insert(arena_.end(), name.begin(), name.end());
+        } else if (slot.hash != hash || NameAt(slot) != name) {
+            continue;
+        }
+        
+        if ((slot.kinds & kind) == 0) {
+            slot.kinds |= kind;
+            if (kind == KIND_CLASS) {
+                classOrder_.push_back(static_cast<uint32_t>(index));
+                ++classCount_;
+            } else {
+                ++packageCount_;
+            }
+        }
+        return static_cast<uint32_t>(index);
+    }
+}
+
+uint32_t ClassIndex::Find(std::string_view name) const {
+    if (slots_.empty()) {
+        return EMPTY_SLOT;
+    }
+    
+    uint32_t hash = Hash(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        const Slot& slot = slots_[index];
+        if (slot.nameOffset == EMPTY_SLOT) {
+            return EMPTY_SLOT;
+        }
+        if (slot.hash == hash && NameAt(slot) == name) {
+            return static_cast<uint32_t>(index);
+        }
+    }
+}
+
+std::string_view ClassIndex::Normalize(std::string_view name, std::string& scratch) {
+    if (name.find('/') == std::string_view::npos) {
+        return name;
+    }
+    
+    scratch.assign(name.begin(), name.end());
+    std::replace(scratch.begin(), scratch.end(), '/', '.');
+    return scratch;
+}
+
+uint32_t ClassIndex::Hash(std::string_view name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
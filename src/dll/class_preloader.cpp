@@ -0,0 +1,287 @@
+#include "../include/class_preloader.h"
+#include "../include/class_index.h"
+#include <algorithm>
+#include <unordered_map>
+
+ClassPreloader::ClassPreloader()
+    : jvm_(nullptr), job_(nullptr), jobId_(0), finishedWorkers_(0), attachedWorkers_(0),
+      startedWorkers_(0), stopping_(false) {
+}
+
+ClassPreloader::~ClassPreloader() {
+    Stop();
+}
+
+ErrorCode ClassPreloader::Start(JavaVM* jvm, size_t threads) {
+    if (!jvm) {
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    if (IsRunning()) {
+        return ErrorCode::SUCCESS;
+    }
+    
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    threads = std::max<size_t>(1, std::min(threads, MAX_THREADS));
+    
+    jvm_ = jvm;
+    stopping_ = false;
+    attachedWorkers_ = 0;
+    startedWorkers_ = 0;
+    try {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&ClassPreloader::WorkerLoop, this, i);
+        }
+    } catch (const std::system_error& e) {
+        LOG_ERROR(L"Failed to create preload worker: " << StringToWString(e.what()));
+        Stop();
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    // 等待所有线程完成附加，附加失败的线程已退出
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobDone_.wait(lock, [this]() { return startedWorkers_ == workers_.size(); });
+    if (attachedWorkers_ == 0) {
+        lock.unlock();
+        LOG_ERROR(L"No preload worker could attach to the JVM");
+        Stop();
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    LOG_DEBUG(L"Class preloader started with " << attachedWorkers_ << L" attached threads");
+    return ErrorCode::SUCCESS;
+}
+
+void ClassPreloader::Stop() {
+    // 等待进行中的任务完成
+    std::lock_guard<std::mutex> jobLock(jobMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobReady_.notify_all();
+    
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+PreloadResult ClassPreloader::Preload(jobject classLoader, const std::vector<std::string>& classNames, size_t maxThreads) {
+    Job job;
+    job.classLoader = classLoader;
+    job.classNames = &classNames;
+    job.batches = PartitionByPackage(classNames);
+    job.initialize = false;
+    job.maxThreads = maxThreads;
+    return RunJob(job);
+}
+
+PreloadResult ClassPreloader::Initialize(jobject classLoader, const std::vector<std::string>& classNames) {
+    // 整个列表作为一批，按原顺序初始化
+    Job job;
+    job.classLoader = classLoader;
+    job.classNames = &classNames;
+    job.batches.emplace_back(classNames.size());
+    for (size_t i = 0; i < classNames.size(); ++i) {
+        job.batches[0][i] = static_cast<uint32_t>(i);
+    }
+    job.initialize = true;
+    job.maxThreads = 1;
+    return RunJob(job);
+}
+
+PreloadResult ClassPreloader::RunJob(Job& job) {
+    PreloadResult result;
+    if (!job.classLoader || job.classNames->empty()) {
+        return result;
+    }
+    
+    // 在任务锁下检查：Stop可能在另一线程上进行，工作线程退出后任务将无人完成
+    std::lock_guard<std::mutex> jobLock(jobMutex_);
+    if (workers_.empty()) {
+        return result;
+    }
+    auto start = std::chrono::steady_clock::now();
+    
+    job.cursor = 0;
+    job.loaded = 0;
+    job.failed = 0;
+    size_t threads = attachedWorkers_;
+    if (job.maxThreads != 0) {
+        threads = std::min(threads, job.maxThreads);
+    }
+    job.maxThreads = std::min(threads, job.batches.size());
+    
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &job;
+        finishedWorkers_ = 0;
+        ++jobId_;
+        jobReady_.notify_all();
+        jobDone_.wait(lock, [this]() { return finishedWorkers_ == attachedWorkers_; });
+        job_ = nullptr;
+    }
+    
+    result.loaded = job.loaded.load();
+    result.failed = job.failed.load();
+    result.threads = job.maxThreads;
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    LOG_INFO((job.initialize ? L"Initialized " : L"Preloaded ") << result.loaded << L" classes (" << result.failed
+             << L" failed) on " << result.threads << L" threads in " << result.durationMs << L" ms");
+    return result;
+}
+
+void ClassPreloader::WorkerLoop(size_t workerIndex) {
+    JNIEnv* env = nullptr;
+    jclass classClass = nullptr;
+    jmethodID forName = nullptr;
+    bool attached = jvm_->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr) == JNI_OK && env;
+    if (attached) {
+        jclass localClass = env->FindClass("java/lang/Class");
+        forName = localClass ?
+            env->GetStaticMethodID(localClass, "forName", "(Ljava/lang/String;ZLjava/lang/ClassLoader;)Ljava/lang/Class;") : nullptr;
+        classClass = localClass ? static_cast<jclass>(env->NewGlobalRef(localClass)) : nullptr;
+        if (localClass) {
+            env->DeleteLocalRef(localClass);
+        }
+        if (!forName || !classClass || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            if (classClass) {
+                env->DeleteGlobalRef(classClass);
+            }
+            jvm_->DetachCurrentThread();
+            attached = false;
+        }
+    }
+    
+    // 按附加成功的顺序编号，任务只使用编号小于其线程数的工作线程
+    uint64_t seenJobId;
+    size_t rank = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++startedWorkers_;
+        if (attached) {
+            rank = attachedWorkers_++;
+        }
+        seenJobId = jobId_;
+    }
+    jobDone_.notify_all();
+    if (!attached) {
+        LOG_WARNING(L"Preload worker " << workerIndex << L" failed to attach to JVM");
+        return;
+    }
+    
+    while (true) {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobReady_.wait(lock, [this, seenJobId]() { return stopping_ || jobId_ != seenJobId; });
+            if (stopping_) {
+                break;
+            }
+            seenJobId = jobId_;
+            job = job_;
+        }
+        
+        // 超出本次任务线程数的工作线程直接报告完成
+        if (job && rank < job->maxThreads) {
+            ProcessBatches(env, classClass, forName, *job);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++finishedWorkers_;
+        }
+        jobDone_.notify_all();
+    }
+    
+    env->DeleteGlobalRef(classClass);
+    jvm_->DetachCurrentThread();
+}
+
+void ClassPreloader::ProcessBatches(JNIEnv* env, jclass classClass, jmethodID forName, Job& job) {
+    const std::vector<std::string>& classNames = *job.classNames;
+    jboolean initialize = job.initialize ? JNI_TRUE : JNI_FALSE;
+    
+    size_t batchIndex;
+    while ((batchIndex = job.cursor.fetch_add(1, std::memory_order_relaxed)) < job.batches.size()) {
+        for (uint32_t index : job.batches[batchIndex]) {
+            jstring name = env->NewStringUTF(classNames[index].c_str());
+            jobject clazz = name ? env->CallStaticObjectMethod(classClass, forName, name, initialize, job.classLoader) : nullptr;
+            if (env->ExceptionCheck() || !clazz) {
+                // NoClassDefFoundError、ExceptionInInitializerError等只影响这个类
+                env->ExceptionClear();
+                job.failed.fetch_add(1, std::memory_order_relaxed);
+                LOG_DEBUG(L"Preload failed: " << StringToWString(classNames[index]));
+            } else {
+                job.loaded.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (clazz) {
+                env->DeleteLocalRef(clazz);
+            }
+            if (name) {
+                env->DeleteLocalRef(name);
+            }
+        }
+    }
+}
+
+std::vector<std::vector<uint32_t>> ClassPreloader::PartitionByPackage(const std::vector<std::string>& classNames,
+                                                                      size_t maxBatchSize) {
+    if (maxBatchSize == 0) {
+        maxBatchSize = MAX_BATCH_SIZE;
+    }
+    
+    // 按包首次出现的顺序分组，保持JAR中的相对顺序
+    std::unordered_map<std::string_view, size_t> packageGroups;
+    std::vector<std::vector<uint32_t>> groups;
+    for (size_t i = 0; i < classNames.size(); ++i) {
+        std::string_view package = ClassIndex::PackageOf(classNames[i]);
+        auto inserted = packageGroups.emplace(package, groups.size());
+        if (inserted.second) {
+            groups.emplace_back();
+        }
+        groups[inserted.first->second].push_back(static_cast<uint32_t>(i));
+    }
+    
+    // 大包拆成批；先领取大批次，尾部用小批次平衡各线程
+    std::vector<std::vector<uint32_t>> batches;
+    for (auto& group : groups) {
+        for (size_t offset = 0; offset < group.size(); offset += maxBatchSize) {
+            size_t end = std::min(group.size(), offset + maxBatchSize);
+            batches.emplace_back(group.begin() + offset, group.begin() + end);
+        }
+    }
+    std::stable_sort(batches.begin(), batches.end(), [](const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        return a.size() > b.size();
+    });
+    return batches;
+}
+
+bool ClassPreloader::IsParallelCapable(JNIEnv* env, jobject classLoader) {
+    if (!env || !classLoader) {
+        return false;
+    }
+    
+    jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+    jmethodID method = classLoaderClass ? env->GetMethodID(classLoaderClass, "isRegisteredAsParallelCapable", "()Z") : nullptr;
+    if (classLoaderClass) {
+        env->DeleteLocalRef(classLoaderClass);
+    }
+    if (!method) {
+        env->ExceptionClear();
+        return true;
+    }
+    
+    jboolean capable = env->CallBooleanMethod(classLoader, method);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return false;
+    }
+    return capable == JNI_TRUE;
+}
@@ -0,0 +1,341 @@
+#include "../include/control_channel.h"
+#include "../include/metrics_registry.h"
+#include <chrono>
+
+ControlServer::ControlServer() : running_(false) {
+}
+
+ControlServer::~ControlServer() {
+    Stop();
+}
+
+ErrorCode ControlServer::Start(const std::wstring& endpoint, ControlHandlers handlers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (running_) {
+        LOG_INFO(L"Control server already started: " << endpoint_);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    ErrorCode result = ControlTransport::Listen(endpoint, listener_);
+    if (result != ErrorCode::SUCCESS) {
+        LOG_ERROR_DETAILS(CREATE_ERROR_DETAILS(result, L"Failed to create control endpoint", endpoint));
+        return result;
+    }
+    
+    try {
+        endpoint_ = endpoint;
+        handlers_ = std::move(handlers);
+        running_ = true;
+        thread_ = std::thread(&ControlServer::ThreadFunc, this);
+        
+        LOG_INFO(L"Control server listening on " << endpoint_);
+        return ErrorCode::SUCCESS;
+    
+    } catch (const std::exception& e) {
+        running_ = false;
+        LOG_ERROR(L"Failed to start control server thread: " << StringToWString(e.what()));
+        listener_.reset();
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+}
+
+void ControlServer::Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!thread_.joinable()) {
+        running_ = false;
+        return;
+    }
+    
+    running_ = false;
+    listener_->Shutdown();
+    
+    // 在命令处理函数中调用Stop会等待自身，只能放弃该线程，监听端点随进程释放
+    if (thread_.get_id() == std::this_thread::get_id()) {
+        LOG_ERROR(L"Control server stopped from its own command handler: " << endpoint_);
+        thread_.detach();
+        listener_.release();
+        return;
+    }
+    
+    // Shutdown取消所有挂起的I/O，只需等待正在执行的命令（如重载JAR）结束
+    thread_.join();
+    listener_.reset();
+    
+    LOG_INFO(L"Control server stopped: " << endpoint_);
+}
+
+void ControlServer::ThreadFunc() {
+    LOG_DEBUG(L"Control server thread started");
+    
+    while (running_) {
+        std::unique_ptr<ControlConnection> connection = listener_->Accept();
+        if (!connection) {
+            continue;
+        }
+        
+        LOG_DEBUG(L"Control client connected");
+        ServeClient(*connection);
+        connection.reset();
+        LOG_DEBUG(L"Control client disconnected");
+    }
+    
+    if (handlers_.threadExit) {
+        handlers_.threadExit();
+    }
+    
+    LOG_DEBUG(L"Control server thread ended");
+}
+
+void ControlServer::ServeClient(ControlConnection& connection) {
+    uint8_t header[ControlProtocol::HEADER_SIZE];
+    while (running_ && connection.ReadExact(header, ControlProtocol::HEADER_SIZE)) {
+        ControlMessage request;
+        uint32_t payloadLength = 0;
+        if (ControlProtocol::DecodeHeader(header, request, payloadLength) != ErrorCode::SUCCESS) {
+            // 无法确定消息边界，断开客户端
+            return;
+        }
+        
+        request.payload.resize(payloadLength);
+        if (payloadLength > 0 && !connection.ReadExact(request.payload.data(), payloadLength)) {
+            return;
+        }
+        
+        std::vector<uint8_t> response = ControlProtocol::Encode(HandleRequest(request));
+        if (!connection.WriteAll(response.data(), response.size())) {
+            return;
+        }
+    }
+}
+
+ControlMessage ControlServer::HandleRequest(const ControlMessage& request) {
+    auto start = std::chrono::steady_clock::now();
+    
+    PayloadWriter writer;
+    ErrorCode result;
+    try {
+        result = Dispatch(request, writer);
+    } catch (const std::exception& e) {
+        LOG_ERROR(L"Exception while handling control command: " << StringToWString(e.what()));
+        writer = PayloadWriter();
+        writer.WriteString(e.what());
+        result = ErrorCode::UNKNOWN_ERROR;
+    }
+    
+    ControlMessage response;
+    response.command = request.command;
+    response.requestId = request.requestId;
+    response.status = static_cast<int32_t>(result);
+    response.payload = writer.Release();
+    
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    metrics.Increment("control.commands");
+    if (result != ErrorCode::SUCCESS) {
+        metrics.Increment("control.errors");
+    }
+    metrics.Set("control.last_duration_us",
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return response;
+}
+
+ErrorCode ControlServer::Dispatch(const ControlMessage& request, PayloadWriter& response) {
+    PayloadReader reader(request.payload);
+    auto reject = [&response](const std::string& message) {
+        LOG_ERROR(L"Control command rejected: " << StringToWString(message));
+        response.WriteString(message);
+        return ErrorCode::INVALID_PARAMETER;
+    };
+    
+    switch (request.command) {
+    case ControlCommand::PING:
+        return ErrorCode::SUCCESS;
+    
+    case ControlCommand::RELOAD: {
+        if (!handlers_.reload) {
+            return reject("hot reload is not enabled");
+        }
+        LOG_INFO(L"Reload requested through control channel");
+        ErrorCode result = handlers_.reload();
+        if (result != ErrorCode::SUCCESS) {
+            response.WriteString("reload failed");
+        }
+        return result;
+    }
+    
+    case ControlCommand::INVOKE: {
+        std::string className;
+        std::string methodName;
+        uint32_t argCount = 0;
+        if (!reader.ReadString(className, MAX_CLASS_NAME_LENGTH) ||
+            !reader.ReadString(methodName, MAX_METHOD_NAME_LENGTH) ||
+            !reader.ReadUInt32(argCount) || argCount > ControlProtocol::MAX_INVOKE_ARGS) {
+            return reject("malformed invoke request");
+        }
+        
+        std::vector<std::string> args(argCount);
+        for (auto& arg : args) {
+            if (!reader.ReadString(arg)) {
+                return reject("malformed invoke arguments");
+            }
+        }
+        if (!reader.AtEnd()) {
+            return reject("unexpected data after invoke arguments");
+        }
+        if (!handlers_.invoke) {
+            return reject("invoke is not available");
+        }
+        
+        ErrorCode result = handlers_.invoke(className, methodName, args);
+        if (result != ErrorCode::SUCCESS) {
+            response.WriteString("invoke " + className + "." + methodName + " failed");
+        }
+        return result;
+    }
+    
+    case ControlCommand::GET_METRICS: {
+        MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+        metrics.Set("log.dropped_records", static_cast<int64_t>(Logger::GetInstance().GetDroppedRecordCount()));
+        
+        auto snapshot = metrics.Snapshot();
+        response.WriteUInt32(static_cast<uint32_t>(snapshot.size()));
+        for (const auto& metric : snapshot) {
+            response.WriteString(metric.first);
+            response.WriteInt64(metric.second);
+        }
+        return ErrorCode::SUCCESS;
+    }
+    
+    case ControlCommand::SET_LOG_LEVEL: {
+        uint32_t level = 0;
+        if (!reader.ReadUInt32(level) || !reader.AtEnd() || level > static_cast<uint32_t>(LogLevel::CRITICAL)) {
+            return reject("invalid log level");
+        }
+        Logger::GetInstance().SetLogLevel(static_cast<LogLevel>(level));
+        LOG_INFO(L"Log level changed through control channel: " << level);
+        return ErrorCode::SUCCESS;
+    }
+    }
+    
+    return reject("unknown command " + std::to_string(static_cast<uint32_t>(request.command)));
+}
+
+ControlClient::ControlClient() : nextRequestId_(1) {
+}
+
+ControlClient::~ControlClient() {
+    Disconnect();
+}
+
+ErrorCode ControlClient::Connect(const std::wstring& endpoint, uint32_t timeoutMs) {
+    Disconnect();
+    return ControlTransport::Connect(endpoint, timeoutMs, connection_);
+}
+
+void ControlClient::Disconnect() {
+    connection_.reset();
+}
+
+ErrorCode ControlClient::Send(ControlCommand command, const std::vector<uint8_t>& payload, std::vector<uint8_t>& responsePayload) {
+    errorMessage_.clear();
+    responsePayload.clear();
+    
+    if (!connection_) {
+        errorMessage_ = "not connected";
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    ControlMessage request;
+    request.command = command;
+    request.requestId = nextRequestId_++;
+    request.payload = payload;
+    std::vector<uint8_t> data = ControlProtocol::Encode(request);
+    
+    if (!connection_->WriteAll(data.data(), data.size())) {
+        errorMessage_ = "failed to send request";
+        return ErrorCode::MEMORY_WRITE_FAILED;
+    }
+    
+    uint8_t header[ControlProtocol::HEADER_SIZE];
+    ControlMessage response;
+    uint32_t payloadLength = 0;
+    if (!connection_->ReadExact(header, ControlProtocol::HEADER_SIZE) ||
+        ControlProtocol::DecodeHeader(header, response, payloadLength) != ErrorCode::SUCCESS ||
+        response.requestId != request.requestId || response.command != command) {
+        errorMessage_ = "invalid response";
+        Disconnect();
+        return ErrorCode::UNKNOWN_ERROR;
+    }
+    
+    responsePayload.resize(payloadLength);
+    if (payloadLength > 0 && !connection_->ReadExact(responsePayload.data(), payloadLength)) {
+        errorMessage_ = "truncated response";
+        Disconnect();
+        return ErrorCode::UNKNOWN_ERROR;
+    }
+    
+    ErrorCode status = static_cast<ErrorCode>(response.status);
+    if (status != ErrorCode::SUCCESS) {
+        PayloadReader reader(responsePayload);
+        reader.ReadString(errorMessage_);
+    }
+    return status;
+}
+
+ErrorCode ControlClient::Ping() {
+    std::vector<uint8_t> response;
+    return Send(ControlCommand::PING, {}, response);
+}
+
+ErrorCode ControlClient::Reload() {
+    std::vector<uint8_t> response;
+    return Send(ControlCommand::RELOAD, {}, response);
+}
+
+ErrorCode ControlClient::Invoke(const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+    PayloadWriter writer;
+    writer.WriteString(className);
+    writer.WriteString(methodName);
+    writer.WriteUInt32(static_cast<uint32_t>(args.size()));
+    for (const auto& arg : args) {
+        writer.WriteString(arg);
+    }
+    
+    std::vector<uint8_t> response;
+    return Send(ControlCommand::INVOKE, writer.GetData(), response);
+}
+
+ErrorCode ControlClient::GetMetrics(std::vector<std::pair<std::string, int64_t>>& metrics) {
+    std::vector<uint8_t> response;
+    ErrorCode result = Send(ControlCommand::GET_METRICS, {}, response);
+    if (result != ErrorCode::SUCCESS) {
+        return result;
+    }
+    
+    PayloadReader reader(response);
+    uint32_t count = 0;
+    if (!reader.ReadUInt32(count)) {
+        errorMessage_ = "malformed metrics response";
+        return ErrorCode::UNKNOWN_ERROR;
+    }
+    
+    metrics.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::pair<std::string, int64_t> metric;
+        if (!reader.ReadString(metric.first) || !reader.ReadInt64(metric.second)) {
+            errorMessage_ = "malformed metrics response";
+            return ErrorCode::UNKNOWN_ERROR;
+        }
+        metrics.push_back(std::move(metric));
+    }
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode ControlClient::SetLogLevel(LogLevel level) {
+    PayloadWriter writer;
+    writer.WriteUInt32(static_cast<uint32_t>(level));
+    
+    std::vector<uint8_t> response;
+    return Send(ControlCommand::SET_LOG_LEVEL, writer.GetData(), response);
+}
@@ -0,0 +1,108 @@
+#include "../include/control_protocol.h"
+
+namespace {
+
+void Put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+uint32_t Get32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+std::vector<uint8_t> ControlProtocol::Encode(const ControlMessage& message) {
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + message.payload.size());
+    Put32(out, MAGIC);
+    Put32(out, VERSION | (static_cast<uint32_t>(message.command) << 16));
+    Put32(out, message.requestId);
+    Put32(out, static_cast<uint32_t>(message.status));
+    Put32(out, static_cast<uint32_t>(message.payload.size()));
+    out.insert(out.end(), message.payload.begin(), message.payload.end());
+    return out;
+}
+
+ErrorCode ControlProtocol::DecodeHeader(const uint8_t* header, ControlMessage& message, uint32_t& payloadLength) {
+    if (Get32(header) != MAGIC) {
+        LOG_ERROR(L"Invalid control message magic");
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    uint32_t versionAndCommand = Get32(header + 4);
+    if ((versionAndCommand & 0xFFFF) != VERSION) {
+        LOG_ERROR(L"Unsupported control protocol version: " << (versionAndCommand & 0xFFFF));
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    payloadLength = Get32(header + 16);
+    if (payloadLength > MAX_PAYLOAD_SIZE) {
+        LOG_ERROR(L"Control message payload too large: " << payloadLength);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    message.command = static_cast<ControlCommand>(versionAndCommand >> 16);
+    message.requestId = Get32(header + 8);
+    message.status = static_cast<int32_t>(Get32(header + 12));
+    message.payload.clear();
+    return ErrorCode::SUCCESS;
+}
+
+const char* ControlProtocol::GetCommandName(ControlCommand command) {
+    switch (command) {
+    case ControlCommand::PING: return "ping";
+    case ControlCommand::RELOAD: return "reload";
+    case ControlCommand::INVOKE: return "invoke";
+    case ControlCommand::GET_METRICS: return "metrics";
+    case ControlCommand::SET_LOG_LEVEL: return "log-level";
+    }
+    return "unknown";
+}
+
+void PayloadWriter::WriteUInt32(uint32_t value) {
+    Put32(data_, value);
+}
+
+void PayloadWriter::WriteInt64(int64_t value) {
+    Put32(data_, static_cast<uint32_t>(static_cast<uint64_t>(value)));
+    Put32(data_, static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+}
+
+void PayloadWriter::WriteString(const std::string& value) {
+    Put32(data_, static_cast<uint32_t>(value.size()));
+    data_.insert(data_.end(), value.begin(), value.end());
+}
+
+bool PayloadReader::ReadUInt32(uint32_t& value) {
+    if (size_ - offset_ < 4) {
+        return false;
+    }
+    value = Get32(data_ + offset_);
+    offset_ += 4;
+    return true;
+}
+
+bool PayloadReader::ReadInt64(int64_t& value) {
+    uint32_t low, high;
+    if (size_ - offset_ < 8 || !ReadUInt32(low) || !ReadUInt32(high)) {
+        return false;
+    }
+    value = static_cast<int64_t>(static_cast<uint64_t>(low) | (static_cast<uint64_t>(high) << 32));
+    return true;
+}
+
+bool PayloadReader::ReadString(std::string& value, size_t maxLength) {
+    uint32_t length;
+    size_t start = offset_;
+    if (!ReadUInt32(length) || length > maxLength || size_ - offset_ < length) {
+        offset_ = start;
+        return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data_ + offset_), length);
+    offset_ += length;
+    return true;
+}
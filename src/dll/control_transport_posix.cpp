@@ -0,0 +1,252 @@
+// 控制通道的POSIX传输：UNIX域套接字
+#include "../include/control_transport.h"
+#include "../include/platform.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+bool MakeAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// 等待fd就绪；wakeFd可读（监听端已Shutdown）时返回false
+bool WaitReady(int fd, short events, int wakeFd) {
+    pollfd fds[2] = { { fd, events, 0 }, { wakeFd, POLLIN, 0 } };
+    while (true) {
+        int count = poll(fds, wakeFd >= 0 ? 2 : 1, -1);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 || (wakeFd >= 0 && fds[1].revents != 0)) {
+            return false;
+        }
+        return fds[0].revents != 0;
+    }
+}
+
+// 服务端连接与客户端共用；服务端的连接在监听端Shutdown时中止挂起的读写
+class SocketConnection : public ControlConnection {
+public:
+    SocketConnection(int fd, int wakeFd) : fd_(fd), wakeFd_(wakeFd) {}
+    
+    ~SocketConnection() override {
+        close(fd_);
+    }
+    
+    bool ReadExact(uint8_t* buffer, size_t size) override {
+        size_t offset = 0;
+        while (offset < size) {
+            if (!WaitReady(fd_, POLLIN, wakeFd_)) {
+                return false;
+            }
+            ssize_t received = recv(fd_, buffer + offset, size - offset, 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(received);
+        }
+        return true;
+    }
+    
+    bool WriteAll(const uint8_t* data, size_t size) override {
+        size_t offset = 0;
+        while (offset < size) {
+            if (!WaitReady(fd_, POLLOUT, wakeFd_)) {
+                return false;
+            }
+            // 对端已断开时返回EPIPE而不是产生SIGPIPE
+            ssize_t sent = send(fd_, data + offset, size - offset, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+    int wakeFd_;
+};
+
+class SocketListener : public ControlListener {
+public:
+    SocketListener(int fd, std::string path, int wakeRead, int wakeWrite)
+        : fd_(fd), path_(std::move(path)), wakeRead_(wakeRead), wakeWrite_(wakeWrite) {}
+    
+    ~SocketListener() override {
+        close(fd_);
+        unlink(path_.c_str());
+        close(wakeRead_);
+        close(wakeWrite_);
+    }
+    
+    std::unique_ptr<ControlConnection> Accept() override {
+        while (WaitReady(fd_, POLLIN, wakeRead_)) {
+            int client = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                continue;
+            }
+            
+            // 与命名管道的默认DACL对应：只接受同一用户或root
+            ucred credentials = {};
+            socklen_t length = sizeof(credentials);
+            if (getsockopt(client, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0 ||
+                (credentials.uid != geteuid() && credentials.uid != 0)) {
+                LOG_WARNING(L"Control connection rejected from uid " << credentials.uid);
+                close(client);
+                continue;
+            }
+            return std::make_unique<SocketConnection>(client, wakeRead_);
+        }
+        return nullptr;
+    }
+    
+    void Shutdown() override {
+        // 唤醒管道不再读取，之后所有等待都立即返回
+        char signal = 1;
+        ssize_t ignored = write(wakeWrite_, &signal, 1);
+        (void)ignored;
+    }
+
+private:
+    int fd_;
+    std::string path_;
+    int wakeRead_;
+    int wakeWrite_;
+};
+
+} // namespace
+
+std::wstring ControlTransport::GetEndpointName(uint32_t processId) {
+    const char* directory = std::getenv("TMPDIR");
+    std::string path = (directory && *directory) ? directory : "/tmp";
+    if (path.back() != '/') {
+        path += '/';
+    }
+    return Platform::Utf8ToWide(path) + L"dllinject-control-" + std::to_wstring(processId) + L".sock";
+}
+
+ErrorCode ControlTransport::Listen(const std::wstring& endpoint, std::unique_ptr<ControlListener>& listener) {
+    std::string path = Platform::WideToUtf8(endpoint);
+    sockaddr_un address;
+    if (!MakeAddress(path, address)) {
+        LOG_ERROR(L"Control socket path too long: " << endpoint);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    // 残留的套接字文件：有服务端在监听时失败（与FILE_FLAG_FIRST_PIPE_INSTANCE一致），
+    // 否则只删除属于当前用户的套接字，其他用户预先创建的文件使bind失败
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        bool listening = probe >= 0 &&
+            (connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 || errno == EAGAIN);
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (listening) {
+            LOG_ERROR(L"Control endpoint already in use: " << endpoint);
+            return ErrorCode::THREAD_CREATION_FAILED;
+        }
+        if (S_ISSOCK(status.st_mode) && status.st_uid == geteuid()) {
+            unlink(path.c_str());
+        }
+    }
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    // 套接字文件的权限取自socket的inode，bind之前设置，避免创建后到chmod之间的窗口
+    fchmod(fd, S_IRUSR | S_IWUSR);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        LOG_ERROR(L"Failed to bind control socket " << endpoint << L", errno: " << errno);
+        close(fd);
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    chmod(path.c_str(), S_IRUSR | S_IWUSR);
+    
+    int wake[2];
+    if (listen(fd, 1) != 0 || pipe2(wake, O_CLOEXEC) != 0) {
+        LOG_ERROR(L"Failed to listen on control socket " << endpoint << L", errno: " << errno);
+        close(fd);
+        unlink(path.c_str());
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    listener = std::make_unique<SocketListener>(fd, std::move(path), wake[0], wake[1]);
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode ControlTransport::Connect(const std::wstring& endpoint, uint32_t timeoutMs, std::unique_ptr<ControlConnection>& connection) {
+    sockaddr_un address;
+    if (!MakeAddress(Platform::WideToUtf8(endpoint), address)) {
+        LOG_ERROR(L"Control socket path too long: " << endpoint);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return ErrorCode::THREAD_CREATION_FAILED;
+        }
+        
+        // 服务端正在处理其他客户端且积压队列已满时，connect最多阻塞到超时
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        timeval timeout = {};
+        timeout.tv_sec = static_cast<time_t>(std::max<int64_t>(remaining, 1) / 1000);
+        timeout.tv_usec = static_cast<suseconds_t>(std::max<int64_t>(remaining, 1) % 1000 * 1000);
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            timeval blocking = {};
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &blocking, sizeof(blocking));
+            connection = std::make_unique<SocketConnection>(fd, -1);
+            return ErrorCode::SUCCESS;
+        }
+        
+        int error = errno;
+        close(fd);
+        if (error == ENOENT || error == ECONNREFUSED) {
+            LOG_ERROR(L"No control endpoint found: " << endpoint);
+            return ErrorCode::PROCESS_NOT_FOUND;
+        }
+        if (error == EACCES || error == EPERM) {
+            LOG_ERROR(L"Access denied to control endpoint: " << endpoint);
+            return ErrorCode::PROCESS_ACCESS_DENIED;
+        }
+        if (error != EINTR && error != EAGAIN) {
+            LOG_ERROR(L"Failed to connect to control endpoint: " << endpoint << L", errno: " << error);
+            return ErrorCode::THREAD_TIMEOUT;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            LOG_ERROR(L"Failed to connect to control endpoint: " << endpoint << L", timed out");
+            return ErrorCode::THREAD_TIMEOUT;
+        }
+    }
+}
@@ -0,0 +1,230 @@
+// 控制通道的Windows传输：命名管道
+#include "../include/control_transport.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+// 服务端的管道只有一个实例，连接对象借用监听端的管道与事件
+class PipeListener;
+
+class PipeServerConnection : public ControlConnection {
+public:
+    explicit PipeServerConnection(PipeListener& listener) : listener_(listener) {}
+    ~PipeServerConnection() override;
+    
+    bool ReadExact(uint8_t* buffer, size_t size) override;
+    bool WriteAll(const uint8_t* data, size_t size) override;
+
+private:
+    PipeListener& listener_;
+};
+
+class PipeListener : public ControlListener {
+public:
+    PipeListener(HANDLE pipe, HANDLE stopEvent, HANDLE ioEvent)
+        : pipe_(pipe), stopEvent_(stopEvent), ioEvent_(ioEvent) {}
+    
+    ~PipeListener() override {
+        CloseHandle(pipe_);
+        CloseHandle(stopEvent_);
+        CloseHandle(ioEvent_);
+    }
+    
+    std::unique_ptr<ControlConnection> Accept() override {
+        while (WaitForSingleObject(stopEvent_, 0) != WAIT_OBJECT_0) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = ioEvent_;
+            ResetEvent(ioEvent_);
+            
+            // 客户端可能在ConnectNamedPipe之前已经连接
+            BOOL connected = ConnectNamedPipe(pipe_, &overlapped);
+            DWORD transferred = 0;
+            if ((!connected && ::GetLastError() == ERROR_PIPE_CONNECTED) || CompleteIo(overlapped, connected, transferred)) {
+                return std::make_unique<PipeServerConnection>(*this);
+            }
+            
+            if (WaitForSingleObject(stopEvent_, 0) != WAIT_OBJECT_0) {
+                // 例如客户端连接后立即断开，稍后重试
+                LOG_WARNING(L"Control pipe connection failed, error: " << ::GetLastError());
+                DisconnectNamedPipe(pipe_);
+                WaitForSingleObject(stopEvent_, 100);
+            }
+        }
+        return nullptr;
+    }
+    
+    void Shutdown() override {
+        SetEvent(stopEvent_);
+    }
+    
+    // 等待重叠I/O完成，Shutdown时取消并返回false
+    bool CompleteIo(OVERLAPPED& overlapped, BOOL started, DWORD& transferred) {
+        if (!started && ::GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        
+        HANDLE handles[2] = { overlapped.hEvent, stopEvent_ };
+        DWORD waitResult = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (waitResult != WAIT_OBJECT_0) {
+            CancelIoEx(pipe_, &overlapped);
+            GetOverlappedResult(pipe_, &overlapped, &transferred, TRUE);
+            return false;
+        }
+        
+        return GetOverlappedResult(pipe_, &overlapped, &transferred, FALSE) != FALSE;
+    }
+    
+    HANDLE GetPipe() const { return pipe_; }
+    HANDLE GetIoEvent() const { return ioEvent_; }
+
+private:
+    HANDLE pipe_;
+    HANDLE stopEvent_;
+    HANDLE ioEvent_;
+};
+
+PipeServerConnection::~PipeServerConnection() {
+    DisconnectNamedPipe(listener_.GetPipe());
+}
+
+bool PipeServerConnection::ReadExact(uint8_t* buffer, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = listener_.GetIoEvent();
+        ResetEvent(overlapped.hEvent);
+        
+        DWORD transferred = 0;
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - offset, PIPE_BUFFER_SIZE));
+        BOOL started = ReadFile(listener_.GetPipe(), buffer + offset, chunk, nullptr, &overlapped);
+        if (!listener_.CompleteIo(overlapped, started, transferred) || transferred == 0) {
+            return false;
+        }
+        offset += transferred;
+    }
+    return true;
+}
+
+bool PipeServerConnection::WriteAll(const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = listener_.GetIoEvent();
+        ResetEvent(overlapped.hEvent);
+        
+        DWORD transferred = 0;
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - offset, PIPE_BUFFER_SIZE));
+        BOOL started = WriteFile(listener_.GetPipe(), data + offset, chunk, nullptr, &overlapped);
+        if (!listener_.CompleteIo(overlapped, started, transferred) || transferred == 0) {
+            return false;
+        }
+        offset += transferred;
+    }
+    return true;
+}
+
+// 客户端使用同步I/O
+class PipeClientConnection : public ControlConnection {
+public:
+    explicit PipeClientConnection(HANDLE pipe) : pipe_(pipe) {}
+    
+    ~PipeClientConnection() override {
+        CloseHandle(pipe_);
+    }
+    
+    bool ReadExact(uint8_t* buffer, size_t size) override {
+        size_t offset = 0;
+        while (offset < size) {
+            DWORD transferred = 0;
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - offset, PIPE_BUFFER_SIZE));
+            if (!ReadFile(pipe_, buffer + offset, chunk, &transferred, nullptr) || transferred == 0) {
+                return false;
+            }
+            offset += transferred;
+        }
+        return true;
+    }
+    
+    bool WriteAll(const uint8_t* data, size_t size) override {
+        size_t offset = 0;
+        while (offset < size) {
+            DWORD transferred = 0;
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - offset, PIPE_BUFFER_SIZE));
+            if (!WriteFile(pipe_, data + offset, chunk, &transferred, nullptr) || transferred == 0) {
+                return false;
+            }
+            offset += transferred;
+        }
+        return true;
+    }
+
+private:
+    HANDLE pipe_;
+};
+
+} // namespace
+
+std::wstring ControlTransport::GetEndpointName(uint32_t processId) {
+    return L"\\\\.\\pipe\\dllinject-control-" + std::to_wstring(processId);
+}
+
+ErrorCode ControlTransport::Listen(const std::wstring& endpoint, std::unique_ptr<ControlListener>& listener) {
+    // FILE_FLAG_FIRST_PIPE_INSTANCE：同名管道已存在时失败，防止其他进程抢先创建
+    HANDLE pipe = CreateNamedPipeW(
+        endpoint.c_str(),
+        PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+        1,
+        PIPE_BUFFER_SIZE,
+        PIPE_BUFFER_SIZE,
+        0,
+        nullptr
+    );
+    if (pipe == INVALID_HANDLE_VALUE) {
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    HANDLE stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    HANDLE ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!stopEvent || !ioEvent) {
+        LOG_ERROR(L"Failed to create control server events");
+        if (stopEvent) CloseHandle(stopEvent);
+        if (ioEvent) CloseHandle(ioEvent);
+        CloseHandle(pipe);
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    listener = std::make_unique<PipeListener>(pipe, stopEvent, ioEvent);
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode ControlTransport::Connect(const std::wstring& endpoint, uint32_t timeoutMs, std::unique_ptr<ControlConnection>& connection) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        HANDLE pipe = CreateFileW(endpoint.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            connection = std::make_unique<PipeClientConnection>(pipe);
+            return ErrorCode::SUCCESS;
+        }
+        
+        DWORD error = ::GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND) {
+            LOG_ERROR(L"No control endpoint found: " << endpoint);
+            return ErrorCode::PROCESS_NOT_FOUND;
+        }
+        if (error == ERROR_ACCESS_DENIED) {
+            LOG_ERROR(L"Access denied to control endpoint: " << endpoint);
+            return ErrorCode::PROCESS_ACCESS_DENIED;
+        }
+        
+        // 服务端正在处理其他客户端
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (error != ERROR_PIPE_BUSY || remaining <= 0 || !WaitNamedPipeW(endpoint.c_str(), static_cast<DWORD>(remaining))) {
+            LOG_ERROR(L"Failed to connect to control endpoint: " << endpoint << L", error: " << error);
+            return ErrorCode::THREAD_TIMEOUT;
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include "../include/file_watcher.h"
+#include <algorithm>
+
+FileWatcher::FileWatcher()
+    : watching_(false), minInterval_(HOT_RELOAD_CHECK_INTERVAL), settleDelay_(500) {
+}
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+ErrorCode FileWatcher::Start(const std::wstring& path, ChangeCallback callback, uint32_t minInterval, uint32_t settleDelay) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (watching_) {
+        LOG_INFO(L"File watcher already started: " << path_);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    if (!callback || !FileExists(path)) {
+        LOG_ERROR(L"File not found for monitoring: " << path);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    monitor_ = std::make_unique<Platform::DirectoryMonitor>();
+    if (!monitor_->Create()) {
+        LOG_ERROR(L"Failed to create file watcher stop signal, error: " << Platform::GetLastSystemError());
+        monitor_.reset();
+        return ErrorCode::FILE_MONITOR_FAILED;
+    }
+    
+    try {
+        size_t separator = path.find_last_of(L"\\/");
+        path_ = path;
+        directory_ = separator == std::wstring::npos ? L"." : path.substr(0, separator + 1);
+        callback_ = std::move(callback);
+        minInterval_ = minInterval;
+        settleDelay_ = settleDelay;
+        lastState_ = QueryFileState(path);
+        
+        watching_ = true;
+        thread_ = std::thread(&FileWatcher::ThreadFunc, this);
+        
+        LOG_DEBUG(L"File watcher started for: " << path);
+        return ErrorCode::SUCCESS;
+    
+    } catch (const std::exception& e) {
+        watching_ = false;
+        monitor_.reset();
+        LOG_ERROR(L"Failed to start file watcher thread: " << StringToWString(e.what()));
+        return ErrorCode::FILE_MONITOR_FAILED;
+    }
+}
+
+void FileWatcher::Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!thread_.joinable()) {
+        watching_ = false;
+        return;
+    }
+    
+    watching_ = false;
+    monitor_->Stop();
+    
+    // 在回调中调用Stop会等待自身，只能放弃该线程（它在回调返回后看到停止信号退出）
+    if (thread_.get_id() == std::this_thread::get_id()) {
+        LOG_ERROR(L"File watcher stopped from its own callback: " << path_);
+        thread_.detach();
+        return;
+    }
+    
+    // 停止信号会唤醒所有等待，只需等待正在执行的回调结束
+    thread_.join();
+    monitor_.reset();
+    
+    LOG_DEBUG(L"File watcher stopped: " << path_);
+}
+
+FileWatcher::FileState FileWatcher::QueryFileState(const std::wstring& path) {
+    // 只读取属性，不妨碍其他进程写入、替换或删除文件
+    FileState state;
+    state.exists = Platform::QueryFileIdentity(path, state.identity);
+    return state;
+}
+
+void FileWatcher::ThreadFunc() {
+    LOG_DEBUG(L"File watcher thread started: " << path_);
+    
+    // 监控所在目录而不是文件本身，重命名覆盖只改变目录项
+    if (!monitor_->Watch(directory_)) {
+        LOG_WARNING(L"Directory change notification unavailable, polling only: " << directory_);
+    }
+    
+    // 没有变化时逐步延长等待，目录通知仍会立即唤醒
+    uint32_t currentInterval = minInterval_;
+    int consecutiveNoChanges = 0;
+    const uint32_t maxInterval = std::max<uint32_t>(5000, minInterval_); // 最大5秒间隔
+    
+    while (true) {
+        bool watching = monitor_->IsWatching();
+        Platform::DirectoryMonitor::WaitResult waitResult = monitor_->Wait(currentInterval);
+        if (waitResult == Platform::DirectoryMonitor::WaitResult::STOPPED) {
+            break;
+        }
+        
+        if (watching && !monitor_->IsWatching()) {
+            LOG_WARNING(L"Directory change notification failed, polling only: " << directory_);
+        }
+        
+        try {
+            // 通知可能来自目录中的其他文件，只有被监控文件的状态变化才触发回调；
+            // 文件暂时不存在（删除后再重命名）时等待它重新出现
+            FileState state = QueryFileState(path_);
+            if (!state.exists || state == lastState_) {
+                consecutiveNoChanges++;
+                if (consecutiveNoChanges > 10 && currentInterval < maxInterval) {
+                    currentInterval = std::min(currentInterval * 2, maxInterval);
+                    LOG_DEBUG(L"Increased monitoring interval to " << currentInterval << L"ms");
+                }
+                if (idle_) {
+                    idle_();
+                }
+                continue;
+            }
+            
+            LOG_INFO(L"File modification detected: " << path_);
+            
+            // 等待一小段时间确保文件写入完成，期间Stop立即生效
+            if (monitor_->WaitForStop(settleDelay_)) {
+                break;
+            }
+            lastState_ = QueryFileState(path_);
+            
+            callback_();
+            
+            // 重置检查间隔
+            currentInterval = minInterval_;
+            consecutiveNoChanges = 0;
+        
+        } catch (const std::exception& e) {
+            LOG_ERROR(L"Exception in file watcher thread: " << StringToWString(e.what()));
+        }
+    }
+    
+    if (threadExit_) {
+        threadExit_();
+    }
+    
+    LOG_DEBUG(L"File watcher thread ended: " << path_);
+}
@@ -1,9 +1,9 @@
 #include "../include/hot_reload.h"
-#include <future>
+#include "../include/metrics_registry.h"
 #include <chrono>
 
 HotReloadManager::HotReloadManager(JarLoader* jarLoader) 
-    : jarLoader_(jarLoader), monitoring_(false), lastError_(ErrorCode::SUCCESS) {
+    : jarLoader_(jarLoader), lastError_(ErrorCode::SUCCESS), warmUpEnabled_(false), canaryEnabled_(false) {
     if (!jarLoader_) {
         LOG_ERROR(L"JarLoader pointer is null in HotReloadManager constructor");
         lastError_ = ErrorCode::INVALID_PARAMETER;
@@ -15,13 +15,18 @@ HotReloadManager::HotReloadManager(JarLoader* jarLoader)
 HotReloadManager::~HotReloadManager() {
     LOG_DEBUG(L"HotReloadManager destroying...");
     StopMonitoring();
+    
+    // 灰度的回调指向本对象，析构前按已有数据结束
+    if (jarLoader_ && jarLoader_->IsCanaryActive()) {
+        jarLoader_->EvaluateCanary(true);
+    }
     LOG_DEBUG(L"HotReloadManager destroyed");
 }
 
 ErrorCode HotReloadManager::StartMonitoring(const std::wstring& jarPath, const std::string& className, const std::string& methodName) {
     std::lock_guard<std::mutex> lock(monitorMutex_);
     
-    if (monitoring_) {
+    if (jarWatcher_.IsWatching()) {
         LOG_INFO(L"Hot reload monitoring already started");
         SetLastError(ErrorCode::SUCCESS);
         return ErrorCode::SUCCESS;
@@ -63,79 +68,40 @@ ErrorCode HotReloadManager::StartMonitoring(const std::wstring& jarPath, const s
     
     if (!FileExists(jarPath)) {
         LOG_ERROR(L"JAR file not found for monitoring: " << jarPath);
-        SetLastError(ErrorCode::FILE_NOT_FOUND);
-        return ErrorCode::FILE_NOT_FOUND;
+        SetLastError(ErrorCode::JAR_NOT_FOUND);
+        return ErrorCode::JAR_NOT_FOUND;
     }
     
-    try {
-        // 保存监控参数
-        watchedJarPath_ = jarPath;
-        watchedClassName_ = className;
-        watchedMethodName_ = methodName;
-        lastModifyTime_ = GetFileModifyTime(jarPath);
-        
-        // 启动监控
-        monitoring_ = true;
-        
-        monitorThread_ = std::thread(&HotReloadManager::MonitorThreadFunc, this);
-        
-        // 等待线程启动
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        
-        if (!monitoring_) {
-            LOG_ERROR(L"Monitor thread failed to start properly");
-            SetLastError(ErrorCode::THREAD_CREATION_FAILED);
-            return ErrorCode::THREAD_CREATION_FAILED;
-        }
-        
-        LOG_INFO(L"Hot reload monitoring started for: " << jarPath);
-        SetLastError(ErrorCode::SUCCESS);
-        return ErrorCode::SUCCESS;
-        
-    } catch (const std::exception& e) {
-        monitoring_ = false;
-        LOG_ERROR(L"Failed to start monitoring thread: " << StringToWString(e.what()));
+    // 保存监控参数
+    watchedJarPath_ = jarPath;
+    watchedClassName_ = className;
+    watchedMethodName_ = methodName;
+    
+    // 重载在监控线程中调用JNI，线程退出前从JVM分离
+    jarWatcher_.SetThreadExitCallback([this]() { jarLoader_->DetachCurrentThread(); });
+    jarWatcher_.SetIdleCallback([this]() { OnWatcherIdle(); });
+    ErrorCode result = jarWatcher_.Start(jarPath, [this]() { OnJarModified(); });
+    if (result != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Failed to start JAR file monitoring: " << jarPath);
         SetLastError(ErrorCode::THREAD_CREATION_FAILED);
         return ErrorCode::THREAD_CREATION_FAILED;
-    } catch (...) {
-        monitoring_ = false;
-        LOG_ERROR(L"Unknown exception while starting monitoring thread");
-        SetLastError(ErrorCode::UNKNOWN_ERROR);
-        return ErrorCode::UNKNOWN_ERROR;
     }
+    
+    LOG_INFO(L"Hot reload monitoring started for: " << jarPath);
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
 }
 
 void HotReloadManager::StopMonitoring() {
     std::lock_guard<std::mutex> lock(monitorMutex_);
     
-    if (!monitoring_) {
+    if (!jarWatcher_.IsWatching()) {
         LOG_DEBUG(L"Hot reload monitoring already stopped");
         return;
     }
     
     LOG_INFO(L"Stopping hot reload monitoring...");
-    monitoring_ = false;
-    
-    if (monitorThread_.joinable()) {
-        try {
-            // 等待线程结束，最多等待5秒
-            auto future = std::async(std::launch::async, [this]() {
-                monitorThread_.join();
-            });
-            
-            if (future.wait_for(std::chrono::seconds(5)) == std::future_status::timeout) {
-                LOG_WARNING(L"Monitor thread did not stop within timeout, detaching...");
-                monitorThread_.detach();
-            } else {
-                LOG_DEBUG(L"Monitor thread joined successfully");
-            }
-        } catch (const std::exception& e) {
-            LOG_ERROR(L"Exception while stopping monitor thread: " << StringToWString(e.what()));
-            if (monitorThread_.joinable()) {
-                monitorThread_.detach();
-            }
-        }
-    }
+    jarWatcher_.Stop();
     
     // 清理监控状态
     watchedJarPath_.clear();
@@ -145,180 +111,519 @@ void HotReloadManager::StopMonitoring() {
     LOG_INFO(L"Hot reload monitoring stopped");
 }
 
-void HotReloadManager::MonitorThreadFunc() {
-    LOG_INFO(L"Hot reload monitor thread started");
-    
-    // 性能优化：缓存文件句柄以减少系统调用
-    HANDLE fileHandle = CreateFileW(
-        watchedJarPath_.c_str(),
-        GENERIC_READ,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        nullptr,
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
-        nullptr
-    );
-    
-    // 如果无法获取文件句柄，回退到原始方法
-    bool useFileHandle = (fileHandle != INVALID_HANDLE_VALUE);
-    if (!useFileHandle) {
-        LOG_WARNING(L"Could not open file handle for monitoring, using fallback method");
-    }
-    
-    // 性能优化：动态调整检查间隔
-    int currentInterval = HOT_RELOAD_CHECK_INTERVAL;
-    int consecutiveNoChanges = 0;
-    const int maxInterval = 5000; // 最大5秒间隔
-    const int minInterval = HOT_RELOAD_CHECK_INTERVAL;
-    
-    while (monitoring_) {
-        try {
-            bool fileModified = false;
-            
-            if (useFileHandle) {
-                // 使用文件句柄检查修改时间（更高效）
-                BY_HANDLE_FILE_INFORMATION fileInfo;
-                if (GetFileInformationByHandle(fileHandle, &fileInfo)) {
-                    fileModified = CompareFileTime(&fileInfo.ftLastWriteTime, &lastModifyTime_) > 0;
-                    if (fileModified) {
-                        lastModifyTime_ = fileInfo.ftLastWriteTime;
-                    }
-                } else {
-                    // 文件句柄失效，回退到原始方法
-                    useFileHandle = false;
-                    CloseHandle(fileHandle);
-                    fileHandle = INVALID_HANDLE_VALUE;
-                }
-            }
-            
-            if (!useFileHandle) {
-                // 回退方法
-                fileModified = IsFileModified();
-            }
-            
-            if (fileModified) {
-                LOG_INFO(L"JAR file modification detected: " << watchedJarPath_);
-                
-                // 等待一小段时间确保文件写入完成
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                
-                // 重新加载JAR
-                if (ReloadJar()) {
-                    LOG_INFO(L"JAR hot reload successful");
-                } else {
-                    LOG_ERROR(L"JAR hot reload failed");
-                }
-                
-                // 重置检查间隔
-                currentInterval = minInterval;
-                consecutiveNoChanges = 0;
-                
-                // 如果使用回退方法，更新最后修改时间
-                if (!useFileHandle) {
-                    lastModifyTime_ = GetFileModifyTime(watchedJarPath_);
-                }
-            } else {
-                // 动态调整检查间隔：如果长时间没有变化，增加检查间隔
-                consecutiveNoChanges++;
-                if (consecutiveNoChanges > 10 && currentInterval < maxInterval) {
-                    currentInterval = std::min(currentInterval * 2, maxInterval);
-                    LOG_DEBUG(L"Increased monitoring interval to " << currentInterval << L"ms");
-                }
-            }
-            
-            // 等待检查间隔
-            std::this_thread::sleep_for(std::chrono::milliseconds(currentInterval));
-            
-        } catch (const std::exception& e) {
-            LOG_ERROR(L"Exception in monitor thread: " << StringToWString(e.what()));
-            std::this_thread::sleep_for(std::chrono::milliseconds(currentInterval));
-        }
+void HotReloadManager::OnJarModified() {
+    ReloadNow();
+}
+
+void HotReloadManager::OnWatcherIdle() {
+    // 灰度结论通常在调用路径上得出；插件不再被调用时窗口仍需按时结束
+    if (jarLoader_->IsCanaryActive()) {
+        jarLoader_->EvaluateCanary();
+    }
+}
+
+ErrorCode HotReloadManager::ReloadNow() {
+    if (!IsMonitoring()) {
+        LOG_ERROR(L"Hot reload monitoring is not running");
+        return ErrorCode::INVALID_PARAMETER;
     }
     
-    // 清理文件句柄
-    if (fileHandle != INVALID_HANDLE_VALUE) {
-        CloseHandle(fileHandle);
+    SecurityUtils::InvalidateJarPathCache(watchedJarPath_);
+    
+    // 重新加载JAR，耗时与结果记入指标；前后各采样一次JVM内存与GC
+    JvmMemorySample before;
+    bool sampled = jarLoader_->SampleJvmTelemetry(before);
+    auto start = std::chrono::steady_clock::now();
+    Activation activation = ReloadJar();
+    int64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    
+    JvmMemorySample after;
+    if (sampled && jarLoader_->SampleJvmTelemetry(after)) {
+        RecordJvmDelta(before, after);
+    }
+    
+    // 进入灰度的重载在OnCanaryFinished中按结论计数
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    if (activation != Activation::CANARY) {
+        metrics.Increment(activation == Activation::ACTIVE ? "reload.count" : "reload.failures");
+    }
+    metrics.Set("reload.last_duration_us", durationUs);
+    metrics.Set("jar.generation", static_cast<int64_t>(jarLoader_->GetGeneration()));
+    
+    // 旧代是否真正被回收：retired持续增长说明有引用泄漏，元空间会随重载增长
+    GenerationStats generations = jarLoader_->GetGenerationStats();
+    metrics.Set("generation.retired", static_cast<int64_t>(generations.retired));
+    metrics.Set("generation.collected", static_cast<int64_t>(generations.collected));
+    metrics.Set("generation.leaked", static_cast<int64_t>(generations.leaked));
+    
+    if (activation == Activation::FAILED) {
+        LOG_ERROR(L"JAR hot reload failed");
+        return ErrorCode::JAR_LOAD_FAILED;
     }
     
-    LOG_INFO(L"Hot reload monitor thread ended");
+    LOG_INFO((activation == Activation::CANARY ? L"JAR hot reload entered canary (" : L"JAR hot reload successful (")
+             << durationUs << L" us)");
+    return ErrorCode::SUCCESS;
 }
 
-bool HotReloadManager::IsFileModified() {
-    if (!FileExists(watchedJarPath_)) {
-        LOG_ERROR(L"Watched JAR file no longer exists: " << watchedJarPath_);
-        return false;
-    }
+void HotReloadManager::RecordJvmDelta(const JvmMemorySample& before, const JvmMemorySample& after) {
+    int64_t heapDelta = after.heapUsed - before.heapUsed;
+    int64_t metaspaceDelta = after.metaspaceUsed >= 0 && before.metaspaceUsed >= 0 ?
+        after.metaspaceUsed - before.metaspaceUsed : 0;
+    int64_t classDelta = after.loadedClasses - before.loadedClasses;
+    int64_t gcCountDelta = after.gcCount - before.gcCount;
+    int64_t gcTimeDelta = after.gcTimeMs - before.gcTimeMs;
     
-    FILETIME currentModifyTime = GetFileModifyTime(watchedJarPath_);
+    // 差值描述最近一次重载，jvm.*为重载后的绝对值
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    metrics.Set("reload.heap_used_delta_bytes", heapDelta);
+    metrics.Set("reload.metaspace_used_delta_bytes", metaspaceDelta);
+    metrics.Set("reload.loaded_classes_delta", classDelta);
+    metrics.Set("reload.gc_count_delta", gcCountDelta);
+    metrics.Set("reload.gc_time_delta_ms", gcTimeDelta);
+    metrics.Increment("reload.gc_time_total_ms", gcTimeDelta);
+    metrics.Set("jvm.heap_used_bytes", after.heapUsed);
+    metrics.Set("jvm.heap_committed_bytes", after.heapCommitted);
+    metrics.Set("jvm.metaspace_used_bytes", after.metaspaceUsed);
+    metrics.Set("jvm.loaded_classes", after.loadedClasses);
+    metrics.Set("jvm.unloaded_classes", after.unloadedClasses);
+    metrics.Set("jvm.gc_count", after.gcCount);
+    metrics.Set("jvm.gc_time_ms", after.gcTimeMs);
     
-    // 比较文件时间
-    return CompareFileTime(&currentModifyTime, &lastModifyTime_) > 0;
+    LOG_INFO(L"Reload JVM delta: heap " << heapDelta / 1024 << L" KB, metaspace " << metaspaceDelta / 1024
+             << L" KB, classes " << classDelta << L", GC " << gcCountDelta << L" collections / "
+             << gcTimeDelta << L" ms");
 }
 
-bool HotReloadManager::ReloadJar() {
+HotReloadManager::Activation HotReloadManager::ReloadJar() {
     if (!jarLoader_) {
         LOG_ERROR(L"JarLoader is null during reload");
-        return false;
+        return Activation::FAILED;
     }
     
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    
     try {
         LOG_INFO(L"Reloading JAR: " << watchedJarPath_);
         
-        // 卸载当前JAR
-        ErrorCode unloadResult = jarLoader_->UnloadJar();
-        if (unloadResult != ErrorCode::SUCCESS) {
-            LOG_ERROR(L"Failed to unload current JAR");
-            return false;
+        // 未启用缓存时没有可恢复的版本记录，直接切换
+        if (!versionCache_.IsOpen()) {
+            std::unique_ptr<JarArchive> snapshot = SnapshotAndVerify(watchedJarPath_);
+            return snapshot ? ActivateJar(watchedJarPath_, 0, false, std::move(snapshot)) : Activation::FAILED;
         }
         
-        // 等待一小段时间
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // 先生成完整的版本副本，失败时保留当前代，等待下一次修改
+        JarVersionInfo info;
+        ErrorCode snapshotResult = versionCache_.AddVersion(watchedJarPath_, info);
+        if (snapshotResult != ErrorCode::SUCCESS) {
+            LOG_WARNING(L"JAR version not accepted, keeping current version");
+            return Activation::FAILED;
+        }
         
-        // 重新加载JAR
-        ErrorCode loadResult = jarLoader_->LoadJar(watchedJarPath_);
-        if (loadResult != ErrorCode::SUCCESS) {
-            LOG_ERROR(L"Failed to reload JAR");
-            return false;
+        uint64_t previousVersion = versionCache_.GetCurrentVersion();
+        if (info.version == previousVersion) {
+            LOG_DEBUG(L"JAR content unchanged, version " << info.version << L" is already loaded");
+            return Activation::ACTIVE;
         }
         
-        // 调用指定的方法
-        if (!watchedClassName_.empty() && !watchedMethodName_.empty()) {
-            ErrorCode result = jarLoader_->CallJavaMethod(watchedClassName_, watchedMethodName_);
-            if (result != ErrorCode::SUCCESS) {
-                LOG_ERROR(L"Failed to call method after reload: " << StringToWString(watchedClassName_ + "." + watchedMethodName_));
-                return false;
-            }
+        if (!VerifyJar(info.path)) {
+            LOG_WARNING(L"JAR version " << info.version << L" failed verification, keeping current version");
+            return Activation::FAILED;
         }
         
-        LOG_INFO(L"JAR reload completed successfully");
-        return true;
+        uint64_t previousGeneration = jarLoader_->GetGeneration();
+        Activation activation = ActivateJar(info.path, info.version, true);
+        if (activation == Activation::ACTIVE) {
+            LOG_INFO(L"JAR version " << info.version << L" is now active");
+            return activation;
+        }
+        if (activation == Activation::CANARY) {
+            LOG_INFO(L"JAR version " << info.version << L" entered canary, version " << previousVersion
+                     << L" serves the remaining calls");
+            return activation;
+        }
+        
+        // 新版本不可用时ActivateJar已切回仍处于预热状态的上一代，无需重新加载；回滚本身失败时新版本仍在服务
+        if (jarLoader_->GetGeneration() != previousGeneration) {
+            LOG_ERROR(L"JAR version " << info.version << L" rejected but could not be rolled back, it remains active");
+            return Activation::FAILED;
+        }
+        LOG_WARNING(L"JAR version " << info.version << L" rejected, version " << previousVersion << L" remains active");
+        return Activation::FAILED;
         
     } catch (const std::exception& e) {
         LOG_ERROR(L"Exception during JAR reload: " << StringToWString(e.what()));
+        return Activation::FAILED;
+    }
+}
+
+HotReloadManager::Activation HotReloadManager::ActivateJar(const std::wstring& loadPath, uint64_t version, bool canary,
+                                                            std::unique_ptr<JarArchive> snapshot) {
+    canary = canary && canaryEnabled_;
+    
+    // 进行中的灰度被新版本取代，结论（或被取代）在新一代切换之前报告
+    if (jarLoader_->IsCanaryActive()) {
+        jarLoader_->SupersedeCanary();
+    }
+    
+    // 先为新版本创建类加载器，准备与预热期间当前一代继续服务
+    ErrorCode prepareResult = snapshot ? jarLoader_->PrepareJar(loadPath, std::move(snapshot)) : jarLoader_->PrepareJar(loadPath);
+    if (prepareResult != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Failed to prepare JAR: " << loadPath);
+        return Activation::FAILED;
+    }
+    
+    if (warmUpEnabled_) {
+        // 入口方法切换后单独调用，即使在白名单中也不重放
+        WarmUpOptions options = warmUpOptions_;
+        if (options.replayFilter) {
+            std::function<bool(const std::string&, const std::string&)> filter = warmUpOptions_.replayFilter;
+            options.replayFilter = [this, filter](const std::string& className, const std::string& methodName) {
+                if (className == watchedClassName_ && methodName == watchedMethodName_) {
+                    return false;
+                }
+                return filter(className, methodName);
+            };
+        }
+        
+        WarmUpResult warmUp;
+        if (jarLoader_->WarmUpPreparedJar(options, warmUp) == ErrorCode::SUCCESS) {
+            MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+            metrics.Set("reload.warmup_duration_us", static_cast<int64_t>(warmUp.durationMs * 1000));
+            metrics.Set("reload.warmup_classes", static_cast<int64_t>(warmUp.classesLoaded));
+            metrics.Set("reload.warmup_class_failures", static_cast<int64_t>(warmUp.classesFailed));
+            metrics.Set("reload.warmup_replays", static_cast<int64_t>(warmUp.invocationsReplayed));
+            metrics.Set("reload.warmup_replay_failures", static_cast<int64_t>(warmUp.invocationsFailed));
+        } else {
+            LOG_WARNING(L"JAR warm-up failed, switching without warm-up");
+        }
+    }
+    
+    // 旧的一代交出状态（onUnload），失败时新的一代冷启动；灰度期间两代同时运行，不交接
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    bool handoff = !watchedClassName_.empty() && !canary;
+    StateHandoffResult unloaded;
+    if (handoff && jarLoader_->CaptureHandoffState(watchedClassName_, unloaded) == ErrorCode::SUCCESS && unloaded.supported) {
+        metrics.Set("reload.state_unload_us", static_cast<int64_t>(unloaded.durationMs * 1000));
+        metrics.Set("reload.state_bytes", unloaded.hasState ? unloaded.bytes : 0);
+    }
+    
+    // 切换到新一代，旧的一代保持为备用直到入口方法成功
+    ErrorCode loadResult = jarLoader_->CommitPreparedJar(true);
+    if (loadResult != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Failed to reload JAR: " << loadPath);
+        // 仍是旧的一代在服务，把状态还给它
+        StateHandoffResult restored;
+        if (handoff && jarLoader_->HasHandoffState()) {
+            jarLoader_->DeliverHandoffState(watchedClassName_, restored);
+        }
+        return Activation::FAILED;
+    }
+    
+    // 新的一代接收状态（onLoad）后再调用入口方法；拒绝状态视为新版本不可用，状态保留给回滚后的一代
+    if (handoff) {
+        StateHandoffResult loaded;
+        if (jarLoader_->DeliverHandoffState(watchedClassName_, loaded) != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"onLoad failed after reload: " << StringToWString(watchedClassName_));
+            metrics.Increment("reload.state_handoff_failures");
+            RollbackActivation(version, handoff);
+            return Activation::FAILED;
+        }
+        if (loaded.supported) {
+            metrics.Set("reload.state_load_us", static_cast<int64_t>(loaded.durationMs * 1000));
+            if (loaded.hasState) {
+                metrics.Increment("reload.state_handoffs");
+            }
+        }
+    }
+    
+    // 调用指定的方法
+    if (!watchedClassName_.empty() && !watchedMethodName_.empty()) {
+        ErrorCode result = jarLoader_->CallJavaMethod(watchedClassName_, watchedMethodName_);
+        if (result != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Failed to call method after reload: " << StringToWString(watchedClassName_ + "." + watchedMethodName_));
+            RollbackActivation(version, handoff);
+            return Activation::FAILED;
+        }
+    }
+    
+    // 先更新当前版本：灰度结论可能随后在另一个调用线程上得出并恢复旧版本
+    uint64_t baselineVersion = versionCache_.GetCurrentVersion();
+    if (version != 0) {
+        versionCache_.SetCurrentVersion(version);
+    }
+    
+    // 灰度模式：由两代分担调用，结论由JarLoader在调用路径或监控线程上得出
+    if (canary) {
+        CanaryOptions options = canaryOptions_;
+        options.onFinished = [this, version, baselineVersion](const CanaryReport& report) {
+            OnCanaryFinished(report, version, baselineVersion);
+        };
+        if (jarLoader_->StartCanary(options) == ErrorCode::SUCCESS) {
+            MetricsRegistry::GetInstance().Increment("canary.started");
+            return Activation::CANARY;
+        }
+        LOG_WARNING(L"Canary unavailable, promoting immediately");
+    }
+    
+    // 健康检查通过，备用的旧一代退役
+    jarLoader_->ConfirmCommittedJar();
+    RecordLastKnownGood(version, jarLoader_->GetGenerationInfo());
+    
+    LOG_INFO(L"JAR reload completed successfully");
+    return Activation::ACTIVE;
+}
+
+bool HotReloadManager::RollbackActivation(uint64_t version, bool handoff) {
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    auto start = std::chrono::steady_clock::now();
+    
+    // 失败的一代先交出状态（onLoad失败时状态仍未交付，保留原状态）；
+    // 切换时未交接（灰度）则旧的一代从未交出状态，不能用失败的一代的状态覆盖它
+    StateHandoffResult unloaded;
+    if (handoff) {
+        jarLoader_->CaptureHandoffState(watchedClassName_, unloaded);
+    }
+    
+    if (jarLoader_->RollbackCommittedJar() != ErrorCode::SUCCESS) {
+        // 未通过检查的一代仍在服务，版本记录与实际加载的内容保持一致
+        LOG_ERROR(L"Rollback failed, generation " << jarLoader_->GetGeneration() << L" remains active");
+        metrics.Increment("reload.rollback_failures");
+        if (version != 0) {
+            versionCache_.SetCurrentVersion(version);
+        }
         return false;
     }
+    
+    StateHandoffResult restored;
+    if (handoff && jarLoader_->HasHandoffState()) {
+        jarLoader_->DeliverHandoffState(watchedClassName_, restored);
+    }
+    
+    metrics.Increment("reload.rollbacks");
+    metrics.Set("reload.rollback_us", std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    LOG_WARNING(L"Rolled back to generation " << jarLoader_->GetGeneration() << L" ("
+                << StringToWString(jarLoader_->GetJarFingerprint()) << L")");
+    return true;
+}
+
+void HotReloadManager::OnCanaryFinished(const CanaryReport& report, uint64_t version, uint64_t baselineVersion) {
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    metrics.Set("canary.baseline_calls", static_cast<int64_t>(report.baseline.calls));
+    metrics.Set("canary.baseline_errors", static_cast<int64_t>(report.baseline.errors));
+    metrics.Set("canary.baseline_p50_us", static_cast<int64_t>(report.baseline.p50Us));
+    metrics.Set("canary.baseline_p99_us", static_cast<int64_t>(report.baseline.p99Us));
+    metrics.Set("canary.canary_calls", static_cast<int64_t>(report.canary.calls));
+    metrics.Set("canary.canary_errors", static_cast<int64_t>(report.canary.errors));
+    metrics.Set("canary.canary_p50_us", static_cast<int64_t>(report.canary.p50Us));
+    metrics.Set("canary.canary_p99_us", static_cast<int64_t>(report.canary.p99Us));
+    
+    // 结论在释放JarLoader的锁后报告，期间可能已有更新的一代切换进来，只在该代仍是当前一代时记录
+    GenerationInfo current = jarLoader_->GetGenerationInfo();
+    if (report.verdict == CanaryVerdict::PROMOTE) {
+        metrics.Increment("canary.promotions");
+        metrics.Increment("reload.count");
+        LOG_INFO(L"JAR version " << version << L" is now active: canary promoted (" << StringToWString(report.reason) << L")");
+        if (current.generation == report.canary.generation) {
+            RecordLastKnownGood(version, current);
+        }
+        return;
+    }
+    
+    // 回滚或被取代后旧的一代继续服务，版本缓存的当前版本随之恢复
+    if (baselineVersion != 0 && current.generation == report.baseline.generation) {
+        versionCache_.SetCurrentVersion(baselineVersion);
+    }
+    
+    // 被取代的版本未被判定为不可用，不计为回滚或重载失败
+    if (report.verdict == CanaryVerdict::SUPERSEDED) {
+        metrics.Increment("canary.superseded");
+        LOG_INFO(L"Canary of JAR version " << version << L" ended without a verdict: " << StringToWString(report.reason));
+        return;
+    }
+    
+    metrics.Increment("canary.rollbacks");
+    metrics.Increment("reload.failures");
+    LOG_WARNING(L"Canary rejected JAR version " << version << L", version " << baselineVersion << L" remains active: "
+                << StringToWString(report.reason));
 }
 
-// 前向声明
-int CompareFileTime(const FILETIME* ft1, const FILETIME* ft2);
+void HotReloadManager::RecordLastKnownGood(uint64_t version, const GenerationInfo& generation) {
+    std::lock_guard<std::mutex> lock(lastKnownGoodMutex_);
+    lastKnownGood_.jarPath = generation.jarPath;
+    lastKnownGood_.version = version;
+    lastKnownGood_.generation = generation.generation;
+    lastKnownGood_.fingerprint = generation.fingerprint;
+    
+    MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+    metrics.Set("jar.last_known_good_version", static_cast<int64_t>(version));
+    metrics.Set("jar.last_known_good_generation", static_cast<int64_t>(lastKnownGood_.generation));
+    LOG_INFO(L"Last-known-good JAR: " << lastKnownGood_.jarPath << L" ("
+             << StringToWString(lastKnownGood_.fingerprint) << L")");
+}
 
-// 辅助函数：比较两个FILETIME结构
-int CompareFileTime(const FILETIME* ft1, const FILETIME* ft2) {
-    ULARGE_INTEGER ul1, ul2;
-    ul1.LowPart = ft1->dwLowDateTime;
-    ul1.HighPart = ft1->dwHighDateTime;
-    ul2.LowPart = ft2->dwLowDateTime;
-    ul2.HighPart = ft2->dwHighDateTime;
-    
-    if (ul1.QuadPart < ul2.QuadPart) return -1;
-    if (ul1.QuadPart > ul2.QuadPart) return 1;
-    return 0;
+LastKnownGood HotReloadManager::GetLastKnownGood() {
+    std::lock_guard<std::mutex> lock(lastKnownGoodMutex_);
+    return lastKnownGood_;
 }
 
-void HotReloadManager::SetLastError(ErrorCode error) {
-    lastError_ = error;
+void HotReloadManager::EnableWarmUp(const WarmUpOptions& options) {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    warmUpOptions_ = options;
+    warmUpEnabled_ = true;
 }
 
-ErrorCode HotReloadManager::GetLastError() const {
-    return lastError_;
-}
\ No newline at end of file
+void HotReloadManager::EnableCanary(const CanaryOptions& options) {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    canaryOptions_ = options;
+    canaryEnabled_ = true;
+}
+
+ErrorCode HotReloadManager::EnableVersionCache(const std::wstring& directory, const std::wstring& sourcePath,
+                                               size_t maxVersions, uint64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    
+    ErrorCode result = versionCache_.Open(directory, sourcePath, maxVersions, maxBytes);
+    if (result != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Failed to open JAR version cache: " << directory);
+        SetLastError(result);
+    }
+    return result;
+}
+
+ErrorCode HotReloadManager::EnableIntegrityCheck(const std::wstring& cachePath, const std::wstring& trustedListPath) {
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    
+    auto verifier = std::make_unique<JarVerifier>();
+    if (verifier->OpenCache(cachePath) != ErrorCode::SUCCESS) {
+        LOG_WARNING(L"JAR verification cache unavailable: " << cachePath);
+    }
+    
+    if (!trustedListPath.empty()) {
+        ErrorCode result = verifier->LoadTrustedDigests(trustedListPath);
+        if (result != ErrorCode::SUCCESS) {
+            SetLastError(result);
+            return result;
+        }
+    }
+    
+    jarVerifier_ = std::move(verifier);
+    trustedListPath_ = trustedListPath;
+    LOG_INFO(L"JAR integrity check enabled");
+    return ErrorCode::SUCCESS;
+}
+
+bool HotReloadManager::VerifyJar(const std::wstring& jarPath) {
+    if (!jarVerifier_) {
+        return true;
+    }
+    
+    if (!trustedListPath_.empty() && jarVerifier_->LoadTrustedDigests(trustedListPath_) != ErrorCode::SUCCESS) {
+        LOG_WARNING(L"Trusted digest list unavailable, keeping previous list: " << trustedListPath_);
+    }
+    
+    JarVerificationResult result;
+    ErrorCode verifyResult = jarVerifier_->Verify(jarPath, result);
+    if (verifyResult != ErrorCode::SUCCESS) {
+        SetLastError(verifyResult);
+        return false;
+    }
+    return true;
+}
+
+bool HotReloadManager::VerifyJar(const JarArchive& snapshot) {
+    if (!jarVerifier_) {
+        return true;
+    }
+    
+    if (!trustedListPath_.empty() && jarVerifier_->LoadTrustedDigests(trustedListPath_) != ErrorCode::SUCCESS) {
+        LOG_WARNING(L"Trusted digest list unavailable, keeping previous list: " << trustedListPath_);
+    }
+    
+    JarVerificationResult result;
+    ErrorCode verifyResult = jarVerifier_->Verify(snapshot, result);
+    if (verifyResult != ErrorCode::SUCCESS) {
+        SetLastError(verifyResult);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<JarArchive> HotReloadManager::SnapshotAndVerify(const std::wstring& sourcePath) {
+    auto snapshot = std::make_unique<JarArchive>();
+    ErrorCode result = snapshot->OpenSnapshot(sourcePath);
+    if (result != ErrorCode::SUCCESS) {
+        LOG_WARNING(L"Failed to read JAR snapshot: " << sourcePath << L" (" << snapshot->GetLastErrorMessage() << L")");
+        SetLastError(result);
+        return nullptr;
+    }
+    
+    if (!VerifyJar(*snapshot)) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+ErrorCode HotReloadManager::LoadCurrentVersion(const std::wstring& sourcePath) {
+    if (!jarLoader_) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    
+    if (!versionCache_.IsOpen()) {
+        std::unique_ptr<JarArchive> snapshot = SnapshotAndVerify(sourcePath);
+        if (!snapshot) {
+            return ErrorCode::SECURITY_CHECK_FAILED;
+        }
+        ErrorCode result = jarLoader_->PrepareJar(sourcePath, std::move(snapshot));
+        if (result == ErrorCode::SUCCESS) {
+            result = jarLoader_->CommitPreparedJar();
+        }
+        if (result == ErrorCode::SUCCESS) {
+            RecordLastKnownGood(0, jarLoader_->GetGenerationInfo());
+        }
+        return result;
+    }
+    
+    JarVersionInfo info;
+    ErrorCode result = versionCache_.AddVersion(sourcePath, info);
+    if (result != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Failed to create initial JAR version: " << sourcePath);
+        return result;
+    }
+    
+    if (!VerifyJar(info.path)) {
+        return ErrorCode::SECURITY_CHECK_FAILED;
+    }
+    
+    result = jarLoader_->LoadJar(info.path);
+    if (result == ErrorCode::SUCCESS) {
+        versionCache_.SetCurrentVersion(info.version);
+        RecordLastKnownGood(info.version, jarLoader_->GetGenerationInfo());
+    }
+    return result;
+}
+
+ErrorCode HotReloadManager::RollbackToVersion(uint64_t version) {
+    if (!jarLoader_) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::lock_guard<std::mutex> lock(reloadMutex_);
+    
+    JarVersionInfo info;
+    if (!versionCache_.GetVersion(version, info)) {
+        LOG_ERROR(L"JAR version not found in cache: " << version);
+        return ErrorCode::JAR_NOT_FOUND;
+    }
+    
+    // 显式回滚由操作者发起，不经过灰度
+    if (ActivateJar(info.path, version, false) != Activation::ACTIVE) {
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    
+    LOG_INFO(L"Rolled back to JAR version " << version);
+    return ErrorCode::SUCCESS;
+}
@@ -0,0 +1,235 @@
+#include "../include/injection_runtime.h"
+#include "../include/jar_loader.h"
+#include "../include/hot_reload.h"
+#include "../include/file_watcher.h"
+#include "../include/control_channel.h"
+#include "../include/metrics_registry.h"
+#include "../include/native_channel.h"
+#include <memory>
+
+// 全局变量
+static std::unique_ptr<JarLoader> g_jarLoader;
+static std::unique_ptr<HotReloadManager> g_hotReloadManager;
+static std::unique_ptr<FileWatcher> g_policyWatcher;
+static std::unique_ptr<ControlServer> g_controlServer;
+static InjectionData g_injectionData;
+static const void* g_module = nullptr;
+
+void SetJarInjectionModule(const void* moduleAddress) {
+    g_module = moduleAddress;
+}
+
+void SetJarInjectionData(const InjectionData& data) {
+    g_injectionData = data;
+    LOG_INFO(L"Injection data set: JAR=" << g_injectionData.jarPath << 
+             L", Class=" << g_injectionData.className << 
+             L", Method=" << g_injectionData.methodName);
+}
+
+bool IsJarInjectionInitialized() {
+    return g_jarLoader && g_jarLoader->IsInitialized();
+}
+
+// 初始化JAR注入
+uint32_t InitializeJarInjection() {
+    try {
+        LOG_INFO(L"Initializing JAR injection...");
+        
+        // DLL同目录下的security.policy可追加安全规则，文件无效时拒绝继续；
+        // 之后文件的修改会重新编译并替换策略，修改无效时保留当前策略
+        std::wstring modulePath = g_module ? Platform::GetModulePath(g_module) : L"";
+        if (!modulePath.empty()) {
+            std::wstring moduleDirectory = modulePath;
+            moduleDirectory = moduleDirectory.substr(0, moduleDirectory.find_last_of(L"\\/") + 1);
+            std::wstring policyPath = moduleDirectory + L"security.policy";
+            if (FileExists(policyPath) && SecurityUtils::LoadSecurityPolicy(policyPath) != ErrorCode::SUCCESS) {
+                LOG_ERROR(L"Invalid security policy: " << policyPath);
+                return 1;
+            }
+            
+            if (FileExists(policyPath)) {
+                g_policyWatcher = std::make_unique<FileWatcher>();
+                ErrorCode watchResult = g_policyWatcher->Start(policyPath, [policyPath]() {
+                    if (SecurityUtils::LoadSecurityPolicy(policyPath) != ErrorCode::SUCCESS) {
+                        LOG_WARNING(L"Security policy update rejected, keeping current policy: " << policyPath);
+                    }
+                });
+                if (watchResult != ErrorCode::SUCCESS) {
+                    LOG_WARNING(L"Security policy changes will not be applied until restart: " << policyPath);
+                }
+            }
+        }
+        
+        // 创建JAR加载器
+        g_jarLoader = std::make_unique<JarLoader>();
+        
+        // 初始化JVM
+        ErrorCode initResult = g_jarLoader->InitializeJVM();
+        if (initResult != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Failed to initialize JVM");
+            return 1;
+        }
+        
+        // 加载JAR文件
+        std::wstring jarPath(g_injectionData.jarPath);
+        ErrorCode loadResult;
+        if (g_injectionData.enableHotReload) {
+            // 热重载时从JAR同目录下的版本缓存加载，来源文件可以被随时覆盖
+            g_hotReloadManager = std::make_unique<HotReloadManager>(g_jarLoader.get());
+            size_t separator = jarPath.find_last_of(L"\\/");
+            std::wstring jarDirectory = separator == std::wstring::npos ? L"." : jarPath.substr(0, separator);
+            std::wstring cacheDirectory = jarDirectory + Platform::PATH_SEPARATOR + L".jar_cache";
+            if (g_hotReloadManager->EnableVersionCache(cacheDirectory, jarPath) != ErrorCode::SUCCESS) {
+                LOG_WARNING(L"JAR version cache unavailable, loading JAR in place");
+            }
+            
+            // 每个版本加载前校验完整性；JAR旁存在<名称>.digests时只接受其中列出的摘要
+            std::wstring trustedListPath = jarPath + L".digests";
+            ErrorCode integrityResult = g_hotReloadManager->EnableIntegrityCheck(
+                cacheDirectory + Platform::PATH_SEPARATOR + L"verification.cache", FileExists(trustedListPath) ? trustedListPath : L"");
+            if (integrityResult != ErrorCode::SUCCESS) {
+                LOG_ERROR(L"Failed to enable JAR integrity check");
+                return 1;
+            }
+            
+            // 重载时新一代在切换前预加载类；重放会真实执行插件方法，不开启
+            g_hotReloadManager->EnableWarmUp(WarmUpOptions());
+            
+            loadResult = g_hotReloadManager->LoadCurrentVersion(jarPath);
+        } else {
+            loadResult = g_jarLoader->LoadJar(jarPath);
+        }
+        if (loadResult != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Failed to load JAR file: " << jarPath);
+            return 1;
+        }
+        
+        // 调用Java方法
+        std::string className = WStringToString(g_injectionData.className);
+        std::string methodName = WStringToString(g_injectionData.methodName);
+        
+        ErrorCode callResult = g_jarLoader->CallJavaMethod(className, methodName);
+        if (callResult != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Failed to call Java method: " << g_injectionData.className << L"." << g_injectionData.methodName);
+            return 1;
+        }
+        
+        // 如果启用热重载，启动监控
+        if (g_hotReloadManager) {
+            ErrorCode monitorResult = g_hotReloadManager->StartMonitoring(jarPath, className, methodName);
+            if (monitorResult != ErrorCode::SUCCESS) {
+                LOG_ERROR(L"Failed to start hot reload monitoring");
+            } else {
+                LOG_INFO(L"Hot reload monitoring started");
+            }
+        }
+        
+        MetricsRegistry::GetInstance().Set("jar.generation", static_cast<int64_t>(g_jarLoader->GetGeneration()));
+        
+        // 控制通道：无需重新注入即可重载、调用方法、查询指标和修改日志级别
+        ControlHandlers handlers;
+        if (g_hotReloadManager) {
+            handlers.reload = []() { return g_hotReloadManager->ReloadNow(); };
+        }
+        handlers.invoke = [](const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+            return g_jarLoader->CallJavaMethod(className, methodName, args);
+        };
+        handlers.threadExit = []() { g_jarLoader->DetachCurrentThread(); };
+        
+        g_controlServer = std::make_unique<ControlServer>();
+        if (g_controlServer->Start(ControlServer::GetEndpointName(Platform::GetCurrentProcessId()), std::move(handlers)) != ErrorCode::SUCCESS) {
+            LOG_WARNING(L"Control channel unavailable");
+            g_controlServer.reset();
+        }
+        
+        LOG_INFO(L"JAR injection completed successfully");
+        return 0;
+    
+    } catch (const std::exception& e) {
+        LOG_ERROR(L"Exception during JAR injection: " << StringToWString(e.what()));
+        return 1;
+    } catch (...) {
+        LOG_ERROR(L"Unknown exception during JAR injection");
+        return 1;
+    }
+}
+
+void DetachJarInjectionThread() {
+    if (g_jarLoader) {
+        g_jarLoader->DetachCurrentThread();
+    }
+}
+
+// 停止后台监控
+void StopJarInjectionMonitoring() {
+    // 先停止控制通道，其命令处理函数使用下面释放的对象
+    if (g_controlServer) {
+        g_controlServer->Stop();
+        g_controlServer.reset();
+    }
+    
+    // 停止热重载监控
+    if (g_hotReloadManager) {
+        g_hotReloadManager->StopMonitoring();
+        g_hotReloadManager.reset();
+    }
+    
+    // 停止安全策略监控
+    if (g_policyWatcher) {
+        g_policyWatcher->Stop();
+        g_policyWatcher.reset();
+    }
+    
+    // 停止共享内存通道的消费线程
+    NativeChannel::GetInstance().Close();
+    
+    // 预热线程池在热重载停止后不再使用；JarLoader可能随后被放弃而不析构，不能等Cleanup停止它
+    if (g_jarLoader) {
+        g_jarLoader->StopPreloader();
+    }
+}
+
+// 清理JAR注入
+void CleanupJarInjection() {
+    try {
+        LOG_INFO(L"Cleaning up JAR injection...");
+        
+        StopJarInjectionMonitoring();
+        
+        // 卸载JAR
+        if (g_jarLoader) {
+            ErrorCode unloadResult = g_jarLoader->UnloadJar();
+            if (unloadResult != ErrorCode::SUCCESS) {
+                LOG_ERROR(L"Failed to unload JAR during cleanup");
+            }
+            g_jarLoader.reset();
+        }
+        
+        LOG_INFO(L"JAR injection cleanup completed");
+        
+        // 输出记录队列中剩余的Java日志
+        Logger::GetInstance().Flush();
+    
+    } catch (const std::exception& e) {
+        LOG_ERROR(L"Exception during cleanup: " << StringToWString(e.what()));
+    } catch (...) {
+        LOG_ERROR(L"Unknown exception during cleanup");
+    }
+}
+
+void ShutdownJarInjection() {
+    CleanupJarInjection();
+    Logger::GetInstance().Shutdown();
+}
+
+void AbandonJarInjection() {
+    // 进程退出时其他线程已被终止；模块未经ShutdownInjection被卸载时其代码也随之失效，
+    // 两种情况下都不能等待线程，只能放弃对象
+    if (g_controlServer || g_hotReloadManager || g_policyWatcher || g_jarLoader) {
+        LOG_WARNING(L"Injection runtime abandoned without shutdown");
+    }
+    g_controlServer.release();
+    g_hotReloadManager.release();
+    g_policyWatcher.release();
+    g_jarLoader.release();
+}
@@ -0,0 +1,289 @@
+#include "../include/jar_archive.h"
+#include <cstring>
+
+namespace {
+
+// ZIP格式常量（APPNOTE.TXT）
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t EOCD_SIGNATURE = 0x06054b50;
+constexpr uint32_t ZIP64_EOCD_SIGNATURE = 0x06064b50;
+constexpr uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+constexpr uint16_t ZIP64_EXTRA_ID = 0x0001;
+
+constexpr size_t LOCAL_HEADER_SIZE = 30;
+constexpr size_t CENTRAL_HEADER_SIZE = 46;
+constexpr size_t EOCD_SIZE = 22;
+constexpr size_t ZIP64_EOCD_SIZE = 56;
+constexpr size_t ZIP64_LOCATOR_SIZE = 20;
+constexpr size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+inline uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t ReadU64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+// 检查[offset, offset + length)是否位于[0, limit)内，避免整数溢出
+inline bool InRange(uint64_t offset, uint64_t length, uint64_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+} // namespace
+
+JarArchive::JarArchive()
+    : mappedView_(nullptr), snapshotMemory_(nullptr), mappingSize_(0), data_(nullptr), size_(0),
+      centralDirectoryOffset_(0), centralDirectorySize_(0) {
+}
+
+JarArchive::~JarArchive() {
+    Close();
+}
+
+ErrorCode JarArchive::Parse(const uint8_t* data, size_t size) {
+    entries_.clear();
+    errorMessage_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    centralDirectoryOffset_ = 0;
+    centralDirectorySize_ = 0;
+    
+    if (!data || size < EOCD_SIZE) {
+        Fail(L"file too small to be a ZIP archive");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    data_ = data;
+    size_ = size;
+    
+    uint64_t entryCount = 0;
+    uint64_t cdOffset = 0;
+    uint64_t cdSize = 0;
+    if (!ParseEndOfCentralDirectory(entryCount, cdOffset, cdSize) ||
+        !ParseCentralDirectory(entryCount, cdOffset, cdSize)) {
+        entries_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    // 中央目录范围已在解析时校验
+    centralDirectoryOffset_ = static_cast<size_t>(cdOffset);
+    centralDirectorySize_ = static_cast<size_t>(cdSize);
+    return ErrorCode::SUCCESS;
+}
+
+void JarArchive::Close() {
+    Unmap();
+    entries_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    centralDirectoryOffset_ = 0;
+    centralDirectorySize_ = 0;
+}
+
+const JarEntry* JarArchive::FindEntry(std::string_view name) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool JarArchive::GetEntryData(const JarEntry& entry, const uint8_t*& data, uint64_t& size) const {
+    data = nullptr;
+    size = 0;
+    
+    if (!data_ || !InRange(entry.localHeaderOffset, LOCAL_HEADER_SIZE, size_)) {
+        return false;
+    }
+    
+    const uint8_t* header = data_ + entry.localHeaderOffset;
+    if (ReadU32(header) != LOCAL_HEADER_SIGNATURE) {
+        return false;
+    }
+    
+    // 以中央目录中的大小为准，本地头的大小字段在使用数据描述符时可能为0
+    uint64_t dataOffset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + ReadU16(header + 26) + ReadU16(header + 28);
+    if (!InRange(dataOffset, entry.compressedSize, size_)) {
+        return false;
+    }
+    
+    data = data_ + dataOffset;
+    size = entry.compressedSize;
+    return true;
+}
+
+bool JarArchive::ParseEndOfCentralDirectory(uint64_t& entryCount, uint64_t& cdOffset, uint64_t& cdSize) {
+    // EOCD位于文件末尾，之后最多跟随65535字节的注释，从后向前查找签名
+    size_t searchStart = size_ > EOCD_SIZE + MAX_COMMENT_SIZE ? size_ - EOCD_SIZE - MAX_COMMENT_SIZE : 0;
+    size_t eocdPos = SIZE_MAX;
+    for (size_t pos = size_ - EOCD_SIZE + 1; pos-- > searchStart;) {
+        if (ReadU32(data_ + pos) == EOCD_SIGNATURE &&
+            pos + EOCD_SIZE + ReadU16(data_ + pos + 20) <= size_) {
+            eocdPos = pos;
+            break;
+        }
+    }
+    
+    if (eocdPos == SIZE_MAX) {
+        return Fail(L"end of central directory record not found");
+    }
+    
+    const uint8_t* eocd = data_ + eocdPos;
+    uint16_t diskNumber = ReadU16(eocd + 4);
+    uint16_t cdDisk = ReadU16(eocd + 6);
+    uint16_t diskEntries = ReadU16(eocd + 8);
+    entryCount = ReadU16(eocd + 10);
+    cdSize = ReadU32(eocd + 12);
+    cdOffset = ReadU32(eocd + 16);
+    
+    bool needsZip64 = entryCount == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF;
+    bool hasLocator = eocdPos >= ZIP64_LOCATOR_SIZE &&
+                      ReadU32(data_ + eocdPos - ZIP64_LOCATOR_SIZE) == ZIP64_LOCATOR_SIGNATURE;
+    
+    if (hasLocator) {
+        const uint8_t* locator = data_ + eocdPos - ZIP64_LOCATOR_SIZE;
+        uint64_t zip64EocdOffset = ReadU64(locator + 8);
+        if (ReadU32(locator + 16) > 1 || !InRange(zip64EocdOffset, ZIP64_EOCD_SIZE, eocdPos - ZIP64_LOCATOR_SIZE)) {
+            return Fail(L"invalid ZIP64 end of central directory locator");
+        }
+        
+        const uint8_t* zip64Eocd = data_ + zip64EocdOffset;
+        if (ReadU32(zip64Eocd) != ZIP64_EOCD_SIGNATURE) {
+            return Fail(L"ZIP64 end of central directory record not found");
+        }
+        
+        if (ReadU32(zip64Eocd + 16) != 0 || ReadU32(zip64Eocd + 20) != 0 ||
+            ReadU64(zip64Eocd + 24) != ReadU64(zip64Eocd + 32)) {
+            return Fail(L"multi-disk archives are not supported");
+        }
+        
+        entryCount = ReadU64(zip64Eocd + 32);
+        cdSize = ReadU64(zip64Eocd + 40);
+        cdOffset = ReadU64(zip64Eocd + 48);
+        
+        // 中央目录必须位于ZIP64结束记录之前
+        if (!InRange(cdOffset, cdSize, zip64EocdOffset)) {
+            return Fail(L"central directory out of bounds");
+        }
+    } else {
+        if (needsZip64) {
+            return Fail(L"ZIP64 fields present without ZIP64 locator");
+        }
+        if (diskNumber != 0 || cdDisk != 0 || diskEntries != entryCount) {
+            return Fail(L"multi-disk archives are not supported");
+        }
+        if (!InRange(cdOffset, cdSize, eocdPos)) {
+            return Fail(L"central directory out of bounds");
+        }
+    }
+    
+    if (entryCount > MAX_ENTRY_COUNT || entryCount > cdSize / CENTRAL_HEADER_SIZE) {
+        return Fail(L"entry count inconsistent with central directory size");
+    }
+    
+    return true;
+}
+
+bool JarArchive::ParseCentralDirectory(uint64_t entryCount, uint64_t cdOffset, uint64_t cdSize) {
+    entries_.reserve(static_cast<size_t>(entryCount));
+    
+    uint64_t pos = cdOffset;
+    uint64_t cdEnd = cdOffset + cdSize;
+    
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (!InRange(pos, CENTRAL_HEADER_SIZE, cdEnd)) {
+            return Fail(L"truncated central directory");
+        }
+        
+        const uint8_t* header = data_ + pos;
+        if (ReadU32(header) != CENTRAL_HEADER_SIGNATURE) {
+            return Fail(L"bad central directory header signature");
+        }
+        
+        uint16_t nameLength = ReadU16(header + 28);
+        uint16_t extraLength = ReadU16(header + 30);
+        uint16_t commentLength = ReadU16(header + 32);
+        uint64_t recordSize = CENTRAL_HEADER_SIZE + static_cast<uint64_t>(nameLength) + extraLength + commentLength;
+        if (!InRange(pos, recordSize, cdEnd)) {
+            return Fail(L"central directory entry exceeds directory bounds");
+        }
+        
+        JarEntry entry;
+        entry.flags = ReadU16(header + 8);
+        entry.method = ReadU16(header + 10);
+        entry.crc32 = ReadU32(header + 16);
+        entry.compressedSize = ReadU32(header + 20);
+        entry.uncompressedSize = ReadU32(header + 24);
+        entry.localHeaderOffset = ReadU32(header + 42);
+        entry.name = std::string_view(reinterpret_cast<const char*>(header + CENTRAL_HEADER_SIZE), nameLength);
+        
+        if (nameLength == 0 || entry.name.find('\0') != std::string_view::npos) {
+            return Fail(L"invalid entry name");
+        }
+        
+        // ZIP64扩展字段：仅对取值为0xFFFFFFFF的字段按顺序给出64位值
+        const uint8_t* extra = header + CENTRAL_HEADER_SIZE + nameLength;
+        const uint8_t* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            uint16_t id = ReadU16(extra);
+            uint16_t length = ReadU16(extra + 2);
+            const uint8_t* field = extra + 4;
+            if (length > extraEnd - field) {
+                return Fail(L"malformed extra field");
+            }
+            
+            if (id == ZIP64_EXTRA_ID) {
+                const uint8_t* fieldEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFF) {
+                    if (fieldEnd - field < 8) return Fail(L"truncated ZIP64 extra field");
+                    entry.uncompressedSize = ReadU64(field);
+                    field += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF) {
+                    if (fieldEnd - field < 8) return Fail(L"truncated ZIP64 extra field");
+                    entry.compressedSize = ReadU64(field);
+                    field += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF) {
+                    if (fieldEnd - field < 8) return Fail(L"truncated ZIP64 extra field");
+                    entry.localHeaderOffset = ReadU64(field);
+                }
+            }
+            extra += 4 + length;
+        }
+        
+        // 条目数据必须位于中央目录之前
+        if (!InRange(entry.localHeaderOffset, LOCAL_HEADER_SIZE, cdOffset) ||
+            !InRange(entry.localHeaderOffset + LOCAL_HEADER_SIZE, entry.compressedSize, cdOffset)) {
+            return Fail(L"entry data out of bounds");
+        }
+        
+        if (entry.method != METHOD_STORED && entry.method != METHOD_DEFLATED) {
+            return Fail(L"unsupported compression method");
+        }
+        
+        if ((entry.flags & 0x1) != 0) {
+            return Fail(L"encrypted entries are not supported");
+        }
+        
+        entries_.push_back(entry);
+        pos += recordSize;
+    }
+    
+    return true;
+}
+
+bool JarArchive::Fail(const std::wstring& message) {
+    errorMessage_ = message;
+    return false;
+}
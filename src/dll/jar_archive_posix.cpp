@@ -0,0 +1,138 @@
+// JarArchive的POSIX文件映射与快照（mmap）
+#include "../include/jar_archive.h"
+#include "../include/platform.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::wstring SystemErrorMessage(const wchar_t* what) {
+    return std::wstring(what) + L" (errno " + std::to_wstring(errno) + L")";
+}
+
+// 打开文件并读取大小；失败时返回-1并写入原因
+int OpenForReading(const std::wstring& path, size_t& size, std::wstring& error, ErrorCode& code) {
+    int fd = open(Platform::WideToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = SystemErrorMessage(L"cannot open file");
+        code = ErrorCode::JAR_NOT_FOUND;
+        return -1;
+    }
+    
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size <= 0 ||
+        static_cast<uint64_t>(status.st_size) > SIZE_MAX) {
+        close(fd);
+        error = L"empty or unreadable file";
+        code = ErrorCode::JAR_INVALID_FORMAT;
+        return -1;
+    }
+    size = static_cast<size_t>(status.st_size);
+    return fd;
+}
+
+} // namespace
+
+ErrorCode JarArchive::Open(const std::wstring& path) {
+    Close();
+    path_ = path;
+    
+    size_t size = 0;
+    std::wstring error;
+    ErrorCode code = ErrorCode::SUCCESS;
+    int fd = OpenForReading(path, size, error, code);
+    if (fd < 0) {
+        Fail(error);
+        return code;
+    }
+    
+    // 映射保留文件的引用，建立后即可关闭描述符
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        Fail(SystemErrorMessage(L"cannot map file"));
+    }
+    close(fd);
+    if (view == MAP_FAILED) {
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    mappedView_ = static_cast<const uint8_t*>(view);
+    mappingSize_ = size;
+    
+    ErrorCode result = Parse(mappedView_, mappingSize_);
+    if (result != ErrorCode::SUCCESS) {
+        Unmap();
+    }
+    return result;
+}
+
+ErrorCode JarArchive::OpenSnapshot(const std::wstring& path) {
+    Close();
+    path_ = path;
+    
+    size_t size = 0;
+    std::wstring error;
+    ErrorCode code = ErrorCode::SUCCESS;
+    int fd = OpenForReading(path, size, error, code);
+    if (fd < 0) {
+        Fail(error);
+        return code;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    
+    // 匿名映射，读取完成后改为只读，与Windows的VirtualAlloc/VirtualProtect一致
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        close(fd);
+        Fail(L"cannot allocate snapshot of " + std::to_wstring(size) + L" bytes");
+        return ErrorCode::MEMORY_ALLOCATION_FAILED;
+    }
+    snapshotMemory_ = memory;
+    mappingSize_ = size;
+    
+    uint8_t* buffer = static_cast<uint8_t*>(snapshotMemory_);
+    size_t totalRead = 0;
+    while (totalRead < size) {
+        size_t chunk = std::min<size_t>(size - totalRead, 16 * 1024 * 1024);
+        ssize_t bytesRead = read(fd, buffer + totalRead, chunk);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            break;
+        }
+        totalRead += static_cast<size_t>(bytesRead);
+    }
+    close(fd);
+    
+    // 文件在读取过程中被截断（通常是构建工具正在写入）
+    if (totalRead != size) {
+        Unmap();
+        Fail(L"file changed while reading");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    // 快照之后不可修改
+    mprotect(snapshotMemory_, size, PROT_READ);
+    
+    ErrorCode result = Parse(buffer, size);
+    if (result != ErrorCode::SUCCESS) {
+        Unmap();
+    }
+    return result;
+}
+
+void JarArchive::Unmap() {
+    if (mappedView_) {
+        munmap(const_cast<uint8_t*>(mappedView_), mappingSize_);
+        mappedView_ = nullptr;
+    }
+    if (snapshotMemory_) {
+        munmap(snapshotMemory_, mappingSize_);
+        snapshotMemory_ = nullptr;
+    }
+    mappingSize_ = 0;
+}
@@ -0,0 +1,130 @@
+// JarArchive的Windows文件映射与快照
+#include "../include/jar_archive.h"
+#include <windows.h>
+#include <algorithm>
+
+namespace {
+
+std::wstring SystemErrorMessage(const wchar_t* what) {
+    return std::wstring(what) + L" (error " + std::to_wstring(::GetLastError()) + L")";
+}
+
+} // namespace
+
+ErrorCode JarArchive::Open(const std::wstring& path) {
+    Close();
+    path_ = path;
+    
+    // 与OpenSnapshot一致，不阻止构建工具写入、替换或删除源文件；
+    // 映射期间文件不能被截短，内容被覆盖时条目访问仍受边界与签名检查保护
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        Fail(SystemErrorMessage(L"cannot open file"));
+        return ErrorCode::JAR_NOT_FOUND;
+    }
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+        CloseHandle(file);
+        Fail(L"empty or unreadable file");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    // 视图持有映射对象的引用，映射建立后即可关闭两个句柄
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        Fail(SystemErrorMessage(L"cannot create file mapping"));
+        CloseHandle(file);
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    
+    mappedView_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!mappedView_) {
+        Fail(SystemErrorMessage(L"cannot map file"));
+    }
+    CloseHandle(mapping);
+    CloseHandle(file);
+    if (!mappedView_) {
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    mappingSize_ = static_cast<size_t>(fileSize.QuadPart);
+    
+    ErrorCode result = Parse(mappedView_, mappingSize_);
+    if (result != ErrorCode::SUCCESS) {
+        Unmap();
+    }
+    return result;
+}
+
+ErrorCode JarArchive::OpenSnapshot(const std::wstring& path) {
+    Close();
+    path_ = path;
+    
+    // 允许构建工具同时写入、替换或删除源文件
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        Fail(SystemErrorMessage(L"cannot open file"));
+        return ErrorCode::JAR_NOT_FOUND;
+    }
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+        CloseHandle(file);
+        Fail(L"empty or unreadable file");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    size_t size = static_cast<size_t>(fileSize.QuadPart);
+    snapshotMemory_ = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!snapshotMemory_) {
+        CloseHandle(file);
+        Fail(L"cannot allocate snapshot of " + std::to_wstring(size) + L" bytes");
+        return ErrorCode::MEMORY_ALLOCATION_FAILED;
+    }
+    mappingSize_ = size;
+    
+    uint8_t* buffer = static_cast<uint8_t*>(snapshotMemory_);
+    size_t totalRead = 0;
+    while (totalRead < size) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size - totalRead, 16 * 1024 * 1024));
+        DWORD bytesRead = 0;
+        if (!ReadFile(file, buffer + totalRead, chunk, &bytesRead, nullptr) || bytesRead == 0) {
+            break;
+        }
+        totalRead += bytesRead;
+    }
+    CloseHandle(file);
+    
+    // 文件在读取过程中被截断（通常是构建工具正在写入）
+    if (totalRead != size) {
+        Unmap();
+        Fail(L"file changed while reading");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    // 快照之后不可修改
+    DWORD oldProtect = 0;
+    VirtualProtect(snapshotMemory_, size, PAGE_READONLY, &oldProtect);
+    
+    ErrorCode result = Parse(buffer, size);
+    if (result != ErrorCode::SUCCESS) {
+        Unmap();
+    }
+    return result;
+}
+
+void JarArchive::Unmap() {
+    if (mappedView_) {
+        UnmapViewOfFile(mappedView_);
+        mappedView_ = nullptr;
+    }
+    if (snapshotMemory_) {
+        VirtualFree(snapshotMemory_, 0, MEM_RELEASE);
+        snapshotMemory_ = nullptr;
+    }
+    mappingSize_ = 0;
+}
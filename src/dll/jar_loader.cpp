@@ -1,12 +1,24 @@
 #include "../include/jar_loader.h"
 #include "../include/common.h"
-#include <shlwapi.h>
+#include "../include/jar_archive.h"
+#include "../include/class_index.h"
+#include "../include/snapshot_class_loader.h"
+#include "../include/class_preloader.h"
+#include "../include/platform.h"
+#include <filesystem>
 #include <mutex>
 #include <unordered_map>
 
+// 当前线程是否由JarLoader附加（而不是由JVM创建或由其他代码附加）
+static thread_local bool t_attachedByLoader = false;
+
 JarLoader::JarLoader() 
     : jvm_(nullptr), env_(nullptr), initialized_(false), 
-      lastError_(ErrorCode::SUCCESS), classLoader_(nullptr) {
+      lastError_(ErrorCode::SUCCESS), classLoader_(nullptr), generation_(0), generationCounter_(0),
+      defaultInstancePolicy_(InstancePolicy::PER_CALL), timeToFirstCallMs_(-1),
+      classLoaderMode_(ClassLoaderMode::URL), collectedGenerations_(0),
+      generationLeakThreshold_(DEFAULT_GENERATION_LEAK_THRESHOLD), stagedLoader_(nullptr),
+      invocationPath_(InvocationPath::JNI), handoffState_(nullptr), canaryNotificationPending_(false) {
     LOG_DEBUG(L"JarLoader created");
 }
 
@@ -25,6 +37,9 @@ ErrorCode JarLoader::InitializeJVM() {
         return ErrorCode::SUCCESS;
     }
 
+    startupBegin_ = std::chrono::steady_clock::now();
+    timeToFirstCallMs_ = -1;
+    
     try {
         // 检查是否已经有JVM实例
         JavaVM* existingJVMs[1];
@@ -40,15 +55,10 @@ ErrorCode JarLoader::InitializeJVM() {
                 return ErrorCode::JVM_INIT_FAILED;
             }
             
-            result = jvm_->AttachCurrentThread((void**)&env_, NULL);
-            if (result != JNI_OK) {
-                LOG_ERROR(L"Failed to attach to existing JVM thread, error code: " << result);
-                SetLastError(ErrorCode::JVM_INIT_FAILED);
-                return ErrorCode::JVM_INIT_FAILED;
-            }
-            
-            if (!env_) {
-                LOG_ERROR(L"JNI environment is null after attach");
+            // 与其他入口一样以守护线程附加并记录，注入线程结束前可以分离；
+            // 已附加的线程（如VMInit回调所在线程）保持原状
+            if (!AttachCurrentThread()) {
+                LOG_ERROR(L"Failed to attach to existing JVM thread");
                 SetLastError(ErrorCode::JVM_INIT_FAILED);
                 return ErrorCode::JVM_INIT_FAILED;
             }
@@ -85,6 +95,11 @@ ErrorCode JarLoader::InitializeJVM() {
         jint version = env_->GetVersion();
         LOG_INFO(L"JNI version: " << std::hex << version);
         
+        // 解析失败时调用照常进行，只是不设置上下文类加载器
+        if (!ResolveContextLoaderMethods()) {
+            LOG_WARNING(L"Context class loader methods unavailable, plugins run with the caller's context loader");
+        }
+        
         initialized_ = true;
         SetLastError(ErrorCode::SUCCESS);
         LOG_INFO(L"JVM initialization successful");
@@ -102,14 +117,254 @@ ErrorCode JarLoader::InitializeJVM() {
 }
 
 ErrorCode JarLoader::LoadJar(const std::wstring& jarPath) {
+    CanaryNotifier notifier(*this);
     std::lock_guard<std::mutex> lock(jniMutex_);
     
-    if (!initialized_) {
+    if (!initialized_ || !AttachCurrentThread()) {
+        LOG_ERROR(L"JVM not initialized");
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    
+    ErrorCode result = PrepareJarLocked(jarPath);
+    if (result != ErrorCode::SUCCESS) {
+        return result;
+    }
+    return CommitPreparedJarLocked(false);
+}
+
+ErrorCode JarLoader::PrepareJar(const std::wstring& jarPath) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        LOG_ERROR(L"JVM not initialized");
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    return PrepareJarLocked(jarPath);
+}
+
+ErrorCode JarLoader::PrepareJar(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot) {
+    if (!snapshot || !snapshot->IsSnapshot()) {
+        SetLastError(ErrorCode::INVALID_PARAMETER);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        LOG_ERROR(L"JVM not initialized");
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    return PrepareJarLocked(jarPath, std::move(snapshot));
+}
+
+ErrorCode JarLoader::CommitPreparedJar(bool keepPrevious) {
+    CanaryNotifier notifier(*this);
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
         LOG_ERROR(L"JVM not initialized");
         SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
         return ErrorCode::JVM_NOT_INITIALIZED;
     }
+    return CommitPreparedJarLocked(keepPrevious);
+}
+
+ErrorCode JarLoader::ConfirmCommittedJar() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    
+    // 显式确认覆盖进行中的灰度
+    canary_.Stop();
+    if (standby_.loader) {
+        uint64_t standbyGeneration = standby_.generation;
+        RetireStandbyGeneration();
+        LOG_INFO(L"Generation " << generation_ << L" confirmed, standby generation " << standbyGeneration << L" retired");
+    }
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarLoader::RollbackCommittedJar() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    
+    if (!standby_.loader) {
+        LOG_ERROR(L"No standby generation to roll back to");
+        SetLastError(ErrorCode::INVALID_PARAMETER);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    canary_.Stop();
+    RollbackToStandby();
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
+}
+
+void JarLoader::RollbackToStandby() {
+    JNILocalFrame localFrame(env_, 16);
+    
+    // 备用的一代连同其缓存原样恢复为当前一代，失败的一代退役
+    uint64_t failedGeneration = generation_;
+    SwapWithStandby();
+    RetireStandbyGeneration();
+    
+    LOG_WARNING(L"Rolled back from generation " << failedGeneration << L" to generation " << generation_
+                << L": " << currentJarPath_);
+}
+
+ErrorCode JarLoader::StartCanary(const CanaryOptions& options) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    
+    if (!standby_.loader) {
+        LOG_ERROR(L"Canary requires a standby generation");
+        SetLastError(ErrorCode::INVALID_PARAMETER);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    canary_.Start(options, standby_.generation, generation_);
+    LOG_INFO(L"Canary started: " << canary_.GetOptions().fraction * 100 << L"% of calls to generation " << generation_
+             << L" for " << options.windowMs << L" ms, generation " << standby_.generation << L" serves the rest");
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
+}
+
+CanaryVerdict JarLoader::EvaluateCanary(bool force) {
+    CanaryNotifier notifier(*this);
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread() || !canary_.IsActive()) {
+        return CanaryVerdict::PENDING;
+    }
+    
+    CanaryVerdict verdict = canary_.Evaluate(force);
+    if (verdict != CanaryVerdict::PENDING) {
+        FinishCanary(verdict);
+    }
+    return verdict;
+}
+
+CanaryVerdict JarLoader::SupersedeCanary() {
+    CanaryNotifier notifier(*this);
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread() || !canary_.IsActive()) {
+        return CanaryVerdict::PENDING;
+    }
+    
+    CanaryVerdict verdict = canary_.Supersede();
+    FinishCanary(verdict);
+    return verdict;
+}
+
+CanaryReport JarLoader::GetCanaryReport() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return canary_.GetReport();
+}
+
+void JarLoader::FinishCanary(CanaryVerdict verdict) {
+    CanaryReport report = canary_.GetReport();
+    std::function<void(const CanaryReport&)> onFinished = canary_.GetOptions().onFinished;
+    canary_.Stop();
+    report.active = false;
+    
+    LOG_INFO(L"Canary generation " << report.canary.generation << L": " << report.canary.calls << L" calls, "
+             << report.canary.errors << L" errors, p99 " << report.canary.p99Us << L" us; baseline generation "
+             << report.baseline.generation << L": " << report.baseline.calls << L" calls, " << report.baseline.errors
+             << L" errors, p99 " << report.baseline.p99Us << L" us");
+    
+    if (verdict == CanaryVerdict::ROLLBACK) {
+        LOG_WARNING(L"Canary generation " << report.canary.generation << L" rejected: " << StringToWString(report.reason));
+        RollbackToStandby();
+    } else if (verdict == CanaryVerdict::SUPERSEDED) {
+        LOG_INFO(L"Canary generation " << report.canary.generation << L" ended without a verdict: "
+                 << StringToWString(report.reason));
+        RollbackToStandby();
+    } else {
+        LOG_INFO(L"Canary generation " << report.canary.generation << L" promoted: " << StringToWString(report.reason));
+        RetireStandbyGeneration();
+    }
+    
+    // 回调可能读取JarLoader的状态，在释放锁后调用
+    if (onFinished) {
+        canaryNotifications_.push_back(CanaryNotification{std::move(onFinished), report});
+        canaryNotificationPending_ = true;
+    }
+}
+
+void JarLoader::NotifyCanaryFinished() {
+    if (!canaryNotificationPending_) {
+        return;
+    }
+    
+    std::vector<CanaryNotification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(jniMutex_);
+        notifications.swap(canaryNotifications_);
+        canaryNotificationPending_ = false;
+    }
+    for (const auto& notification : notifications) {
+        try {
+            notification.callback(notification.report);
+        } catch (const std::exception& e) {
+            LOG_ERROR(L"Exception in canary callback: " << StringToWString(e.what()));
+        }
+    }
+}
+
+bool JarLoader::IsCanaryActive() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return canary_.IsActive();
+}
+
+std::wstring JarLoader::GetCurrentJarPath() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return currentJarPath_;
+}
+
+std::string JarLoader::GetJarFingerprint() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return currentFingerprint_;
+}
+
+uint64_t JarLoader::GetGeneration() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return generation_;
+}
+
+GenerationInfo JarLoader::GetGenerationInfo() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    GenerationInfo info;
+    info.generation = generation_;
+    info.jarPath = currentJarPath_;
+    info.fingerprint = currentFingerprint_;
+    return info;
+}
+
+void JarLoader::DiscardPreparedJar() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
     
+    if (initialized_ && AttachCurrentThread()) {
+        DiscardPreparedJarLocked();
+    }
+}
+
+ErrorCode JarLoader::PrepareJarLocked(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot) {
     // 安全验证JAR路径
     if (!SecurityUtils::ValidateJarPath(jarPath)) {
         LOG_ERROR(L"JAR path failed security validation: " << jarPath);
@@ -117,49 +372,537 @@ ErrorCode JarLoader::LoadJar(const std::wstring& jarPath) {
         return ErrorCode::INVALID_PARAMETER;
     }
     
+    // 类路径上的JAR由应用类加载器按父优先委派定义，插件类加载器拿到的是旧类，
+    // 热重载与卸载都会静默失效
+    if (!jvmClassPath_.empty() && ClassPathContainsJar(jvmClassPath_, jarPath)) {
+        if (!jvmStartupOptions_.allowPluginOnClassPath) {
+            LOG_ERROR(L"JAR is on the JVM class path and would be defined by the application class loader: " << jarPath);
+            SetLastError(ErrorCode::INVALID_PARAMETER);
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        LOG_WARNING(L"JAR is on the JVM class path, its classes cannot be hot reloaded or unloaded: " << jarPath);
+    }
+    
+    // 在进入JVM之前校验ZIP结构，损坏或非ZIP文件直接拒绝；同时从中央目录构建类名索引
+    // 快照模式下文件只读取一次，同一份内存既用于校验也用于提供类字节；
+    // 调用者传入的快照已经过结构校验，直接使用
+    bool useSnapshot = snapshot || classLoaderMode_ == ClassLoaderMode::SNAPSHOT;
+    ClassIndex classIndex;
+    auto archive = snapshot ? std::move(snapshot) : std::make_unique<JarArchive>();
+    ErrorCode archiveResult = archive->IsOpen() ? ErrorCode::SUCCESS
+                            : useSnapshot ? archive->OpenSnapshot(jarPath) : archive->Open(jarPath);
+    if (archiveResult != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"JAR failed structural validation: " << jarPath << L" (" << archive->GetLastErrorMessage() << L")");
+        // 文件可能已被删除或替换，下次重新完整验证路径
+        SecurityUtils::InvalidateJarPathCache(jarPath);
+        SetLastError(archiveResult);
+        return archiveResult;
+    }
+    classIndex.Build(*archive);
+    
+    // 指纹与完整性校验的归档摘要相同，可直接与可信摘要列表和校验日志对照
+    JarVerifier::Digest digest;
+    std::wstring digestError;
+    if (!fingerprintVerifier_.ComputeDigest(*archive, digest, digestError)) {
+        LOG_ERROR(L"Failed to compute JAR fingerprint: " << jarPath << L" (" << digestError << L")");
+        SecurityUtils::InvalidateJarPathCache(jarPath);
+        SetLastError(ErrorCode::JAR_INVALID_FORMAT);
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    std::string fingerprint = JarVerifier::ToHex(digest);
+    if (!useSnapshot) {
+        archive.reset();
+    }
+    
     try {
-        // 使用CreateClassLoader方法创建类加载器
-        ErrorCode result = CreateClassLoader(jarPath);
+        JNILocalFrame localFrame(env_, 16);
+        
+        // 按模式创建类加载器，此时还不影响当前一代
+        ErrorCode result = useSnapshot ? CreateSnapshotClassLoader(jarPath, std::move(archive)) : CreateClassLoader(jarPath);
         if (result != ErrorCode::SUCCESS) {
             LOG_ERROR(L"Failed to create class loader for JAR: " << jarPath);
             SetLastError(result);
             return result;
         }
         
-        // 设置当前线程的类加载器
-        if (classLoader_) {
-            jclass threadClass = env_->FindClass("java/lang/Thread");
-            if (threadClass && !CheckJNIException()) {
-                jmethodID currentThreadMethod = env_->GetStaticMethodID(threadClass, "currentThread", "()Ljava/lang/Thread;");
-                if (currentThreadMethod && !CheckJNIException()) {
-                    jobject currentThread = env_->CallStaticObjectMethod(threadClass, currentThreadMethod);
-                    if (currentThread && !CheckJNIException()) {
-                        jmethodID setContextClassLoaderMethod = env_->GetMethodID(threadClass, "setContextClassLoader", "(Ljava/lang/ClassLoader;)V");
-                        if (setContextClassLoaderMethod && !CheckJNIException()) {
-                            env_->CallVoidMethod(currentThread, setContextClassLoaderMethod, classLoader_);
-                            if (!CheckJNIException()) {
-                                currentJarPath_ = jarPath;
-                                LOG_INFO(L"JAR loaded successfully: " << jarPath);
-                                SetLastError(ErrorCode::SUCCESS);
-                                return ErrorCode::SUCCESS;
-                            }
-                        }
-                        env_->DeleteLocalRef(currentThread);
-                    }
+        stagedJarPath_ = jarPath;
+        stagedFingerprint_ = std::move(fingerprint);
+        stagedClassIndex_ = std::move(classIndex);
+        LOG_DEBUG(L"JAR prepared: " << jarPath);
+        SetLastError(ErrorCode::SUCCESS);
+        return ErrorCode::SUCCESS;
+    
+    } catch (const std::exception& e) {
+        LOG_ERROR(L"Exception during JAR loading: " << StringToWString(e.what()));
+        DiscardPreparedJarLocked();
+        SetLastError(ErrorCode::UNKNOWN_ERROR);
+        return ErrorCode::UNKNOWN_ERROR;
+    }
+}
+
+ErrorCode JarLoader::CommitPreparedJarLocked(bool keepPrevious) {
+    if (!stagedLoader_) {
+        LOG_ERROR(L"No prepared JAR to commit");
+        SetLastError(ErrorCode::INVALID_PARAMETER);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    // 新版本取代进行中的灰度：已有数据足以得出结论时按结论提升或回滚，否则切回旧的一代并报告为被取代
+    if (canary_.IsActive()) {
+        FinishCanary(canary_.Supersede());
+    }
+    
+    // 退役旧加载器产生的局部引用在返回时一并释放
+    JNILocalFrame localFrame(env_, 16);
+    
+    InstallClassLoader(stagedLoader_, keepPrevious);
+    env_->DeleteGlobalRef(stagedLoader_);
+    stagedLoader_ = nullptr;
+    currentJarPath_ = stagedJarPath_;
+    currentFingerprint_ = std::move(stagedFingerprint_);
+    classIndex_ = std::move(stagedClassIndex_);
+    stagedJarPath_.clear();
+    stagedFingerprint_.clear();
+    stagedClassIndex_.Clear();
+    
+    LOG_INFO(L"JAR loaded successfully: " << currentJarPath_);
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
+}
+
+ContextClassLoaderScope::ContextClassLoaderScope(JNIEnv* env, const ContextLoaderMethods& methods, jobject loader)
+    : env_(env), methods_(methods), thread_(nullptr), previous_(nullptr), changed_(false) {
+    if (!env_ || !loader || !methods_.IsResolved() || env_->ExceptionCheck()) {
+        return;
+    }
+    
+    thread_ = env_->CallStaticObjectMethod(methods_.threadClass, methods_.currentThread);
+    previous_ = thread_ ? env_->CallObjectMethod(thread_, methods_.getContextClassLoader) : nullptr;
+    if (!thread_ || env_->ExceptionCheck()) {
+        env_->ExceptionClear();
+        return;
+    }
+    if (env_->IsSameObject(previous_, loader)) {
+        return;
+    }
+    
+    env_->CallVoidMethod(thread_, methods_.setContextClassLoader, loader);
+    if (env_->ExceptionCheck()) {
+        env_->ExceptionClear();
+        return;
+    }
+    changed_ = true;
+}
+
+ContextClassLoaderScope::~ContextClassLoaderScope() {
+    if (changed_) {
+        // 调用者可能还有未处理的Java异常，恢复期间暂存
+        jthrowable pending = env_->ExceptionOccurred();
+        if (pending) {
+            env_->ExceptionClear();
+        }
+        env_->CallVoidMethod(thread_, methods_.setContextClassLoader, previous_);
+        if (env_->ExceptionCheck()) {
+            env_->ExceptionClear();
+            LOG_WARNING(L"Failed to restore context class loader");
+        }
+        if (pending) {
+            env_->Throw(pending);
+            env_->DeleteLocalRef(pending);
+        }
+    }
+    
+    // 调用线程可能长期不返回Java，局部引用不会自动释放
+    if (previous_) {
+        env_->DeleteLocalRef(previous_);
+    }
+    if (thread_) {
+        env_->DeleteLocalRef(thread_);
+    }
+}
+
+bool JarLoader::ResolveContextLoaderMethods() {
+    if (contextLoaderMethods_.IsResolved()) {
+        return true;
+    }
+    
+    JNILocalFrame localFrame(env_, 4);
+    jclass threadClass = env_->FindClass("java/lang/Thread");
+    if (!threadClass || CheckJNIException()) {
+        return false;
+    }
+    
+    ContextLoaderMethods methods;
+    methods.currentThread = env_->GetStaticMethodID(threadClass, "currentThread", "()Ljava/lang/Thread;");
+    methods.getContextClassLoader = env_->GetMethodID(threadClass, "getContextClassLoader", "()Ljava/lang/ClassLoader;");
+    methods.setContextClassLoader = env_->GetMethodID(threadClass, "setContextClassLoader", "(Ljava/lang/ClassLoader;)V");
+    if (!methods.currentThread || !methods.getContextClassLoader || !methods.setContextClassLoader || CheckJNIException()) {
+        return false;
+    }
+    methods.threadClass = static_cast<jclass>(env_->NewGlobalRef(threadClass));
+    if (!methods.threadClass) {
+        return false;
+    }
+    
+    contextLoaderMethods_ = methods;
+    return true;
+}
+
+void JarLoader::DiscardPreparedJarLocked() {
+    if (!stagedLoader_) {
+        return;
+    }
+    
+    // 尚未切换的加载器没有实例或缓存引用它，关闭后即可回收
+    JNILocalFrame localFrame(env_, 4);
+    jclass closeableClass = env_->FindClass("java/io/Closeable");
+    jmethodID closeMethod = closeableClass ? env_->GetMethodID(closeableClass, "close", "()V") : nullptr;
+    if (closeMethod && !CheckJNIException() && env_->IsInstanceOf(stagedLoader_, closeableClass)) {
+        env_->CallVoidMethod(stagedLoader_, closeMethod);
+        CheckJNIException();
+    }
+    env_->DeleteGlobalRef(stagedLoader_);
+    stagedLoader_ = nullptr;
+    LOG_DEBUG(L"Prepared JAR discarded: " << stagedJarPath_);
+    stagedJarPath_.clear();
+    stagedFingerprint_.clear();
+    stagedClassIndex_.Clear();
+}
+
+ErrorCode JarLoader::WarmUpPreparedJar(const WarmUpOptions& options, WarmUpResult& result) {
+    result = WarmUpResult();
+    
+    std::vector<std::string> classNames;
+    std::vector<RecordedInvocation> invocations;
+    jobject loader = nullptr;
+    JNIEnv* env = nullptr;
+    ContextLoaderMethods contextMethods;
+    size_t preloadThreads = options.preloadThreads;
+    {
+        std::lock_guard<std::mutex> lock(jniMutex_);
+        
+        if (!initialized_ || !AttachCurrentThread()) {
+            SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+            return ErrorCode::JVM_NOT_INITIALIZED;
+        }
+        if (!stagedLoader_) {
+            LOG_ERROR(L"No prepared JAR to warm up");
+            SetLastError(ErrorCode::INVALID_PARAMETER);
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        
+        if (options.preloadClasses) {
+            classNames.reserve(stagedClassIndex_.GetClassCount());
+            stagedClassIndex_.ForEachClass([&classNames](std::string_view name) {
+                // 模块与包描述不是可加载的类
+                std::string_view simpleName = name.substr(name.rfind('.') == std::string_view::npos ? 0 : name.rfind('.') + 1);
+                if (simpleName != "module-info" && simpleName != "package-info") {
+                    classNames.emplace_back(name);
+                }
+            });
+        }
+        // 重放会真实执行方法，只重放白名单中的调用
+        if (options.replayInvocations && options.replayFilter) {
+            for (const auto& invocation : recordedInvocations_) {
+                if (options.replayFilter(invocation.className, invocation.methodName)) {
+                    invocations.push_back(invocation);
                 }
-                env_->DeleteLocalRef(threadClass);
             }
         }
+        loader = env_->NewGlobalRef(stagedLoader_);
+        env = env_;
+        contextMethods = contextLoaderMethods_;
         
-        LOG_ERROR(L"Failed to set context class loader");
-        SetLastError(ErrorCode::JAVA_METHOD_CALL_FAILED);
-        return ErrorCode::JAVA_METHOD_CALL_FAILED;
+        // 未注册为parallel capable的加载器在loadClass上串行，多线程没有收益
+        if (!classNames.empty() && !ClassPreloader::IsParallelCapable(env_, loader)) {
+            LOG_WARNING(L"Class loader is not parallel capable, preloading on a single thread");
+            preloadThreads = 1;
+        }
+        if (!classNames.empty() && !preloader_.IsRunning() && preloader_.Start(jvm_) != ErrorCode::SUCCESS) {
+            LOG_WARNING(L"Class preloader unavailable, skipping class preloading");
+            classNames.clear();
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    // 预加载在预先附加的工作线程上进行，不持有jniMutex_，当前一代的调用不受影响
+    if (!classNames.empty()) {
+        PreloadResult preload = preloader_.Preload(loader, classNames, preloadThreads);
+        result.classesLoaded = preload.loaded;
+        result.classesFailed = preload.failed;
+        result.preloadThreads = preload.threads;
+        result.preloadMs = preload.durationMs;
         
-    } catch (const std::exception& e) {
-        LOG_ERROR(L"Exception during JAR loading: " << StringToWString(e.what()));
-        SetLastError(ErrorCode::UNKNOWN_ERROR);
-        return ErrorCode::UNKNOWN_ERROR;
+        if (options.initializeClasses) {
+            result.classesInitialized = preloader_.Initialize(loader, classNames).loaded;
+        }
+    }
+    
+    // 重放让解释器执行过真实的调用路径，并积累方法调用计数供JIT编译；
+    // 同样不持有jniMutex_，使用本线程的JNIEnv（env_属于最近加锁的线程），上下文类加载器为新一代
+    for (const auto& invocation : invocations) {
+        for (uint32_t i = 0; i < options.replayIterations; ++i) {
+            if (InvokeOnLoader(env, contextMethods, loader, invocation.className, invocation.methodName,
+                               invocation.args) == ErrorCode::SUCCESS) {
+                ++result.invocationsReplayed;
+            } else {
+                ++result.invocationsFailed;
+                break;
+            }
+        }
+    }
+    env->DeleteGlobalRef(loader);
+    
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(L"Warm-up completed in " << result.durationMs << L" ms: " << result.classesLoaded << L" classes loaded ("
+             << result.classesFailed << L" failed) on " << result.preloadThreads << L" threads in " << result.preloadMs
+             << L" ms, " << result.classesInitialized << L" initialized, " << result.invocationsReplayed << L" invocations replayed ("
+             << result.invocationsFailed << L" failed)");
+    SetLastError(ErrorCode::SUCCESS);
+    return ErrorCode::SUCCESS;
+}
+
+void JarLoader::StopPreloader() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    if (preloader_.IsRunning()) {
+        preloader_.Stop();
+        LOG_DEBUG(L"Class preloader stopped");
+    }
+}
+
+size_t JarLoader::GetRecordedInvocationCount() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return recordedInvocations_.size();
+}
+
+void JarLoader::RecordInvocation(const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+    // 每次成功调用都会经过这里：按哈希查找，已记录的同一调用移到最前，否则插入并淘汰最旧的
+    size_t hash = HashInvocation(className, methodName, args);
+    auto range = recordedIndex_.equal_range(hash);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        const RecordedInvocation& invocation = *entry->second;
+        if (invocation.className == className && invocation.methodName == methodName && invocation.args == args) {
+            recordedInvocations_.splice(recordedInvocations_.begin(), recordedInvocations_, entry->second);
+            return;
+        }
+    }
+    
+    recordedInvocations_.push_front(RecordedInvocation{className, methodName, args});
+    recordedIndex_.emplace(hash, recordedInvocations_.begin());
+    if (recordedInvocations_.size() > MAX_RECORDED_INVOCATIONS) {
+        auto oldest = std::prev(recordedInvocations_.end());
+        auto evicted = recordedIndex_.equal_range(HashInvocation(oldest->className, oldest->methodName, oldest->args));
+        for (auto entry = evicted.first; entry != evicted.second; ++entry) {
+            if (entry->second == oldest) {
+                recordedIndex_.erase(entry);
+                break;
+            }
+        }
+        recordedInvocations_.pop_back();
+    }
+}
+
+size_t JarLoader::HashInvocation(const std::string& className, const std::string& methodName,
+                                 const std::vector<std::string>& args) {
+    std::hash<std::string> hasher;
+    size_t h = hasher(className);
+    h ^= hasher(methodName) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    for (const auto& arg : args) {
+        h ^= hasher(arg) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+ErrorCode JarLoader::InvokeOnLoader(JNIEnv* env, const ContextLoaderMethods& contextMethods, jobject loader,
+                                    const std::string& className, const std::string& methodName,
+                                    const std::vector<std::string>& args) {
+    ContextClassLoaderScope contextLoader(env, contextMethods, loader);
+    JNILocalFrame localFrame(env, static_cast<jint>(args.size() + 16));
+    
+    jclass clazz = LoadClassFrom(env, loader, className);
+    if (!clazz) {
+        return ErrorCode::JAVA_CLASS_NOT_FOUND;
+    }
+    
+    // 签名规则与CallJavaMethod一致：main接受String[]，其他方法无参数
+    bool isMain = methodName == "main";
+    const char* signature = isMain ? "([Ljava/lang/String;)V" : "()V";
+    jmethodID staticMethod = env->GetStaticMethodID(clazz, methodName.c_str(), signature);
+    if (!staticMethod) {
+        env->ExceptionClear();
+    }
+    
+    if (isMain) {
+        if (!staticMethod) {
+            return ErrorCode::JAVA_METHOD_NOT_FOUND;
+        }
+        jclass stringClass = env->FindClass("java/lang/String");
+        jobjectArray argsArray = env->NewObjectArray(static_cast<jsize>(args.size()), stringClass, nullptr);
+        for (size_t i = 0; argsArray && i < args.size(); ++i) {
+            env->SetObjectArrayElement(argsArray, static_cast<jsize>(i), env->NewStringUTF(args[i].c_str()));
+        }
+        env->CallStaticVoidMethod(clazz, staticMethod, argsArray);
+    } else if (staticMethod) {
+        env->CallStaticVoidMethod(clazz, staticMethod);
+    } else {
+        // 实例方法：每次重放使用新实例，不进入实例缓存
+        jmethodID method = env->GetMethodID(clazz, methodName.c_str(), signature);
+        jmethodID constructor = method ? env->GetMethodID(clazz, "<init>", "()V") : nullptr;
+        if (!method || !constructor) {
+            env->ExceptionClear();
+            return ErrorCode::JAVA_METHOD_NOT_FOUND;
+        }
+        jobject instance = env->NewObject(clazz, constructor);
+        if (instance) {
+            env->CallVoidMethod(instance, method);
+        }
+    }
+    
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOG_DEBUG(L"Replayed invocation threw: " << StringToWString(className + "." + methodName));
+        return ErrorCode::JAVA_EXCEPTION;
+    }
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarLoader::CaptureHandoffState(const std::string& className, StateHandoffResult& result) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    result = StateHandoffResult();
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    if (!classLoader_) {
+        return ErrorCode::SUCCESS;
+    }
+    
+    JNILocalFrame localFrame(env_, 16);
+    
+    jclass clazz = nullptr;
+    jmethodID onUnload = FindLifecycleMethod(className, "onUnload", "()Ljava/nio/ByteBuffer;", clazz);
+    if (!onUnload) {
+        return ErrorCode::SUCCESS;
+    }
+    result.supported = true;
+    
+    auto start = std::chrono::steady_clock::now();
+    jobject state;
+    {
+        ContextClassLoaderScope contextLoader(env_, contextLoaderMethods_, classLoader_);
+        state = env_->CallStaticObjectMethod(clazz, onUnload);
+    }
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (env_->ExceptionCheck()) {
+        env_->ExceptionDescribe();
+        env_->ExceptionClear();
+        LOG_WARNING(L"onUnload threw in generation " << generation_ << L", no state handed off");
+        return ErrorCode::JAVA_EXCEPTION;
+    }
+    
+    // ByteBuffer及其底层数组由引导类加载器定义，保留它不会阻止旧的一代被回收
+    if (handoffState_) {
+        LOG_WARNING(L"Previous handoff state not yet delivered, discarding state from generation " << generation_);
+        DescribeHandoffState(handoffState_, result);
+        return ErrorCode::SUCCESS;
+    }
+    if (state) {
+        handoffState_ = env_->NewGlobalRef(state);
+        DescribeHandoffState(handoffState_, result);
+    }
+    
+    LOG_INFO(L"onUnload completed in " << result.durationMs << L" ms, state "
+             << (result.hasState ? std::to_wstring(result.bytes) + L" bytes" : std::wstring(L"empty")));
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarLoader::DeliverHandoffState(const std::string& className, StateHandoffResult& result) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    result = StateHandoffResult();
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    if (!classLoader_) {
+        return ErrorCode::SUCCESS;
+    }
+    
+    JNILocalFrame localFrame(env_, 16);
+    
+    jclass clazz = nullptr;
+    jmethodID onLoad = FindLifecycleMethod(className, "onLoad", "(Ljava/nio/ByteBuffer;)V", clazz);
+    if (!onLoad) {
+        // 新的一代不接收状态，状态随之丢弃
+        if (handoffState_) {
+            LOG_WARNING(L"Generation " << generation_ << L" has no onLoad, discarding handoff state");
+            env_->DeleteGlobalRef(handoffState_);
+            handoffState_ = nullptr;
+        }
+        return ErrorCode::SUCCESS;
+    }
+    result.supported = true;
+    if (handoffState_) {
+        DescribeHandoffState(handoffState_, result);
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    {
+        ContextClassLoaderScope contextLoader(env_, contextLoaderMethods_, classLoader_);
+        env_->CallStaticVoidMethod(clazz, onLoad, handoffState_);
+    }
+    result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (env_->ExceptionCheck()) {
+        env_->ExceptionDescribe();
+        env_->ExceptionClear();
+        LOG_ERROR(L"onLoad threw in generation " << generation_ << L", keeping handoff state");
+        return ErrorCode::JAVA_EXCEPTION;
+    }
+    
+    if (handoffState_) {
+        env_->DeleteGlobalRef(handoffState_);
+        handoffState_ = nullptr;
+    }
+    LOG_INFO(L"onLoad completed in " << result.durationMs << L" ms for generation " << generation_);
+    return ErrorCode::SUCCESS;
+}
+
+jmethodID JarLoader::FindLifecycleMethod(const std::string& className, const char* name, const char* signature, jclass& clazz) {
+    clazz = nullptr;
+    if (classIndex_.IsBuilt() && !classIndex_.ContainsClass(className)) {
+        return nullptr;
+    }
+    
+    clazz = LoadClassFrom(env_, classLoader_, className);
+    if (!clazz) {
+        return nullptr;
+    }
+    
+    // 生命周期方法是可选的，没有声明时不记录错误
+    jmethodID method = env_->GetStaticMethodID(clazz, name, signature);
+    if (!method) {
+        env_->ExceptionClear();
+    }
+    return method;
+}
+
+void JarLoader::DescribeHandoffState(jobject buffer, StateHandoffResult& result) {
+    result.hasState = buffer != nullptr;
+    if (!buffer) {
+        return;
+    }
+    
+    jclass bufferClass = env_->FindClass("java/nio/Buffer");
+    jmethodID remaining = bufferClass ? env_->GetMethodID(bufferClass, "remaining", "()I") : nullptr;
+    jmethodID isDirect = bufferClass ? env_->GetMethodID(bufferClass, "isDirect", "()Z") : nullptr;
+    if (remaining && isDirect) {
+        result.bytes = env_->CallIntMethod(buffer, remaining);
+        result.direct = env_->CallBooleanMethod(buffer, isDirect) == JNI_TRUE;
     }
+    if (bufferClass) {
+        env_->DeleteLocalRef(bufferClass);
+    }
+    CheckJNIException();
 }
 
 ErrorCode JarLoader::UnloadJar() {
@@ -170,10 +913,19 @@ ErrorCode JarLoader::UnloadJar() {
         return ErrorCode::SUCCESS;
     }
     
+    if (!AttachCurrentThread()) {
+        SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
+        return ErrorCode::JVM_NOT_INITIALIZED;
+    }
+    
     try {
-        // 注意：Java中卸载类加载器是复杂的，这里只是简单的清理
+        // 类加载器退役后，只有在没有任何类、实例或线程引用它时才会连同其类一起被回收
+        canary_.Stop();
+        RetireStandbyGeneration();
+        RetireClassLoader();
         currentJarPath_.clear();
-        classCache_.clear();
+        currentFingerprint_.clear();
+        classIndex_.Clear();
         LOG_INFO(L"JAR unloaded");
         SetLastError(ErrorCode::SUCCESS);
         return ErrorCode::SUCCESS;
@@ -186,9 +938,10 @@ ErrorCode JarLoader::UnloadJar() {
 }
 
 ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+    CanaryNotifier notifier(*this);
     std::lock_guard<std::mutex> lock(jniMutex_);
     
-    if (!initialized_) {
+    if (!initialized_ || !AttachCurrentThread()) {
         LOG_ERROR(L"JVM not initialized");
         SetLastError(ErrorCode::JVM_NOT_INITIALIZED);
         return ErrorCode::JVM_NOT_INITIALIZED;
@@ -207,7 +960,63 @@ ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::str
         return ErrorCode::INVALID_PARAMETER;
     }
     
+    if (canary_.IsActive()) {
+        return CallWithCanary(className, methodName, args);
+    }
+    return CallJavaMethodLocked(className, methodName, args);
+}
+
+ErrorCode JarLoader::CallWithCanary(const std::string& className, const std::string& methodName,
+                                    const std::vector<std::string>& args) {
+    // 未被采样的调用临时换入备用的旧一代执行
+    bool toCanary = canary_.RouteToCanary();
+    auto start = std::chrono::steady_clock::now();
+    if (!toCanary) {
+        SwapWithStandby();
+    }
+    ErrorCode result = CallJavaMethodLocked(className, methodName, args);
+    if (!toCanary) {
+        SwapWithStandby();
+    }
+    uint64_t micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    
+    canary_.Record(toCanary, micros, result == ErrorCode::SUCCESS);
+    CanaryVerdict verdict = canary_.Evaluate(false);
+    if (verdict != CanaryVerdict::PENDING) {
+        FinishCanary(verdict);
+    }
+    SetLastError(result);
+    return result;
+}
+
+ErrorCode JarLoader::CallJavaMethodLocked(const std::string& className, const std::string& methodName,
+                                          const std::vector<std::string>& args) {
+    // 先查本地类名索引，JAR中不存在的类无需经过FindClass抛出异常
+    if (classIndex_.IsBuilt() && !classIndex_.ContainsClass(className)) {
+        if (!classIndex_.ContainsPackage(ClassIndex::PackageOf(className))) {
+            LOG_ERROR(L"Package not found in JAR: " << StringToWString(std::string(ClassIndex::PackageOf(className))));
+        }
+        LOG_ERROR(L"Class not found in JAR: " << StringToWString(className));
+        SetLastError(ErrorCode::JAVA_CLASS_NOT_FOUND);
+        return ErrorCode::JAVA_CLASS_NOT_FOUND;
+    }
+    
     try {
+        // 调用期间上下文类加载器指向执行调用的一代（灰度时可能是临时换入的旧一代）
+        ContextClassLoaderScope contextLoader(env_, contextLoaderMethods_, classLoader_);
+        
+        // 命中缓存的调用器时跳过类、方法与实例的查找
+        ErrorCode handleResult;
+        if (invocationPath_ == InvocationPath::METHOD_HANDLE &&
+            CallViaMethodHandle(className, methodName, args, handleResult)) {
+            SetLastError(handleResult);
+            return handleResult;
+        }
+        
+        // 类、参数数组与实例的局部引用在返回时一并释放
+        JNILocalFrame localFrame(env_, static_cast<jint>(args.size() + 16));
+        
         // 查找类
         jclass clazz = FindClass(className);
         if (!clazz) {
@@ -223,7 +1032,7 @@ ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::str
         }
         
         // 查找方法
-        jmethodID method = FindMethod(clazz, methodName, signature);
+        jmethodID method = FindMethod(clazz, className, methodName, signature);
         if (!method) {
             LOG_ERROR(L"Failed to find method: " << StringToWString(methodName));
             SetLastError(ErrorCode::JAVA_METHOD_NOT_FOUND);
@@ -246,12 +1055,13 @@ ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::str
         if (methodName == "main") {
             env_->CallStaticVoidMethod(clazz, method, argsArray);
         } else {
-            // 创建类实例并调用实例方法
-            jmethodID constructor = env_->GetMethodID(clazz, "<init>", "()V");
-            if (constructor) {
-                jobject instance = env_->NewObject(clazz, constructor);
-                if (instance) {
-                    env_->CallVoidMethod(instance, method);
+            // 按实例策略获取类实例并调用实例方法
+            bool isLocalRef = false;
+            jobject instance = AcquireInstance(clazz, className, isLocalRef);
+            if (instance) {
+                env_->CallVoidMethod(instance, method);
+                if (isLocalRef) {
+                    env_->DeleteLocalRef(instance);
                 }
             } else {
                 // 尝试作为静态方法调用
@@ -268,6 +1078,7 @@ ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::str
             return ErrorCode::JAVA_EXCEPTION;
         }
         
+        OnCallSucceeded(className, methodName, args);
         LOG_INFO(L"Java method called successfully: " << StringToWString(className + "." + methodName));
         SetLastError(ErrorCode::SUCCESS);
         return ErrorCode::SUCCESS;
@@ -279,23 +1090,83 @@ ErrorCode JarLoader::CallJavaMethod(const std::string& className, const std::str
     }
 }
 
-void JarLoader::SetupJVMArgs(JavaVMInitArgs& vmArgs, std::vector<JavaVMOption>& options, const std::wstring& jarPath) {
-    vmArgs.version = JNI_VERSION_1_8;
-    vmArgs.nOptions = 0;
-    vmArgs.options = nullptr;
-    vmArgs.ignoreUnrecognized = JNI_FALSE;
+bool JarLoader::CallViaMethodHandle(const std::string& className, const std::string& methodName,
+                                    const std::vector<std::string>& args, ErrorCode& result) {
+    bool isMain = methodName == "main";
+    auto policyIt = instancePolicies_.find(className);
+    InstancePolicy policy = policyIt != instancePolicies_.end() ? policyIt->second : defaultInstancePolicy_;
     
-    if (!jarPath.empty()) {
-        std::string classPath = "-Djava.class.path=" + WStringToString(jarPath);
-        options.push_back({const_cast<char*>(classPath.c_str()), nullptr});
-        vmArgs.nOptions = options.size();
-        vmArgs.options = options.data();
+    // 每线程实例绑定在句柄中，因此每个线程各有一个调用器
+    std::string key = className + "." + methodName;
+    if (!isMain && policy == InstancePolicy::PER_THREAD) {
+        key += "#" + std::to_string(Platform::GetCurrentThreadId());
+    }
+    if (methodHandles_.IsUnsupported(key)) {
+        return false;
+    }
+    
+    JNILocalFrame localFrame(env_, static_cast<jint>(args.size() + 16));
+    
+    jobject invoker = methodHandles_.Find(key);
+    if (!invoker) {
+        // 首次调用：解析并缓存，找不到类时由JNI路径报告错误
+        jclass clazz = FindClass(className);
+        if (!clazz) {
+            return false;
+        }
+        jobject receiver = nullptr;
+        if (!isMain && policy != InstancePolicy::PER_CALL) {
+            bool isLocalRef = false;
+            receiver = AcquireInstance(clazz, className, isLocalRef);
+        }
+        invoker = methodHandles_.Resolve(env_, key, clazz, methodName, isMain, receiver);
+        if (!invoker) {
+            return false;
+        }
+    }
+    
+    jobjectArray argsArray = nullptr;
+    if (isMain) {
+        jclass stringClass = env_->FindClass("java/lang/String");
+        argsArray = env_->NewObjectArray(static_cast<jsize>(args.size()), stringClass, nullptr);
+        for (size_t i = 0; argsArray && i < args.size(); ++i) {
+            env_->SetObjectArrayElement(argsArray, static_cast<jsize>(i), env_->NewStringUTF(args[i].c_str()));
+        }
     }
+    
+    methodHandles_.Invoke(env_, invoker, argsArray);
+    if (env_->ExceptionCheck()) {
+        env_->ExceptionDescribe();
+        env_->ExceptionClear();
+        LOG_ERROR(L"Java exception occurred during method handle call");
+        result = ErrorCode::JAVA_EXCEPTION;
+        return true;
+    }
+    
+    OnCallSucceeded(className, methodName, args);
+    LOG_DEBUG(L"Java method called via method handle: " << StringToWString(key));
+    result = ErrorCode::SUCCESS;
+    return true;
+}
+
+void JarLoader::OnCallSucceeded(const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+    // 记录启动到首次成功调用的耗时
+    if (timeToFirstCallMs_ < 0) {
+        timeToFirstCallMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin_).count();
+        LOG_INFO(L"Time to first Java method call: " << timeToFirstCallMs_ << L" ms");
+    }
+    
+    RecordInvocation(className, methodName, args);
 }
 
 jclass JarLoader::FindClass(const std::string& className) {
     if (!env_) return nullptr;
     
+    // JNI的FindClass只能看到系统类加载器，JAR中的类必须经由当前类加载器加载
+    if (classLoader_) {
+        return LoadClassFrom(env_, classLoader_, className);
+    }
+    
     // 将点号替换为斜杠
     std::string jniClassName = className;
     for (char& c : jniClassName) {
@@ -305,13 +1176,91 @@ jclass JarLoader::FindClass(const std::string& className) {
     return env_->FindClass(jniClassName.c_str());
 }
 
-jmethodID JarLoader::FindMethod(jclass clazz, const std::string& methodName, const std::string& signature) {
+jclass JarLoader::LoadClassFrom(JNIEnv* env, jobject loader, const std::string& className) {
+    if (!env || !loader) {
+        return nullptr;
+    }
+    
+    jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+    jmethodID loadClassMethod = classLoaderClass ?
+        env->GetMethodID(classLoaderClass, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;") : nullptr;
+    if (classLoaderClass) {
+        env->DeleteLocalRef(classLoaderClass);
+    }
+    if (!loadClassMethod || CheckJNIException(env)) {
+        return nullptr;
+    }
+    
+    std::string binaryName = className;
+    for (char& c : binaryName) {
+        if (c == '/') c = '.';
+    }
+    
+    jstring nameString = env->NewStringUTF(binaryName.c_str());
+    if (!nameString || CheckJNIException(env)) {
+        return nullptr;
+    }
+    jobject clazz = env->CallObjectMethod(loader, loadClassMethod, nameString);
+    env->DeleteLocalRef(nameString);
+    if (CheckJNIException(env)) {
+        return nullptr;
+    }
+    return static_cast<jclass>(clazz);
+}
+
+bool JarLoader::AttachCurrentThread() {
+    if (!jvm_) {
+        return false;
+    }
+    
+    JNIEnv* env = nullptr;
+    jint result = jvm_->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8);
+    if (result == JNI_EDETACHED) {
+        // 以守护线程附加，不阻止JVM退出
+        result = jvm_->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr);
+        if (result == JNI_OK) {
+            t_attachedByLoader = true;
+            LOG_DEBUG(L"Attached thread " << Platform::GetCurrentThreadId() << L" to JVM");
+        }
+    }
+    
+    if (result != JNI_OK || !env) {
+        LOG_ERROR(L"Failed to attach current thread to JVM, error code: " << result);
+        return false;
+    }
+    
+    env_ = env;
+    return true;
+}
+
+void JarLoader::DetachCurrentThread() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!jvm_) {
+        return;
+    }
+    
+    // 每线程实例只在重载时释放的话，长期运行的进程中每个结束的线程都会留下全局引用
+    JNIEnv* env = nullptr;
+    if (jvm_->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) == JNI_OK && env) {
+        env_ = env;
+        ReleaseThreadInstances(Platform::GetCurrentThreadId());
+    }
+    
+    if (t_attachedByLoader) {
+        jvm_->DetachCurrentThread();
+        t_attachedByLoader = false;
+        LOG_DEBUG(L"Detached thread " << Platform::GetCurrentThreadId() << L" from JVM");
+    }
+}
+
+jmethodID JarLoader::FindMethod(jclass clazz, const std::string& className, const std::string& methodName, const std::string& signature) {
     if (!env_ || !clazz) {
         return nullptr;
     }
     
-    // 创建缓存键：方法名 + 签名
-    std::string cacheKey = methodName + ":" + signature;
+    // 创建缓存键：类名 + 方法名 + 签名（不同类的同名方法ID不同）
+    std::string cacheKey = className + "." + methodName + ":" + signature;
     
     // 检查缓存
     auto it = methodCache_.find(cacheKey);
@@ -337,30 +1286,62 @@ jmethodID JarLoader::FindMethod(jclass clazz, const std::string& methodName, con
     return method;
 }
 
-// 新增的辅助方法实现
 ErrorCode JarLoader::SetupJVMArgs(JavaVMInitArgs& vmArgs, std::vector<JavaVMOption>& options, const std::wstring& jarPath) {
     try {
         options.clear();
         
-        // 基本JVM选项
-        JavaVMOption option1;
-        option1.optionString = const_cast<char*>("-Djava.class.path=.");
-        options.push_back(option1);
+        // 选项字符串保存在成员中，保证在JNI_CreateJavaVM调用期间有效
+        jvmOptionStrings_.clear();
         
-        // 如果提供了JAR路径，添加到classpath
-        std::string jarPathStr;
-        if (!jarPath.empty()) {
-            jarPathStr = WStringToString(jarPath);
-            std::string classpathOption = "-Djava.class.path=" + jarPathStr;
-            JavaVMOption jarOption;
-            jarOption.optionString = const_cast<char*>(classpathOption.c_str());
-            options.push_back(jarOption);
+        // 类路径：优先使用传入的JAR，其次是启动配置，最后是当前目录
+        std::wstring classPath = !jarPath.empty() ? jarPath : jvmStartupOptions_.classPath;
+        jvmOptionStrings_.push_back("-Djava.class.path=" + (classPath.empty() ? std::string(".") : WStringToString(classPath)));
+        jvmClassPath_ = classPath;
+        
+        // AppCDS：首次运行在退出时转储动态归档，后续运行映射该归档
+        // 只有内置类加载器（类路径上）的类会被归档，即宿主与依赖库；
+        // 插件JAR由独立的类加载器定义，不放在类路径上（见PrepareJarLocked中的检查）
+        const std::wstring& archivePath = jvmStartupOptions_.cdsArchivePath;
+        CdsMode cdsMode = jvmStartupOptions_.cdsMode;
+        if (cdsMode != CdsMode::DISABLED && archivePath.empty()) {
+            LOG_WARNING(L"CDS enabled but no archive path configured, CDS disabled");
+            cdsMode = CdsMode::DISABLED;
+        }
+        
+        if (cdsMode == CdsMode::AUTO) {
+            cdsMode = FileExists(archivePath) ? CdsMode::USE : CdsMode::DUMP;
+        }
+        
+        if (cdsMode == CdsMode::USE) {
+            // -Xshare:auto：归档不可用（JDK版本或类路径不匹配）时回退到正常启动
+            jvmOptionStrings_.push_back("-XX:SharedArchiveFile=" + WStringToString(archivePath));
+            jvmOptionStrings_.push_back("-Xshare:auto");
+            LOG_INFO(L"Using CDS archive: " << archivePath);
+        } else if (cdsMode == CdsMode::DUMP) {
+            // 动态归档需要JDK 13及以上
+            jvmOptionStrings_.push_back("-XX:ArchiveClassesAtExit=" + WStringToString(archivePath));
+            LOG_INFO(L"CDS archive will be dumped at JVM exit: " << archivePath);
+        }
+        
+        // 用户配置的额外选项放在最后，可以覆盖上面的默认值
+        for (const auto& option : jvmStartupOptions_.options) {
+            if (!option.empty()) {
+                jvmOptionStrings_.push_back(option);
+            }
+        }
+        
+        for (auto& optionString : jvmOptionStrings_) {
+            JavaVMOption option;
+            option.optionString = const_cast<char*>(optionString.c_str());
+            option.extraInfo = nullptr;
+            options.push_back(option);
+            LOG_DEBUG(L"JVM option: " << StringToWString(optionString));
         }
         
         vmArgs.version = JNI_VERSION_1_8;
         vmArgs.nOptions = static_cast<jint>(options.size());
         vmArgs.options = options.data();
-        vmArgs.ignoreUnrecognized = JNI_FALSE;
+        vmArgs.ignoreUnrecognized = jvmStartupOptions_.ignoreUnrecognized ? JNI_TRUE : JNI_FALSE;
         
         return ErrorCode::SUCCESS;
     } catch (const std::exception& e) {
@@ -369,16 +1350,50 @@ ErrorCode JarLoader::SetupJVMArgs(JavaVMInitArgs& vmArgs, std::vector<JavaVMOpti
     }
 }
 
-bool JarLoader::CheckJNIException() {
-    if (!env_) {
+void JarLoader::SetJvmStartupOptions(const JvmStartupOptions& options) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    jvmStartupOptions_ = options;
+}
+
+bool JarLoader::ClassPathContainsJar(const std::wstring& classPath, const std::wstring& jarPath) {
+    if (jarPath.empty()) {
         return false;
     }
     
-    if (env_->ExceptionCheck()) {
-        jthrowable exception = env_->ExceptionOccurred();
+    std::filesystem::path jar = Platform::ToFilesystemPath(jarPath).lexically_normal();
+    size_t begin = 0;
+    while (begin <= classPath.size()) {
+        size_t end = classPath.find(Platform::PATH_LIST_SEPARATOR, begin);
+        if (end == std::wstring::npos) {
+            end = classPath.size();
+        }
+        std::wstring entry = classPath.substr(begin, end - begin);
+        begin = end + 1;
+        if (entry.empty()) {
+            continue;
+        }
+        
+        // "dir/*"展开为目录下的全部JAR
+        std::filesystem::path entryPath = Platform::ToFilesystemPath(entry).lexically_normal();
+        const std::filesystem::path& candidate = entryPath.filename() == L"*" ? jar.parent_path() : jar;
+        const std::filesystem::path& expected = entryPath.filename() == L"*" ? entryPath.parent_path() : entryPath;
+        if (candidate == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JarLoader::CheckJNIException(JNIEnv* env) {
+    if (!env) {
+        return false;
+    }
+    
+    if (env->ExceptionCheck()) {
+        jthrowable exception = env->ExceptionOccurred();
         if (exception) {
-            env_->ExceptionDescribe();
-            env_->ExceptionClear();
+            env->ExceptionDescribe();
+            env->ExceptionClear();
             LOG_ERROR(L"JNI exception detected and cleared");
         }
         return true;
@@ -500,13 +1515,7 @@ ErrorCode JarLoader::CreateClassLoader(const std::wstring& jarPath) {
             return ErrorCode::OBJECT_CREATION_FAILED;
         }
         
-        // 清理旧的ClassLoader
-        if (classLoader_) {
-            env_->DeleteGlobalRef(classLoader_);
-        }
-        
-        // 保存新的ClassLoader为全局引用
-        classLoader_ = env_->NewGlobalRef(newClassLoader);
+        StageClassLoader(newClassLoader);
         
         // 清理本地引用
         env_->DeleteLocalRef(jarPathJStr);
@@ -525,6 +1534,199 @@ ErrorCode JarLoader::CreateClassLoader(const std::wstring& jarPath) {
     }
 }
 
+ErrorCode JarLoader::CreateSnapshotClassLoader(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot) {
+    if (!env_ || !snapshot) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    SnapshotRegistry& registry = SnapshotRegistry::GetInstance();
+    jlong handle = registry.Register(std::move(snapshot));
+    if (handle == 0) {
+        LOG_ERROR(L"Failed to register JAR snapshot: " << jarPath);
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    
+    // 快照此后归加载器所有，加载器close()或被回收时释放
+    jobject newClassLoader = registry.CreateClassLoader(env_, handle, jarPath, nullptr);
+    if (!newClassLoader) {
+        registry.Release(handle);
+        return ErrorCode::OBJECT_CREATION_FAILED;
+    }
+    
+    StageClassLoader(newClassLoader);
+    env_->DeleteLocalRef(newClassLoader);
+    
+    LOG_INFO(L"Snapshot ClassLoader created successfully for: " << jarPath);
+    return ErrorCode::SUCCESS;
+}
+
+void JarLoader::StageClassLoader(jobject newClassLoader) {
+    // 之前准备但未切换的一代被新的替代
+    DiscardPreparedJarLocked();
+    stagedLoader_ = env_->NewGlobalRef(newClassLoader);
+}
+
+void JarLoader::InstallClassLoader(jobject newClassLoader, bool keepPrevious) {
+    // 之前未确认的备用一代不再需要
+    RetireStandbyGeneration();
+    
+    if (keepPrevious && classLoader_) {
+        // 旧的一代连同缓存原样转为备用，当前一代从空的状态开始
+        SwapWithStandby();
+    } else {
+        // 旧的ClassLoader及其代的实例、方法缓存一并退役
+        RetireClassLoader();
+    }
+    
+    // 保存新的ClassLoader为全局引用，进入新的一代
+    classLoader_ = env_->NewGlobalRef(newClassLoader);
+    generation_ = ++generationCounter_;
+}
+
+void JarLoader::SwapWithStandby() {
+    std::swap(classLoader_, standby_.loader);
+    std::swap(generation_, standby_.generation);
+    currentJarPath_.swap(standby_.jarPath);
+    currentFingerprint_.swap(standby_.fingerprint);
+    std::swap(classIndex_, standby_.classIndex);
+    classCache_.swap(standby_.classCache);
+    methodCache_.swap(standby_.methodCache);
+    methodHandles_.SwapEntries(standbyMethodHandles_);
+}
+
+void JarLoader::RetireStandbyGeneration() {
+    if (!standby_.loader) {
+        return;
+    }
+    
+    // RetireClassLoader作用于当前一代：临时换入备用的一代，退役后换回
+    SwapWithStandby();
+    RetireClassLoader();
+    SwapWithStandby();
+    standby_ = StandbyGeneration();
+}
+
+void JarLoader::RetireClassLoader() {
+    // 实例与方法ID属于旧代的类，不能用于新加载的类，且全局引用会阻止旧代被回收
+    ReleaseInstances(generation_);
+    methodCache_.clear();
+    methodHandles_.Clear(env_);
+    if (env_) {
+        for (auto& pair : classCache_) {
+            if (pair.second) {
+                env_->DeleteGlobalRef(pair.second);
+            }
+        }
+    }
+    classCache_.clear();
+    
+    if (!classLoader_ || !env_) {
+        return;
+    }
+    
+    // 上下文类加载器只在调用期间指向某一代（ContextClassLoaderScope），无需恢复任何线程的上下文类加载器
+    JNILocalFrame localFrame(env_, 16);
+    
+    // 关闭加载器：URLClassLoader释放JAR文件句柄，SnapshotClassLoader释放本地快照
+    // 已加载的类仍可使用，只是不能再加载新类
+    jclass closeableClass = env_->FindClass("java/io/Closeable");
+    if (closeableClass && !CheckJNIException() && env_->IsInstanceOf(classLoader_, closeableClass)) {
+        jmethodID closeMethod = env_->GetMethodID(closeableClass, "close", "()V");
+        if (closeMethod && !CheckJNIException()) {
+            env_->CallVoidMethod(classLoader_, closeMethod);
+            if (CheckJNIException()) {
+                LOG_WARNING(L"Failed to close class loader of generation " << generation_);
+            }
+        }
+    }
+    
+    // 改为弱全局引用跟踪，加载器被回收后才算真正卸载
+    jweak weakLoader = env_->NewWeakGlobalRef(classLoader_);
+    env_->DeleteGlobalRef(classLoader_);
+    classLoader_ = nullptr;
+    if (weakLoader) {
+        retiredGenerations_.push_back({generation_, weakLoader, currentJarPath_, false});
+    }
+    LOG_DEBUG(L"Class loader generation " << generation_ << L" retired");
+    
+    PollRetiredGenerations();
+}
+
+GenerationStats JarLoader::PollRetiredGenerations() {
+    GenerationStats stats;
+    stats.current = generation_;
+    
+    if (env_) {
+        auto it = retiredGenerations_.begin();
+        while (it != retiredGenerations_.end()) {
+            if (env_->IsSameObject(it->loader, nullptr)) {
+                env_->DeleteWeakGlobalRef(it->loader);
+                ++collectedGenerations_;
+                LOG_DEBUG(L"Class loader generation " << it->generation << L" collected");
+                it = retiredGenerations_.erase(it);
+                continue;
+            }
+            
+            // 落后多代仍可达：通常是目标代码启动的线程、注册到系统类的回调或ThreadLocal持有了旧代
+            uint64_t age = generationCounter_ - it->generation;
+            if (age >= generationLeakThreshold_) {
+                ++stats.leaked;
+                if (!it->reported) {
+                    LOG_WARNING(L"Class loader generation " << it->generation << L" (" << it->jarPath
+                                << L") is still reachable " << age << L" generations after retirement");
+                    it->reported = true;
+                }
+            }
+            ++it;
+        }
+    }
+    
+    stats.retired = retiredGenerations_.size();
+    stats.collected = collectedGenerations_;
+    return stats;
+}
+
+GenerationStats JarLoader::GetGenerationStats() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        GenerationStats stats;
+        stats.current = generation_;
+        stats.retired = retiredGenerations_.size();
+        stats.collected = collectedGenerations_;
+        return stats;
+    }
+    return PollRetiredGenerations();
+}
+
+bool JarLoader::SampleJvmTelemetry(JvmMemorySample& sample) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (!initialized_ || !AttachCurrentThread()) {
+        return false;
+    }
+    return telemetry_.Sample(env_, sample);
+}
+
+GenerationStats JarLoader::CollectRetiredGenerations() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    
+    if (initialized_ && AttachCurrentThread()) {
+        JNILocalFrame localFrame(env_, 4);
+        jclass systemClass = env_->FindClass("java/lang/System");
+        jmethodID gcMethod = systemClass ? env_->GetStaticMethodID(systemClass, "gc", "()V") : nullptr;
+        if (gcMethod && !CheckJNIException()) {
+            env_->CallStaticVoidMethod(systemClass, gcMethod);
+            CheckJNIException();
+        }
+    }
+    
+    GenerationStats stats = PollRetiredGenerations();
+    LOG_INFO(L"Class loader generations: current " << stats.current << L", retired " << stats.retired
+             << L", collected " << stats.collected << L", leaked " << stats.leaked);
+    return stats;
+}
+
 void JarLoader::Cleanup() {
     std::lock_guard<std::mutex> lock(jniMutex_);
     
@@ -542,11 +1744,57 @@ void JarLoader::Cleanup() {
         // 清理方法缓存
         methodCache_.clear();
         
-        // 清理ClassLoader
+        // 清理类名索引
+        classIndex_.Clear();
+        
+        // 清理实例缓存
+        ReleaseInstances();
+        
+        // 清理ClassLoader、未切换的一代、备用的一代与退役代的弱引用
+        if (env_) {
+            if (standby_.loader) {
+                env_->DeleteGlobalRef(standby_.loader);
+            }
+            for (auto& pair : standby_.classCache) {
+                if (pair.second) {
+                    env_->DeleteGlobalRef(pair.second);
+                }
+            }
+        }
+        standby_ = StandbyGeneration();
+        standbyMethodHandles_.Release(env_);
+        canary_.Stop();
+        canaryNotifications_.clear();
+        canaryNotificationPending_ = false;
+        if (stagedLoader_ && env_) {
+            env_->DeleteGlobalRef(stagedLoader_);
+            stagedLoader_ = nullptr;
+        }
         if (classLoader_ && env_) {
             env_->DeleteGlobalRef(classLoader_);
             classLoader_ = nullptr;
         }
+        if (env_) {
+            for (auto& retired : retiredGenerations_) {
+                env_->DeleteWeakGlobalRef(retired.loader);
+            }
+        }
+        retiredGenerations_.clear();
+        
+        // 清理缓存的MXBean、Thread类、MethodHandle调用器与未交付的状态
+        telemetry_.Release(env_);
+        if (contextLoaderMethods_.threadClass && env_) {
+            env_->DeleteGlobalRef(contextLoaderMethods_.threadClass);
+        }
+        contextLoaderMethods_ = ContextLoaderMethods();
+        methodHandles_.Release(env_);
+        if (handoffState_ && env_) {
+            env_->DeleteGlobalRef(handoffState_);
+        }
+        handoffState_ = nullptr;
+        
+        // 停止预加载线程
+        preloader_.Stop();
         
         // 分离线程（如果是附加的）
         if (jvm_ && initialized_) {
@@ -566,6 +1814,144 @@ void JarLoader::Cleanup() {
     }
 }
 
+void JarLoader::SetInstancePolicy(const std::string& className, InstancePolicy policy) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    instancePolicies_[className] = policy;
+    LOG_DEBUG(L"Instance policy for " << StringToWString(className) << L" set to " << static_cast<int>(policy));
+}
+
+void JarLoader::SetDefaultInstancePolicy(InstancePolicy policy) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    defaultInstancePolicy_ = policy;
+}
+
+InstancePolicy JarLoader::GetInstancePolicy(const std::string& className) {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    auto it = instancePolicies_.find(className);
+    return it != instancePolicies_.end() ? it->second : defaultInstancePolicy_;
+}
+
+size_t JarLoader::GetCachedInstanceCount() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return instanceCache_.size();
+}
+
+size_t JarLoader::GetCachedMethodHandleCount() {
+    std::lock_guard<std::mutex> lock(jniMutex_);
+    return methodHandles_.GetCount();
+}
+
+jobject JarLoader::AcquireInstance(jclass clazz, const std::string& className, bool& isLocalRef) {
+    isLocalRef = false;
+    if (!env_ || !clazz) {
+        return nullptr;
+    }
+    
+    auto policyIt = instancePolicies_.find(className);
+    InstancePolicy policy = policyIt != instancePolicies_.end() ? policyIt->second : defaultInstancePolicy_;
+    
+    // 非每次调用策略：先查缓存
+    InstanceKey key{generation_, className, 0};
+    if (policy == InstancePolicy::PER_THREAD) {
+        key.threadId = Platform::GetCurrentThreadId();
+    }
+    if (policy != InstancePolicy::PER_CALL) {
+        auto it = instanceCache_.find(key);
+        if (it != instanceCache_.end()) {
+            return it->second;
+        }
+    }
+    
+    // 缓存未命中，构造新实例
+    jmethodID constructor = env_->GetMethodID(clazz, "<init>", "()V");
+    if (!constructor) {
+        // 没有无参构造函数，由调用者回退到静态调用
+        env_->ExceptionClear();
+        return nullptr;
+    }
+    
+    jobject instance = env_->NewObject(clazz, constructor);
+    if (!instance || CheckJNIException()) {
+        LOG_ERROR(L"Failed to create instance of " << StringToWString(className));
+        return nullptr;
+    }
+    
+    if (policy == InstancePolicy::PER_CALL) {
+        isLocalRef = true;
+        return instance;
+    }
+    
+    // 提升为全局引用并缓存，直到类加载器代切换
+    jobject globalInstance = env_->NewGlobalRef(instance);
+    env_->DeleteLocalRef(instance);
+    if (!globalInstance) {
+        LOG_ERROR(L"Failed to create global reference for instance of " << StringToWString(className));
+        return nullptr;
+    }
+    
+    instanceCache_.emplace(std::move(key), globalInstance);
+    LOG_DEBUG(L"Instance cached: " << StringToWString(className) << L" (generation " << generation_ << L")");
+    return globalInstance;
+}
+
+void JarLoader::ReleaseInstances(uint64_t generation) {
+    size_t released = 0;
+    for (auto it = instanceCache_.begin(); it != instanceCache_.end();) {
+        if (it->first.generation != generation) {
+            ++it;
+            continue;
+        }
+        if (env_ && it->second) {
+            env_->DeleteGlobalRef(it->second);
+        }
+        it = instanceCache_.erase(it);
+        ++released;
+    }
+    
+    if (released > 0) {
+        LOG_DEBUG(L"Released " << released << L" cached instances of generation " << generation);
+    }
+}
+
+void JarLoader::ReleaseThreadInstances(uint32_t threadId) {
+    size_t released = 0;
+    for (auto it = instanceCache_.begin(); it != instanceCache_.end();) {
+        if (it->first.threadId != threadId) {
+            ++it;
+            continue;
+        }
+        if (env_ && it->second) {
+            env_->DeleteGlobalRef(it->second);
+        }
+        it = instanceCache_.erase(it);
+        ++released;
+    }
+    
+    // 每线程的调用器以"#线程ID"结尾，句柄中绑定了该线程的实例
+    std::string suffix = "#" + std::to_string(threadId);
+    methodHandles_.RemoveBySuffix(env_, suffix);
+    standbyMethodHandles_.RemoveBySuffix(env_, suffix);
+    
+    if (released > 0) {
+        LOG_DEBUG(L"Released " << released << L" per-thread instances of thread " << threadId);
+    }
+}
+
+void JarLoader::ReleaseInstances() {
+    if (env_) {
+        for (auto& pair : instanceCache_) {
+            if (pair.second) {
+                env_->DeleteGlobalRef(pair.second);
+            }
+        }
+    }
+    
+    if (!instanceCache_.empty()) {
+        LOG_DEBUG(L"Released " << instanceCache_.size() << L" cached instances");
+    }
+    instanceCache_.clear();
+}
+
 bool JarLoader::ValidateInput(const std::string& input, size_t maxLength) {
     if (input.empty() || input.length() > maxLength) {
         return false;
@@ -581,11 +1967,3 @@ bool JarLoader::ValidateInput(const std::string& input, size_t maxLength) {
     
     return true;
 }
-
-void JarLoader::SetLastError(ErrorCode error) {
-    lastError_ = error;
-}
-
-ErrorCode JarLoader::GetLastError() const {
-    return lastError_;
-}
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "../include/jar_verifier.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x3143564A;   // "JVC1"
+constexpr size_t ENTRIES_PER_BATCH = 32;         // 工作线程每次领取的条目数
+constexpr size_t MIN_ENTRIES_PER_THREAD = 64;    // 条目太少时不值得启动线程
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t recordSize;
+};
+
+uint32_t Crc32(const uint8_t* data, uint64_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> values{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+            }
+            values[i] = crc;
+        }
+        return values;
+    }();
+    
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint64_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace
+
+JarVerifier::JarVerifier() : threadCount_(0) {
+}
+
+ErrorCode JarVerifier::OpenCache(const std::wstring& cachePath) {
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    
+    if (cachePath.empty()) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    cachePath_ = cachePath;
+    records_.clear();
+    
+    std::ifstream file(Platform::ToFilesystemPath(cachePath), std::ios::binary);
+    if (!file) {
+        LOG_DEBUG(L"JAR verification cache not found, starting empty: " << cachePath);
+        return ErrorCode::SUCCESS;
+    }
+    
+    CacheHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != CACHE_MAGIC || header.recordSize != sizeof(CacheRecord)) {
+        LOG_WARNING(L"Ignoring incompatible JAR verification cache: " << cachePath);
+        return ErrorCode::SUCCESS;
+    }
+    
+    CacheRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        records_.push_back(record);
+    }
+    if (records_.size() > MAX_CACHE_RECORDS) {
+        records_.erase(records_.begin(), records_.end() - MAX_CACHE_RECORDS);
+    }
+    
+    LOG_INFO(L"JAR verification cache loaded: " << cachePath << L", records: " << records_.size());
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarVerifier::LoadTrustedDigests(const std::wstring& listPath) {
+    std::ifstream file(Platform::ToFilesystemPath(listPath));
+    if (!file) {
+        LOG_ERROR(L"Failed to open trusted digest list: " << listPath);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::set<std::string> digests;
+    std::string line;
+    while (std::getline(file, line)) {
+        // 只取每行第一个字段，兼容"摘要 文件名"的格式
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        size_t end = line.find_first_of(" \t\r", begin);
+        std::string digest = line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        std::transform(digest.begin(), digest.end(), digest.begin(), ::tolower);
+        digests.insert(digest);
+    }
+    
+    LOG_DEBUG(L"Loaded " << digests.size() << L" trusted JAR digests from: " << listPath);
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    trustedDigests_.swap(digests);
+    return ErrorCode::SUCCESS;
+}
+
+void JarVerifier::AddTrustedDigest(const std::string& digest) {
+    std::string normalized = digest;
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::tolower);
+    
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    trustedDigests_.insert(normalized);
+}
+
+bool JarVerifier::HasTrustedDigests() {
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    return !trustedDigests_.empty();
+}
+
+ErrorCode JarVerifier::Verify(const std::wstring& jarPath, JarVerificationResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    result = JarVerificationResult();
+    
+    // 不阻止其他进程写入，改为比较校验前后的文件标识，保证缓存的标识与摘要对应同一内容
+    Platform::FileIdentity identity;
+    if (!Platform::QueryFileIdentity(jarPath, identity)) {
+        LOG_ERROR(L"Failed to open JAR for verification: " << jarPath << L", error: " << Platform::GetLastSystemError());
+        return ErrorCode::JAR_NOT_FOUND;
+    }
+    
+    JarArchive archive;
+    if (archive.Open(jarPath) != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"JAR verification failed: " << jarPath << L" (" << archive.GetLastErrorMessage() << L")");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    result.entryCount = archive.GetEntryCount();
+    
+    CacheRecord key = {};
+    key.device = identity.device;
+    key.fileIndex = identity.fileId;
+    key.size = archive.GetSize();
+    key.writeTime = identity.modifyTime;
+    if (!HashBuffer(archive.GetCentralDirectory(), archive.GetCentralDirectorySize(), key.fingerprint)) {
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    
+    Digest digest;
+    {
+        std::lock_guard<std::mutex> lock(verifierMutex_);
+        for (const auto& record : records_) {
+            if (record.device == key.device && record.fileIndex == key.fileIndex &&
+                record.size == key.size && record.writeTime == key.writeTime && record.fingerprint == key.fingerprint) {
+                digest = record.digest;
+                result.fromCache = true;
+                break;
+            }
+        }
+    }
+    
+    if (!result.fromCache) {
+        std::wstring error;
+        if (!ComputeDigest(archive, digest, error)) {
+            LOG_ERROR(L"JAR verification failed: " << jarPath << L" (" << error << L")");
+            return ErrorCode::JAR_INVALID_FORMAT;
+        }
+        
+        Platform::FileIdentity after;
+        if (!Platform::QueryFileIdentity(jarPath, after) || after != identity || identity.size != key.size) {
+            LOG_ERROR(L"JAR changed during verification: " << jarPath);
+            return ErrorCode::JAR_INVALID_FORMAT;
+        }
+        
+        std::lock_guard<std::mutex> lock(verifierMutex_);
+        key.digest = digest;
+        records_.push_back(key);
+        if (records_.size() > MAX_CACHE_RECORDS) {
+            records_.erase(records_.begin());
+        }
+        if (!cachePath_.empty() && !SaveCache()) {
+            LOG_WARNING(L"Failed to save JAR verification cache: " << cachePath_);
+        }
+    }
+    
+    result.digest = ToHex(digest);
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    ErrorCode trustResult = CheckTrusted(jarPath, result);
+    if (trustResult != ErrorCode::SUCCESS) {
+        return trustResult;
+    }
+    
+    LOG_INFO(L"JAR verified: " << jarPath << L", digest: " << StringToWString(result.digest)
+             << L", entries: " << result.entryCount << (result.fromCache ? L" (cached)" : L"")
+             << L", " << result.elapsedMs << L"ms");
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarVerifier::Verify(const JarArchive& snapshot, JarVerificationResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    result = JarVerificationResult();
+    
+    if (!snapshot.IsOpen()) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    result.entryCount = snapshot.GetEntryCount();
+    
+    Digest digest;
+    std::wstring error;
+    if (!ComputeDigest(snapshot, digest, error)) {
+        LOG_ERROR(L"JAR verification failed: " << snapshot.GetPath() << L" (" << error << L")");
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    result.digest = ToHex(digest);
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    ErrorCode trustResult = CheckTrusted(snapshot.GetPath(), result);
+    if (trustResult != ErrorCode::SUCCESS) {
+        return trustResult;
+    }
+    
+    LOG_INFO(L"JAR snapshot verified: " << snapshot.GetPath() << L", digest: " << StringToWString(result.digest)
+             << L", entries: " << result.entryCount << L", " << result.elapsedMs << L"ms");
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarVerifier::CheckTrusted(const std::wstring& jarPath, JarVerificationResult& result) {
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    if (trustedDigests_.empty()) {
+        return ErrorCode::SUCCESS;
+    }
+    
+    result.trusted = trustedDigests_.count(result.digest) > 0;
+    if (!result.trusted) {
+        LOG_ERROR(L"JAR digest is not trusted: " << jarPath << L", digest: " << StringToWString(result.digest));
+        return ErrorCode::SECURITY_CHECK_FAILED;
+    }
+    return ErrorCode::SUCCESS;
+}
+
+size_t JarVerifier::GetCacheSize() {
+    std::lock_guard<std::mutex> lock(verifierMutex_);
+    return records_.size();
+}
+
+bool JarVerifier::ComputeDigest(const JarArchive& archive, Digest& digest, std::wstring& error) {
+    size_t entryCount = archive.GetEntryCount();
+    std::vector<Digest> entryDigests(entryCount);
+    
+    size_t threadCount = threadCount_ ? threadCount_ : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::max<size_t>(1, std::min(threadCount, entryCount / MIN_ENTRIES_PER_THREAD));
+    
+    // 条目分批领取，大小不均的条目也能在线程间均衡
+    std::atomic<size_t> nextEntry(0);
+    std::atomic<size_t> failedEntry(entryCount);
+    std::atomic<bool> failed(false);
+    
+    auto worker = [&]() {
+        Sha256 hash;
+        if (!hash.IsValid()) {
+            failed = true;
+            return;
+        }
+        
+        while (!failed) {
+            size_t begin = nextEntry.fetch_add(ENTRIES_PER_BATCH);
+            if (begin >= entryCount) {
+                break;
+            }
+            
+            size_t end = std::min(begin + ENTRIES_PER_BATCH, entryCount);
+            for (size_t i = begin; i < end; ++i) {
+                if (!HashEntry(archive, archive.GetEntry(i), hash, entryDigests[i])) {
+                    size_t expected = entryCount;
+                    failedEntry.compare_exchange_strong(expected, i);
+                    failed = true;
+                    break;
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    if (failed) {
+        size_t index = failedEntry;
+        error = index < entryCount ?
+            L"entry data corrupted: " + StringToWString(std::string(archive.GetEntry(index).name)) :
+            L"failed to create hash object";
+        return false;
+    }
+    
+    if (!HashBuffer(entryDigests.empty() ? nullptr : entryDigests[0].data(), entryCount * sizeof(Digest), digest)) {
+        error = L"failed to hash entry digests";
+        return false;
+    }
+    return true;
+}
+
+std::string JarVerifier::ToHex(const Digest& digest) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(digest.size() * 2);
+    for (uint8_t byte : digest) {
+        hex.push_back(HEX_DIGITS[byte >> 4]);
+        hex.push_back(HEX_DIGITS[byte & 0x0F]);
+    }
+    return hex;
+}
+
+bool JarVerifier::HashEntry(const JarArchive& archive, const JarEntry& entry, Sha256& hash, Digest& digest) {
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+    if (!archive.GetEntryData(entry, data, size)) {
+        return false;
+    }
+    
+    if (entry.method == JarArchive::METHOD_STORED && Crc32(data, size) != entry.crc32) {
+        return false;
+    }
+    
+    // 名称以NUL结束，随后是小端序的方法、CRC32与原始大小
+    uint8_t header[15] = {};
+    for (int i = 0; i < 2; ++i) {
+        header[1 + i] = static_cast<uint8_t>(entry.method >> (8 * i));
+    }
+    for (int i = 0; i < 4; ++i) {
+        header[3 + i] = static_cast<uint8_t>(entry.crc32 >> (8 * i));
+    }
+    for (int i = 0; i < 8; ++i) {
+        header[7 + i] = static_cast<uint8_t>(entry.uncompressedSize >> (8 * i));
+    }
+    
+    return hash.Update(reinterpret_cast<const uint8_t*>(entry.name.data()), entry.name.size()) &&
+           hash.Update(header, sizeof(header)) &&
+           hash.Update(data, size) &&
+           hash.Finish(digest);
+}
+
+bool JarVerifier::HashBuffer(const uint8_t* data, size_t size, Digest& digest) {
+    return Sha256::Hash(data, size, digest);
+}
+
+bool JarVerifier::SaveCache() {
+    std::wstring tempPath = cachePath_ + L".tmp";
+    {
+        std::ofstream file(Platform::ToFilesystemPath(tempPath), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        
+        CacheHeader header = {CACHE_MAGIC, static_cast<uint32_t>(sizeof(CacheRecord))};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!records_.empty()) {
+            file.write(reinterpret_cast<const char*>(records_.data()), records_.size() * sizeof(CacheRecord));
+        }
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(Platform::ToFilesystemPath(tempPath), Platform::ToFilesystemPath(cachePath_), error);
+    return !error;
+}
@@ -0,0 +1,362 @@
+#include "../include/jar_version_cache.h"
+#include "../include/jar_archive.h"
+#include "../include/security_utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <set>
+
+namespace {
+
+constexpr wchar_t VERSION_MARKER[] = L".v";
+constexpr wchar_t JAR_EXTENSION[] = L".jar";
+constexpr wchar_t TEMP_EXTENSION[] = L".tmp";
+constexpr int VERSION_DIGITS = 6;
+
+bool HasJarExtension(const std::wstring& name, size_t extension) {
+    return extension != std::wstring::npos && EqualsIgnoreCase(name.substr(extension), JAR_EXTENSION);
+}
+
+// 去掉目录和.jar扩展名
+std::wstring FileStem(const std::wstring& path) {
+    size_t slash = path.find_last_of(L"\\/");
+    std::wstring name = slash == std::wstring::npos ? path : path.substr(slash + 1);
+    size_t extension = name.rfind(L'.');
+    if (HasJarExtension(name, extension)) {
+        name.resize(extension);
+    }
+    return name;
+}
+
+// 从<名称>.v<版本号>.jar中解析版本号与名称，不匹配时返回0
+uint64_t ParseVersion(const std::wstring& fileName, std::wstring& stem) {
+    size_t jarLength = wcslen(JAR_EXTENSION);
+    if (fileName.size() <= jarLength || !HasJarExtension(fileName, fileName.size() - jarLength)) {
+        return 0;
+    }
+    
+    std::wstring name = fileName.substr(0, fileName.size() - jarLength);
+    size_t marker = name.rfind(VERSION_MARKER);
+    if (marker == std::wstring::npos || marker + 2 >= name.size()) {
+        return 0;
+    }
+    
+    uint64_t version = 0;
+    for (size_t i = marker + 2; i < name.size(); ++i) {
+        if (name[i] < L'0' || name[i] > L'9') {
+            return 0;
+        }
+        version = version * 10 + static_cast<uint64_t>(name[i] - L'0');
+    }
+    stem = name.substr(0, marker);
+    return version;
+}
+
+} // namespace
+
+JarVersionCache::JarVersionCache()
+    : maxVersions_(DEFAULT_MAX_VERSIONS), maxBytes_(DEFAULT_MAX_BYTES), nextVersion_(1),
+      currentVersion_(0), pendingVersion_(0), useCounter_(0) {
+}
+
+ErrorCode JarVersionCache::Open(const std::wstring& directory, const std::wstring& sourcePath,
+                                size_t maxVersions, uint64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    
+    std::wstring sourceStem = FileStem(sourcePath);
+    if (directory.empty() || sourceStem.empty() || maxVersions == 0) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::wstring normalized = directory;
+    while (normalized.size() > 1 && (normalized.back() == L'\\' || normalized.back() == L'/')) {
+        normalized.pop_back();
+    }
+    
+    std::error_code error;
+    std::filesystem::create_directory(Platform::ToFilesystemPath(normalized), error);
+    if (error) {
+        LOG_ERROR(L"Failed to create JAR version cache directory: " << normalized << L", error: " << error.value());
+        return ErrorCode::HOT_RELOAD_START_FAILED;
+    }
+    
+    directory_ = normalized;
+    sourceStem_ = sourceStem;
+    maxVersions_ = maxVersions;
+    maxBytes_ = maxBytes;
+    versions_.clear();
+    nextVersion_ = 1;
+    currentVersion_ = 0;
+    pendingVersion_ = 0;
+    
+    ScanDirectory();
+    LOG_INFO(L"JAR version cache opened: " << directory_ << L", existing versions: " << versions_.size());
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JarVersionCache::AddVersion(const std::wstring& sourcePath, JarVersionInfo& info) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    
+    if (directory_.empty()) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    if (!Platform::FileNameEquals(FileStem(sourcePath), sourceStem_)) {
+        LOG_ERROR(L"JAR does not belong to this version cache: " << sourcePath);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    // 不阻止构建工具继续写入，改为比较复制前后的文件标识（替换、大小与修改时间）
+    Platform::FileIdentity before;
+    if (!Platform::QueryFileIdentity(sourcePath, before)) {
+        LOG_ERROR(L"Failed to open JAR for versioning: " << sourcePath << L", error: " << Platform::GetLastSystemError());
+        return ErrorCode::JAR_NOT_FOUND;
+    }
+    uint64_t size = before.size;
+    
+    // 来源未变化，复用最新版本
+    for (auto it = versions_.rbegin(); it != versions_.rend(); ++it) {
+        if (it->sourcePath == sourcePath && it->size == size && it->sourceWriteTime == before.modifyTime) {
+            info = *it;
+            pendingVersion_ = it->version;
+            return ErrorCode::SUCCESS;
+        }
+    }
+    
+    uint64_t version = nextVersion_++;
+    std::wstring finalPath = MakeVersionPath(sourcePath, version);
+    std::wstring tempPath = finalPath + TEMP_EXTENSION;
+    DeleteVersionFile(tempPath);
+    
+    bool cloned = size > 0 && Platform::CloneFile(sourcePath, tempPath);
+    if (!cloned) {
+        std::error_code error;
+        std::filesystem::copy_file(Platform::ToFilesystemPath(sourcePath), Platform::ToFilesystemPath(tempPath),
+                                   std::filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            LOG_ERROR(L"Failed to copy JAR into version cache: " << sourcePath << L", error: " << error.value());
+            DeleteVersionFile(tempPath);
+            return ErrorCode::JAR_LOAD_FAILED;
+        }
+    }
+    
+    Platform::FileIdentity after;
+    if (!Platform::QueryFileIdentity(sourcePath, after) || after != before) {
+        LOG_WARNING(L"JAR changed while being copied, skipping version: " << sourcePath);
+        DeleteVersionFile(tempPath);
+        return ErrorCode::JAR_INVALID_FORMAT;
+    }
+    
+    // 只发布结构完整的副本
+    {
+        JarArchive archive;
+        ErrorCode validation = archive.Open(tempPath);
+        if (validation != ErrorCode::SUCCESS) {
+            LOG_WARNING(L"JAR copy is not a complete archive, skipping version: " << sourcePath << L" ("
+                        << archive.GetLastErrorMessage() << L")");
+            archive.Close();
+            DeleteVersionFile(tempPath);
+            return ErrorCode::JAR_INVALID_FORMAT;
+        }
+    }
+    
+    std::error_code error;
+    SetReadOnly(tempPath, true);
+    std::filesystem::rename(Platform::ToFilesystemPath(tempPath), Platform::ToFilesystemPath(finalPath), error);
+    if (error) {
+        LOG_ERROR(L"Failed to publish JAR version: " << finalPath << L", error: " << error.value());
+        DeleteVersionFile(tempPath);
+        return ErrorCode::JAR_LOAD_FAILED;
+    }
+    
+    JarVersionInfo entry;
+    entry.version = version;
+    entry.path = finalPath;
+    entry.sourcePath = sourcePath;
+    entry.size = size;
+    entry.sourceWriteTime = before.modifyTime;
+    entry.cloned = cloned;
+    entry.lastUsed = ++useCounter_;
+    versions_.push_back(entry);
+    info = entry;
+    
+    LOG_INFO(L"JAR version " << version << L" cached (" << (cloned ? L"block clone" : L"copy") << L", "
+             << size << L" bytes): " << finalPath);
+    
+    // 调用者切换到新版本之前，新版本与当前版本一样受保护
+    pendingVersion_ = version;
+    EvictLocked();
+    return ErrorCode::SUCCESS;
+}
+
+bool JarVersionCache::GetVersion(uint64_t version, JarVersionInfo& info) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    for (const auto& entry : versions_) {
+        if (entry.version == version) {
+            info = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<JarVersionInfo> JarVersionCache::GetVersions() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return std::vector<JarVersionInfo>(versions_.rbegin(), versions_.rend());
+}
+
+void JarVersionCache::SetCurrentVersion(uint64_t version) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    for (auto& entry : versions_) {
+        if (entry.version == version) {
+            entry.lastUsed = ++useCounter_;
+            currentVersion_ = version;
+            if (pendingVersion_ == version) {
+                pendingVersion_ = 0;
+            }
+            return;
+        }
+    }
+}
+
+uint64_t JarVersionCache::GetCurrentVersion() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return currentVersion_;
+}
+
+size_t JarVersionCache::Evict() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return EvictLocked();
+}
+
+uint64_t JarVersionCache::GetTotalBytes() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    uint64_t total = 0;
+    for (const auto& entry : versions_) {
+        total += entry.size;
+    }
+    return total;
+}
+
+size_t JarVersionCache::EvictLocked() {
+    size_t removed = 0;
+    std::set<uint64_t> busy;
+    
+    while (true) {
+        uint64_t totalBytes = 0;
+        for (const auto& entry : versions_) {
+            totalBytes += entry.size;
+        }
+        if (versions_.size() <= maxVersions_ && totalBytes <= maxBytes_) {
+            break;
+        }
+        
+        // 选择最久未使用、非当前、非新建、本轮未删除失败的版本
+        auto victim = versions_.end();
+        for (auto it = versions_.begin(); it != versions_.end(); ++it) {
+            if (it->version == currentVersion_ || it->version == pendingVersion_ || busy.count(it->version)) {
+                continue;
+            }
+            if (victim == versions_.end() || it->lastUsed < victim->lastUsed) {
+                victim = it;
+            }
+        }
+        if (victim == versions_.end()) {
+            break;
+        }
+        
+        if (DeleteVersionFile(victim->path)) {
+            LOG_DEBUG(L"JAR version " << victim->version << L" evicted: " << victim->path);
+            versions_.erase(victim);
+            ++removed;
+        } else {
+            LOG_DEBUG(L"JAR version " << victim->version << L" still in use, eviction deferred");
+            busy.insert(victim->version);
+        }
+    }
+    
+    return removed;
+}
+
+std::wstring JarVersionCache::MakeVersionPath(const std::wstring& sourcePath, uint64_t version) const {
+    std::wstring digits = std::to_wstring(version);
+    if (digits.size() < VERSION_DIGITS) {
+        digits.insert(0, VERSION_DIGITS - digits.size(), L'0');
+    }
+    return directory_ + Platform::PATH_SEPARATOR + FileStem(sourcePath) + VERSION_MARKER + digits + JAR_EXTENSION;
+}
+
+void JarVersionCache::ScanDirectory() {
+    std::error_code error;
+    std::filesystem::directory_iterator it(Platform::ToFilesystemPath(directory_), error);
+    for (; !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+        std::error_code statusError;
+        if (!it->is_regular_file(statusError)) {
+            continue;
+        }
+        
+        std::wstring fileName = Platform::FromFilesystemPath(it->path().filename());
+        std::wstring path = directory_ + Platform::PATH_SEPARATOR + fileName;
+        
+        // 上次进程退出时未发布的临时副本
+        size_t tempLength = wcslen(TEMP_EXTENSION);
+        bool temporary = fileName.size() > tempLength &&
+                         fileName.compare(fileName.size() - tempLength, tempLength, TEMP_EXTENSION) == 0;
+        
+        // 只处理当前来源的副本，目录中其他来源的版本与无关文件保持不动
+        std::wstring stem;
+        uint64_t version = ParseVersion(temporary ? fileName.substr(0, fileName.size() - tempLength) : fileName, stem);
+        if (version == 0 || !Platform::FileNameEquals(stem, sourceStem_)) {
+            continue;
+        }
+        
+        if (temporary) {
+            DeleteVersionFile(path);
+            continue;
+        }
+        
+        JarVersionInfo entry;
+        entry.version = version;
+        entry.path = path;
+        entry.size = it->file_size(statusError);
+        versions_.push_back(entry);
+        nextVersion_ = std::max(nextVersion_, version + 1);
+    }
+    
+    // 已有版本按版本号确定LRU顺序
+    std::sort(versions_.begin(), versions_.end(), [](const JarVersionInfo& a, const JarVersionInfo& b) {
+        return a.version < b.version;
+    });
+    for (auto& entry : versions_) {
+        entry.lastUsed = ++useCounter_;
+    }
+}
+
+void JarVersionCache::SetReadOnly(const std::wstring& path, bool readOnly) {
+    // Windows上对应FILE_ATTRIBUTE_READONLY；恢复可写时只加回所有者的写权限
+    using std::filesystem::perms;
+    std::error_code error;
+    if (readOnly) {
+        std::filesystem::permissions(Platform::ToFilesystemPath(path),
+                                     perms::owner_write | perms::group_write | perms::others_write,
+                                     std::filesystem::perm_options::remove, error);
+    } else {
+        std::filesystem::permissions(Platform::ToFilesystemPath(path), perms::owner_write,
+                                     std::filesystem::perm_options::add, error);
+    }
+}
+
+bool JarVersionCache::DeleteVersionFile(const std::wstring& path) {
+    SecurityUtils::InvalidateJarPathCache(path);
+    
+    // 文件不存在时remove返回false且不设置错误
+    std::error_code error;
+    SetReadOnly(path, false);
+    std::filesystem::remove(Platform::ToFilesystemPath(path), error);
+    if (!error) {
+        return true;
+    }
+    
+    // 仍被占用（Windows上被映射或打开的文件不能删除），恢复只读属性
+    SetReadOnly(path, true);
+    return false;
+}
@@ -1,8 +1,60 @@
 #include "../include/jar_loader.h"
 #include "../include/common.h"
+#include "../include/native_channel.h"
 
 // JNI桥接函数，允许Java代码调用C++函数
 
+// 日志快速路径：Java字符串通过GetStringRegion直接拷贝进线程局部缓冲区，不分配堆内存
+// jchar与Windows的wchar_t同为UTF-16，无需编码转换；其他平台的wchar_t为UTF-32，
+// 先拷贝进UTF-16缓冲区再逐字符转换
+static_assert(sizeof(jchar) == sizeof(char16_t), "jchar must be a UTF-16 code unit");
+
+namespace {
+
+constexpr jsize LOG_BUFFER_CHARS = 2048;
+constexpr wchar_t JAVA_LOG_PREFIX[] = L"Java Log: ";
+constexpr wchar_t TRUNCATED_SUFFIX[] = L"...";
+constexpr jsize TRUNCATED_SUFFIX_CHARS = static_cast<jsize>(sizeof(TRUNCATED_SUFFIX) / sizeof(wchar_t) - 1);
+
+thread_local wchar_t t_logBuffer[LOG_BUFFER_CHARS];
+#ifndef _WIN32
+thread_local jchar t_utf16Buffer[LOG_BUFFER_CHARS];
+#endif
+
+// 将一条Java字符串提交到日志记录队列
+void SubmitJavaLog(JNIEnv* env, jstring message) {
+    jsize length = env->GetStringLength(message);
+    jsize copyLength = length;
+    bool truncated = false;
+    if (copyLength > LOG_BUFFER_CHARS - TRUNCATED_SUFFIX_CHARS) {
+        copyLength = LOG_BUFFER_CHARS - TRUNCATED_SUFFIX_CHARS;
+        truncated = true;
+    }
+    
+#ifdef _WIN32
+    env->GetStringRegion(message, 0, copyLength, reinterpret_cast<jchar*>(t_logBuffer));
+#else
+    env->GetStringRegion(message, 0, copyLength, t_utf16Buffer);
+#endif
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return;
+    }
+#ifndef _WIN32
+    copyLength = static_cast<jsize>(Platform::Utf16ToWide(reinterpret_cast<const char16_t*>(t_utf16Buffer),
+                                                          static_cast<size_t>(copyLength), t_logBuffer));
+#endif
+    
+    if (truncated) {
+        wmemcpy(t_logBuffer + copyLength, TRUNCATED_SUFFIX, TRUNCATED_SUFFIX_CHARS);
+        copyLength += TRUNCATED_SUFFIX_CHARS;
+    }
+    
+    Logger::GetInstance().Submit(LogLevel::INFO, t_logBuffer, static_cast<size_t>(copyLength), JAVA_LOG_PREFIX);
+}
+
+} // namespace
+
 extern "C" {
 
 // 导出给Java调用的函数：记录日志
@@ -11,14 +63,35 @@ JNIEXPORT void JNICALL Java_NativeBridge_logMessage(JNIEnv* env, jclass clazz, j
         return;
     }
     
-    const char* msg = env->GetStringUTFChars(message, nullptr);
-    if (msg) {
-        try {
-            LOG_INFO(L"Java Log: " << StringToWString(msg));
-        } catch (...) {
-            // 确保即使在异常情况下也释放资源
+    // 级别过滤放在JNI数据拷贝之前
+    if (LogLevel::INFO < Logger::GetInstance().GetLogLevel()) {
+        return;
+    }
+    
+    SubmitJavaLog(env, message);
+}
+
+// 导出给Java调用的函数：批量记录日志，每批只有一次JNI调用
+JNIEXPORT void JNICALL Java_NativeBridge_logMessages(JNIEnv* env, jclass clazz, jobjectArray messages) {
+    if (!env || !messages) {
+        return;
+    }
+    
+    if (LogLevel::INFO < Logger::GetInstance().GetLogLevel()) {
+        return;
+    }
+    
+    jsize count = env->GetArrayLength(messages);
+    for (jsize i = 0; i < count; ++i) {
+        jstring message = static_cast<jstring>(env->GetObjectArrayElement(messages, i));
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+            return;
+        }
+        if (message) {
+            SubmitJavaLog(env, message);
+            env->DeleteLocalRef(message);
         }
-        env->ReleaseStringUTFChars(message, msg);
     }
 }
 
@@ -29,22 +102,16 @@ JNIEXPORT jstring JNICALL Java_NativeBridge_getSystemInfo(JNIEnv* env, jclass cl
     }
     
     try {
-        std::string systemInfo = "Windows DLL Injection Demo - System Info:\n";
-        
-        // 获取系统信息
-        SYSTEM_INFO sysInfo;
-        GetSystemInfo(&sysInfo);
+        std::string systemInfo = "DLL Injection Demo - System Info:\n";
         
-        systemInfo += "Processor Architecture: " + std::to_string(sysInfo.wProcessorArchitecture) + "\n";
-        systemInfo += "Number of Processors: " + std::to_string(sysInfo.dwNumberOfProcessors) + "\n";
-        systemInfo += "Page Size: " + std::to_string(sysInfo.dwPageSize) + "\n";
+        // 获取处理器与内存信息
+        Platform::SystemInfo sysInfo = Platform::QuerySystemInfo();
         
-        // 获取内存信息
-        MEMORYSTATUSEX memInfo;
-        memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-        if (GlobalMemoryStatusEx(&memInfo)) {
-            systemInfo += "Total Physical Memory: " + std::to_string(memInfo.ullTotalPhys / (1024 * 1024)) + " MB\n";
-            systemInfo += "Available Physical Memory: " + std::to_string(memInfo.ullAvailPhys / (1024 * 1024)) + " MB\n";
+        systemInfo += "Number of Processors: " + std::to_string(sysInfo.processorCount) + "\n";
+        systemInfo += "Page Size: " + std::to_string(sysInfo.pageSize) + "\n";
+        if (sysInfo.totalPhysicalMemory != 0) {
+            systemInfo += "Total Physical Memory: " + std::to_string(sysInfo.totalPhysicalMemory / (1024 * 1024)) + " MB\n";
+            systemInfo += "Available Physical Memory: " + std::to_string(sysInfo.availablePhysicalMemory / (1024 * 1024)) + " MB\n";
         }
         
         jstring result = env->NewStringUTF(systemInfo.c_str());
@@ -113,12 +180,69 @@ JNIEXPORT jboolean JNICALL Java_NativeBridge_fileExists(JNIEnv* env, jclass claz
 
 // 导出给Java调用的函数：获取当前进程ID
 JNIEXPORT jint JNICALL Java_NativeBridge_getCurrentProcessId(JNIEnv* env, jclass clazz) {
-    return static_cast<jint>(GetCurrentProcessId());
+    return static_cast<jint>(Platform::GetCurrentProcessId());
 }
 
 // 导出给Java调用的函数：获取当前线程ID
 JNIEXPORT jint JNICALL Java_NativeBridge_getCurrentThreadId(JNIEnv* env, jclass clazz) {
-    return static_cast<jint>(GetCurrentThreadId());
+    return static_cast<jint>(Platform::GetCurrentThreadId());
+}
+
+// 导出给Java调用的函数：打开共享内存通道，返回{toNative, toJava}两个DirectByteBuffer
+JNIEXPORT jobjectArray JNICALL Java_NativeBridge_openChannel(JNIEnv* env, jclass clazz, jint capacity) {
+    if (!env || capacity <= 0) {
+        return nullptr;
+    }
+    
+    try {
+        NativeChannel& channel = NativeChannel::GetInstance();
+        if (channel.Open(static_cast<uint32_t>(capacity)) != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Failed to open native channel");
+            return nullptr;
+        }
+        
+        SharedRingBuffer* toNative = channel.GetToNativeBuffer();
+        SharedRingBuffer* toJava = channel.GetToJavaBuffer();
+        
+        jclass byteBufferClass = env->FindClass("java/nio/ByteBuffer");
+        if (!byteBufferClass || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            return nullptr;
+        }
+        
+        jobjectArray result = env->NewObjectArray(2, byteBufferClass, nullptr);
+        env->DeleteLocalRef(byteBufferClass);
+        if (!result || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            return nullptr;
+        }
+        
+        jobject toNativeBuffer = env->NewDirectByteBuffer(toNative->GetMemory(), static_cast<jlong>(toNative->GetMemorySize()));
+        jobject toJavaBuffer = env->NewDirectByteBuffer(toJava->GetMemory(), static_cast<jlong>(toJava->GetMemorySize()));
+        if (!toNativeBuffer || !toJavaBuffer || env->ExceptionCheck()) {
+            env->ExceptionClear();
+            LOG_ERROR(L"Failed to create direct byte buffers for native channel");
+            return nullptr;
+        }
+        
+        env->SetObjectArrayElement(result, 0, toNativeBuffer);
+        env->SetObjectArrayElement(result, 1, toJavaBuffer);
+        env->DeleteLocalRef(toNativeBuffer);
+        env->DeleteLocalRef(toJavaBuffer);
+        return result;
+    } catch (...) {
+        LOG_ERROR(L"Exception in openChannel");
+        return nullptr;
+    }
+}
+
+// 导出给Java调用的函数：关闭共享内存通道
+JNIEXPORT void JNICALL Java_NativeBridge_closeChannel(JNIEnv* env, jclass clazz) {
+    try {
+        NativeChannel::GetInstance().Close();
+    } catch (...) {
+        LOG_ERROR(L"Exception in closeChannel");
+    }
 }
 
 } // extern "C"
@@ -136,11 +260,14 @@ bool RegisterNativeMethods(JNIEnv* env) {
         // 定义本地方法
         JNINativeMethod methods[] = {
             {"logMessage", "(Ljava/lang/String;)V", (void*)Java_NativeBridge_logMessage},
+            {"logMessages", "([Ljava/lang/String;)V", (void*)Java_NativeBridge_logMessages},
             {"getSystemInfo", "()Ljava/lang/String;", (void*)Java_NativeBridge_getSystemInfo},
             {"executeCommand", "(Ljava/lang/String;)Ljava/lang/String;", (void*)Java_NativeBridge_executeCommand},
             {"fileExists", "(Ljava/lang/String;)Z", (void*)Java_NativeBridge_fileExists},
             {"getCurrentProcessId", "()I", (void*)Java_NativeBridge_getCurrentProcessId},
-            {"getCurrentThreadId", "()I", (void*)Java_NativeBridge_getCurrentThreadId}
+            {"getCurrentThreadId", "()I", (void*)Java_NativeBridge_getCurrentThreadId},
+            {"openChannel", "(I)[Ljava/nio/ByteBuffer;", (void*)Java_NativeBridge_openChannel},
+            {"closeChannel", "()V", (void*)Java_NativeBridge_closeChannel}
         };
         
         // 注册本地方法
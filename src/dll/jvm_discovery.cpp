@@ -0,0 +1,366 @@
+#include "../include/jvm_discovery.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 前导中各字段的偏移
+const size_t PROLOGUE_BYTE_ORDER = 4;
+const size_t PROLOGUE_MAJOR_VERSION = 5;
+const size_t PROLOGUE_ACCESSIBLE = 7;
+const size_t PROLOGUE_ENTRY_OFFSET = 24;
+const size_t PROLOGUE_NUM_ENTRIES = 28;
+
+// 条目头中各字段的偏移
+const size_t ENTRY_LENGTH = 0;
+const size_t ENTRY_NAME_OFFSET = 4;
+const size_t ENTRY_VECTOR_LENGTH = 8;
+const size_t ENTRY_DATA_TYPE = 12;
+const size_t ENTRY_DATA_OFFSET = 16;
+
+const uint8_t PERFDATA_MAJOR_VERSION = 2;
+
+// 忽略大小写比较后缀（只用于ASCII扩展名）
+bool EndsWithIgnoreCase(const std::string& text, const char* suffix) {
+    size_t length = strlen(suffix);
+    if (text.size() < length) {
+        return false;
+    }
+    return std::equal(text.end() - length, text.end(), suffix, [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+// 只读映射整个文件，析构时解除映射
+class ReadOnlyFileView {
+public:
+    ReadOnlyFileView() : data_(nullptr), size_(0) {}
+    ReadOnlyFileView(const ReadOnlyFileView&) = delete;
+    ReadOnlyFileView& operator=(const ReadOnlyFileView&) = delete;
+    
+    ~ReadOnlyFileView() {
+        if (!data_) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+    
+    // 文件小于minSize或大于maxSize时返回INVALID_PARAMETER
+    ErrorCode Open(const std::wstring& path, uint64_t minSize, uint64_t maxSize) {
+#ifdef _WIN32
+        // 目标JVM持有文件并持续写入，必须允许共享读写
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return ErrorCode::PROCESS_NOT_FOUND;
+        }
+        
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) < minSize ||
+            static_cast<uint64_t>(fileSize.QuadPart) > maxSize) {
+            CloseHandle(file);
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            return ErrorCode::PROCESS_ACCESS_DENIED;
+        }
+        
+        // 视图独立于映射句柄存在
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        std::string narrowPath = std::filesystem::path(path).string();
+        int file = open(narrowPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) {
+            return ErrorCode::PROCESS_NOT_FOUND;
+        }
+        
+        struct stat status;
+        if (fstat(file, &status) != 0 || static_cast<uint64_t>(status.st_size) < minSize ||
+            static_cast<uint64_t>(status.st_size) > maxSize) {
+            close(file);
+            return ErrorCode::INVALID_PARAMETER;
+        }
+        
+        // 映射在文件描述符关闭后仍然有效
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+        close(file);
+        if (view != MAP_FAILED) {
+            data_ = static_cast<const uint8_t*>(view);
+            size_ = static_cast<size_t>(status.st_size);
+        }
+#endif
+        return data_ ? ErrorCode::SUCCESS : ErrorCode::PROCESS_ACCESS_DENIED;
+    }
+    
+    const uint8_t* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+} // namespace
+
+PerfData::PerfData() : bigEndian_(true), accessible_(false) {
+}
+
+uint32_t PerfData::Read32(const uint8_t* p) const {
+    if (bigEndian_) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint64_t PerfData::Read64(const uint8_t* p) const {
+    uint64_t first = Read32(p);
+    uint64_t second = Read32(p + 4);
+    return bigEndian_ ? (first << 32) | second : (second << 32) | first;
+}
+
+ErrorCode PerfData::Fail(const std::wstring& message) {
+    errorMessage_ = message;
+    entries_.clear();
+    return ErrorCode::INVALID_PARAMETER;
+}
+
+ErrorCode PerfData::Parse(const uint8_t* data, size_t size) {
+    entries_.clear();
+    errorMessage_.clear();
+    accessible_ = false;
+    
+    if (!data || size < PROLOGUE_SIZE) {
+        return Fail(L"file too small for perf data prologue");
+    }
+    
+    // 魔数总是以大端序存放，字节序字段决定其余字段
+    bigEndian_ = true;
+    if (Read32(data) != MAGIC) {
+        return Fail(L"bad perf data magic");
+    }
+    bigEndian_ = data[PROLOGUE_BYTE_ORDER] == 0;
+    if (data[PROLOGUE_MAJOR_VERSION] != PERFDATA_MAJOR_VERSION) {
+        return Fail(L"unsupported perf data version " + std::to_wstring(data[PROLOGUE_MAJOR_VERSION]));
+    }
+    accessible_ = data[PROLOGUE_ACCESSIBLE] != 0;
+    
+    // 目标JVM可能同时追加条目，前导字段只读取一次
+    const size_t entryOffset = Read32(data + PROLOGUE_ENTRY_OFFSET);
+    const size_t entryCount = Read32(data + PROLOGUE_NUM_ENTRIES);
+    if (entryOffset < PROLOGUE_SIZE || entryOffset > size) {
+        return Fail(L"entry offset out of range");
+    }
+    if (entryCount > (size - entryOffset) / ENTRY_HEADER_SIZE) {
+        return Fail(L"entry count exceeds file size");
+    }
+    
+    entries_.reserve(entryCount);
+    size_t offset = entryOffset;
+    for (size_t i = 0; i < entryCount; ++i) {
+        if (size - offset < ENTRY_HEADER_SIZE) {
+            return Fail(L"truncated entry header");
+        }
+        const uint8_t* entry = data + offset;
+        const size_t length = Read32(entry + ENTRY_LENGTH);
+        const size_t nameOffset = Read32(entry + ENTRY_NAME_OFFSET);
+        const uint32_t vectorLength = Read32(entry + ENTRY_VECTOR_LENGTH);
+        const char type = static_cast<char>(entry[ENTRY_DATA_TYPE]);
+        const size_t dataOffset = Read32(entry + ENTRY_DATA_OFFSET);
+        
+        if (length < ENTRY_HEADER_SIZE || length > size - offset) {
+            return Fail(L"entry length out of range");
+        }
+        if (nameOffset < ENTRY_HEADER_SIZE || nameOffset >= length || dataOffset < ENTRY_HEADER_SIZE || dataOffset > length) {
+            return Fail(L"entry field offset out of range");
+        }
+        
+        const char* name = reinterpret_cast<const char*>(entry + nameOffset);
+        const void* nameEnd = memchr(name, 0, length - nameOffset);
+        if (!nameEnd) {
+            return Fail(L"unterminated entry name");
+        }
+        
+        // 只保留能安全读取的类型，其余条目跳过
+        size_t dataSize = vectorLength == 0 ? (type == 'J' ? 8 : 0) : (type == 'B' ? vectorLength : 0);
+        if (dataSize != 0 && dataSize <= length - dataOffset) {
+            std::string_view key(name, static_cast<const char*>(nameEnd) - name);
+            entries_.emplace(key, Entry{type, vectorLength, entry + dataOffset});
+        }
+        
+        offset += length;
+    }
+    
+    return ErrorCode::SUCCESS;
+}
+
+bool PerfData::GetString(std::string_view name, std::string& value) const {
+    auto it = entries_.find(name);
+    if (it == entries_.end() || it->second.type != 'B' || it->second.vectorLength == 0) {
+        return false;
+    }
+    
+    const char* text = reinterpret_cast<const char*>(it->second.data);
+    const void* end = memchr(text, 0, it->second.vectorLength);
+    value.assign(text, end ? static_cast<const char*>(end) - text : it->second.vectorLength);
+    return true;
+}
+
+bool PerfData::GetLong(std::string_view name, int64_t& value) const {
+    auto it = entries_.find(name);
+    if (it == entries_.end() || it->second.type != 'J' || it->second.vectorLength != 0) {
+        return false;
+    }
+    
+    value = static_cast<int64_t>(Read64(it->second.data));
+    return true;
+}
+
+std::string JvmProcessInfo::GetShortName() const {
+    std::string command = mainClass;
+    
+    // -jar启动：去掉目录，保留JAR文件名
+    size_t separator = command.find_last_of("\\/");
+    if (separator != std::string::npos) {
+        return command.substr(separator + 1);
+    }
+    if (EndsWithIgnoreCase(command, ".jar")) {
+        return command;
+    }
+    
+    size_t dot = command.find_last_of('.');
+    return dot == std::string::npos ? command : command.substr(dot + 1);
+}
+
+int64_t JvmDiscovery::CurrentTimeMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+ErrorCode JvmDiscovery::ParsePerfData(const uint8_t* data, size_t size, int64_t nowMillis, JvmProcessInfo& info) {
+    PerfData perfData;
+    ErrorCode result = perfData.Parse(data, size);
+    if (result != ErrorCode::SUCCESS) {
+        return result;
+    }
+    
+    // 尚未完成初始化的JVM还不能注入
+    if (!perfData.IsAccessible()) {
+        return ErrorCode::PROCESS_ACCESS_DENIED;
+    }
+    
+    std::string command;
+    if (!perfData.GetString("sun.rt.javaCommand", command)) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    size_t space = command.find(' ');
+    info.mainClass = command.substr(0, space);
+    info.mainArgs = space == std::string::npos ? std::string() : command.substr(space + 1);
+    
+    perfData.GetString("java.rt.vmArgs", info.jvmArgs);
+    perfData.GetString("java.rt.vmFlags", info.jvmFlags);
+    
+    info.startTimeMillis = 0;
+    info.uptimeMillis = 0;
+    if (perfData.GetLong("sun.rt.createVmBeginTime", info.startTimeMillis) && info.startTimeMillis > 0) {
+        info.uptimeMillis = std::max<int64_t>(0, nowMillis - info.startTimeMillis);
+    }
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode JvmDiscovery::ReadPerfDataFile(const std::wstring& path, JvmProcessInfo& info) {
+    // 文件名即进程ID
+    std::wstring fileName = std::filesystem::path(path).filename().wstring();
+    if (fileName.empty() || fileName.size() > 10 ||
+        fileName.find_first_not_of(L"0123456789") != std::wstring::npos) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    uint64_t processId = std::stoull(fileName);
+    if (processId == 0 || processId > UINT32_MAX) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    ReadOnlyFileView view;
+    ErrorCode result = view.Open(path, PerfData::PROLOGUE_SIZE, MAX_PERF_DATA_SIZE);
+    if (result != ErrorCode::SUCCESS) {
+        return result;
+    }
+    
+    result = ParsePerfData(view.GetData(), view.GetSize(), CurrentTimeMillis(), info);
+    if (result == ErrorCode::SUCCESS) {
+        info.processId = static_cast<uint32_t>(processId);
+    }
+    return result;
+}
+
+std::vector<JvmProcessInfo> JvmDiscovery::FindJvms() {
+#ifdef _WIN32
+    // 与java.io.tmpdir相同，来自GetTempPath
+    std::error_code error;
+    std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(error);
+    if (error) {
+        return {};
+    }
+    return FindJvms(tempDirectory.wstring());
+#else
+    // HotSpot在Linux上总是使用/tmp，不受TMPDIR影响
+    return FindJvms(L"/tmp");
+#endif
+}
+
+std::vector<JvmProcessInfo> JvmDiscovery::FindJvms(const std::wstring& tempDirectory) {
+    std::vector<JvmProcessInfo> jvms;
+    std::error_code error;
+    
+    // 每个用户一个hsperfdata_<用户名>目录，无权访问的目录直接跳过
+    for (const auto& userDirectory : std::filesystem::directory_iterator(tempDirectory, error)) {
+        std::wstring directoryName = userDirectory.path().filename().wstring();
+        if (directoryName.compare(0, 11, L"hsperfdata_") != 0 || !userDirectory.is_directory(error)) {
+            continue;
+        }
+        
+        std::error_code listError;
+        for (const auto& perfFile : std::filesystem::directory_iterator(userDirectory.path(), listError)) {
+            if (!perfFile.is_regular_file(listError)) {
+                continue;
+            }
+            
+            JvmProcessInfo info;
+            if (ReadPerfDataFile(perfFile.path().wstring(), info) == ErrorCode::SUCCESS) {
+                jvms.push_back(std::move(info));
+            }
+        }
+    }
+    
+    std::sort(jvms.begin(), jvms.end(), [](const JvmProcessInfo& a, const JvmProcessInfo& b) {
+        return a.processId < b.processId;
+    });
+    return jvms;
+}
+
+bool JvmDiscovery::MatchesMainClass(const JvmProcessInfo& info, const std::string& mainClass) {
+    if (mainClass.empty()) {
+        return false;
+    }
+    return info.mainClass == mainClass || info.GetShortName() == mainClass;
+}
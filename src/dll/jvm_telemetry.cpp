@@ -0,0 +1,178 @@
+#include "../include/jvm_telemetry.h"
+#include "../include/jar_loader.h"
+#include <cstring>
+
+JvmTelemetry::JvmTelemetry()
+    : resolved_(false), failed_(false), memoryBean_(nullptr), classLoadingBean_(nullptr),
+      metaspacePool_(nullptr), getHeapUsage_(nullptr), getPoolUsage_(nullptr), getUsed_(nullptr),
+      getCommitted_(nullptr), getLoadedClassCount_(nullptr), getUnloadedClassCount_(nullptr),
+      getCollectionCount_(nullptr), getCollectionTime_(nullptr) {
+}
+
+bool JvmTelemetry::Sample(JNIEnv* env, JvmMemorySample& sample) {
+    if (!env || failed_) {
+        return false;
+    }
+    if (!resolved_ && !Resolve(env)) {
+        failed_ = true;
+        Release(env);
+        LOG_WARNING(L"JVM telemetry unavailable, platform MXBeans could not be resolved");
+        return false;
+    }
+    
+    JNILocalFrame localFrame(env, 8);
+    
+    jobject heapUsage = env->CallObjectMethod(memoryBean_, getHeapUsage_);
+    if (!ReadUsage(env, heapUsage, sample.heapUsed, &sample.heapCommitted)) {
+        return false;
+    }
+    
+    sample.metaspaceUsed = -1;
+    if (metaspacePool_) {
+        jobject poolUsage = env->CallObjectMethod(metaspacePool_, getPoolUsage_);
+        if (!ReadUsage(env, poolUsage, sample.metaspaceUsed, nullptr)) {
+            return false;
+        }
+    }
+    
+    sample.loadedClasses = env->CallIntMethod(classLoadingBean_, getLoadedClassCount_);
+    sample.unloadedClasses = env->CallLongMethod(classLoadingBean_, getUnloadedClassCount_);
+    
+    // 收集器不支持计数时返回-1，不计入总数
+    sample.gcCount = 0;
+    sample.gcTimeMs = 0;
+    for (jobject gcBean : gcBeans_) {
+        jlong count = env->CallLongMethod(gcBean, getCollectionCount_);
+        jlong timeMs = env->CallLongMethod(gcBean, getCollectionTime_);
+        sample.gcCount += count > 0 ? count : 0;
+        sample.gcTimeMs += timeMs > 0 ? timeMs : 0;
+    }
+    
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOG_WARNING(L"Java exception while sampling JVM telemetry");
+        return false;
+    }
+    return true;
+}
+
+void JvmTelemetry::Release(JNIEnv* env) {
+    if (env) {
+        for (jobject* ref : {&memoryBean_, &classLoadingBean_, &metaspacePool_}) {
+            if (*ref) {
+                env->DeleteGlobalRef(*ref);
+            }
+        }
+        for (jobject gcBean : gcBeans_) {
+            env->DeleteGlobalRef(gcBean);
+        }
+    }
+    memoryBean_ = nullptr;
+    classLoadingBean_ = nullptr;
+    metaspacePool_ = nullptr;
+    gcBeans_.clear();
+    resolved_ = false;
+}
+
+bool JvmTelemetry::Resolve(JNIEnv* env) {
+    JNILocalFrame localFrame(env, 32);
+    
+    jclass factoryClass = env->FindClass("java/lang/management/ManagementFactory");
+    jclass memoryBeanClass = env->FindClass("java/lang/management/MemoryMXBean");
+    jclass classLoadingBeanClass = env->FindClass("java/lang/management/ClassLoadingMXBean");
+    jclass poolBeanClass = env->FindClass("java/lang/management/MemoryPoolMXBean");
+    jclass gcBeanClass = env->FindClass("java/lang/management/GarbageCollectorMXBean");
+    jclass usageClass = env->FindClass("java/lang/management/MemoryUsage");
+    jclass listClass = env->FindClass("java/util/List");
+    if (env->ExceptionCheck() || !factoryClass || !memoryBeanClass || !classLoadingBeanClass ||
+        !poolBeanClass || !gcBeanClass || !usageClass || !listClass) {
+        env->ExceptionClear();
+        return false;
+    }
+    
+    jmethodID getMemoryBean = env->GetStaticMethodID(factoryClass, "getMemoryMXBean", "()Ljava/lang/management/MemoryMXBean;");
+    jmethodID getClassLoadingBean = env->GetStaticMethodID(factoryClass, "getClassLoadingMXBean", "()Ljava/lang/management/ClassLoadingMXBean;");
+    jmethodID getPoolBeans = env->GetStaticMethodID(factoryClass, "getMemoryPoolMXBeans", "()Ljava/util/List;");
+    jmethodID getGcBeans = env->GetStaticMethodID(factoryClass, "getGarbageCollectorMXBeans", "()Ljava/util/List;");
+    jmethodID getPoolName = env->GetMethodID(poolBeanClass, "getName", "()Ljava/lang/String;");
+    jmethodID listSize = env->GetMethodID(listClass, "size", "()I");
+    jmethodID listGet = env->GetMethodID(listClass, "get", "(I)Ljava/lang/Object;");
+    getHeapUsage_ = env->GetMethodID(memoryBeanClass, "getHeapMemoryUsage", "()Ljava/lang/management/MemoryUsage;");
+    getPoolUsage_ = env->GetMethodID(poolBeanClass, "getUsage", "()Ljava/lang/management/MemoryUsage;");
+    getUsed_ = env->GetMethodID(usageClass, "getUsed", "()J");
+    getCommitted_ = env->GetMethodID(usageClass, "getCommitted", "()J");
+    getLoadedClassCount_ = env->GetMethodID(classLoadingBeanClass, "getLoadedClassCount", "()I");
+    getUnloadedClassCount_ = env->GetMethodID(classLoadingBeanClass, "getUnloadedClassCount", "()J");
+    getCollectionCount_ = env->GetMethodID(gcBeanClass, "getCollectionCount", "()J");
+    getCollectionTime_ = env->GetMethodID(gcBeanClass, "getCollectionTime", "()J");
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return false;
+    }
+    
+    // MXBean实例在JVM生命周期内不变，保存为全局引用
+    jobject memoryBean = env->CallStaticObjectMethod(factoryClass, getMemoryBean);
+    jobject classLoadingBean = env->CallStaticObjectMethod(factoryClass, getClassLoadingBean);
+    jobject poolBeans = env->CallStaticObjectMethod(factoryClass, getPoolBeans);
+    jobject gcBeans = env->CallStaticObjectMethod(factoryClass, getGcBeans);
+    if (env->ExceptionCheck() || !memoryBean || !classLoadingBean || !poolBeans || !gcBeans) {
+        env->ExceptionClear();
+        return false;
+    }
+    memoryBean_ = env->NewGlobalRef(memoryBean);
+    classLoadingBean_ = env->NewGlobalRef(classLoadingBean);
+    
+    jint poolCount = env->CallIntMethod(poolBeans, listSize);
+    for (jint i = 0; i < poolCount && !env->ExceptionCheck(); ++i) {
+        JNILocalFrame poolFrame(env, 4);
+        jobject pool = env->CallObjectMethod(poolBeans, listGet, i);
+        jstring name = pool ? static_cast<jstring>(env->CallObjectMethod(pool, getPoolName)) : nullptr;
+        if (!name) {
+            continue;
+        }
+        const char* chars = env->GetStringUTFChars(name, nullptr);
+        bool isMetaspace = chars && std::strcmp(chars, "Metaspace") == 0;
+        if (chars) {
+            env->ReleaseStringUTFChars(name, chars);
+        }
+        if (isMetaspace) {
+            metaspacePool_ = env->NewGlobalRef(pool);
+            break;
+        }
+    }
+    
+    jint gcCount = env->CallIntMethod(gcBeans, listSize);
+    for (jint i = 0; i < gcCount && !env->ExceptionCheck(); ++i) {
+        jobject gcBean = env->CallObjectMethod(gcBeans, listGet, i);
+        if (gcBean) {
+            gcBeans_.push_back(env->NewGlobalRef(gcBean));
+            env->DeleteLocalRef(gcBean);
+        }
+    }
+    
+    if (env->ExceptionCheck() || !memoryBean_ || !classLoadingBean_) {
+        env->ExceptionClear();
+        return false;
+    }
+    
+    resolved_ = true;
+    LOG_DEBUG(L"JVM telemetry resolved: " << gcBeans_.size() << L" collectors, metaspace pool "
+              << (metaspacePool_ ? L"found" : L"not found"));
+    return true;
+}
+
+bool JvmTelemetry::ReadUsage(JNIEnv* env, jobject usage, int64_t& used, int64_t* committed) {
+    if (env->ExceptionCheck() || !usage) {
+        env->ExceptionClear();
+        return false;
+    }
+    used = env->CallLongMethod(usage, getUsed_);
+    if (committed) {
+        *committed = env->CallLongMethod(usage, getCommitted_);
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return false;
+    }
+    return true;
+}
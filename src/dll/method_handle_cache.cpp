@@ -0,0 +1,151 @@
+#include "../include/method_handle_cache.h"
+#include "handle_invoker_bytes.h"
+
+MethodHandleCache::MethodHandleCache()
+    : invokerClass_(nullptr), create_(nullptr), invoke_(nullptr), defineFailed_(false) {
+}
+
+jobject MethodHandleCache::Find(const std::string& key) const {
+    auto it = invokers_.find(key);
+    return it != invokers_.end() ? it->second : nullptr;
+}
+
+jobject MethodHandleCache::Resolve(JNIEnv* env, const std::string& key, jclass clazz, const std::string& methodName,
+                                   bool stringArgs, jobject receiver) {
+    if (!env || !clazz || IsUnsupported(key)) {
+        return nullptr;
+    }
+    if (!DefineInvokerClass(env)) {
+        unsupported_.insert(key);
+        return nullptr;
+    }
+    
+    jstring name = env->NewStringUTF(methodName.c_str());
+    jobject invoker = name ? env->CallStaticObjectMethod(invokerClass_, create_, clazz, name,
+                                                         stringArgs ? JNI_TRUE : JNI_FALSE, receiver) : nullptr;
+    if (name) {
+        env->DeleteLocalRef(name);
+    }
+    if (env->ExceptionCheck() || !invoker) {
+        // 找不到方法、缺少无参构造器或访问被拒绝：本代内改走JNI路径
+        env->ExceptionClear();
+        unsupported_.insert(key);
+        LOG_WARNING(L"Method handle unavailable, falling back to JNI: " << StringToWString(key));
+        return nullptr;
+    }
+    
+    jobject globalInvoker = env->NewGlobalRef(invoker);
+    env->DeleteLocalRef(invoker);
+    if (!globalInvoker) {
+        return nullptr;
+    }
+    invokers_[key] = globalInvoker;
+    LOG_DEBUG(L"Method handle cached: " << StringToWString(key));
+    return globalInvoker;
+}
+
+void MethodHandleCache::Invoke(JNIEnv* env, jobject invoker, jobjectArray args) {
+    env->CallVoidMethod(invoker, invoke_, args);
+}
+
+void MethodHandleCache::Clear(JNIEnv* env) {
+    if (env) {
+        for (auto& pair : invokers_) {
+            env->DeleteGlobalRef(pair.second);
+        }
+    }
+    invokers_.clear();
+    unsupported_.clear();
+}
+
+void MethodHandleCache::RemoveBySuffix(JNIEnv* env, const std::string& suffix) {
+    for (auto it = invokers_.begin(); it != invokers_.end();) {
+        const std::string& key = it->first;
+        if (key.size() < suffix.size() || key.compare(key.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            ++it;
+            continue;
+        }
+        if (env) {
+            env->DeleteGlobalRef(it->second);
+        }
+        it = invokers_.erase(it);
+    }
+}
+
+void MethodHandleCache::SwapEntries(MethodHandleCache& other) {
+    invokers_.swap(other.invokers_);
+    unsupported_.swap(other.unsupported_);
+}
+
+void MethodHandleCache::Release(JNIEnv* env) {
+    Clear(env);
+    if (env && invokerClass_) {
+        env->DeleteGlobalRef(invokerClass_);
+    }
+    invokerClass_ = nullptr;
+    create_ = nullptr;
+    invoke_ = nullptr;
+}
+
+bool MethodHandleCache::DefineInvokerClass(JNIEnv* env) {
+    if (invokerClass_) {
+        return true;
+    }
+    if (defineFailed_) {
+        return false;
+    }
+    
+    // 定义到系统类加载器中，使其对所有代可见
+    jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+    jmethodID getSystemClassLoader = classLoaderClass ?
+        env->GetStaticMethodID(classLoaderClass, "getSystemClassLoader", "()Ljava/lang/ClassLoader;") : nullptr;
+    jobject systemLoader = getSystemClassLoader ? env->CallStaticObjectMethod(classLoaderClass, getSystemClassLoader) : nullptr;
+    if (!systemLoader || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        if (classLoaderClass) {
+            env->DeleteLocalRef(classLoaderClass);
+        }
+        defineFailed_ = true;
+        LOG_ERROR(L"Failed to get system class loader");
+        return false;
+    }
+    
+    jclass invokerClass = env->DefineClass(INVOKER_CLASS_NAME, systemLoader,
+                                           reinterpret_cast<const jbyte*>(HANDLE_INVOKER_BYTES),
+                                           static_cast<jsize>(HANDLE_INVOKER_BYTES_SIZE));
+    if (!invokerClass || env->ExceptionCheck()) {
+        // 类已由之前的注入或另一个加载器实例定义过，改为从系统类加载器取得
+        env->ExceptionClear();
+        jmethodID loadClass = env->GetMethodID(classLoaderClass, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;");
+        jstring className = env->NewStringUTF("dllinject.HandleInvoker");
+        invokerClass = loadClass && className ? static_cast<jclass>(env->CallObjectMethod(systemLoader, loadClass, className)) : nullptr;
+        if (className) {
+            env->DeleteLocalRef(className);
+        }
+    }
+    env->DeleteLocalRef(systemLoader);
+    env->DeleteLocalRef(classLoaderClass);
+    
+    if (invokerClass && !env->ExceptionCheck()) {
+        create_ = env->GetStaticMethodID(invokerClass, "create",
+                                         "(Ljava/lang/Class;Ljava/lang/String;ZLjava/lang/Object;)Ldllinject/HandleInvoker;");
+        invoke_ = create_ ? env->GetMethodID(invokerClass, "invoke", "([Ljava/lang/Object;)V") : nullptr;
+    }
+    if (!invokerClass || !create_ || !invoke_ || env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        if (invokerClass) {
+            env->DeleteLocalRef(invokerClass);
+        }
+        create_ = nullptr;
+        invoke_ = nullptr;
+        defineFailed_ = true;
+        LOG_ERROR(L"Failed to define HandleInvoker class");
+        return false;
+    }
+    
+    invokerClass_ = static_cast<jclass>(env->NewGlobalRef(invokerClass));
+    env->DeleteLocalRef(invokerClass);
+    LOG_INFO(L"HandleInvoker defined");
+    return invokerClass_ != nullptr;
+}
@@ -0,0 +1,32 @@
+#include "../include/metrics_registry.h"
+
+MetricsRegistry& MetricsRegistry::GetInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::Increment(const std::string& name, int64_t delta) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_[name] += delta;
+}
+
+void MetricsRegistry::Set(const std::string& name, int64_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_[name] = value;
+}
+
+int64_t MetricsRegistry::Get(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = values_.find(name);
+    return it != values_.end() ? it->second : 0;
+}
+
+std::vector<std::pair<std::string, int64_t>> MetricsRegistry::Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::pair<std::string, int64_t>>(values_.begin(), values_.end());
+}
+
+void MetricsRegistry::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_.clear();
+}
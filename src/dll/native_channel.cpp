@@ -0,0 +1,131 @@
+#include "../include/native_channel.h"
+
+namespace {
+
+// 消费线程空闲时的退避参数
+constexpr int IDLE_SPIN_ROUNDS = 64;
+constexpr int IDLE_SLEEP_MS = 1;
+constexpr size_t DRAIN_BATCH = 256;
+
+} // namespace
+
+NativeChannel& NativeChannel::GetInstance() {
+    static NativeChannel instance;
+    return instance;
+}
+
+NativeChannel::~NativeChannel() {
+    // 静态析构在模块卸载时执行，持有加载器锁，不能等待消费线程退出；
+    // 消费线程应已由Close停止（ShutdownInjection或VMDeath），这里只放弃仍未停止的线程
+    if (consumerThread_.joinable()) {
+        running_ = false;
+        consumerThread_.detach();
+    }
+}
+
+ErrorCode NativeChannel::Open(uint32_t capacity) {
+    std::lock_guard<std::mutex> lock(channelMutex_);
+    
+    if (running_) {
+        return ErrorCode::SUCCESS;
+    }
+    
+    if (!toNative_ || !toJava_) {
+        toNative_ = std::make_unique<SharedRingBuffer>(capacity);
+        toJava_ = std::make_unique<SharedRingBuffer>(capacity);
+        if (!toNative_->IsValid() || !toJava_->IsValid()) {
+            LOG_ERROR(L"Failed to allocate native channel buffers");
+            toNative_.reset();
+            toJava_.reset();
+            return ErrorCode::MEMORY_ALLOCATION_FAILED;
+        }
+    }
+    
+    try {
+        running_ = true;
+        consumerThread_ = std::thread(&NativeChannel::ConsumerThreadFunc, this);
+    } catch (const std::exception& e) {
+        running_ = false;
+        LOG_ERROR(L"Failed to start native channel consumer: " << StringToWString(e.what()));
+        return ErrorCode::THREAD_CREATION_FAILED;
+    }
+    
+    LOG_INFO(L"Native channel opened, capacity: " << toNative_->GetCapacity());
+    return ErrorCode::SUCCESS;
+}
+
+void NativeChannel::Close() {
+    std::lock_guard<std::mutex> lock(channelMutex_);
+    
+    if (!running_) {
+        return;
+    }
+    
+    running_ = false;
+    if (consumerThread_.joinable()) {
+        consumerThread_.join();
+    }
+    
+    LOG_INFO(L"Native channel closed, records received: " << recordsReceived_.load()
+             << L", dropped: " << recordsDropped_.load());
+}
+
+bool NativeChannel::Send(ChannelRecordType type, const void* data, uint32_t length) {
+    if (!toJava_) {
+        return false;
+    }
+    
+    // toJava方向可能有多个本地线程写入，串行化以满足单生产者约束
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    return toJava_->TryWrite(static_cast<uint32_t>(type), data, length);
+}
+
+void NativeChannel::SetRecordHandler(RecordHandler handler) {
+    std::lock_guard<std::mutex> lock(handlerMutex_);
+    recordHandler_ = std::move(handler);
+}
+
+void NativeChannel::ConsumerThreadFunc() {
+    LOG_DEBUG(L"Native channel consumer thread started");
+    
+    int idleRounds = 0;
+    auto dispatch = [this](uint32_t type, const uint8_t* data, uint32_t length) {
+        Dispatch(type, data, length);
+    };
+    
+    while (running_) {
+        size_t count = toNative_->Drain(dispatch, DRAIN_BATCH);
+        if (count > 0) {
+            recordsReceived_ += count;
+            idleRounds = 0;
+            continue;
+        }
+        
+        // 空闲退避：先自旋让出CPU，再短暂休眠
+        if (++idleRounds < IDLE_SPIN_ROUNDS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+    }
+    
+    // 退出前处理剩余记录
+    recordsReceived_ += toNative_->Drain(dispatch);
+    LOG_DEBUG(L"Native channel consumer thread ended");
+}
+
+void NativeChannel::Dispatch(uint32_t type, const uint8_t* data, uint32_t length) {
+    if (type == static_cast<uint32_t>(ChannelRecordType::LOG)) {
+        // Java的char与Windows的wchar_t同为UTF-16，直接从共享内存提交到日志记录队列
+        Logger::GetInstance().Submit(LogLevel::INFO, reinterpret_cast<const wchar_t*>(data),
+                                     length / sizeof(wchar_t), L"Java Log: ");
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(handlerMutex_);
+    if (recordHandler_) {
+        recordHandler_(type, data, length);
+    } else {
+        ++recordsDropped_;
+    }
+}
@@ -0,0 +1,444 @@
+#include "../include/security_policy.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+
+// 映像格式版本，改变任一结构的布局时递增
+static const uint32_t POLICY_IMAGE_MAGIC = 0x4950534A;   // "JSPI"
+static const uint32_t POLICY_IMAGE_VERSION = 1;
+
+PatternMatcher::PatternMatcher()
+    : latinClasses_(nullptr), wideClasses_(nullptr), wideClassCount_(0), transitions_(nullptr),
+      classCount_(0), stateCount_(0), patternCount_(0) {
+    Build({});
+}
+
+wchar_t PatternMatcher::Fold(wchar_t c) {
+    return static_cast<wchar_t>(::towupper(c));
+}
+
+uint32_t PatternMatcher::ClassOf(wchar_t c) const {
+    if (static_cast<uint32_t>(c) < 256) {
+        return latinClasses_[static_cast<uint32_t>(c)];
+    }
+    
+    wchar_t folded = Fold(c);
+    if (static_cast<uint32_t>(folded) < 256) {
+        return latinClasses_[static_cast<uint32_t>(folded)];
+    }
+    
+    // wideClasses_按字符升序存放(字符, 类)对
+    size_t low = 0;
+    size_t high = wideClassCount_;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        uint32_t value = wideClasses_[middle * 2];
+        if (value < static_cast<uint32_t>(folded)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low < wideClassCount_ && wideClasses_[low * 2] == static_cast<uint32_t>(folded) ? wideClasses_[low * 2 + 1] : 0;
+}
+
+std::vector<uint32_t> PatternMatcher::Compile(const std::vector<std::wstring>& patterns) {
+    std::vector<std::wstring> folded;
+    for (const auto& pattern : patterns) {
+        if (pattern.empty()) {
+            continue;
+        }
+        std::wstring upper = pattern;
+        std::transform(upper.begin(), upper.end(), upper.begin(), Fold);
+        folded.push_back(upper);
+    }
+    
+    // 字符类：模式中出现的每个折叠字符一类，其余字符都归入0类
+    std::vector<wchar_t> alphabet;
+    for (const auto& pattern : folded) {
+        alphabet.insert(alphabet.end(), pattern.begin(), pattern.end());
+    }
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    const size_t classCount = alphabet.size() + 1;
+    
+    auto classOfFolded = [&alphabet](wchar_t upper) -> uint32_t {
+        auto it = std::lower_bound(alphabet.begin(), alphabet.end(), upper);
+        return it != alphabet.end() && *it == upper ? static_cast<uint32_t>(it - alphabet.begin() + 1) : 0;
+    };
+    
+    std::vector<uint32_t> latinClasses(256);
+    for (uint32_t c = 0; c < latinClasses.size(); ++c) {
+        latinClasses[c] = classOfFolded(Fold(static_cast<wchar_t>(c)));
+    }
+    std::vector<uint32_t> wideClasses;
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        if (static_cast<uint32_t>(alphabet[i]) >= 256) {
+            wideClasses.push_back(static_cast<uint32_t>(alphabet[i]));
+            wideClasses.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    
+    // 字典树，未定义的转移暂记为NONE
+    const uint32_t NONE = UINT32_MAX;
+    std::vector<uint32_t> transitions(classCount, NONE);
+    std::vector<uint8_t> accepting(1, 0);
+    for (const auto& pattern : folded) {
+        uint32_t state = 0;
+        for (wchar_t c : pattern) {
+            size_t index = state * classCount + classOfFolded(c);
+            if (transitions[index] == NONE) {
+                // 扩展转移表会使引用失效，只能按下标访问
+                transitions[index] = static_cast<uint32_t>(accepting.size());
+                transitions.insert(transitions.end(), classCount, NONE);
+                accepting.push_back(0);
+            }
+            state = transitions[index];
+        }
+        accepting[state] = 1;
+    }
+    
+    // 按层次补全失败转移；父状态的失败状态更浅，其转移行此时已经完整
+    std::vector<uint32_t> failure(accepting.size(), 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < classCount; ++c) {
+        uint32_t& next = transitions[c];
+        if (next == NONE) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+        
+        for (size_t c = 0; c < classCount; ++c) {
+            uint32_t& next = transitions[state * classCount + c];
+            uint32_t fallback = transitions[failure[state] * classCount + c];
+            if (next == NONE) {
+                next = fallback;
+            } else {
+                failure[next] = fallback;
+                accepting[next] |= accepting[fallback];
+                queue.push_back(next);
+            }
+        }
+    }
+    
+    // 接受标记并入转移目标，匹配时不再访问单独的数组
+    for (auto& next : transitions) {
+        if (accepting[next]) {
+            next |= ACCEPTING;
+        }
+    }
+    
+    std::vector<uint32_t> image = {
+        static_cast<uint32_t>(folded.size()), static_cast<uint32_t>(classCount),
+        static_cast<uint32_t>(accepting.size()), static_cast<uint32_t>(wideClasses.size() / 2)
+    };
+    image.insert(image.end(), latinClasses.begin(), latinClasses.end());
+    image.insert(image.end(), wideClasses.begin(), wideClasses.end());
+    image.insert(image.end(), transitions.begin(), transitions.end());
+    return image;
+}
+
+bool PatternMatcher::Attach(const uint32_t* image, size_t wordCount) {
+    if (!image || wordCount < 4 + 256) {
+        return false;
+    }
+    
+    const size_t classCount = image[1];
+    const size_t stateCount = image[2];
+    const size_t wideClassCount = image[3];
+    if (classCount == 0 || stateCount == 0 || stateCount >= ACCEPTING ||
+        wordCount != 4 + 256 + wideClassCount * 2 + stateCount * classCount) {
+        return false;
+    }
+    
+    // 映像可能来自外部，逐项检查下标范围，查询时不再检查
+    const uint32_t* latinClasses = image + 4;
+    const uint32_t* wideClasses = latinClasses + 256;
+    const uint32_t* transitions = wideClasses + wideClassCount * 2;
+    for (size_t c = 0; c < 256; ++c) {
+        if (latinClasses[c] >= classCount) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < wideClassCount; ++i) {
+        if (wideClasses[i * 2 + 1] >= classCount || (i > 0 && wideClasses[i * 2] <= wideClasses[i * 2 - 2])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < stateCount * classCount; ++i) {
+        if ((transitions[i] & ~ACCEPTING) >= stateCount) {
+            return false;
+        }
+    }
+    
+    patternCount_ = image[0];
+    classCount_ = classCount;
+    stateCount_ = stateCount;
+    wideClassCount_ = wideClassCount;
+    latinClasses_ = latinClasses;
+    wideClasses_ = wideClasses;
+    transitions_ = transitions;
+    return true;
+}
+
+void PatternMatcher::Build(const std::vector<std::wstring>& patterns) {
+    image_ = Compile(patterns);
+    Attach(image_.data(), image_.size());
+}
+
+bool PatternMatcher::Matches(const std::wstring& text) const {
+    uint32_t state = 0;
+    for (wchar_t c : text) {
+        uint32_t next = transitions_[state * classCount_ + ClassOf(c)];
+        if (next & ACCEPTING) {
+            return true;
+        }
+        state = next;
+    }
+    return false;
+}
+
+ExactNameSet::ExactNameSet()
+    : slots_(nullptr), characters_(nullptr), characterCount_(0), seed_(0), mask_(0), nameCount_(0) {
+    Build({});
+}
+
+wchar_t ExactNameSet::Fold(wchar_t c) {
+    return static_cast<wchar_t>(::towlower(c));
+}
+
+uint32_t ExactNameSet::Hash(const std::wstring& name, uint32_t seed) {
+    // 带种子的FNV-1a，最后混合高位使掩码后的低位分布均匀
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (wchar_t c : name) {
+        hash ^= static_cast<uint32_t>(Fold(c)) & 0xFFFF;
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+std::vector<uint32_t> ExactNameSet::Compile(const std::vector<std::wstring>& names) {
+    std::vector<std::wstring> folded;
+    for (const auto& name : names) {
+        if (name.empty()) {
+            continue;
+        }
+        std::wstring lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), Fold);
+        folded.push_back(lower);
+    }
+    std::sort(folded.begin(), folded.end());
+    folded.erase(std::unique(folded.begin(), folded.end()), folded.end());
+    
+    // 从两倍名称数的槽位开始搜索无冲突的种子，找不到时槽位翻倍
+    std::vector<const std::wstring*> slots;
+    uint32_t seed = 0;
+    if (!folded.empty()) {
+        size_t slotCount = 1;
+        while (slotCount < folded.size() * 2) {
+            slotCount <<= 1;
+        }
+        for (bool found = false; !found; slotCount <<= 1) {
+            slots.assign(slotCount, nullptr);
+            uint32_t mask = static_cast<uint32_t>(slotCount - 1);
+            for (seed = 1; seed <= 64 && !found; ++seed) {
+                bool collided = false;
+                for (const auto& name : folded) {
+                    const std::wstring*& slot = slots[Hash(name, seed) & mask];
+                    if (slot) {
+                        collided = true;
+                        break;
+                    }
+                    slot = &name;
+                }
+                if (!collided) {
+                    found = true;
+                    break;
+                }
+                std::fill(slots.begin(), slots.end(), nullptr);
+            }
+            if (found) {
+                break;
+            }
+        }
+    }
+    
+    // 槽位表后接所有名称的字符
+    const size_t slotCount = slots.size();
+    std::vector<uint32_t> image = {
+        static_cast<uint32_t>(folded.size()), seed, static_cast<uint32_t>(slotCount), 0
+    };
+    image.resize(4 + slotCount * 2, 0);
+    std::vector<uint32_t> characters;
+    for (size_t i = 0; i < slotCount; ++i) {
+        if (slots[i]) {
+            image[4 + i * 2] = static_cast<uint32_t>(characters.size());
+            image[4 + i * 2 + 1] = static_cast<uint32_t>(slots[i]->size());
+            for (wchar_t c : *slots[i]) {
+                characters.push_back(static_cast<uint32_t>(c));
+            }
+        }
+    }
+    image[3] = static_cast<uint32_t>(characters.size());
+    image.insert(image.end(), characters.begin(), characters.end());
+    return image;
+}
+
+bool ExactNameSet::Attach(const uint32_t* image, size_t wordCount) {
+    if (!image || wordCount < 4) {
+        return false;
+    }
+    
+    const size_t slotCount = image[2];
+    const size_t characterCount = image[3];
+    if ((slotCount & (slotCount - 1)) != 0 || wordCount != 4 + slotCount * 2 + characterCount) {
+        return false;
+    }
+    
+    const uint32_t* slots = image + 4;
+    for (size_t i = 0; i < slotCount; ++i) {
+        if (static_cast<uint64_t>(slots[i * 2]) + slots[i * 2 + 1] > characterCount) {
+            return false;
+        }
+    }
+    
+    nameCount_ = image[0];
+    seed_ = image[1];
+    mask_ = slotCount == 0 ? 0 : static_cast<uint32_t>(slotCount - 1);
+    slots_ = slotCount == 0 ? nullptr : slots;
+    characters_ = slots + slotCount * 2;
+    characterCount_ = characterCount;
+    return true;
+}
+
+void ExactNameSet::Build(const std::vector<std::wstring>& names) {
+    image_ = Compile(names);
+    Attach(image_.data(), image_.size());
+}
+
+bool ExactNameSet::Contains(const std::wstring& name) const {
+    if (!slots_ || name.empty()) {
+        return false;
+    }
+    
+    const uint32_t* slot = slots_ + (Hash(name, seed_) & mask_) * 2;
+    if (slot[1] != name.size()) {
+        return false;
+    }
+    const uint32_t* characters = characters_ + slot[0];
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (static_cast<uint32_t>(Fold(name[i])) != characters[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SecurityPolicy::SecurityPolicy() : mappedView_(nullptr), imageWords_(0) {}
+
+SecurityPolicy::~SecurityPolicy() {
+    Platform::FreePages(mappedView_, GetImageSize());
+}
+
+std::unique_ptr<SecurityPolicy> SecurityPolicy::Compile(const std::vector<std::wstring>& forbiddenPathPatterns,
+                                                        const std::vector<std::wstring>& criticalProcesses) {
+    std::vector<uint32_t> forbiddenPaths = PatternMatcher::Compile(forbiddenPathPatterns);
+    std::vector<uint32_t> processes = ExactNameSet::Compile(criticalProcesses);
+    
+    // 头部：标识、版本，以及各节的(偏移, 字数)
+    const uint32_t headerWords = 6;
+    std::vector<uint32_t> image = {
+        POLICY_IMAGE_MAGIC, POLICY_IMAGE_VERSION,
+        headerWords, static_cast<uint32_t>(forbiddenPaths.size()),
+        static_cast<uint32_t>(headerWords + forbiddenPaths.size()), static_cast<uint32_t>(processes.size())
+    };
+    image.insert(image.end(), forbiddenPaths.begin(), forbiddenPaths.end());
+    image.insert(image.end(), processes.begin(), processes.end());
+    
+    std::unique_ptr<SecurityPolicy> policy(new SecurityPolicy());
+    const uint32_t* published = policy->Publish(image);
+    policy->imageWords_ = image.size();
+    
+    // 从发布后的只读副本建立视图，此后不再访问编译用的临时映像
+    if (!policy->forbiddenPaths_.Attach(published + published[2], published[3]) ||
+        !policy->criticalProcesses_.Attach(published + published[4], published[5])) {
+        LOG_ERROR(L"Compiled security policy image is inconsistent");
+        return nullptr;
+    }
+    return policy;
+}
+
+const uint32_t* SecurityPolicy::Publish(const std::vector<uint32_t>& image) {
+    const size_t bytes = image.size() * sizeof(uint32_t);
+    
+    // 独立的匿名页面：写入后改为只读，之后对映像的意外写入会立即出错
+    void* pages = Platform::AllocatePages(bytes);
+    if (pages) {
+        memcpy(pages, image.data(), bytes);
+        if (Platform::ProtectPagesReadOnly(pages, bytes)) {
+            mappedView_ = pages;
+            return static_cast<const uint32_t*>(mappedView_);
+        }
+        Platform::FreePages(pages, bytes);
+    }
+    
+    LOG_WARNING(L"Failed to map security policy image, using heap memory: " << Platform::GetLastSystemError());
+    heapImage_ = image;
+    return heapImage_.data();
+}
+
+ErrorCode SecurityPolicy::ParseFile(const std::wstring& policyPath,
+                                    std::vector<std::wstring>& forbiddenPathPatterns,
+                                    std::vector<std::wstring>& criticalProcesses) {
+    std::ifstream file(Platform::ToFilesystemPath(policyPath));
+    if (!file) {
+        LOG_ERROR(L"Failed to open security policy: " << policyPath);
+        return ErrorCode::INVALID_PARAMETER;
+    }
+    
+    std::vector<std::wstring> paths;
+    std::vector<std::wstring> processes;
+    std::vector<std::wstring>* section = nullptr;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        size_t end = line.find_last_not_of(" \t\r");
+        std::string value = line.substr(begin, end - begin + 1);
+        
+        if (value == "[forbidden_paths]") {
+            section = &paths;
+        } else if (value == "[critical_processes]") {
+            section = &processes;
+        } else if (value.front() == '[' || !section) {
+            LOG_ERROR(L"Invalid security policy line " << lineNumber << L": " << StringToWString(value));
+            return ErrorCode::INVALID_PARAMETER;
+        } else if (value.length() > MAX_PATH_LENGTH) {
+            LOG_ERROR(L"Security policy rule too long at line " << lineNumber);
+            return ErrorCode::INVALID_PARAMETER;
+        } else {
+            section->push_back(StringToWString(value));
+        }
+    }
+    
+    LOG_DEBUG(L"Loaded " << paths.size() << L" forbidden path patterns and " << processes.size()
+              << L" critical processes from: " << policyPath);
+    forbiddenPathPatterns.insert(forbiddenPathPatterns.end(), paths.begin(), paths.end());
+    criticalProcesses.insert(criticalProcesses.end(), processes.begin(), processes.end());
+    return ErrorCode::SUCCESS;
+}
@@ -1,35 +1,27 @@
 #include "../include/security_utils.h"
-#include <shlwapi.h>
-#include <wintrust.h>
-#include <softpub.h>
+#include <algorithm>
 #include <random>
 #include <sstream>
 #include <iomanip>
 
 // 静态成员初始化
-const std::string SecurityUtils::DANGEROUS_CHARS = ";<>|&$`\"'\\*?[]{}()";
-const std::wstring SecurityUtils::DANGEROUS_WCHARS = L";<>|&$`\"'\\*?[]{}()";
-
-const std::vector<std::wstring> SecurityUtils::SYSTEM_CRITICAL_PROCESSES = {
-    L"csrss.exe", L"winlogon.exe", L"services.exe", L"lsass.exe", L"svchost.exe",
-    L"explorer.exe", L"dwm.exe", L"wininit.exe", L"smss.exe", L"system",
-    L"registry", L"audiodg.exe", L"conhost.exe", L"dllhost.exe"
-};
-
-const std::vector<std::wstring> SecurityUtils::ALLOWED_DLL_EXTENSIONS = {
-    L".dll", L".DLL"
-};
+const CharClassScanner SecurityUtils::DANGEROUS_CHAR_SCANNER(JAVA_NAME_DANGEROUS_CHARS);
+const CharClassScanner SecurityUtils::CLASS_NAME_CHAR_SCANNER(
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_.");
 
 const std::vector<std::wstring> SecurityUtils::ALLOWED_JAR_EXTENSIONS = {
     L".jar", L".JAR"
 };
 
-const std::vector<std::wstring> SecurityUtils::FORBIDDEN_PATH_PATTERNS = {
-    L"\\Windows\\System32\\", L"\\Windows\\SysWOW64\\", L"\\Windows\\WinSxS\\",
-    L"\\Program Files\\Windows Defender\\", L"\\Program Files (x86)\\Windows Defender\\",
-    L"\\Windows\\Boot\\", L"\\Windows\\Fonts\\", L"\\Windows\\inf\\",
-    L"\\$Recycle.Bin\\", L"\\System Volume Information\\"
-};
+// 验证缓存的容量上限，超出时整体清空（版本缓存会产生大量只用一次的路径）
+static const size_t MAX_JAR_PATH_CACHE_ENTRIES = 256;
+
+std::atomic<const SecurityPolicy*> SecurityUtils::securityPolicy_(nullptr);
+std::mutex SecurityUtils::policyMutex_;
+std::vector<std::unique_ptr<const SecurityPolicy>> SecurityUtils::policies_;
+
+std::mutex SecurityUtils::jarPathCacheMutex_;
+std::unordered_map<std::wstring, SecurityUtils::JarPathCacheEntry> SecurityUtils::jarPathCache_;
 
 bool SecurityUtils::ValidateProcessName(const std::wstring& processName) {
     if (processName.empty() || processName.length() > 260) {
@@ -59,7 +51,7 @@ bool SecurityUtils::ValidateProcessName(const std::wstring& processName) {
 }
 
 bool SecurityUtils::ValidateDllPath(const std::wstring& dllPath) {
-    if (dllPath.empty() || dllPath.length() > MAX_PATH) {
+    if (dllPath.empty() || dllPath.length() > MAX_PATH_LENGTH) {
         LOG_ERROR(L"Invalid DLL path length");
         return false;
     }
@@ -86,11 +78,28 @@ bool SecurityUtils::ValidateDllPath(const std::wstring& dllPath) {
 }
 
 bool SecurityUtils::ValidateJarPath(const std::wstring& jarPath) {
-    if (jarPath.empty() || jarPath.length() > MAX_PATH) {
+    if (jarPath.empty() || jarPath.length() > MAX_PATH_LENGTH) {
         LOG_ERROR(L"Invalid JAR path length");
         return false;
     }
     
+    // 命中缓存时只比较文件标识：路径指向的文件被替换、修改或删除后标识不同，移除缓存项并完整验证；
+    // 缓存项在其他安全策略下验证时同样重新验证
+    std::wstring cacheKey = MakeJarPathCacheKey(jarPath);
+    const SecurityPolicy* policy = GetSecurityPolicy();
+    Platform::FileIdentity identity;
+    bool hasIdentity = Platform::QueryFileIdentity(jarPath, identity);
+    {
+        std::lock_guard<std::mutex> lock(jarPathCacheMutex_);
+        auto it = jarPathCache_.find(cacheKey);
+        if (it != jarPathCache_.end()) {
+            if (hasIdentity && it->second.identity == identity && it->second.policy == policy) {
+                return true;
+            }
+            jarPathCache_.erase(it);
+        }
+    }
+    
     // 检查文件扩展名
     if (!HasValidExtension(jarPath, ALLOWED_JAR_EXTENSIONS)) {
         LOG_ERROR(L"Invalid JAR file extension");
@@ -109,59 +118,99 @@ bool SecurityUtils::ValidateJarPath(const std::wstring& jarPath) {
         return false;
     }
     
+    // 无法读取文件标识时不缓存，下次仍完整验证
+    if (hasIdentity || Platform::QueryFileIdentity(jarPath, identity)) {
+        std::lock_guard<std::mutex> lock(jarPathCacheMutex_);
+        if (jarPathCache_.size() >= MAX_JAR_PATH_CACHE_ENTRIES) {
+            jarPathCache_.clear();
+        }
+        jarPathCache_[cacheKey] = JarPathCacheEntry{ identity, policy };
+    }
+    
     return true;
 }
 
+void SecurityUtils::InvalidateJarPathCache(const std::wstring& jarPath) {
+    std::wstring cacheKey = MakeJarPathCacheKey(jarPath);
+    
+    std::lock_guard<std::mutex> lock(jarPathCacheMutex_);
+    auto it = jarPathCache_.find(cacheKey);
+    if (it == jarPathCache_.end()) {
+        return;
+    }
+    
+    // 同一文件可能以不同路径（短文件名、大小写、相对路径）被验证过
+    Platform::FileIdentity identity = it->second.identity;
+    for (auto entry = jarPathCache_.begin(); entry != jarPathCache_.end();) {
+        if (entry->second.identity == identity) {
+            entry = jarPathCache_.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+void SecurityUtils::ClearJarPathCache() {
+    std::lock_guard<std::mutex> lock(jarPathCacheMutex_);
+    jarPathCache_.clear();
+}
+
 bool SecurityUtils::ValidateClassName(const std::string& className) {
-    if (className.empty() || className.length() > MAX_CLASS_NAME_LENGTH) {
+    switch (JavaNameValidator::CheckClassName(className)) {
+    case JavaNameValidator::Result::VALID:
+        return true;
+    case JavaNameValidator::Result::INVALID_LENGTH:
         LOG_ERROR(L"Invalid class name length");
         return false;
-    }
-    
-    // 检查危险字符
-    if (ContainsDangerousChars(className)) {
+    case JavaNameValidator::Result::DANGEROUS_CHARS:
         LOG_ERROR(L"Class name contains dangerous characters");
         return false;
-    }
-    
-    // 检查Java类名格式（简单验证）
-    std::regex classNamePattern(R"(^[a-zA-Z_$][a-zA-Z0-9_$]*(\.[a-zA-Z_$][a-zA-Z0-9_$]*)*$)");
-    if (!std::regex_match(className, classNamePattern)) {
+    default:
         LOG_ERROR(L"Invalid Java class name format");
         return false;
     }
-    
-    return true;
 }
 
 bool SecurityUtils::ValidateMethodName(const std::string& methodName) {
-    if (methodName.empty() || methodName.length() > MAX_METHOD_NAME_LENGTH) {
+    switch (JavaNameValidator::CheckMethodName(methodName)) {
+    case JavaNameValidator::Result::VALID:
+        return true;
+    case JavaNameValidator::Result::INVALID_LENGTH:
         LOG_ERROR(L"Invalid method name length");
         return false;
-    }
-    
-    // 检查危险字符
-    if (ContainsDangerousChars(methodName)) {
+    case JavaNameValidator::Result::DANGEROUS_CHARS:
         LOG_ERROR(L"Method name contains dangerous characters");
         return false;
-    }
-    
-    // 检查Java方法名格式（简单验证）
-    std::regex methodNamePattern(R"(^[a-zA-Z_$][a-zA-Z0-9_$]*$)");
-    if (!std::regex_match(methodName, methodNamePattern)) {
+    default:
         LOG_ERROR(L"Invalid Java method name format");
         return false;
     }
+}
+
+std::vector<size_t> SecurityUtils::FindInvalidClassNames(const std::vector<std::string_view>& classNames) {
+    std::vector<size_t> invalidIndices;
+    for (size_t i = 0; i < classNames.size(); ++i) {
+        std::string_view className = classNames[i];
+        // 字符集检查覆盖危险字符（含'$'）与非法字符，剩余的只有各段首字符的规则
+        if (className.empty() || className.length() > MAX_CLASS_NAME_LENGTH ||
+            CLASS_NAME_CHAR_SCANNER.FindFirstNotOf(className) != CharClassScanner::npos ||
+            !HasValidClassNameSegments(className)) {
+            invalidIndices.push_back(i);
+        }
+    }
     
-    return true;
+    if (!invalidIndices.empty()) {
+        LOG_DEBUG(invalidIndices.size() << L" of " << classNames.size() << L" class names failed validation");
+    }
+    return invalidIndices;
 }
 
 bool SecurityUtils::ContainsDangerousChars(const std::string& input) {
-    return input.find_first_of(DANGEROUS_CHARS) != std::string::npos;
+    return DANGEROUS_CHAR_SCANNER.FindFirstOf(input) != CharClassScanner::npos;
 }
 
 bool SecurityUtils::ContainsDangerousChars(const std::wstring& input) {
-    return input.find_first_of(DANGEROUS_WCHARS) != std::wstring::npos;
+    return DANGEROUS_CHAR_SCANNER.FindFirstOf(input) != CharClassScanner::npos;
 }
 
 bool SecurityUtils::IsPathSafe(const std::wstring& path) {
@@ -181,108 +230,64 @@ bool SecurityUtils::IsPathSafe(const std::wstring& path) {
     }
     
     // 检查是否为绝对路径
-    if (normalizedPath.length() < 3 || normalizedPath[1] != L':' || normalizedPath[2] != L'\\') {
-        LOG_ERROR(L"Path is not an absolute Windows path");
+    if (!IsAbsolutePath(normalizedPath)) {
+        LOG_ERROR(L"Path is not an absolute path");
         return false;
     }
     
     return true;
 }
 
-bool SecurityUtils::HasSufficientPrivileges() {
-    HANDLE hToken = NULL;
-    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken)) {
-        LOG_ERROR(L"Failed to open process token, error: " << GetLastError());
-        return false;
-    }
-    
-    ScopedHandle tokenHandle(hToken);
-    
-    TOKEN_ELEVATION elevation;
-    DWORD dwSize;
-    if (!GetTokenInformation(hToken, TokenElevation, &elevation, sizeof(elevation), &dwSize)) {
-        LOG_ERROR(L"Failed to get token elevation info, error: " << GetLastError());
-        return false;
-    }
-    
-    if (!elevation.TokenIsElevated) {
-        LOG_WARNING(L"Process is not running with elevated privileges");
-        return false;
-    }
-    
-    return true;
+bool SecurityUtils::IsSystemCriticalProcess(const std::wstring& processName) {
+    return GetSecurityPolicy()->IsCriticalProcess(processName);
 }
 
-bool SecurityUtils::IsSystemCriticalProcess(DWORD processId) {
-    // 系统进程通常有较低的PID
-    if (processId <= 8) {
-        return true;
+ErrorCode SecurityUtils::LoadSecurityPolicy(const std::wstring& policyPath) {
+    std::vector<std::wstring> forbiddenPathPatterns = FORBIDDEN_PATH_PATTERNS;
+    std::vector<std::wstring> criticalProcesses = SYSTEM_CRITICAL_PROCESSES;
+    ErrorCode result = SecurityPolicy::ParseFile(policyPath, forbiddenPathPatterns, criticalProcesses);
+    if (result != ErrorCode::SUCCESS) {
+        return result;
     }
     
-    ScopedHandle hProcess(OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId));
-    if (!hProcess.IsValid()) {
-        // 如果无法打开进程，可能是系统进程
-        return true;
+    std::unique_ptr<const SecurityPolicy> policy = SecurityPolicy::Compile(forbiddenPathPatterns, criticalProcesses);
+    if (!policy) {
+        return ErrorCode::SECURITY_CHECK_FAILED;
     }
     
-    wchar_t processName[MAX_PATH];
-    DWORD size = MAX_PATH;
-    if (QueryFullProcessImageNameW(hProcess.Get(), 0, processName, &size)) {
-        std::wstring fullPath(processName);
-        size_t lastSlash = fullPath.find_last_of(L'\\');
-        if (lastSlash != std::wstring::npos) {
-            std::wstring fileName = fullPath.substr(lastSlash + 1);
-            return IsSystemCriticalProcess(fileName);
-        }
+    LOG_INFO(L"Security policy loaded: " << policy->GetForbiddenPathCount() << L" forbidden path patterns, "
+             << policy->GetCriticalProcessCount() << L" critical processes");
+    
+    {
+        std::lock_guard<std::mutex> lock(policyMutex_);
+        securityPolicy_.store(PublishSecurityPolicy(std::move(policy)), std::memory_order_release);
     }
     
-    return false;
+    // 新规则可能拒绝已缓存的路径：旧策略下的缓存项在下次验证时失效，这里不获取缓存锁，
+    // 策略文件监控线程因此不会与持有缓存锁的线程互相等待
+    return ErrorCode::SUCCESS;
 }
 
-bool SecurityUtils::IsSystemCriticalProcess(const std::wstring& processName) {
-    std::wstring lowerProcessName = processName;
-    std::transform(lowerProcessName.begin(), lowerProcessName.end(), lowerProcessName.begin(), ::towlower);
-    
-    for (const auto& criticalProcess : SYSTEM_CRITICAL_PROCESSES) {
-        std::wstring lowerCritical = criticalProcess;
-        std::transform(lowerCritical.begin(), lowerCritical.end(), lowerCritical.begin(), ::towlower);
-        
-        if (lowerProcessName == lowerCritical) {
-            return true;
-        }
-    }
-    
-    return false;
+const SecurityPolicy* SecurityUtils::PublishSecurityPolicy(std::unique_ptr<const SecurityPolicy> policy) {
+    // 调用者持有policyMutex_
+    policies_.push_back(std::move(policy));
+    return policies_.back().get();
 }
 
-bool SecurityUtils::VerifyFileSignature(const std::wstring& filePath) {
-    WINTRUST_FILE_INFO fileInfo = {};
-    fileInfo.cbStruct = sizeof(WINTRUST_FILE_INFO);
-    fileInfo.pcwszFilePath = filePath.c_str();
-    fileInfo.hFile = NULL;
-    fileInfo.pgKnownSubject = NULL;
-    
-    WINTRUST_DATA winTrustData = {};
-    winTrustData.cbStruct = sizeof(WINTRUST_DATA);
-    winTrustData.pPolicyCallbackData = NULL;
-    winTrustData.pSIPClientData = NULL;
-    winTrustData.dwUIChoice = WTD_UI_NONE;
-    winTrustData.fdwRevocationChecks = WTD_REVOKE_NONE;
-    winTrustData.dwUnionChoice = WTD_CHOICE_FILE;
-    winTrustData.dwStateAction = WTD_STATEACTION_VERIFY;
-    winTrustData.hWVTStateData = NULL;
-    winTrustData.pwszURLReference = NULL;
-    winTrustData.dwProvFlags = WTD_SAFER_FLAG;
-    winTrustData.pFile = &fileInfo;
-    
-    GUID policyGUID = WINTRUST_ACTION_GENERIC_VERIFY_V2;
-    LONG result = WinVerifyTrust(NULL, &policyGUID, &winTrustData);
-    
-    // 清理
-    winTrustData.dwStateAction = WTD_STATEACTION_CLOSE;
-    WinVerifyTrust(NULL, &policyGUID, &winTrustData);
+const SecurityPolicy* SecurityUtils::GetSecurityPolicy() {
+    const SecurityPolicy* policy = securityPolicy_.load(std::memory_order_acquire);
+    if (policy) {
+        return policy;
+    }
     
-    return result == ERROR_SUCCESS;
+    // 只在首次使用时加锁构建内置策略
+    std::lock_guard<std::mutex> lock(policyMutex_);
+    policy = securityPolicy_.load(std::memory_order_acquire);
+    if (!policy) {
+        policy = PublishSecurityPolicy(SecurityPolicy::Compile(FORBIDDEN_PATH_PATTERNS, SYSTEM_CRITICAL_PROCESSES));
+        securityPolicy_.store(policy, std::memory_order_release);
+    }
+    return policy;
 }
 
 void SecurityUtils::SecureZeroMemory(void* ptr, size_t size) {
@@ -317,7 +322,7 @@ bool SecurityUtils::HasValidExtension(const std::wstring& filePath, const std::v
     
     std::wstring extension = filePath.substr(dotPos);
     for (const auto& allowedExt : allowedExtensions) {
-        if (_wcsicmp(extension.c_str(), allowedExt.c_str()) == 0) {
+        if (EqualsIgnoreCase(extension, allowedExt)) {
             return true;
         }
     }
@@ -326,26 +331,24 @@ bool SecurityUtils::HasValidExtension(const std::wstring& filePath, const std::v
 }
 
 bool SecurityUtils::MatchesForbiddenPattern(const std::wstring& path) {
-    std::wstring upperPath = path;
-    std::transform(upperPath.begin(), upperPath.end(), upperPath.begin(), ::towupper);
-    
-    for (const auto& pattern : FORBIDDEN_PATH_PATTERNS) {
-        std::wstring upperPattern = pattern;
-        std::transform(upperPattern.begin(), upperPattern.end(), upperPattern.begin(), ::towupper);
+    return GetSecurityPolicy()->MatchesForbiddenPath(path);
+}
+
+bool SecurityUtils::HasValidClassNameSegments(std::string_view className) {
+    size_t segmentStart = 0;
+    while (true) {
+        if (segmentStart >= className.length()) {
+            return false;
+        }
+        char first = className[segmentStart];
+        if (first == '.' || (first >= '0' && first <= '9')) {
+            return false;
+        }
         
-        if (upperPath.find(upperPattern) != std::wstring::npos) {
+        size_t dot = className.find('.', segmentStart);
+        if (dot == std::string_view::npos) {
             return true;
         }
+        segmentStart = dot + 1;
     }
-    
-    return false;
 }
-
-std::wstring SecurityUtils::NormalizePath(const std::wstring& path) {
-    wchar_t buffer[MAX_PATH];
-    if (GetFullPathNameW(path.c_str(), MAX_PATH, buffer, NULL) == 0) {
-        return path; // 如果失败，返回原路径
-    }
-    
-    return std::wstring(buffer);
-}
\ No newline at end of file
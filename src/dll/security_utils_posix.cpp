@@ -0,0 +1,77 @@
+// SecurityUtils中与POSIX（Linux）相关的部分：内置规则、权限与进程查询、路径规范化
+#include "../include/security_utils.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+const std::vector<std::wstring> SecurityUtils::SYSTEM_CRITICAL_PROCESSES = {
+    L"init", L"systemd", L"kthreadd", L"systemd-journald", L"systemd-logind",
+    L"systemd-udevd", L"udevd", L"dbus-daemon", L"sshd", L"polkitd"
+};
+
+const std::vector<std::wstring> SecurityUtils::ALLOWED_DLL_EXTENSIONS = {
+    L".so"
+};
+
+const std::vector<std::wstring> SecurityUtils::FORBIDDEN_PATH_PATTERNS = {
+    L"/proc/", L"/sys/", L"/dev/", L"/boot/", L"/etc/",
+    L"/lib/modules/", L"/usr/lib/modules/", L"/lost+found/"
+};
+
+bool SecurityUtils::HasSufficientPrivileges() {
+    // 附加到其他用户的进程需要root；同一用户的进程受ptrace_scope限制，这里只检查有效用户
+    if (geteuid() != 0) {
+        LOG_WARNING(L"Process is not running with elevated privileges");
+        return false;
+    }
+    
+    return true;
+}
+
+bool SecurityUtils::IsSystemCriticalProcess(uint32_t processId) {
+    // init与kthreadd
+    if (processId <= 2) {
+        return true;
+    }
+    
+    // 内核线程没有命令行，无法读取进程信息时同样视为系统进程
+    std::string procDirectory = "/proc/" + std::to_string(processId);
+    std::ifstream cmdline(procDirectory + "/cmdline");
+    if (!cmdline || cmdline.peek() == std::ifstream::traits_type::eof()) {
+        return true;
+    }
+    
+    std::ifstream comm(procDirectory + "/comm");
+    std::string processName;
+    if (!std::getline(comm, processName)) {
+        return true;
+    }
+    
+    return IsSystemCriticalProcess(StringToWString(processName));
+}
+
+bool SecurityUtils::VerifyFileSignature(const std::wstring& filePath) {
+    // 没有与Authenticode对应的系统级签名验证，JAR的完整性由JarVerifier的可信摘要列表保证
+    LOG_DEBUG(L"File signature verification is not available on this platform: " << filePath);
+    return false;
+}
+
+std::wstring SecurityUtils::NormalizePath(const std::wstring& path) {
+    // 与GetFullPathNameW一致：转换为绝对路径并按字面折叠"."与".."，不解析符号链接
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(Platform::ToFilesystemPath(path), error);
+    if (error) {
+        return path; // 如果失败，返回原路径
+    }
+    
+    return Platform::FromFilesystemPath(absolute.lexically_normal());
+}
+
+bool SecurityUtils::IsAbsolutePath(const std::wstring& normalizedPath) {
+    return !normalizedPath.empty() && normalizedPath[0] == L'/';
+}
+
+std::wstring SecurityUtils::MakeJarPathCacheKey(const std::wstring& path) {
+    // 文件系统区分大小写，不折叠
+    return NormalizePath(path);
+}
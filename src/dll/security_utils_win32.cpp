@@ -0,0 +1,121 @@
+// SecurityUtils中与Windows相关的部分：内置规则、令牌与进程查询、Authenticode签名、路径规范化
+#include "../include/security_utils.h"
+#include <wintrust.h>
+#include <softpub.h>
+#include <algorithm>
+
+const std::vector<std::wstring> SecurityUtils::SYSTEM_CRITICAL_PROCESSES = {
+    L"csrss.exe", L"winlogon.exe", L"services.exe", L"lsass.exe", L"svchost.exe",
+    L"explorer.exe", L"dwm.exe", L"wininit.exe", L"smss.exe", L"system",
+    L"registry", L"audiodg.exe", L"conhost.exe", L"dllhost.exe"
+};
+
+const std::vector<std::wstring> SecurityUtils::ALLOWED_DLL_EXTENSIONS = {
+    L".dll", L".DLL"
+};
+
+const std::vector<std::wstring> SecurityUtils::FORBIDDEN_PATH_PATTERNS = {
+    L"\\Windows\\System32\\", L"\\Windows\\SysWOW64\\", L"\\Windows\\WinSxS\\",
+    L"\\Program Files\\Windows Defender\\", L"\\Program Files (x86)\\Windows Defender\\",
+    L"\\Windows\\Boot\\", L"\\Windows\\Fonts\\", L"\\Windows\\inf\\",
+    L"\\$Recycle.Bin\\", L"\\System Volume Information\\"
+};
+
+bool SecurityUtils::HasSufficientPrivileges() {
+    HANDLE hToken = NULL;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken)) {
+        LOG_ERROR(L"Failed to open process token, error: " << GetLastError());
+        return false;
+    }
+    
+    ScopedHandle tokenHandle(hToken);
+    
+    TOKEN_ELEVATION elevation;
+    DWORD dwSize;
+    if (!GetTokenInformation(hToken, TokenElevation, &elevation, sizeof(elevation), &dwSize)) {
+        LOG_ERROR(L"Failed to get token elevation info, error: " << GetLastError());
+        return false;
+    }
+    
+    if (!elevation.TokenIsElevated) {
+        LOG_WARNING(L"Process is not running with elevated privileges");
+        return false;
+    }
+    
+    return true;
+}
+
+bool SecurityUtils::IsSystemCriticalProcess(uint32_t processId) {
+    // 系统进程通常有较低的PID
+    if (processId <= 8) {
+        return true;
+    }
+    
+    ScopedHandle hProcess(OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId));
+    if (!hProcess) {
+        // 如果无法打开进程，可能是系统进程
+        return true;
+    }
+    
+    wchar_t processName[MAX_PATH];
+    DWORD size = MAX_PATH;
+    if (QueryFullProcessImageNameW(hProcess.get(), 0, processName, &size)) {
+        std::wstring fullPath(processName);
+        size_t lastSlash = fullPath.find_last_of(L'\\');
+        if (lastSlash != std::wstring::npos) {
+            std::wstring fileName = fullPath.substr(lastSlash + 1);
+            return IsSystemCriticalProcess(fileName);
+        }
+    }
+    
+    return false;
+}
+
+bool SecurityUtils::VerifyFileSignature(const std::wstring& filePath) {
+    WINTRUST_FILE_INFO fileInfo = {};
+    fileInfo.cbStruct = sizeof(WINTRUST_FILE_INFO);
+    fileInfo.pcwszFilePath = filePath.c_str();
+    fileInfo.hFile = NULL;
+    fileInfo.pgKnownSubject = NULL;
+    
+    WINTRUST_DATA winTrustData = {};
+    winTrustData.cbStruct = sizeof(WINTRUST_DATA);
+    winTrustData.pPolicyCallbackData = NULL;
+    winTrustData.pSIPClientData = NULL;
+    winTrustData.dwUIChoice = WTD_UI_NONE;
+    winTrustData.fdwRevocationChecks = WTD_REVOKE_NONE;
+    winTrustData.dwUnionChoice = WTD_CHOICE_FILE;
+    winTrustData.dwStateAction = WTD_STATEACTION_VERIFY;
+    winTrustData.hWVTStateData = NULL;
+    winTrustData.pwszURLReference = NULL;
+    winTrustData.dwProvFlags = WTD_SAFER_FLAG;
+    winTrustData.pFile = &fileInfo;
+    
+    GUID policyGUID = WINTRUST_ACTION_GENERIC_VERIFY_V2;
+    LONG result = WinVerifyTrust(NULL, &policyGUID, &winTrustData);
+    
+    // 清理
+    winTrustData.dwStateAction = WTD_STATEACTION_CLOSE;
+    WinVerifyTrust(NULL, &policyGUID, &winTrustData);
+    
+    return result == ERROR_SUCCESS;
+}
+
+std::wstring SecurityUtils::NormalizePath(const std::wstring& path) {
+    wchar_t buffer[MAX_PATH];
+    if (GetFullPathNameW(path.c_str(), MAX_PATH, buffer, NULL) == 0) {
+        return path; // 如果失败，返回原路径
+    }
+    
+    return std::wstring(buffer);
+}
+
+bool SecurityUtils::IsAbsolutePath(const std::wstring& normalizedPath) {
+    return normalizedPath.length() >= 3 && normalizedPath[1] == L':' && normalizedPath[2] == L'\\';
+}
+
+std::wstring SecurityUtils::MakeJarPathCacheKey(const std::wstring& path) {
+    std::wstring key = NormalizePath(path);
+    std::transform(key.begin(), key.end(), key.begin(), ::towupper);
+    return key;
+}
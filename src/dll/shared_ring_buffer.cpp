@@ -0,0 +1,86 @@
+#include "../include/shared_ring_buffer.h"
+
+namespace {
+
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = SharedRingBuffer::MIN_CAPACITY;
+    while (result < value && result < SharedRingBuffer::MAX_CAPACITY) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+SharedRingBuffer::SharedRingBuffer(uint32_t capacity)
+    : memory_(nullptr), data_(nullptr), capacity_(RoundUpToPowerOfTwo(capacity)) {
+    // 按页分配的内存已清零且页对齐，读写位置天然满足8字节对齐
+    memory_ = static_cast<uint8_t*>(Platform::AllocatePages(GetMemorySize()));
+    if (!memory_) {
+        LOG_ERROR(L"Failed to allocate ring buffer memory, size: " << GetMemorySize() << L", error: " << Platform::GetLastSystemError());
+        return;
+    }
+    
+    data_ = memory_ + HEADER_SIZE;
+    uint32_t magic = MAGIC;
+    memcpy(memory_, &magic, sizeof(magic));
+    memcpy(memory_ + 4, &capacity_, sizeof(capacity_));
+    WritePos()->store(0, std::memory_order_relaxed);
+    ReadPos()->store(0, std::memory_order_relaxed);
+    
+    LOG_DEBUG(L"Shared ring buffer created, capacity: " << capacity_);
+}
+
+SharedRingBuffer::~SharedRingBuffer() {
+    if (memory_) {
+        Platform::FreePages(memory_, GetMemorySize());
+        memory_ = nullptr;
+        data_ = nullptr;
+    }
+}
+
+bool SharedRingBuffer::TryWrite(uint32_t type, const void* data, uint32_t length) {
+    if (!memory_ || (length > 0 && !data) || length > GetMaxPayload()) {
+        return false;
+    }
+    
+    uint32_t recordSize = RecordSize(length);
+    int64_t write = WritePos()->load(std::memory_order_relaxed);
+    int64_t read = ReadPos()->load(std::memory_order_acquire);
+    uint64_t used = static_cast<uint64_t>(write - read);
+    
+    uint32_t offset = static_cast<uint32_t>(write) & (capacity_ - 1);
+    uint32_t contiguous = capacity_ - offset;
+    
+    if (recordSize > contiguous) {
+        // 尾部放不下：写入填充记录后从数据区起点继续
+        if (used + contiguous + recordSize > capacity_) {
+            return false;
+        }
+        int32_t padding = PADDING_RECORD;
+        memcpy(data_ + offset, &padding, sizeof(padding));
+        write += contiguous;
+        offset = 0;
+    } else if (used + recordSize > capacity_) {
+        return false;
+    }
+    
+    int32_t recordLength = static_cast<int32_t>(length);
+    memcpy(data_ + offset, &recordLength, sizeof(recordLength));
+    memcpy(data_ + offset + 4, &type, sizeof(type));
+    if (length > 0) {
+        memcpy(data_ + offset + RECORD_HEADER_SIZE, data, length);
+    }
+    
+    WritePos()->store(write + recordSize, std::memory_order_release);
+    return true;
+}
+
+uint64_t SharedRingBuffer::GetUsedBytes() const {
+    if (!memory_) {
+        return 0;
+    }
+    int64_t write = WritePos()->load(std::memory_order_acquire);
+    int64_t read = ReadPos()->load(std::memory_order_acquire);
+    return static_cast<uint64_t>(write - read);
+}
@@ -0,0 +1,261 @@
+#include "../include/snapshot_class_loader.h"
+#include "snapshot_class_loader_bytes.h"
+
+namespace {
+
+// 条目名通常很短，放在栈上避免分配
+constexpr jsize NAME_BUFFER_SIZE = 512;
+
+// SnapshotClassLoader.findEntry(long, String, long[])
+jobject JNICALL SnapshotFindEntry(JNIEnv* env, jclass clazz, jlong handle, jstring entryName, jlongArray info) {
+    if (!env || !entryName || !info) {
+        return nullptr;
+    }
+    
+    jsize nameChars = env->GetStringLength(entryName);
+    jsize nameBytes = env->GetStringUTFLength(entryName);
+    char stackBuffer[NAME_BUFFER_SIZE];
+    std::string heapBuffer;
+    char* buffer = stackBuffer;
+    if (nameBytes >= NAME_BUFFER_SIZE) {
+        heapBuffer.resize(static_cast<size_t>(nameBytes) + 1);
+        buffer = &heapBuffer[0];
+    }
+    env->GetStringUTFRegion(entryName, 0, nameChars, buffer);
+    if (env->ExceptionCheck()) {
+        return nullptr;
+    }
+    
+    const JarEntry* entry = nullptr;
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+    if (!SnapshotRegistry::GetInstance().FindEntry(handle, std::string_view(buffer, static_cast<size_t>(nameBytes)),
+                                                    entry, data, size)) {
+        return nullptr;
+    }
+    
+    jlong entryInfo[2] = {
+        static_cast<jlong>(entry->method),
+        static_cast<jlong>(entry->uncompressedSize)
+    };
+    env->SetLongArrayRegion(info, 0, 2, entryInfo);
+    if (env->ExceptionCheck()) {
+        return nullptr;
+    }
+    
+    // 快照内存为只读页，Java端只读取
+    return env->NewDirectByteBuffer(const_cast<uint8_t*>(data), static_cast<jlong>(size));
+}
+
+// SnapshotClassLoader.release(long)
+void JNICALL SnapshotRelease(JNIEnv* env, jclass clazz, jlong handle) {
+    SnapshotRegistry::GetInstance().Release(handle);
+}
+
+} // namespace
+
+SnapshotRegistry& SnapshotRegistry::GetInstance() {
+    static SnapshotRegistry instance;
+    return instance;
+}
+
+SnapshotRegistry::SnapshotRegistry() : nextHandle_(1), loaderClass_(nullptr), loaderConstructor_(nullptr) {
+}
+
+jlong SnapshotRegistry::Register(std::unique_ptr<JarArchive> archive) {
+    if (!archive || !archive->IsOpen()) {
+        return 0;
+    }
+    
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->entries.reserve(archive->GetEntryCount());
+    for (const auto& entry : *archive) {
+        if (!entry.IsDirectory()) {
+            snapshot->entries.emplace(entry.name, &entry);
+        }
+    }
+    snapshot->archive = std::move(archive);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    jlong handle = nextHandle_++;
+    LOG_INFO(L"JAR snapshot registered: " << snapshot->archive->GetPath() << L", handle: " << handle
+             << L", size: " << snapshot->archive->GetSize());
+    snapshots_.emplace(handle, std::move(snapshot));
+    return handle;
+}
+
+void SnapshotRegistry::Release(jlong handle) {
+    std::unique_ptr<Snapshot> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = snapshots_.find(handle);
+        if (it == snapshots_.end()) {
+            return;
+        }
+        snapshot = std::move(it->second);
+        snapshots_.erase(it);
+    }
+    
+    // 在锁外释放快照内存
+    LOG_INFO(L"JAR snapshot released: " << snapshot->archive->GetPath() << L", handle: " << handle);
+}
+
+bool SnapshotRegistry::FindEntry(jlong handle, std::string_view name, const JarEntry*& entry,
+                                 const uint8_t*& data, uint64_t& size) {
+    const Snapshot* snapshot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = snapshots_.find(handle);
+        if (it == snapshots_.end()) {
+            return false;
+        }
+        snapshot = it->second.get();
+    }
+    
+    // 快照只在所属加载器close()或被回收后释放，此时不会有进行中的查找
+    auto entryIt = snapshot->entries.find(name);
+    if (entryIt == snapshot->entries.end()) {
+        return false;
+    }
+    
+    entry = entryIt->second;
+    return snapshot->archive->GetEntryData(*entry, data, size);
+}
+
+size_t SnapshotRegistry::GetSnapshotCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshots_.size();
+}
+
+size_t SnapshotRegistry::GetSnapshotBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& pair : snapshots_) {
+        total += pair.second->archive->GetSize();
+    }
+    return total;
+}
+
+jobject SnapshotRegistry::CreateClassLoader(JNIEnv* env, jlong handle, const std::wstring& source, jobject parent) {
+    if (!env) {
+        return nullptr;
+    }
+    
+    jclass loaderClass = nullptr;
+    jmethodID loaderConstructor = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!DefineLoaderClass(env)) {
+            return nullptr;
+        }
+        loaderClass = loaderClass_;
+        loaderConstructor = loaderConstructor_;
+    }
+    
+    jobject parentLoader = parent;
+    if (!parentLoader) {
+        jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+        jmethodID getSystemClassLoader = classLoaderClass ?
+            env->GetStaticMethodID(classLoaderClass, "getSystemClassLoader", "()Ljava/lang/ClassLoader;") : nullptr;
+        if (getSystemClassLoader) {
+            parentLoader = env->CallStaticObjectMethod(classLoaderClass, getSystemClassLoader);
+        }
+        if (classLoaderClass) {
+            env->DeleteLocalRef(classLoaderClass);
+        }
+        if (!parentLoader || env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+            LOG_ERROR(L"Failed to get system class loader");
+            return nullptr;
+        }
+    }
+    
+    std::u16string sourceUtf16 = Platform::WideToUtf16(source);
+    jstring sourceString = env->NewString(reinterpret_cast<const jchar*>(sourceUtf16.c_str()), static_cast<jsize>(sourceUtf16.size()));
+    jobject loader = sourceString ? env->NewObject(loaderClass, loaderConstructor, handle, sourceString, parentLoader) : nullptr;
+    if (sourceString) {
+        env->DeleteLocalRef(sourceString);
+    }
+    if (parentLoader != parent) {
+        env->DeleteLocalRef(parentLoader);
+    }
+    
+    if (!loader || env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        LOG_ERROR(L"Failed to create SnapshotClassLoader for: " << source);
+        return nullptr;
+    }
+    return loader;
+}
+
+bool SnapshotRegistry::DefineLoaderClass(JNIEnv* env) {
+    if (loaderClass_) {
+        return true;
+    }
+    
+    // 定义到系统类加载器中，使其对所有代可见
+    jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+    if (!classLoaderClass || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOG_ERROR(L"Failed to find ClassLoader class");
+        return false;
+    }
+    
+    jmethodID getSystemClassLoader = env->GetStaticMethodID(classLoaderClass, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+    jobject systemLoader = getSystemClassLoader ? env->CallStaticObjectMethod(classLoaderClass, getSystemClassLoader) : nullptr;
+    if (!systemLoader || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        env->DeleteLocalRef(classLoaderClass);
+        LOG_ERROR(L"Failed to get system class loader");
+        return false;
+    }
+    
+    jclass loaderClass = env->DefineClass(LOADER_CLASS_NAME, systemLoader,
+                                          reinterpret_cast<const jbyte*>(SNAPSHOT_CLASS_LOADER_BYTES),
+                                          static_cast<jsize>(SNAPSHOT_CLASS_LOADER_BYTES_SIZE));
+    if (!loaderClass || env->ExceptionCheck()) {
+        // DLL重新注入到同一JVM时类已定义过，改为从系统类加载器取得
+        env->ExceptionClear();
+        jmethodID loadClass = env->GetMethodID(classLoaderClass, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;");
+        jstring className = env->NewStringUTF("dllinject.SnapshotClassLoader");
+        loaderClass = loadClass && className ? static_cast<jclass>(env->CallObjectMethod(systemLoader, loadClass, className)) : nullptr;
+        if (className) {
+            env->DeleteLocalRef(className);
+        }
+    }
+    env->DeleteLocalRef(systemLoader);
+    env->DeleteLocalRef(classLoaderClass);
+    
+    if (!loaderClass || env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        LOG_ERROR(L"Failed to define SnapshotClassLoader class");
+        return false;
+    }
+    
+    JNINativeMethod methods[] = {
+        {const_cast<char*>("findEntry"), const_cast<char*>("(JLjava/lang/String;[J)Ljava/nio/ByteBuffer;"), (void*)SnapshotFindEntry},
+        {const_cast<char*>("release"), const_cast<char*>("(J)V"), (void*)SnapshotRelease}
+    };
+    if (env->RegisterNatives(loaderClass, methods, sizeof(methods) / sizeof(methods[0])) != JNI_OK) {
+        env->ExceptionClear();
+        env->DeleteLocalRef(loaderClass);
+        LOG_ERROR(L"Failed to register SnapshotClassLoader native methods");
+        return false;
+    }
+    
+    loaderConstructor_ = env->GetMethodID(loaderClass, "<init>", "(JLjava/lang/String;Ljava/lang/ClassLoader;)V");
+    if (!loaderConstructor_ || env->ExceptionCheck()) {
+        env->ExceptionClear();
+        env->DeleteLocalRef(loaderClass);
+        LOG_ERROR(L"Failed to find SnapshotClassLoader constructor");
+        return false;
+    }
+    
+    loaderClass_ = static_cast<jclass>(env->NewGlobalRef(loaderClass));
+    env->DeleteLocalRef(loaderClass);
+    LOG_INFO(L"SnapshotClassLoader defined");
+    return loaderClass_ != nullptr;
+}
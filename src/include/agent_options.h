@@ -0,0 +1,19 @@
+#pragma once
+
+#include "common.h"
+#include <string>
+
+// JVMTI代理选项
+//
+// 以-agentpath:<库路径>=<选项>或Attach API传入，格式为逗号分隔的键值对，
+// 与InjectionData的字段一一对应：
+//
+//   jar=<JAR路径>,class=<类名>,method=<方法名>,hotReload=true|false
+//
+// jar为必需项，class、method、hotReload的默认值与injector.exe相同
+// （Main、main、true）。JAR路径中不能包含逗号。
+class AgentOptions {
+public:
+    // 解析选项字符串，未知键、重复键、空值或超长的值都视为无效
+    static ErrorCode Parse(const std::string& options, InjectionData& data);
+};
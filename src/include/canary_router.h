@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// 对数-线性分桶的延迟直方图（微秒）
+//
+// 每个2的幂区间再等分为SUB_BUCKETS个子桶，相对误差不超过1/SUB_BUCKETS，
+// 记录是O(1)的数组自增，不分配内存。不加锁，由调用者串行化。
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = 64 * SUB_BUCKETS;
+    
+    LatencyHistogram() { Reset(); }
+    
+    void Record(uint64_t micros);
+    void Reset();
+    
+    uint64_t GetCount() const { return count_; }
+    uint64_t GetMax() const { return max_; }
+    
+    // 分位数（0到1），返回所在桶的上界；没有样本时返回0
+    uint64_t Percentile(double quantile) const;
+    
+    // 桶的下标与上界，供测试使用
+    static size_t BucketIndex(uint64_t micros);
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> buckets_;
+    uint64_t count_;
+    uint64_t max_;
+};
+
+// 灰度结论
+enum class CanaryVerdict {
+    PENDING,     // 窗口未结束且未超出预算
+    PROMOTE,     // 新的一代在预算内，接管全部调用
+    ROLLBACK,    // 新的一代超出延迟或错误预算，切回旧的一代
+    SUPERSEDED   // 得出结论前被更新的版本取代，切回旧的一代，不计为回滚
+};
+
+// 一代在灰度窗口内的统计
+struct CanaryArmStats {
+    uint64_t generation;
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t p50Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+    
+    CanaryArmStats() : generation(0), calls(0), errors(0), p50Us(0), p99Us(0), maxUs(0) {}
+    
+    double ErrorRate() const { return calls ? static_cast<double>(errors) / calls : 0.0; }
+};
+
+// 灰度报告
+struct CanaryReport {
+    bool active;
+    CanaryVerdict verdict;
+    double elapsedMs;
+    CanaryArmStats baseline;   // 旧的一代
+    CanaryArmStats canary;     // 新的一代
+    std::string reason;        // 结论的原因，供日志与控制通道输出
+    
+    CanaryReport() : active(false), verdict(CanaryVerdict::PENDING), elapsedMs(0) {}
+};
+
+// 灰度选项
+struct CanaryOptions {
+    double fraction;            // 路由到新的一代的调用比例
+    uint32_t windowMs;          // 灰度窗口，结束时新的一代样本充足且在预算内即提升
+    uint64_t minCalls;          // 每一代至少这么多次调用后才比较预算
+    uint32_t maxWindowExtensions; // 窗口结束时新的一代不足minCalls，最多再等待这么多个窗口，仍不足则回滚
+    double maxLatencyRatio;     // 新的一代p99不超过旧的一代p99的倍数
+    uint64_t latencySlackUs;    // 延迟预算的绝对余量，避免亚毫秒级调用的抖动触发回滚
+    double maxErrorRateDelta;   // 新的一代错误率最多比旧的一代高出的比例
+    
+    // 灰度结束时调用，在得出结论的线程上、JarLoader释放内部锁之后执行，可以调用JarLoader的方法
+    std::function<void(const CanaryReport&)> onFinished;
+    
+    CanaryOptions()
+        : fraction(0.1), windowMs(60000), minCalls(100), maxWindowExtensions(2), maxLatencyRatio(1.5),
+          latencySlackUs(200), maxErrorRateDelta(0.01) {}
+};
+
+// 灰度路由：新旧两代同时在线时决定每次调用由哪一代执行，并按代统计延迟与错误
+//
+// 采样是确定性的：每次调用累加fraction，满1时路由到新的一代，
+// 因此任意连续的调用序列中新的一代所占比例都接近fraction。
+// 窗口内新的一代达到minCalls后一旦超出预算立即回滚，慢的版本不必等到窗口结束；
+// 窗口结束时样本充足且在预算内则提升。样本不足不能说明新的一代可用：窗口最多延长
+// maxWindowExtensions个，期间达到minCalls即按预算判断，到期仍不足或被强制结束时回滚。
+// 不加锁，由调用者串行化（JarLoader在jniMutex_下调用）。
+class CanaryRouter {
+public:
+    CanaryRouter();
+    
+    void Start(const CanaryOptions& options, uint64_t baselineGeneration, uint64_t canaryGeneration);
+    void Stop();
+    
+    bool IsActive() const { return active_; }
+    const CanaryOptions& GetOptions() const { return options_; }
+    
+    // 下一次调用是否路由到新的一代
+    bool RouteToCanary();
+    
+    // 记录一次调用的耗时与结果
+    void Record(bool canary, uint64_t micros, bool succeeded);
+    
+    // 按预算判断；force为true时视为窗口已结束
+    CanaryVerdict Evaluate(bool force);
+    
+    // 更新的版本到来：已有数据足以得出结论（超出预算或窗口结束时样本充足）时返回该结论，否则为SUPERSEDED
+    CanaryVerdict Supersede();
+    
+    // 当前统计与最近一次判断
+    CanaryReport GetReport() const;
+
+private:
+    struct Arm {
+        uint64_t generation;
+        uint64_t calls;
+        uint64_t errors;
+        LatencyHistogram latency;
+        
+        Arm() : generation(0), calls(0), errors(0) {}
+    };
+    
+    bool active_;
+    CanaryOptions options_;
+    std::chrono::steady_clock::time_point start_;
+    double credit_;
+    Arm baseline_;
+    Arm canary_;
+    CanaryVerdict verdict_;
+    std::string reason_;
+    
+    static CanaryArmStats Summarize(const Arm& arm);
+    
+    // 新的一代是否超出预算，超出时写入原因
+    bool ExceedsBudget(std::string& reason) const;
+};
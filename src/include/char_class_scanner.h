@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// 基于字符类位图的向量化扫描
+//
+// 位图按低4位索引，每个字节的第h位表示字符(h << 4 | 低4位)属于该类，
+// 因此只能描述1..127的ASCII字符，非ASCII字符总是不属于该类。
+// 运行时按CPU选择AVX2（每步32字节）、SSSE3（每步16字节）或逐字符查表，
+// 宽字符先饱和压缩为字节再复用同一套分类，两种宽度共享同一张位图。
+class CharClassScanner {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    // members中的'\0'与非ASCII字符被忽略
+    explicit constexpr CharClassScanner(std::string_view members) : bitmap_{} {
+        for (char c : members) {
+            unsigned char value = static_cast<unsigned char>(c);
+            if (value != 0 && value < 0x80) {
+                bitmap_[value & 0x0F] |= static_cast<uint8_t>(1u << (value >> 4));
+            }
+        }
+    }
+    
+    constexpr bool IsMember(uint32_t c) const {
+        return c < 0x80 && ((bitmap_[c & 0x0F] >> (c >> 4)) & 1) != 0;
+    }
+    
+    // 第一个属于该类的字符位置，不存在时返回npos
+    size_t FindFirstOf(std::string_view text) const;
+    size_t FindFirstOf(std::wstring_view text) const;
+    
+    // 第一个不属于该类的字符位置，不存在时返回npos
+    size_t FindFirstNotOf(std::string_view text) const;
+    size_t FindFirstNotOf(std::wstring_view text) const;
+    
+    // 当前CPU使用的实现："AVX2"、"SSSE3"或"scalar"
+    static const char* GetInstructionSet();
+
+private:
+    std::array<uint8_t, 16> bitmap_;
+    
+    template<bool Negate>
+    size_t FindBytes(const uint8_t* data, size_t length) const;
+    
+    template<bool Negate>
+    size_t FindWide(const uint16_t* data, size_t length) const;
+    
+    template<bool Negate, typename CharT>
+    size_t FindScalar(const CharT* data, size_t begin, size_t length) const;
+};
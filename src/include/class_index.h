@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common.h"
+#include "jar_archive.h"
+#include <cstdint>
+#include <string_view>
+
+// JAR中类名与包名的紧凑哈希索引
+//
+// 由中央目录构建一次，之后只读。所有名称存放在一块连续的字符区（arena）中，
+// 哈希表为开放寻址的连续槽位数组，点号形式的查询不分配内存、不经过JNI。
+// 名称统一使用点号形式（com.example.Main），默认包为空字符串。
+class ClassIndex {
+public:
+    ClassIndex();
+    
+    // 从已解析的JAR构建索引，替换原有内容
+    void Build(const JarArchive& archive);
+    
+    // 清空索引
+    void Clear();
+    
+    // 是否已由JAR构建
+    bool IsBuilt() const { return built_; }
+    
+    // 类是否存在于JAR中（接受点号或斜杠形式）
+    bool ContainsClass(std::string_view className) const;
+    
+    // 包是否存在于JAR中（至少包含一个类）
+    bool ContainsPackage(std::string_view packageName) const;
+    
+    size_t GetClassCount() const { return classCount_; }
+    size_t GetPackageCount() const { return packageCount_; }
+    
+    // 按中央目录顺序遍历所有类名
+    template<typename Visitor>
+    void ForEachClass(Visitor&& visitor) const;
+    
+    // 入口点候选：顶层类（非内部类、非module-info/package-info），按名称排序
+    std::vector<std::string> GetEntryPointCandidates() const;
+    
+    // 名称区与槽位表占用的字节数
+    size_t GetMemoryUsage() const;
+    
+    // 取类名所在的包名（点号或斜杠形式均可）
+    static std::string_view PackageOf(std::string_view className);
+
+private:
+    static constexpr uint8_t KIND_CLASS = 1;
+    static constexpr uint8_t KIND_PACKAGE = 2;
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+    
+    // 槽位：名称在arena中的偏移、长度、哈希值与种类标志
+    struct Slot {
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint8_t kinds;
+        uint8_t reserved;
+        uint32_t hash;
+    };
+    
+    std::vector<char> arena_;          // 名称区，名称之间不分隔
+    std::vector<Slot> slots_;          // 开放寻址表，容量为2的幂
+    std::vector<uint32_t> classOrder_; // 类所在槽位，按中央目录顺序
+    size_t classCount_;
+    size_t packageCount_;
+    bool built_;
+    
+    // 插入名称或为已有名称追加种类标志
+    uint32_t Insert(std::string_view name, uint8_t kind);
+    
+    // 查找名称所在槽位，不存在时返回EMPTY_SLOT
+    uint32_t Find(std::string_view name) const;
+    
+    // 将斜杠形式规范化为点号形式；已是点号形式时直接返回原视图
+    static std::string_view Normalize(std::string_view name, std::string& scratch);
+    
+    static uint32_t Hash(std::string_view name);
+    
+    std::string_view NameAt(const Slot& slot) const {
+        return std::string_view(arena_.data() + slot.nameOffset, slot.nameLength);
+    }
+};
+
+template<typename Visitor>
+void ClassIndex::ForEachClass(Visitor&& visitor) const {
+    for (uint32_t slotIndex : classOrder_) {
+        visitor(NameAt(slots_[slotIndex]));
+    }
+}
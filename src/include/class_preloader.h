@@ -0,0 +1,96 @@
+#pragma once
+
+#include "common.h"
+#include <jni.h>
+#include <condition_variable>
+
+// 预加载结果
+struct PreloadResult {
+    size_t loaded;       // 成功加载的类
+    size_t failed;       // 失败的类（缺少可选依赖、静态初始化抛出异常等）
+    size_t threads;      // 实际使用的线程数
+    double durationMs;
+    
+    PreloadResult() : loaded(0), failed(0), threads(0), durationMs(0) {}
+};
+
+// 在预先附加到JVM的工作线程上用Class.forName预加载类
+//
+// 新一代的类在首次使用时才被加载、验证和初始化，这些开销会落在重载后的第一批调用上。
+// 预加载把它提前到切换之前。类名按包分组，较大的包拆成批，工作线程从共享游标领取批次：
+// 同一包的类由同一线程连续加载，减少定义包与读取相邻条目时的竞争。
+// 并行阶段只加载和链接（initialize=false）；静态初始化之间可能互相依赖，
+// 多线程交叉初始化可能死锁，因此Initialize只在一个线程上依次执行。
+// 类加载器必须注册为parallel capable（URLClassLoader与SnapshotClassLoader均已注册），
+// 否则loadClass在加载器对象上串行，此时只使用一个线程。
+class ClassPreloader {
+public:
+    // 最多使用的线程数
+    static constexpr size_t MAX_THREADS = 8;
+    
+    // 每批最多的类数量，较大的包拆成多批
+    static constexpr size_t MAX_BATCH_SIZE = 64;
+    
+    ClassPreloader();
+    ~ClassPreloader();
+    
+    ClassPreloader(const ClassPreloader&) = delete;
+    ClassPreloader& operator=(const ClassPreloader&) = delete;
+    
+    // 创建工作线程并以守护线程附加到JVM，threads为0时按CPU核数选择（不超过MAX_THREADS）
+    ErrorCode Start(JavaVM* jvm, size_t threads = 0);
+    
+    // 等待进行中的任务完成后停止工作线程，线程从JVM分离后退出
+    void Stop();
+    
+    bool IsRunning() const { return !workers_.empty(); }
+    size_t GetThreadCount() const { return workers_.size(); }
+    
+    // 用classLoader（全局引用）并行加载并链接classNames中的类（点号形式），不执行静态初始化
+    // maxThreads非0时最多使用这么多线程；阻塞直到完成
+    PreloadResult Preload(jobject classLoader, const std::vector<std::string>& classNames, size_t maxThreads = 0);
+    
+    // 在一个工作线程上依次执行静态初始化
+    PreloadResult Initialize(jobject classLoader, const std::vector<std::string>& classNames);
+    
+    // 按包分组并把大包拆成不超过maxBatchSize的批，返回每批中的类名下标
+    static std::vector<std::vector<uint32_t>> PartitionByPackage(const std::vector<std::string>& classNames,
+                                                                 size_t maxBatchSize = MAX_BATCH_SIZE);
+    
+    // 类加载器是否注册为parallel capable（Java 8没有查询方法时视为是）
+    static bool IsParallelCapable(JNIEnv* env, jobject classLoader);
+
+private:
+    // 一次预加载任务，由所有工作线程共享
+    struct Job {
+        jobject classLoader;
+        const std::vector<std::string>* classNames;
+        std::vector<std::vector<uint32_t>> batches;
+        bool initialize;
+        size_t maxThreads;
+        std::atomic<size_t> cursor;
+        std::atomic<size_t> loaded;
+        std::atomic<size_t> failed;
+    };
+    
+    JavaVM* jvm_;
+    std::vector<std::thread> workers_;
+    std::mutex jobMutex_;                 // 串行化Preload/Initialize调用
+    std::mutex mutex_;                    // 保护以下状态
+    std::condition_variable jobReady_;
+    std::condition_variable jobDone_;
+    Job* job_;
+    uint64_t jobId_;
+    size_t finishedWorkers_;
+    size_t attachedWorkers_;
+    size_t startedWorkers_;
+    bool stopping_;
+    
+    void WorkerLoop(size_t workerIndex);
+    
+    // 执行任务并等待所有工作线程完成
+    PreloadResult RunJob(Job& job);
+    
+    // 工作线程处理领取到的批次
+    static void ProcessBatches(JNIEnv* env, jclass classClass, jmethodID forName, Job& job);
+};
@@ -1,6 +1,13 @@
 #pragma once
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
+#include "error_code.h"
+#include "platform.h"
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
 #include <string>
 #include <vector>
 #include <memory>
@@ -8,52 +15,33 @@
 #include <fstream>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <chrono>
 #include <sstream>
 
-// 错误码定义
-enum class ErrorCode : int {
-    SUCCESS = 0,
-    PROCESS_NOT_FOUND = 1001,
-    PROCESS_ACCESS_DENIED = 1002,
-    MEMORY_ALLOCATION_FAILED = 1003,
-    MEMORY_WRITE_FAILED = 1004,
-    THREAD_CREATION_FAILED = 1005,
-    THREAD_TIMEOUT = 1006,
-    DLL_NOT_FOUND = 1007,
-    JVM_INIT_FAILED = 2001,
-    JVM_NOT_INITIALIZED = 2002,
-    JAR_NOT_FOUND = 2003,
-    JAR_LOAD_FAILED = 2004,
-    JAVA_CLASS_NOT_FOUND = 2005,
-    JAVA_METHOD_NOT_FOUND = 2006,
-    JAVA_METHOD_CALL_FAILED = 2007,
-    JAVA_EXCEPTION = 2008,
-    CLASS_NOT_FOUND = 2009,
-    METHOD_NOT_FOUND = 2010,
-    OBJECT_CREATION_FAILED = 2011,
-    METHOD_CALL_FAILED = 2012,
-    HOT_RELOAD_START_FAILED = 3001,
-    FILE_MONITOR_FAILED = 3002,
-    INVALID_PARAMETER = 4001,
-    SECURITY_CHECK_FAILED = 4002,
-    UNKNOWN_ERROR = 9999
-};
+// 工具函数
+std::wstring StringToWString(const std::string& str);
+std::string WStringToString(const std::wstring& wstr);
+bool FileExists(const std::wstring& path);
+
+// 只比较ASCII字母的大小写，用于扩展名、选项值等协议字符串
+bool EqualsIgnoreCase(const std::string& left, const std::string& right);
+bool EqualsIgnoreCase(const std::wstring& left, const std::wstring& right);
 
 // 错误详情结构
 struct ErrorDetails {
     ErrorCode code;
     std::wstring message;
     std::wstring context;
-    DWORD systemError;
+    uint32_t systemError;
     std::string file;
     int line;
     
     ErrorDetails() : code(ErrorCode::SUCCESS), systemError(0), line(0) {}
     
     ErrorDetails(ErrorCode c, const std::wstring& msg, const std::wstring& ctx = L"", 
-                DWORD sysErr = 0, const std::string& f = "", int l = 0)
+                uint32_t sysErr = 0, const std::string& f = "", int l = 0)
         : code(c), message(msg), context(ctx), systemError(sysErr), file(f), line(l) {}
     
     std::wstring ToString() const {
@@ -86,16 +74,57 @@ class Logger {
 public:
     static Logger& GetInstance();
     void SetLogLevel(LogLevel level) { logLevel_ = level; }
+    LogLevel GetLogLevel() const { return logLevel_; }
     void SetLogFile(const std::wstring& filePath);
     void Log(LogLevel level, const std::wstring& message, const char* file = nullptr, int line = 0);
     
+    // 异步提交日志记录：文本拷贝进记录队列后立即返回，由后台线程格式化并输出
+    // 稳态下不分配堆内存，适合JNI等高频调用路径
+    void Submit(LogLevel level, const wchar_t* text, size_t length, const wchar_t* prefix = nullptr);
+    
+    // 等待记录队列中的日志全部输出
+    void Flush();
+    
+    // 停止后台输出线程（会先输出剩余记录）
+    // 实例不会被析构，宿主需在卸载前从普通线程显式调用，不能在DllMain中调用
+    void Shutdown();
+    
+    // 因队列已满被丢弃的记录数
+    uint64_t GetDroppedRecordCount() const { return droppedRecords_; }
+
 private:
-    Logger() : logLevel_(LogLevel::INFO) {}
+    // 队列中的日志记录，文本存放在共享的字符区中
+    struct PendingRecord {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        size_t offset;
+        size_t length;
+    };
+    
+    Logger() : logLevel_(LogLevel::INFO), writerRunning_(false), submittedRecords_(0),
+               writtenRecords_(0), droppedRecords_(0) {}
+    ~Logger();
+    
     LogLevel logLevel_;
     std::wstring logFilePath_;
     std::mutex logMutex_;
     
+    // 记录队列（双缓冲：提交方追加到pending，输出线程整批交换后处理）
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::condition_variable flushCondition_;
+    std::vector<PendingRecord> pendingRecords_;
+    std::vector<wchar_t> pendingText_;
+    std::thread writerThread_;
+    bool writerRunning_;
+    uint64_t submittedRecords_;
+    uint64_t writtenRecords_;
+    std::atomic<uint64_t> droppedRecords_;
+    
+    void WriterThreadFunc();
+    void WriteEntry(const std::wstring& entry, std::ofstream* logFile);
     std::wstring GetTimestamp();
+    std::wstring GetTimestamp(std::chrono::system_clock::time_point time);
     std::wstring LogLevelToString(LogLevel level);
 };
 
@@ -136,26 +165,31 @@ private:
 } while(0)
 
 #define CREATE_ERROR_DETAILS(code, msg, context) \
-    ErrorDetails(code, msg, context, GetLastError(), __FILE__, __LINE__)
+    ErrorDetails(code, msg, context, Platform::GetLastSystemError(), __FILE__, __LINE__)
 
 #define CREATE_ERROR_DETAILS_NO_SYS(code, msg, context) \
     ErrorDetails(code, msg, context, 0, __FILE__, __LINE__)
 
 // 常量定义
-constexpr DWORD INJECTION_TIMEOUT = 5000; // 5秒超时
-constexpr DWORD HOT_RELOAD_CHECK_INTERVAL = 1000; // 1秒检查间隔
+constexpr uint32_t INJECTION_TIMEOUT = 5000; // 5秒超时
+constexpr uint32_t HOT_RELOAD_CHECK_INTERVAL = 1000; // 1秒检查间隔
 constexpr size_t MAX_CLASS_NAME_LENGTH = 256;
 constexpr size_t MAX_METHOD_NAME_LENGTH = 128;
+#ifdef _WIN32
+constexpr size_t MAX_PATH_LENGTH = MAX_PATH;
+#else
+constexpr size_t MAX_PATH_LENGTH = 4096; // PATH_MAX
+#endif
 
 // 结构体定义
 struct InjectionData {
-    wchar_t jarPath[MAX_PATH];
+    wchar_t jarPath[MAX_PATH_LENGTH];
     wchar_t className[MAX_CLASS_NAME_LENGTH];
     wchar_t methodName[MAX_METHOD_NAME_LENGTH];
     bool enableHotReload;
     ErrorCode lastError;
-    DWORD processId;
-    DWORD threadId;
+    uint32_t processId;
+    uint32_t threadId;
     
     // 构造函数
     InjectionData() : enableHotReload(false), lastError(ErrorCode::SUCCESS), processId(0), threadId(0) {
@@ -169,12 +203,13 @@ struct InjectionData {
         return wcslen(jarPath) > 0 && 
                wcslen(className) > 0 && 
                wcslen(methodName) > 0 &&
-               wcslen(jarPath) < MAX_PATH &&
+               wcslen(jarPath) < MAX_PATH_LENGTH &&
                wcslen(className) < MAX_CLASS_NAME_LENGTH &&
                wcslen(methodName) < MAX_METHOD_NAME_LENGTH;
     }
 };
 
+#ifdef _WIN32
 // 异常安全的资源管理器
 template<typename T>
 class ScopedHandle {
@@ -213,8 +248,5 @@ private:
     T handle_;
 };
 
-// 工具函数
-std::wstring StringToWString(const std::string& str);
-std::string WStringToString(const std::wstring& wstr);
-bool FileExists(const std::wstring& path);
-FILETIME GetFileModifyTime(const std::wstring& path);
\ No newline at end of file
+FILETIME GetFileModifyTime(const std::wstring& path);
+#endif
\ No newline at end of file
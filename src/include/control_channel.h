@@ -0,0 +1,96 @@
+#pragma once
+
+#include "common.h"
+#include "control_protocol.h"
+#include "control_transport.h"
+#include <functional>
+#include <utility>
+
+// 控制命令的处理函数，由注入运行时提供
+struct ControlHandlers {
+    std::function<ErrorCode()> reload;
+    std::function<ErrorCode(const std::string& className, const std::string& methodName,
+                            const std::vector<std::string>& args)> invoke;
+    std::function<void()> threadExit;   // 服务线程退出前调用，例如分离JNI线程
+};
+
+// 注入模块的本地控制端点
+//
+// 负责消息分帧与命令处理，字节流由ControlTransport提供：Windows上为命名管道
+// \\.\pipe\dllinject-control-<pid>，拒绝远程客户端，使用进程令牌的默认DACL；Linux上为
+// UNIX域套接字，文件权限0600且只接受同一用户或root的连接。客户端逐条发送请求、等待响应，
+// 同一时刻只服务一个客户端。
+//
+// 命令在服务线程中执行。Stop取消挂起的I/O并等待服务线程退出，包括正在执行的命令，
+// 因此命令处理函数不能等待调用Stop的线程所持有的锁，也不能调用Stop。
+class ControlServer {
+public:
+    ControlServer();
+    ~ControlServer();
+    
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+    
+    // 指定进程的控制端点名称
+    static std::wstring GetEndpointName(uint32_t processId) { return ControlTransport::GetEndpointName(processId); }
+    
+    // 创建监听端点并启动服务线程；端点已被占用时失败
+    ErrorCode Start(const std::wstring& endpoint, ControlHandlers handlers);
+    
+    // 停止服务线程并关闭端点，返回时服务线程已退出
+    void Stop();
+    
+    bool IsRunning() const { return running_; }
+    
+    // 处理一条请求并生成响应（服务线程调用）
+    ControlMessage HandleRequest(const ControlMessage& request);
+    
+    // 设置命令处理函数（测试时直接调用HandleRequest，不启动服务线程）
+    void SetHandlers(ControlHandlers handlers) { handlers_ = std::move(handlers); }
+
+private:
+    std::wstring endpoint_;
+    ControlHandlers handlers_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::unique_ptr<ControlListener> listener_;
+    
+    void ThreadFunc();
+    
+    // 处理一个已连接的客户端，直到其断开
+    void ServeClient(ControlConnection& connection);
+    
+    ErrorCode Dispatch(const ControlMessage& request, PayloadWriter& response);
+};
+
+// 控制通道客户端（injector.exe --control）
+class ControlClient {
+public:
+    ControlClient();
+    ~ControlClient();
+    
+    ControlClient(const ControlClient&) = delete;
+    ControlClient& operator=(const ControlClient&) = delete;
+    
+    // 连接到控制端点，服务端忙时最多等待timeoutMs毫秒
+    ErrorCode Connect(const std::wstring& endpoint, uint32_t timeoutMs = 2000);
+    
+    void Disconnect();
+    
+    // 发送请求并等待响应，返回响应中的状态；失败时错误描述见GetLastErrorMessage
+    ErrorCode Send(ControlCommand command, const std::vector<uint8_t>& payload, std::vector<uint8_t>& responsePayload);
+    
+    ErrorCode Ping();
+    ErrorCode Reload();
+    ErrorCode Invoke(const std::string& className, const std::string& methodName, const std::vector<std::string>& args);
+    ErrorCode GetMetrics(std::vector<std::pair<std::string, int64_t>>& metrics);
+    ErrorCode SetLogLevel(LogLevel level);
+    
+    const std::string& GetLastErrorMessage() const { return errorMessage_; }
+
+private:
+    std::unique_ptr<ControlConnection> connection_;
+    uint32_t nextRequestId_;
+    std::string errorMessage_;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common.h"
+#include <cstdint>
+
+// 控制通道的二进制协议
+//
+// 每条消息由20字节的小端消息头和负载组成：
+//   magic(4) 'JCTL'  version(2)  command(2)  requestId(4)  status(4)  payloadLength(4)
+// 响应回显请求的command与requestId，status为ErrorCode，失败时负载是UTF-8错误描述。
+// 负载中的字符串以4字节长度前缀加UTF-8字节表示，整数均为小端。
+//
+//   PING           请求与响应均无负载
+//   RELOAD         立即重载当前JAR，无负载
+//   INVOKE         请求：类名、方法名、参数个数(4)、参数字符串
+//   GET_METRICS    响应：指标个数(4)，每个指标为名称字符串与int64值
+//   SET_LOG_LEVEL  请求：日志级别(4)，取值与LogLevel相同
+enum class ControlCommand : uint16_t {
+    PING = 1,
+    RELOAD = 2,
+    INVOKE = 3,
+    GET_METRICS = 4,
+    SET_LOG_LEVEL = 5
+};
+
+struct ControlMessage {
+    ControlCommand command = ControlCommand::PING;
+    uint32_t requestId = 0;
+    int32_t status = 0;
+    std::vector<uint8_t> payload;
+};
+
+class ControlProtocol {
+public:
+    static constexpr uint32_t MAGIC = 0x4C54434A;     // "JCTL"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 20;
+    static constexpr uint32_t MAX_PAYLOAD_SIZE = 1024 * 1024;
+    static constexpr uint32_t MAX_INVOKE_ARGS = 256;
+    
+    // 把消息编码为消息头加负载
+    static std::vector<uint8_t> Encode(const ControlMessage& message);
+    
+    // 解析消息头，得到命令、请求ID、状态与负载长度；负载由调用者随后读取
+    static ErrorCode DecodeHeader(const uint8_t* header, ControlMessage& message, uint32_t& payloadLength);
+    
+    // 命令名称，用于日志与命令行
+    static const char* GetCommandName(ControlCommand command);
+};
+
+// 负载写入器
+class PayloadWriter {
+public:
+    void WriteUInt32(uint32_t value);
+    void WriteInt64(int64_t value);
+    void WriteString(const std::string& value);
+    
+    const std::vector<uint8_t>& GetData() const { return data_; }
+    std::vector<uint8_t> Release() { return std::move(data_); }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+// 负载读取器，所有读取都检查边界，失败时不移动读取位置
+class PayloadReader {
+public:
+    PayloadReader(const uint8_t* data, size_t size) : data_(data), size_(size), offset_(0) {}
+    explicit PayloadReader(const std::vector<uint8_t>& data) : PayloadReader(data.data(), data.size()) {}
+    
+    bool ReadUInt32(uint32_t& value);
+    bool ReadInt64(int64_t& value);
+    bool ReadString(std::string& value, size_t maxLength = ControlProtocol::MAX_PAYLOAD_SIZE);
+    
+    // 负载是否已全部读取
+    bool AtEnd() const { return offset_ == size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+};
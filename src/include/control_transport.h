@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common.h"
+#include <cstdint>
+#include <memory>
+
+// 控制通道的传输层
+//
+// ControlServer/ControlClient只负责消息分帧与命令处理，字节流的收发由这里的接口提供。
+// 每个平台一个实现，由构建选择：control_transport_win32.cpp为命名管道，
+// control_transport_posix.cpp为UNIX域套接字。
+
+// 一个已连接的客户端或服务端，读写失败或对端断开后不可再用
+class ControlConnection {
+public:
+    virtual ~ControlConnection() = default;
+    
+    // 读满size字节；对端断开、出错或监听端关闭时返回false
+    virtual bool ReadExact(uint8_t* buffer, size_t size) = 0;
+    
+    virtual bool WriteAll(const uint8_t* data, size_t size) = 0;
+};
+
+// 服务端监听端点，同一时刻只服务一个客户端
+class ControlListener {
+public:
+    virtual ~ControlListener() = default;
+    
+    // 等待下一个客户端；Shutdown之后返回nullptr
+    // 返回的连接必须在下一次Accept之前释放
+    virtual std::unique_ptr<ControlConnection> Accept() = 0;
+    
+    // 取消挂起的Accept与连接上的I/O，可以从其他线程调用
+    virtual void Shutdown() = 0;
+};
+
+class ControlTransport {
+public:
+    // 指定进程的控制端点：Windows为\\.\pipe\dllinject-control-<pid>，
+    // 其他平台为临时目录（TMPDIR，默认/tmp）下的dllinject-control-<pid>.sock
+    static std::wstring GetEndpointName(uint32_t processId);
+    
+    // 创建监听端点；同名端点已有服务端在监听时失败
+    static ErrorCode Listen(const std::wstring& endpoint, std::unique_ptr<ControlListener>& listener);
+    
+    // 连接到端点，服务端忙时最多等待timeoutMs毫秒
+    static ErrorCode Connect(const std::wstring& endpoint, uint32_t timeoutMs, std::unique_ptr<ControlConnection>& connection);
+};
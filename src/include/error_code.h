@@ -0,0 +1,32 @@
+#pragma once
+
+// 错误码定义
+// 不依赖平台头文件，需要在其他平台编译的模块（如JvmDiscovery）只包含这个头文件
+enum class ErrorCode : int {
+    SUCCESS = 0,
+    PROCESS_NOT_FOUND = 1001,
+    PROCESS_ACCESS_DENIED = 1002,
+    MEMORY_ALLOCATION_FAILED = 1003,
+    MEMORY_WRITE_FAILED = 1004,
+    THREAD_CREATION_FAILED = 1005,
+    THREAD_TIMEOUT = 1006,
+    DLL_NOT_FOUND = 1007,
+    JVM_INIT_FAILED = 2001,
+    JVM_NOT_INITIALIZED = 2002,
+    JAR_NOT_FOUND = 2003,
+    JAR_LOAD_FAILED = 2004,
+    JAVA_CLASS_NOT_FOUND = 2005,
+    JAVA_METHOD_NOT_FOUND = 2006,
+    JAVA_METHOD_CALL_FAILED = 2007,
+    JAVA_EXCEPTION = 2008,
+    CLASS_NOT_FOUND = 2009,
+    METHOD_NOT_FOUND = 2010,
+    OBJECT_CREATION_FAILED = 2011,
+    METHOD_CALL_FAILED = 2012,
+    JAR_INVALID_FORMAT = 2013,
+    HOT_RELOAD_START_FAILED = 3001,
+    FILE_MONITOR_FAILED = 3002,
+    INVALID_PARAMETER = 4001,
+    SECURITY_CHECK_FAILED = 4002,
+    UNKNOWN_ERROR = 9999
+};
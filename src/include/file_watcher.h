@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common.h"
+#include <functional>
+
+// 单个文件的修改监控
+//
+// 监控线程等待文件所在目录的变更通知，通知到达或轮询间隔到期时按路径读取文件状态
+// （卷序列号或设备、文件索引或inode、大小、修改时间）并与上次比较，目录中其他文件的变化被忽略。
+// 监控目录而不是持有文件句柄，"写临时文件再重命名覆盖"的原子保存同样能被发现。
+// 目录通知不可用时（如部分网络共享）只靠轮询，长时间没有变化时轮询间隔逐步加倍（最大5秒）。
+// 检测到变化后等待写入完成再在监控线程中调用回调。热重载与安全策略共用这一机制。
+//
+// Stop设置停止信号并等待监控线程退出，包括正在执行的回调；因此回调不能等待
+// 调用Stop的线程所持有的锁，也不能在回调中调用Stop。
+class FileWatcher {
+public:
+    using ChangeCallback = std::function<void()>;
+    
+    FileWatcher();
+    ~FileWatcher();
+    
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    
+    // 开始监控，回调在监控线程中执行
+    ErrorCode Start(const std::wstring& path, ChangeCallback callback,
+                    uint32_t minInterval = HOT_RELOAD_CHECK_INTERVAL, uint32_t settleDelay = 500);
+    
+    // 停止监控并等待监控线程退出
+    void Stop();
+    
+    // 监控线程退出前调用，例如分离回调中附加到JVM的线程；需在Start之前设置
+    void SetThreadExitCallback(std::function<void()> callback) { threadExit_ = std::move(callback); }
+    
+    // 文件没有变化的每次唤醒（轮询间隔到期或目录中其他文件变化）时在监控线程中调用，
+    // 用于需要定期推进的工作；间隔随轮询退避，最长5秒。需在Start之前设置
+    void SetIdleCallback(std::function<void()> callback) { idle_ = std::move(callback); }
+    
+    bool IsWatching() const { return watching_; }
+    
+    const std::wstring& GetPath() const { return path_; }
+
+private:
+    // 按路径读取的文件状态，文件被替换时文件标识改变
+    struct FileState {
+        bool exists;
+        Platform::FileIdentity identity;
+        
+        FileState() : exists(false) {}
+        
+        bool operator==(const FileState& other) const {
+            return exists == other.exists && identity == other.identity;
+        }
+    };
+    
+    std::atomic<bool> watching_;
+    std::thread thread_;
+    std::wstring path_;
+    std::wstring directory_;
+    ChangeCallback callback_;
+    std::function<void()> threadExit_;
+    std::function<void()> idle_;
+    uint32_t minInterval_;
+    uint32_t settleDelay_;
+    FileState lastState_;
+    std::unique_ptr<Platform::DirectoryMonitor> monitor_;  // 目录通知与停止信号，Stop时立即唤醒监控线程
+    std::mutex mutex_;                  // 串行化Start与Stop
+    
+    // 监控线程函数
+    void ThreadFunc();
+    
+    // 按路径读取文件状态，文件不存在时exists为false
+    static FileState QueryFileState(const std::wstring& path);
+};
@@ -3,8 +3,22 @@
 #include "common.h"
 #include "jar_loader.h"
 #include "security_utils.h"
+#include "jar_version_cache.h"
+#include "jar_verifier.h"
+#include "file_watcher.h"
+#include <memory>
 #include <mutex>
 
+// 最近一次通过健康检查（入口方法调用成功）的JAR
+struct LastKnownGood {
+    std::wstring jarPath;
+    uint64_t version;          // 版本缓存中的版本号，未启用缓存时为0
+    uint64_t generation;       // 类加载器代号
+    std::string fingerprint;   // JAR指纹（SHA-256归档摘要，与完整性校验一致）
+    
+    LastKnownGood() : version(0), generation(0) {}
+};
+
 class HotReloadManager {
 public:
     HotReloadManager(JarLoader* jarLoader);
@@ -17,30 +31,108 @@ public:
     void StopMonitoring();
     
     // 检查是否正在监控
-    bool IsMonitoring() const { return monitoring_; }
+    bool IsMonitoring() const { return jarWatcher_.IsWatching(); }
+    
+    // 立即重载监控中的JAR，不等待文件变化（用于控制通道）
+    ErrorCode ReloadNow();
     
     // 获取最后的错误
     ErrorCode GetLastError() const { return lastError_; }
+    
+    // 为来源JAR启用版本化影子副本缓存，启用后只从缓存中不可变的完整副本加载JAR
+    // 缓存目录应与来源JAR位于同一卷，以便使用块克隆
+    ErrorCode EnableVersionCache(const std::wstring& directory, const std::wstring& sourcePath,
+                                 size_t maxVersions = JarVersionCache::DEFAULT_MAX_VERSIONS,
+                                 uint64_t maxBytes = JarVersionCache::DEFAULT_MAX_BYTES);
+    
+    // 启用完整性校验，每次加载前校验JAR
+    // trustedListPath非空时只接受列表中的摘要，列表在每次校验前重新读取，可与JAR一同更新
+    ErrorCode EnableIntegrityCheck(const std::wstring& cachePath, const std::wstring& trustedListPath = L"");
+    
+    // 启用切换前预热：新一代在切换前预加载所有类；开启重放时只重放白名单中的最近调用，入口方法不重放
+    void EnableWarmUp(const WarmUpOptions& options);
+    
+    // 启用灰度重载：入口方法通过后新旧两代按比例分担调用，新的一代在延迟与错误预算内才提升
+    // 只有监控到的修改（启用版本缓存时）进入灰度，RollbackToVersion与未启用缓存的重载直接切换
+    // 灰度期间两代同时运行，不进行onUnload/onLoad状态交接；options.onFinished由管理器设置，
+    // 没有调用时由监控线程推进灰度窗口
+    void EnableCanary(const CanaryOptions& options);
+    
+    // 加载来源JAR的当前内容（启用缓存时先生成版本副本），用于首次加载
+    ErrorCode LoadCurrentVersion(const std::wstring& sourcePath);
+    
+    // 回滚到缓存中的指定版本并重新调用入口方法
+    ErrorCode RollbackToVersion(uint64_t version);
+    
+    // 缓存中的版本，最新的在前
+    std::vector<JarVersionInfo> GetCachedVersions() { return versionCache_.GetVersions(); }
+    uint64_t GetCurrentVersion() { return versionCache_.GetCurrentVersion(); }
+    
+    // 最近一次通过健康检查的JAR，尚无时jarPath为空
+    LastKnownGood GetLastKnownGood();
 
 private:
     JarLoader* jarLoader_;
-    std::atomic<bool> monitoring_;
-    std::thread monitorThread_;
     std::wstring watchedJarPath_;
     std::string watchedClassName_;
     std::string watchedMethodName_;
-    FILETIME lastModifyTime_;
     ErrorCode lastError_;
     mutable std::mutex monitorMutex_;
+    std::mutex reloadMutex_;           // 串行化重载与回滚
+    JarVersionCache versionCache_;
+    std::unique_ptr<JarVerifier> jarVerifier_;   // 未启用完整性校验时为空
+    std::wstring trustedListPath_;
+    bool warmUpEnabled_;
+    WarmUpOptions warmUpOptions_;
+    FileWatcher jarWatcher_;
+    bool canaryEnabled_;
+    CanaryOptions canaryOptions_;
+    std::mutex lastKnownGoodMutex_;    // 灰度结论可能在持有reloadMutex_的重载线程上回调，不能使用reloadMutex_
+    LastKnownGood lastKnownGood_;
+    
+    // ActivateJar的结果
+    enum class Activation {
+        FAILED,     // 新版本未生效（未切换或已切回旧的一代）
+        ACTIVE,     // 新版本接管全部调用
+        CANARY      // 新版本进入灰度，结论由OnCanaryFinished报告
+    };
+    
+    // JAR文件变化时由监控线程调用
+    void OnJarModified();
+    
+    // 文件未变化时由监控线程定期调用，推进没有调用的灰度
+    void OnWatcherIdle();
+    
+    // 重新加载JAR，内容未变化时返回ACTIVE
+    Activation ReloadJar();
+    
+    // 完整性校验，未启用时直接通过
+    bool VerifyJar(const std::wstring& jarPath);
+    bool VerifyJar(const JarArchive& snapshot);
+    
+    // 未启用版本缓存时读取来源JAR的内存快照并校验，之后从同一快照加载，
+    // 避免校验之后、加载之前来源文件被构建工具替换；失败时返回空
+    std::unique_ptr<JarArchive> SnapshotAndVerify(const std::wstring& sourcePath);
+    
+    // 为指定路径准备新一代（启用时预热），切换后调用入口方法
+    // snapshot非空时从该快照加载，不再读取文件
+    // 切换期间旧的一代保持为备用，onLoad或入口方法失败时立即切回；成功后设为版本缓存的当前版本（version非0时）
+    // 并记为最近可用版本。canary为true且启用了灰度时改为进入灰度
+    Activation ActivateJar(const std::wstring& loadPath, uint64_t version, bool canary,
+                           std::unique_ptr<JarArchive> snapshot = nullptr);
+    
+    // 切回备用的旧一代；handoff与切换时一致，为true时把状态交还给它
+    // 失败时新的一代仍在服务，版本缓存的当前版本随之更新（version非0时）
+    bool RollbackActivation(uint64_t version, bool handoff);
     
-    // 监控线程函数
-    void MonitorThreadFunc();
+    // 记录一代为最近可用版本
+    void RecordLastKnownGood(uint64_t version, const GenerationInfo& generation);
     
-    // 检查文件是否被修改
-    bool IsFileModified();
+    // 灰度结束：写入指标并报告重载结果，提升时记为最近可用版本，回滚时恢复版本缓存的当前版本
+    void OnCanaryFinished(const CanaryReport& report, uint64_t version, uint64_t baselineVersion);
     
-    // 重新加载JAR
-    bool ReloadJar();
+    // 将一次重载前后的JVM采样差值写入指标并记录日志
+    static void RecordJvmDelta(const JvmMemorySample& before, const JvmMemorySample& after);
     
     // 设置错误码
     void SetLastError(ErrorCode error) { lastError_ = error; }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common.h"
+
+// 注入运行时：加载安全策略、初始化JVM、加载JAR并调用入口方法、启动热重载与控制通道
+//
+// inject.dll（远程线程注入）与inject_agent（JVMTI代理）共用同一套流程，
+// 区别只在于注入参数的来源和InitializeJarInjection的调用时机。
+
+// 设置所在模块，用于定位同目录下的security.policy
+// 参数可以是模块内的任意地址；Windows上模块句柄即模块基址，可以直接传入
+void SetJarInjectionModule(const void* moduleAddress);
+
+// 设置注入参数，需在InitializeJarInjection之前调用
+void SetJarInjectionData(const InjectionData& data);
+
+// 初始化JAR注入，成功返回0
+uint32_t InitializeJarInjection();
+
+// 专用注入线程结束前调用：分离注入过程中为该线程附加到JVM的线程
+// JVM自身的线程（如VMInit回调所在线程）不受影响
+void DetachJarInjectionThread();
+
+// 停止控制通道、热重载与安全策略监控以及预热线程池，之后不再有后台线程调用JNI
+void StopJarInjectionMonitoring();
+
+// 停止监控并卸载JAR
+void CleanupJarInjection();
+
+// 完整关闭：停止所有后台线程并等待其退出、卸载JAR、输出剩余日志并停止日志输出线程
+// 必须在普通线程上调用（卸载模块之前），不能在DllMain中调用：等待线程退出需要加载器锁
+void ShutdownJarInjection();
+
+// 模块卸载或JVM已销毁时调用：放弃仍存在的全局对象而不析构，
+// 避免静态析构在加载器锁下等待线程或对已销毁的JVM调用JNI
+void AbandonJarInjection();
+
+// JVM是否已初始化
+bool IsJarInjectionInitialized();
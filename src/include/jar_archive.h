@@ -0,0 +1,106 @@
+#pragma once
+
+#include "error_code.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ZIP/JAR中央目录中的一个条目（只描述位置，不解压）
+struct JarEntry {
+    std::string_view name;        // 条目名，指向归档内存
+    uint16_t method;              // 压缩方法：0=STORED，8=DEFLATED
+    uint16_t flags;               // 通用标志位
+    uint32_t crc32;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+    uint64_t localHeaderOffset;   // 本地文件头偏移
+    
+    bool IsDirectory() const { return !name.empty() && name.back() == '/'; }
+    bool IsClass() const {
+        return name.size() > 6 && name.compare(name.size() - 6, 6, ".class") == 0;
+    }
+};
+
+// 内存映射的JAR读取器
+//
+// Open时映射整个文件并解析、校验结束记录（EOCD，含ZIP64）和中央目录，
+// 损坏或非ZIP文件在微秒级被拒绝，不需要进入JVM。条目数据按需定位，不解压。
+// 解析（jar_archive.cpp）只依赖标准库，不包含common.h，也不记录日志，失败原因由调用者读取；
+// 文件映射与快照在jar_archive_win32.cpp（CreateFileMapping）与jar_archive_posix.cpp（mmap）中实现。
+class JarArchive {
+public:
+    static constexpr uint16_t METHOD_STORED = 0;
+    static constexpr uint16_t METHOD_DEFLATED = 8;
+    static constexpr size_t MAX_ENTRY_COUNT = 1u << 20;
+    
+    JarArchive();
+    ~JarArchive();
+    
+    JarArchive(const JarArchive&) = delete;
+    JarArchive& operator=(const JarArchive&) = delete;
+    
+    // 映射并校验文件
+    // Windows上映射期间文件不能被截短；POSIX上截短映射中的文件会在访问时触发SIGBUS，
+    // 只应映射不再被改写的文件（如版本缓存中的只读副本），构建工具正在写入的文件使用OpenSnapshot
+    ErrorCode Open(const std::wstring& path);
+    
+    // 将文件一次性读入私有只读内存并校验，读取完成后立即关闭文件句柄，
+    // 之后文件可被覆盖或删除而不影响快照
+    ErrorCode OpenSnapshot(const std::wstring& path);
+    
+    // 校验一段内存中的归档（内存由调用者持有，需在JarArchive使用期间保持有效）
+    ErrorCode Parse(const uint8_t* data, size_t size);
+    
+    // 解除映射并清空条目
+    void Close();
+    
+    bool IsOpen() const { return data_ != nullptr; }
+    bool IsSnapshot() const { return snapshotMemory_ != nullptr; }
+    const std::wstring& GetPath() const { return path_; }
+    size_t GetSize() const { return size_; }
+    const uint8_t* GetData() const { return data_; }
+    
+    // 解析失败的原因
+    const std::wstring& GetLastErrorMessage() const { return errorMessage_; }
+    
+    // 条目迭代（中央目录顺序）
+    size_t GetEntryCount() const { return entries_.size(); }
+    const JarEntry& GetEntry(size_t index) const { return entries_[index]; }
+    std::vector<JarEntry>::const_iterator begin() const { return entries_.begin(); }
+    std::vector<JarEntry>::const_iterator end() const { return entries_.end(); }
+    
+    // 按名称查找条目（线性查找）
+    const JarEntry* FindEntry(std::string_view name) const;
+    
+    // 定位条目的原始（可能是压缩的）数据，校验本地文件头
+    bool GetEntryData(const JarEntry& entry, const uint8_t*& data, uint64_t& size) const;
+    
+    // 中央目录的原始字节
+    const uint8_t* GetCentralDirectory() const { return data_ ? data_ + centralDirectoryOffset_ : nullptr; }
+    size_t GetCentralDirectorySize() const { return centralDirectorySize_; }
+
+private:
+    std::wstring path_;
+    const uint8_t* mappedView_;     // 文件映射的视图，映射建立后不再持有文件句柄
+    void* snapshotMemory_;          // 快照的只读内存
+    size_t mappingSize_;            // 视图或快照的字节数
+    const uint8_t* data_;
+    size_t size_;
+    size_t centralDirectoryOffset_;
+    size_t centralDirectorySize_;
+    std::vector<JarEntry> entries_;
+    std::wstring errorMessage_;
+    
+    // 解析结束记录，得到中央目录位置
+    bool ParseEndOfCentralDirectory(uint64_t& entryCount, uint64_t& cdOffset, uint64_t& cdSize);
+    
+    // 解析中央目录
+    bool ParseCentralDirectory(uint64_t entryCount, uint64_t cdOffset, uint64_t cdSize);
+    
+    // 记录解析失败原因
+    bool Fail(const std::wstring& message);
+    
+    // 释放映射或快照内存（平台相关）
+    void Unmap();
+};
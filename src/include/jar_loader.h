@@ -2,7 +2,15 @@
 
 #include "common.h"
 #include "security_utils.h"
+#include "class_index.h"
+#include "jvm_telemetry.h"
+#include "class_preloader.h"
+#include "method_handle_cache.h"
+#include "canary_router.h"
+#include "jar_verifier.h"
 #include <jni.h>
+#include <list>
+#include <functional>
 #include <unordered_map>
 
 // JNI异常安全包装器
@@ -32,6 +40,161 @@ private:
     jobject obj_;
 };
 
+// JNI局部引用帧：作用域结束时释放帧内创建的所有局部引用
+// 长期附加的本地线程（监控线程、控制通道）不会返回Java，局部引用只能这样释放
+class JNILocalFrame {
+public:
+    JNILocalFrame(JNIEnv* env, jint capacity) : env_(env), pushed_(env && env->PushLocalFrame(capacity) == JNI_OK) {}
+    
+    ~JNILocalFrame() {
+        if (pushed_) {
+            env_->PopLocalFrame(nullptr);
+        }
+    }
+    
+    JNILocalFrame(const JNILocalFrame&) = delete;
+    JNILocalFrame& operator=(const JNILocalFrame&) = delete;
+
+private:
+    JNIEnv* env_;
+    bool pushed_;
+};
+
+// java.lang.Thread中读写上下文类加载器的方法，JVM初始化时解析一次
+struct ContextLoaderMethods {
+    jclass threadClass;                  // 全局引用
+    jmethodID currentThread;
+    jmethodID getContextClassLoader;
+    jmethodID setContextClassLoader;
+    
+    ContextLoaderMethods()
+        : threadClass(nullptr), currentThread(nullptr), getContextClassLoader(nullptr), setContextClassLoader(nullptr) {}
+    
+    bool IsResolved() const { return setContextClassLoader != nullptr; }
+};
+
+// 在作用域内把当前线程的上下文类加载器设为某一代的加载器，离开时恢复原值
+//
+// 插件通过上下文类加载器（ServiceLoader、JAXP等）找到所在的一代。只在调用期间设置，
+// 宿主线程、监控线程与控制通道等长期存活的线程在调用之后不再引用这一代，退役后可以被回收。
+// 析构时删除线程对象等局部引用，可以在没有局部引用帧的长期附加线程上使用。
+class ContextClassLoaderScope {
+public:
+    ContextClassLoaderScope(JNIEnv* env, const ContextLoaderMethods& methods, jobject loader);
+    ~ContextClassLoaderScope();
+    
+    ContextClassLoaderScope(const ContextClassLoaderScope&) = delete;
+    ContextClassLoaderScope& operator=(const ContextClassLoaderScope&) = delete;
+
+private:
+    JNIEnv* env_;
+    const ContextLoaderMethods& methods_;
+    jobject thread_;
+    jobject previous_;
+    bool changed_;
+};
+
+// 类数据共享（AppCDS）模式
+enum class CdsMode {
+    DISABLED = 0,  // 不使用CDS归档
+    DUMP = 1,      // 退出时转储动态归档（-XX:ArchiveClassesAtExit）
+    USE = 2,       // 映射已有归档（-XX:SharedArchiveFile）
+    AUTO = 3       // 归档存在则使用，否则转储
+};
+
+// 嵌入式JVM启动配置，仅在进程中没有JVM、需要JNI_CreateJavaVM时生效
+struct JvmStartupOptions {
+    std::vector<std::string> options;   // 额外的JVM选项，如 "-Xmx256m"
+    std::wstring classPath;             // 类路径：宿主与依赖库（CDS只归档这些类），不应包含插件JAR
+    CdsMode cdsMode;
+    std::wstring cdsArchivePath;        // CDS归档文件路径
+    bool ignoreUnrecognized;            // 忽略无法识别的选项
+    
+    // 允许加载类路径上的JAR。其中的类由应用类加载器定义，可以被CDS归档，
+    // 但不能热重载也不能隔离，只适用于基准测试等一次性场景
+    bool allowPluginOnClassPath;
+    
+    JvmStartupOptions() : cdsMode(CdsMode::DISABLED), ignoreUnrecognized(false), allowPluginOnClassPath(false) {}
+};
+
+// 类加载器模式
+enum class ClassLoaderMode {
+    URL = 0,       // URLClassLoader，由JVM打开并持有JAR文件
+    SNAPSHOT = 1   // SnapshotClassLoader，从本地只读内存快照提供类字节，不持有文件
+};
+
+// 目标实例生命周期策略（非main方法调用时使用）
+enum class InstancePolicy {
+    PER_CALL = 0,    // 每次调用创建新实例，调用结束后立即释放
+    SINGLETON = 1,   // 每个类加载器代共享一个实例
+    PER_THREAD = 2   // 每个类加载器代、每个线程一个实例
+};
+
+// Java方法调用路径
+enum class InvocationPath {
+    JNI = 0,            // 每次调用查找类与方法ID、按策略获取实例，经Call*Method调用
+    METHOD_HANDLE = 1   // 每代解析一次MethodHandle并缓存，之后经invokeExact调用
+};
+
+// 新一代切换前的预热配置
+struct WarmUpOptions {
+    bool preloadClasses;        // 并行加载并链接JAR中的所有类
+    size_t preloadThreads;      // 预加载线程数，0为使用全部预加载线程
+    bool initializeClasses;     // 预加载后在一个线程上依次执行静态初始化
+    bool replayInvocations;     // 在新一代上重放最近记录的调用（重放会真实执行方法，默认关闭）
+    uint32_t replayIterations;  // 每个调用重放的次数
+    // 重放的白名单：只重放返回true的调用，为空时不重放
+    std::function<bool(const std::string& className, const std::string& methodName)> replayFilter;
+    
+    WarmUpOptions() : preloadClasses(true), preloadThreads(0), initializeClasses(true), replayInvocations(false),
+                      replayIterations(1) {}
+};
+
+// 预热结果
+struct WarmUpResult {
+    size_t classesLoaded;
+    size_t classesFailed;
+    size_t classesInitialized;
+    size_t preloadThreads;      // 并行加载实际使用的线程数
+    size_t invocationsReplayed;
+    size_t invocationsFailed;
+    double preloadMs;           // 并行加载阶段耗时
+    double durationMs;
+    
+    WarmUpResult() : classesLoaded(0), classesFailed(0), classesInitialized(0), preloadThreads(0), invocationsReplayed(0),
+                     invocationsFailed(0), preloadMs(0), durationMs(0) {}
+};
+
+// 类加载器代的退役与回收统计
+struct GenerationStats {
+    uint64_t current;     // 当前代号
+    size_t retired;       // 已退役、尚未被回收的代数
+    uint64_t collected;   // 累计已被回收的代数
+    size_t leaked;        // 落后当前代超过阈值仍未被回收的代数（疑似泄漏）
+    
+    GenerationStats() : current(0), retired(0), collected(0), leaked(0) {}
+};
+
+// 当前一代的标识，一次加锁读取，三者属于同一代
+struct GenerationInfo {
+    uint64_t generation;
+    std::wstring jarPath;
+    std::string fingerprint;
+    
+    GenerationInfo() : generation(0) {}
+};
+
+// 代间状态交接的一步（onUnload或onLoad）的结果
+struct StateHandoffResult {
+    bool supported;      // 类声明了对应的生命周期方法
+    bool hasState;       // 交接中有状态（onUnload返回了非null的缓冲区）
+    bool direct;         // 状态是直接缓冲区，数据位于本地内存
+    int64_t bytes;       // 状态的剩余字节数
+    double durationMs;   // 生命周期方法耗时
+    
+    StateHandoffResult() : supported(false), hasState(false), direct(false), bytes(0), durationMs(0) {}
+};
+
 class JarLoader {
 public:
     JarLoader();
@@ -50,25 +213,218 @@ public:
     // 卸载JAR文件
     ErrorCode UnloadJar();
     
+    // 两阶段加载：为JAR创建新的类加载器但不切换，当前一代继续服务
+    // LoadJar等价于PrepareJar后立即CommitPreparedJar
+    ErrorCode PrepareJar(const std::wstring& jarPath);
+    
+    // 从调用者已读取（并已校验）的快照准备新一代，不再读取文件，校验与加载的是同一份内容
+    // 无论类加载器模式如何都使用快照类加载器
+    ErrorCode PrepareJar(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot);
+    
+    // 在待切换的一代上预热：预加载类、重放最近记录的调用
+    ErrorCode WarmUpPreparedJar(const WarmUpOptions& options, WarmUpResult& result);
+    
+    // 停止预加载线程池并等待工作线程从JVM分离；之后的预热会重新创建线程池
+    // JarLoader被放弃而不析构时（Agent_OnUnload、模块卸载）线程池不会随Cleanup停止，须先调用
+    void StopPreloader();
+    
+    // 切换到已准备的一代，旧的一代退役
+    // keepPrevious为true时旧的一代作为备用保持加载与预热状态（类、方法、实例与调用器缓存），
+    // 直到ConfirmCommittedJar或RollbackCommittedJar
+    ErrorCode CommitPreparedJar(bool keepPrevious = false);
+    
+    // 新的一代通过健康检查：退役备用的旧一代
+    ErrorCode ConfirmCommittedJar();
+    
+    // 新的一代未通过健康检查：立即切回备用的旧一代，新的一代退役
+    ErrorCode RollbackCommittedJar();
+    
+    // 是否有等待确认或回滚的备用一代
+    bool HasStandbyGeneration() const { return standby_.loader != nullptr; }
+    
+    // 灰度：备用的旧一代继续服务，按比例把CallJavaMethod路由到新的一代并分别统计延迟与错误
+    // 需要先以CommitPreparedJar(true)切换；超出预算立即回滚，窗口结束时在预算内提升（退役旧的一代）
+    ErrorCode StartCanary(const CanaryOptions& options);
+    
+    // 立即判断灰度，force为true时视为窗口已结束；得出结论时提升或回滚，返回前调用onFinished
+    // 没有调用时灰度不会在调用路径上结束，需要定期调用（热重载在监控线程上调用）
+    CanaryVerdict EvaluateCanary(bool force = false);
+    
+    // 更新的版本取代进行中的灰度：已有数据足以得出结论时按结论处理，否则切回旧的一代并以SUPERSEDED报告
+    // CommitPreparedJar对进行中的灰度做同样的处理
+    CanaryVerdict SupersedeCanary();
+    
+    bool IsCanaryActive();
+    
+    // 灰度期间两代的调用次数、错误与延迟分位数
+    CanaryReport GetCanaryReport();
+    
+    // 放弃已准备的一代
+    void DiscardPreparedJar();
+    
+    // 是否有已准备、尚未切换的一代
+    bool HasPreparedJar() const { return stagedLoader_ != nullptr; }
+    
     // 调用Java方法
     ErrorCode CallJavaMethod(const std::string& className, const std::string& methodName, const std::vector<std::string>& args = {});
     
     // 获取JVM实例
     JavaVM* GetJVM() const { return jvm_; }
     
-    // 获取JNI环境
+    // 获取最近一次JNI操作所在线程的JNI环境
     JNIEnv* GetJNIEnv() const { return env_; }
     
+    // 线程退出前调用：释放该线程的每线程实例，并分离由加载器附加的当前线程
+    // 不影响其他方式附加的线程的附加状态
+    void DetachCurrentThread();
+    
     // 检查是否已初始化
     bool IsInitialized() const { return initialized_; }
     
+    // 以下读取当前一代的方法加锁并按值返回：灰度期间调用线程会在锁内临时换入备用的一代
+    
     // 获取当前加载的JAR路径
-    const std::wstring& GetCurrentJarPath() const { return currentJarPath_; }
+    std::wstring GetCurrentJarPath();
+    
+    // 获取当前JAR的指纹（与完整性校验相同的SHA-256归档摘要，十六进制），未加载时为空
+    std::string GetJarFingerprint();
+    
+    // 获取当前一代的代号、路径与指纹
+    GenerationInfo GetGenerationInfo();
     
     // 获取最后的错误码
     ErrorCode GetLastError() const { return lastError_; }
+    
+    // 设置指定类的实例生命周期策略
+    void SetInstancePolicy(const std::string& className, InstancePolicy policy);
+    
+    // 设置默认的实例生命周期策略
+    void SetDefaultInstancePolicy(InstancePolicy policy);
+    
+    // 获取指定类的实例生命周期策略
+    InstancePolicy GetInstancePolicy(const std::string& className);
+    
+    // 获取当前缓存的实例数量
+    size_t GetCachedInstanceCount();
+    
+    // 设置调用路径，METHOD_HANDLE无法解析的方法自动回退到JNI路径
+    // 调用器在解析时绑定实例，实例策略应在首次调用前设置
+    void SetInvocationPath(InvocationPath path) { invocationPath_ = path; }
+    InvocationPath GetInvocationPath() const { return invocationPath_; }
+    
+    // 获取当前代缓存的MethodHandle调用器数量
+    size_t GetCachedMethodHandleCount();
+    
+    // 设置嵌入式JVM启动配置（需在InitializeJVM之前调用）
+    void SetJvmStartupOptions(const JvmStartupOptions& options);
+    
+    // 类路径（按平台的分隔符分隔，Windows为';'，其他平台为':'，支持目录通配"dir/*"）中是否包含该JAR
+    // 路径规范化后按字面比较，区分大小写
+    static bool ClassPathContainsJar(const std::wstring& classPath, const std::wstring& jarPath);
+    
+    // 获取从InitializeJVM开始到首次成功调用Java方法的耗时（毫秒），尚未调用时返回-1
+    double GetTimeToFirstCallMs() const { return timeToFirstCallMs_; }
+    
+    // 获取当前类加载器代号（每次创建ClassLoader时递增）
+    uint64_t GetGeneration();
+    
+    // 设置类加载器模式（下次LoadJar时生效）
+    void SetClassLoaderMode(ClassLoaderMode mode) { classLoaderMode_ = mode; }
+    ClassLoaderMode GetClassLoaderMode() const { return classLoaderMode_; }
+    
+    // 获取当前JAR的类名索引（未加载JAR时为空）
+    const ClassIndex& GetClassIndex() const { return classIndex_; }
+    
+    // 检查已退役的类加载器代，清除已被回收的记录，对疑似泄漏的代记录一次警告
+    GenerationStats GetGenerationStats();
+    
+    // 请求一次完整GC后再检查退役的代（开销大，仅用于诊断与测试）
+    GenerationStats CollectRetiredGenerations();
+    
+    // 当前记录的最近调用数量（用于预热重放）
+    size_t GetRecordedInvocationCount();
+    
+    // 采样JVM堆、元空间、已加载类与GC计数（首次调用时解析并缓存MXBean）
+    bool SampleJvmTelemetry(JvmMemorySample& sample);
+    
+    // 代间状态交接，生命周期约定为类中的两个可选静态方法：
+    //   static java.nio.ByteBuffer onUnload()   旧的一代退役前调用，返回要交给下一代的状态
+    //   static void onLoad(java.nio.ByteBuffer)  新的一代切换后调用，没有状态时传入null
+    // 在当前一代上调用onUnload，返回的缓冲区以全局引用保留、不复制；已有未交付的状态时
+    // 仍调用onUnload（让旧的一代释放资源），但保留原来的状态
+    ErrorCode CaptureHandoffState(const std::string& className, StateHandoffResult& result);
+    
+    // 在当前一代上调用onLoad并传入保留的状态，成功后释放；onLoad抛出异常时保留状态，供回滚后的一代使用
+    ErrorCode DeliverHandoffState(const std::string& className, StateHandoffResult& result);
+    
+    // 是否有尚未交付的状态
+    bool HasHandoffState() const { return handoffState_ != nullptr; }
+    
+    // 退役后落后当前代多少代仍未被回收视为泄漏
+    void SetGenerationLeakThreshold(uint64_t generations) { generationLeakThreshold_ = generations; }
+    
+    // 默认泄漏阈值
+    static const uint64_t DEFAULT_GENERATION_LEAK_THRESHOLD = 8;
+    
+    // 记录的最近调用上限（按类、方法与参数去重）
+    static constexpr size_t MAX_RECORDED_INVOCATIONS = 16;
 
 private:
+    // 实例缓存键：(类加载器代, 类名, 线程ID)，单例策略的线程ID为0
+    struct InstanceKey {
+        uint64_t generation;
+        std::string className;
+        uint32_t threadId;
+        
+        bool operator==(const InstanceKey& other) const {
+            return generation == other.generation && threadId == other.threadId && className == other.className;
+        }
+    };
+    
+    // 已退役的类加载器代：只保留弱全局引用，加载器被回收后与NULL相同
+    struct RetiredGeneration {
+        uint64_t generation;
+        jweak loader;
+        std::wstring jarPath;
+        bool reported;   // 已报告为疑似泄漏
+    };
+    
+    // 切换后保留的备用一代，健康检查前可以原样切回
+    struct StandbyGeneration {
+        uint64_t generation;
+        jobject loader;       // 全局引用，为空表示没有备用的一代
+        std::wstring jarPath;
+        std::string fingerprint;
+        ClassIndex classIndex;
+        std::unordered_map<std::string, jclass> classCache;
+        std::unordered_map<std::string, jmethodID> methodCache;
+        
+        StandbyGeneration() : generation(0), loader(nullptr) {}
+    };
+    
+    // 已得出结论、尚未通知的灰度
+    struct CanaryNotification {
+        std::function<void(const CanaryReport&)> callback;
+        CanaryReport report;
+    };
+    
+    // 记录的一次成功调用，预热时在新一代上重放
+    struct RecordedInvocation {
+        std::string className;
+        std::string methodName;
+        std::vector<std::string> args;
+    };
+    
+    struct InstanceKeyHash {
+        size_t operator()(const InstanceKey& key) const {
+            size_t h = std::hash<std::string>()(key.className);
+            h ^= std::hash<uint64_t>()(key.generation) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>()(key.threadId) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    
+    
     JavaVM* jvm_;
     JNIEnv* env_;
     bool initialized_;
@@ -78,6 +434,40 @@ private:
     std::unordered_map<std::string, jclass> classCache_;  // 类缓存
     std::unordered_map<std::string, jmethodID> methodCache_;  // 方法缓存
     std::mutex jniMutex_;  // JNI操作互斥锁
+    uint64_t generation_;  // 当前类加载器代号
+    uint64_t generationCounter_;  // 已分配的最大代号（回滚后大于当前代号）
+    InstancePolicy defaultInstancePolicy_;  // 默认实例策略
+    std::unordered_map<std::string, InstancePolicy> instancePolicies_;  // 按类配置的实例策略
+    std::unordered_map<InstanceKey, jobject, InstanceKeyHash> instanceCache_;  // 实例缓存（全局引用）
+    JvmStartupOptions jvmStartupOptions_;  // 嵌入式JVM启动配置
+    std::vector<std::string> jvmOptionStrings_;  // JavaVMOption引用的选项字符串
+    std::wstring jvmClassPath_;  // 由本加载器创建JVM时使用的类路径
+    std::chrono::steady_clock::time_point startupBegin_;  // InitializeJVM开始时间
+    double timeToFirstCallMs_;  // 启动到首次成功调用的耗时
+    ClassIndex classIndex_;  // 当前JAR的类名索引
+    ClassLoaderMode classLoaderMode_;  // 类加载器模式
+    std::vector<RetiredGeneration> retiredGenerations_;  // 尚未确认被回收的旧代
+    uint64_t collectedGenerations_;  // 已被回收的代数
+    uint64_t generationLeakThreshold_;  // 泄漏判定阈值（代数）
+    JvmTelemetry telemetry_;  // 缓存的平台MXBean
+    jobject stagedLoader_;  // 已准备、尚未切换的类加载器（全局引用）
+    std::wstring stagedJarPath_;
+    ClassIndex stagedClassIndex_;
+    std::list<RecordedInvocation> recordedInvocations_;  // 最近的成功调用，最新的在前
+    std::unordered_multimap<size_t, std::list<RecordedInvocation>::iterator> recordedIndex_;  // 调用哈希到记录的索引
+    ClassPreloader preloader_;  // 预加载线程池，首次预热时启动
+    InvocationPath invocationPath_;  // 调用路径
+    MethodHandleCache methodHandles_;  // 当前代的MethodHandle调用器
+    jobject handoffState_;  // 等待交给下一代的ByteBuffer（全局引用）
+    std::string currentFingerprint_;  // 当前JAR的指纹
+    std::string stagedFingerprint_;
+    JarVerifier fingerprintVerifier_;  // 只用于计算指纹，不使用其缓存与可信列表
+    StandbyGeneration standby_;  // 等待确认或回滚的旧一代
+    MethodHandleCache standbyMethodHandles_;  // 备用一代的MethodHandle调用器
+    CanaryRouter canary_;  // 灰度路由与按代统计
+    std::vector<CanaryNotification> canaryNotifications_;  // 等待在锁外调用的onFinished
+    std::atomic<bool> canaryNotificationPending_;  // 无通知时CanaryNotifier不必再加锁
+    ContextLoaderMethods contextLoaderMethods_;  // 调用期间切换上下文类加载器
     
     // 设置错误码
     void SetLastError(ErrorCode error) { lastError_ = error; }
@@ -88,14 +478,117 @@ private:
     // 查找Java类（带缓存）
     jclass FindClass(const std::string& className);
     
-    // 查找Java方法
-    jmethodID FindMethod(jclass clazz, const std::string& methodName, const std::string& signature);
+    // 通过指定的类加载器加载类，返回局部引用
+    static jclass LoadClassFrom(JNIEnv* env, jobject loader, const std::string& className);
+    
+    // PrepareJar与CommitPreparedJar的实现（调用者持有jniMutex_并已附加线程）
+    ErrorCode PrepareJarLocked(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot = nullptr);
+    ErrorCode CommitPreparedJarLocked(bool keepPrevious);
+    void DiscardPreparedJarLocked();
+    
+    // CallJavaMethod的实现，在当前一代上调用（调用者持有jniMutex_并已附加线程）
+    ErrorCode CallJavaMethodLocked(const std::string& className, const std::string& methodName,
+                                   const std::vector<std::string>& args);
+    
+    // 灰度期间的调用：按采样换入备用的一代执行，记录耗时与结果后判断预算
+    ErrorCode CallWithCanary(const std::string& className, const std::string& methodName,
+                             const std::vector<std::string>& args);
+    
+    // 按灰度结论提升或回滚，onFinished留到释放jniMutex_后由CanaryNotifier调用
+    void FinishCanary(CanaryVerdict verdict);
+    
+    // 在可能结束灰度的公开方法中声明在jniMutex_的锁之前：析构时锁已释放，调用待通知的onFinished
+    class CanaryNotifier {
+    public:
+        explicit CanaryNotifier(JarLoader& loader) : loader_(loader) {}
+        ~CanaryNotifier() { loader_.NotifyCanaryFinished(); }
+        
+        CanaryNotifier(const CanaryNotifier&) = delete;
+        CanaryNotifier& operator=(const CanaryNotifier&) = delete;
+    
+    private:
+        JarLoader& loader_;
+    };
+    
+    // 调用FinishCanary留下的onFinished（不持有jniMutex_）
+    void NotifyCanaryFinished();
+    
+    // 切回备用的一代，当前一代退役
+    void RollbackToStandby();
+    
+    // 经缓存的MethodHandle调用；调用器无法解析时返回false，由调用者走JNI路径
+    bool CallViaMethodHandle(const std::string& className, const std::string& methodName,
+                             const std::vector<std::string>& args, ErrorCode& result);
+    
+    // 成功调用后的记录：首次调用耗时与预热重放列表
+    void OnCallSucceeded(const std::string& className, const std::string& methodName, const std::vector<std::string>& args);
+    
+    // 记录一次成功调用
+    void RecordInvocation(const std::string& className, const std::string& methodName, const std::vector<std::string>& args);
+    static size_t HashInvocation(const std::string& className, const std::string& methodName, const std::vector<std::string>& args);
+    
+    // 在指定类加载器上调用方法，不使用方法与实例缓存，也不访问成员（预热重放在jniMutex_外、以调用线程的JNIEnv执行）
+    static ErrorCode InvokeOnLoader(JNIEnv* env, const ContextLoaderMethods& contextMethods, jobject loader,
+                                    const std::string& className, const std::string& methodName,
+                                    const std::vector<std::string>& args);
+    
+    // 在当前一代中查找类的静态生命周期方法，类或方法不存在时返回nullptr且不留下异常
+    jmethodID FindLifecycleMethod(const std::string& className, const char* name, const char* signature, jclass& clazz);
+    
+    // 读取状态缓冲区的剩余字节数与是否为直接缓冲区
+    void DescribeHandoffState(jobject buffer, StateHandoffResult& result);
+    
+    // 确保当前线程已附加到JVM并切换到该线程的JNI环境
+    // LoadJar、UnloadJar与CallJavaMethod可能来自监控线程或控制通道，JNIEnv不能跨线程使用；
+    // 由此附加的线程退出前必须调用DetachCurrentThread（监控线程、控制通道与注入线程都通过退出回调调用）
+    bool AttachCurrentThread();
+    
+    // 查找Java方法（按类名缓存，切换类加载器时清空）
+    jmethodID FindMethod(jclass clazz, const std::string& className, const std::string& methodName, const std::string& signature);
     
     // 检查并清理JNI异常
-    bool CheckAndClearJNIException();
+    bool CheckJNIException() { return CheckJNIException(env_); }
+    static bool CheckJNIException(JNIEnv* env);
     
     // 创建URLClassLoader
-    ErrorCode CreateURLClassLoader(const std::wstring& jarPath);
+    ErrorCode CreateClassLoader(const std::wstring& jarPath);
+    
+    // 登记JAR快照并创建SnapshotClassLoader
+    ErrorCode CreateSnapshotClassLoader(const std::wstring& jarPath, std::unique_ptr<JarArchive> snapshot);
+    
+    // 保存新创建的类加载器，等待切换
+    void StageClassLoader(jobject newClassLoader);
+    
+    // 以新的类加载器替换当前加载器，进入新的一代；keepPrevious为true时旧的一代转为备用
+    void InstallClassLoader(jobject newClassLoader, bool keepPrevious);
+    
+    // 交换当前一代与备用一代的加载器、JAR信息与缓存（实例缓存按代号区分，无需交换）
+    void SwapWithStandby();
+    
+    // 让备用的一代退役
+    void RetireStandbyGeneration();
+    
+    // 解析ContextLoaderMethods（调用者持有jniMutex_）
+    bool ResolveContextLoaderMethods();
+    
+    // 让当前类加载器退役：释放该代的全局引用、关闭加载器，改为弱引用跟踪其回收
+    void RetireClassLoader();
+    
+    // 清除已被回收的退役记录并统计（调用者持有jniMutex_）
+    GenerationStats PollRetiredGenerations();
+    
+    // 获取目标实例：按策略返回缓存的全局引用或新建的局部引用
+    // isLocalRef为true时调用者负责释放返回的局部引用
+    jobject AcquireInstance(jclass clazz, const std::string& className, bool& isLocalRef);
+    
+    // 释放所有缓存的实例（卸载或切换类加载器时调用）
+    void ReleaseInstances();
+    
+    // 释放指定代的缓存实例
+    void ReleaseInstances(uint64_t generation);
+    
+    // 释放指定线程在所有代中的每线程实例及绑定它们的调用器
+    void ReleaseThreadInstances(uint32_t threadId);
     
     // 清理资源
     void Cleanup();
@@ -103,4 +596,5 @@ private:
     // 验证输入参数
     bool ValidateClassName(const std::string& className);
     bool ValidateMethodName(const std::string& methodName);
+    bool ValidateInput(const std::string& input, size_t maxLength);
 };
\ No newline at end of file
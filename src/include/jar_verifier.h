@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common.h"
+#include "jar_archive.h"
+#include "sha256.h"
+#include <array>
+#include <mutex>
+#include <set>
+
+// 一次JAR完整性校验的结果
+struct JarVerificationResult {
+    std::string digest;     // 归档摘要（十六进制）
+    size_t entryCount;
+    bool fromCache;         // 摘要来自持久化缓存，未重新计算
+    bool trusted;           // 摘要在可信列表中（未配置列表时为false）
+    double elapsedMs;
+    
+    JarVerificationResult() : entryCount(0), fromCache(false), trusted(false), elapsedMs(0.0) {}
+};
+
+// JAR完整性校验
+//
+// 归档摘要 = SHA-256(各条目摘要按中央目录顺序拼接)，条目摘要覆盖条目名、压缩方法、
+// CRC32、原始大小和原始（压缩）数据，因此可以在多个线程上并行计算。计算时同时校验
+// 每个条目的本地文件头，STORED条目还校验CRC32。
+// 结果按(文件标识, 大小, 修改时间, 中央目录指纹)持久化到磁盘，未变化的归档不会重新计算。
+class JarVerifier {
+public:
+    using Digest = Sha256::Digest;
+    
+    static constexpr size_t MAX_CACHE_RECORDS = 1024;
+    
+    JarVerifier();
+    ~JarVerifier() = default;
+    
+    JarVerifier(const JarVerifier&) = delete;
+    JarVerifier& operator=(const JarVerifier&) = delete;
+    
+    // 载入持久化缓存，文件不存在时从空缓存开始，之后的新结果写回该文件
+    ErrorCode OpenCache(const std::wstring& cachePath);
+    
+    // 载入可信摘要列表（替换已有列表）：每行一个十六进制摘要，#开头为注释
+    // 配置了可信摘要后，摘要不在列表中的JAR校验失败
+    ErrorCode LoadTrustedDigests(const std::wstring& listPath);
+    void AddTrustedDigest(const std::string& digest);
+    bool HasTrustedDigests();
+    
+    // 计算摘要的线程数，0表示使用硬件线程数
+    void SetThreadCount(size_t threadCount) { threadCount_ = threadCount; }
+    
+    // 校验JAR：结构或CRC错误返回JAR_INVALID_FORMAT，不在可信列表中返回SECURITY_CHECK_FAILED
+    ErrorCode Verify(const std::wstring& jarPath, JarVerificationResult& result);
+    
+    // 校验已读入内存的快照；快照没有稳定的文件标识，结果不写入缓存
+    // 调用者随后从同一快照加载，校验与加载之间文件被替换也不影响
+    ErrorCode Verify(const JarArchive& snapshot, JarVerificationResult& result);
+    
+    // 缓存中的记录数
+    size_t GetCacheSize();
+    
+    // 并行计算已打开归档的摘要，条目数据损坏时返回false
+    bool ComputeDigest(const JarArchive& archive, Digest& digest, std::wstring& error);
+    
+    static std::string ToHex(const Digest& digest);
+
+private:
+    // 持久化缓存记录（定长，直接写入文件）
+    struct CacheRecord {
+        uint64_t device;        // 卷序列号或st_dev
+        uint64_t fileIndex;
+        uint64_t size;
+        uint64_t writeTime;
+        Digest fingerprint;     // 中央目录的SHA-256
+        Digest digest;
+    };
+    
+    std::wstring cachePath_;
+    std::vector<CacheRecord> records_;      // 按写入顺序，超过上限时丢弃最旧的
+    std::set<std::string> trustedDigests_;
+    size_t threadCount_;
+    std::mutex verifierMutex_;
+    
+    // 计算一个条目的摘要
+    bool HashEntry(const JarArchive& archive, const JarEntry& entry, Sha256& hash, Digest& digest);
+    
+    // 计算一段内存的SHA-256
+    bool HashBuffer(const uint8_t* data, size_t size, Digest& digest);
+    
+    // 按可信列表检查摘要（未配置列表时通过）
+    ErrorCode CheckTrusted(const std::wstring& jarPath, JarVerificationResult& result);
+    
+    // 将缓存写回磁盘（先写临时文件再替换）
+    bool SaveCache();
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "common.h"
+#include <mutex>
+
+// 缓存中的一个JAR版本
+struct JarVersionInfo {
+    uint64_t version;           // 版本号，单调递增
+    std::wstring path;          // 缓存副本路径（只读、完整、不会再被修改）
+    std::wstring sourcePath;    // 来源JAR路径
+    uint64_t size;
+    uint64_t sourceWriteTime;   // 复制时来源文件的修改时间（平台相关的单位，只用于比较）
+    bool cloned;                // 是否通过块克隆生成（否则为普通复制）
+    uint64_t lastUsed;          // 最近使用序号，用于LRU淘汰
+    
+    JarVersionInfo() : version(0), size(0), sourceWriteTime(0), cloned(false), lastUsed(0) {}
+};
+
+// 版本化的JAR影子副本缓存
+//
+// 每个被接受的JAR版本先复制到缓存目录（<名称>.v<版本号>.jar），校验为完整的ZIP后
+// 才发布，加载器只从这些不可变副本加载，不会读到正在被构建工具写入的文件。
+// 同一卷且文件系统支持块克隆（Windows的ReFS、Dev Drive，Linux的Btrfs、XFS）时
+// 副本与来源共享数据块，复制几乎没有开销；否则回退到普通复制。
+// 版本按数量和总字节数进行LRU淘汰，当前版本与刚创建、尚未切换的版本不会被淘汰，
+// 因此缓存最多暂时比上限多出一个版本。
+// 一个缓存只对应一个来源JAR，同一目录可以被多个来源共用，只登记与淘汰同名的副本。
+class JarVersionCache {
+public:
+    static constexpr size_t DEFAULT_MAX_VERSIONS = 8;
+    static constexpr uint64_t DEFAULT_MAX_BYTES = 512ull * 1024 * 1024;
+    
+    JarVersionCache();
+    ~JarVersionCache() = default;
+    
+    JarVersionCache(const JarVersionCache&) = delete;
+    JarVersionCache& operator=(const JarVersionCache&) = delete;
+    
+    // 为来源JAR打开缓存目录（不存在时创建），并登记目录中该来源已有的版本
+    ErrorCode Open(const std::wstring& directory, const std::wstring& sourcePath,
+                   size_t maxVersions = DEFAULT_MAX_VERSIONS, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+    
+    bool IsOpen() const { return !directory_.empty(); }
+    const std::wstring& GetDirectory() const { return directory_; }
+    
+    // 为来源JAR创建新版本；来源未变化时返回已有的最新版本
+    // 来源在复制过程中被修改或复制结果不是完整的ZIP时返回JAR_INVALID_FORMAT
+    // 来源文件名与Open时不同时返回INVALID_PARAMETER
+    ErrorCode AddVersion(const std::wstring& sourcePath, JarVersionInfo& info);
+    
+    // 获取指定版本
+    bool GetVersion(uint64_t version, JarVersionInfo& info);
+    
+    // 所有版本，最新的在前
+    std::vector<JarVersionInfo> GetVersions();
+    
+    // 标记版本为当前正在使用（受淘汰保护并更新LRU顺序）
+    void SetCurrentVersion(uint64_t version);
+    uint64_t GetCurrentVersion();
+    
+    // 按数量和字节数上限淘汰最久未使用的版本，返回删除的版本数
+    // 仍被占用（例如被旧的类加载器打开）的副本保留到下次淘汰
+    size_t Evict();
+    
+    // 当前缓存的总字节数
+    uint64_t GetTotalBytes();
+
+private:
+    std::wstring directory_;
+    std::wstring sourceStem_;  // 来源JAR的文件名（不含扩展名），副本以此为前缀
+    size_t maxVersions_;
+    uint64_t maxBytes_;
+    std::vector<JarVersionInfo> versions_;  // 按版本号升序
+    uint64_t nextVersion_;
+    uint64_t currentVersion_;
+    uint64_t pendingVersion_;  // 最近由AddVersion返回、尚未成为当前版本的版本，同样不被淘汰
+    uint64_t useCounter_;
+    std::mutex cacheMutex_;
+    
+    // 生成版本副本路径
+    std::wstring MakeVersionPath(const std::wstring& sourcePath, uint64_t version) const;
+    
+    // 登记目录中属于当前来源的已有版本
+    void ScanDirectory();
+    
+    // 设置或清除副本的只读属性
+    static void SetReadOnly(const std::wstring& path, bool readOnly);
+    
+    // 删除只读的版本副本
+    static bool DeleteVersionFile(const std::wstring& path);
+    
+    size_t EvictLocked();
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "common.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// 字符类别标志
+constexpr uint8_t JAVA_NAME_START = 1;       // [a-zA-Z_$]
+constexpr uint8_t JAVA_NAME_PART = 2;        // [a-zA-Z0-9_$]
+constexpr uint8_t JAVA_NAME_DOT = 4;         // 包分隔符
+constexpr uint8_t JAVA_NAME_DANGEROUS = 8;   // SecurityUtils::DANGEROUS_CHARS
+
+constexpr char JAVA_NAME_DANGEROUS_CHARS[] = ";<>|&$`\"'\\*?[]{}()";
+
+constexpr std::array<uint8_t, 256> BuildJavaNameCharTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$';
+        bool digit = c >= '0' && c <= '9';
+        table[c] = static_cast<uint8_t>((letter ? JAVA_NAME_START | JAVA_NAME_PART : 0) |
+                                        (digit ? JAVA_NAME_PART : 0) |
+                                        (c == '.' ? JAVA_NAME_DOT : 0));
+    }
+    for (size_t i = 0; i + 1 < sizeof(JAVA_NAME_DANGEROUS_CHARS); ++i) {
+        table[static_cast<unsigned char>(JAVA_NAME_DANGEROUS_CHARS[i])] |= JAVA_NAME_DANGEROUS;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 256> JAVA_NAME_CHAR_TABLE = BuildJavaNameCharTable();
+
+// Java类名与方法名的表驱动校验
+//
+// 语义与原先的实现一致：先检查长度，再检查危险字符，最后匹配
+//   类名   ^[a-zA-Z_$][a-zA-Z0-9_$]*(\.[a-zA-Z_$][a-zA-Z0-9_$]*)*$
+//   方法名 ^[a-zA-Z_$][a-zA-Z0-9_$]*$
+// 危险字符与格式在同一遍扫描中完成，不分配内存，可在编译期求值。
+// 注意'$'属于危险字符，因此含'$'的名称（如内部类）会被拒绝。
+class JavaNameValidator {
+public:
+    enum class Result {
+        VALID,
+        INVALID_LENGTH,
+        DANGEROUS_CHARS,
+        INVALID_FORMAT
+    };
+    
+    static constexpr Result CheckClassName(std::string_view name) {
+        return Check(name, MAX_CLASS_NAME_LENGTH, true);
+    }
+    
+    static constexpr Result CheckMethodName(std::string_view name) {
+        return Check(name, MAX_METHOD_NAME_LENGTH, false);
+    }
+    
+    static constexpr bool ContainsDangerousChars(std::string_view input) {
+        for (char c : input) {
+            if (JAVA_NAME_CHAR_TABLE[static_cast<unsigned char>(c)] & JAVA_NAME_DANGEROUS) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr Result Check(std::string_view name, size_t maxLength, bool allowDots) {
+        if (name.empty() || name.size() > maxLength) {
+            return Result::INVALID_LENGTH;
+        }
+        
+        // 格式出错后继续扫描，危险字符的判定优先于格式
+        bool formatValid = true;
+        bool expectStart = true;
+        for (char c : name) {
+            uint8_t kind = JAVA_NAME_CHAR_TABLE[static_cast<unsigned char>(c)];
+            if (kind & JAVA_NAME_DANGEROUS) {
+                return Result::DANGEROUS_CHARS;
+            }
+            if (!formatValid) {
+                continue;
+            }
+            
+            if (expectStart) {
+                formatValid = (kind & JAVA_NAME_START) != 0;
+                expectStart = false;
+            } else if (allowDots && (kind & JAVA_NAME_DOT)) {
+                expectStart = true;
+            } else {
+                formatValid = (kind & JAVA_NAME_PART) != 0;
+            }
+        }
+        
+        // 以'.'结尾时缺少标识符
+        return formatValid && !expectStart ? Result::VALID : Result::INVALID_FORMAT;
+    }
+};
+
+static_assert(JavaNameValidator::CheckClassName("com.example.Main") == JavaNameValidator::Result::VALID, "");
+static_assert(JavaNameValidator::CheckClassName("com..Main") == JavaNameValidator::Result::INVALID_FORMAT, "");
+static_assert(JavaNameValidator::CheckClassName("Outer$Inner") == JavaNameValidator::Result::DANGEROUS_CHARS, "");
+static_assert(JavaNameValidator::CheckMethodName("com.example") == JavaNameValidator::Result::INVALID_FORMAT, "");
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "error_code.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// HotSpot性能数据（hsperfdata）的只读解析
+//
+// 每个启用了UsePerfData的JVM把计数器写入临时目录下的hsperfdata_<用户名>/<pid>，
+// 格式与平台无关：32字节的前导（魔数0xCAFEC0C0、字节序、版本、条目偏移与数量）
+// 后接若干自描述条目（名称、类型、单位、数据偏移）。文件由目标JVM持续写入，
+// 这里只读取一次前导，所有偏移都在使用前检查，内容不可信也不会越界。
+class PerfData {
+public:
+    static constexpr uint32_t MAGIC = 0xCAFEC0C0;
+    static constexpr size_t PROLOGUE_SIZE = 32;
+    static constexpr size_t ENTRY_HEADER_SIZE = 20;
+    
+    PerfData();
+    
+    // 解析一段内存（由调用者持有，需在PerfData使用期间保持有效）
+    ErrorCode Parse(const uint8_t* data, size_t size);
+    
+    // 读取字符串计数器（字节数组，以'\0'结尾）
+    bool GetString(std::string_view name, std::string& value) const;
+    
+    // 读取64位整数计数器
+    bool GetLong(std::string_view name, int64_t& value) const;
+    
+    // JVM是否已完成初始化并允许外部读取
+    bool IsAccessible() const { return accessible_; }
+    
+    size_t GetEntryCount() const { return entries_.size(); }
+    
+    // 解析失败的原因
+    const std::wstring& GetLastErrorMessage() const { return errorMessage_; }
+
+private:
+    struct Entry {
+        char type;                 // 'J'=jlong，'B'=jbyte数组
+        uint32_t vectorLength;     // 0表示标量
+        const uint8_t* data;
+    };
+    
+    std::unordered_map<std::string_view, Entry> entries_;   // 名称指向被解析的内存
+    bool bigEndian_;
+    bool accessible_;
+    std::wstring errorMessage_;
+    
+    uint32_t Read32(const uint8_t* p) const;
+    uint64_t Read64(const uint8_t* p) const;
+    ErrorCode Fail(const std::wstring& message);
+};
+
+// 从性能数据得到的JVM信息
+struct JvmProcessInfo {
+    uint32_t processId = 0;
+    std::string mainClass;         // 主类名，以-jar启动时为JAR路径
+    std::string mainArgs;          // 程序参数
+    std::string jvmArgs;           // JVM参数（java.rt.vmArgs）
+    std::string jvmFlags;          // 来自.hotspotrc等的标志（java.rt.vmFlags）
+    int64_t startTimeMillis = 0;   // JVM创建时间，自1970年起的毫秒数
+    int64_t uptimeMillis = 0;
+    
+    // 去掉包名或JAR所在目录后的名称，与jps的默认输出一致
+    std::string GetShortName() const;
+};
+
+// 通过hsperfdata发现本机JVM（与jps相同的方式）
+//
+// 只映射性能数据文件，不打开目标进程，也不需要遍历进程快照；
+// 以-XX:-UsePerfData或-XX:+PerfDisableSharedMem启动的JVM不会被发现。
+// JVM异常退出时可能留下过期文件，对应的进程ID在注入时才会被确认。
+// 只依赖标准库与平台的文件映射（Windows为CreateFileMapping，其他平台为mmap），
+// 不包含common.h，也不记录日志，可以在Linux上编译和测试。
+class JvmDiscovery {
+public:
+    // 性能数据文件的大小上限，HotSpot默认只有32KB
+    static constexpr uint64_t MAX_PERF_DATA_SIZE = 64ull * 1024 * 1024;
+    
+    // 枚举系统临时目录（Linux上为/tmp，与HotSpot一致）下所有hsperfdata_*目录中的JVM
+    static std::vector<JvmProcessInfo> FindJvms();
+    
+    // 枚举指定临时目录下的JVM，按进程ID排序
+    static std::vector<JvmProcessInfo> FindJvms(const std::wstring& tempDirectory);
+    
+    // 映射并读取单个性能数据文件，文件名即进程ID
+    static ErrorCode ReadPerfDataFile(const std::wstring& path, JvmProcessInfo& info);
+    
+    // 从一段性能数据中提取JVM信息，nowMillis用于计算运行时间
+    static ErrorCode ParsePerfData(const uint8_t* data, size_t size, int64_t nowMillis, JvmProcessInfo& info);
+    
+    // 主类是否匹配：完整类名、简单类名、JAR路径或JAR文件名
+    static bool MatchesMainClass(const JvmProcessInfo& info, const std::string& mainClass);
+
+private:
+    static int64_t CurrentTimeMillis();
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common.h"
+#include <jni.h>
+#include <cstdint>
+
+// JVM内存与GC的一次采样，取自平台MXBean
+struct JvmMemorySample {
+    int64_t heapUsed;          // 堆已用字节
+    int64_t heapCommitted;     // 堆已提交字节
+    int64_t metaspaceUsed;     // 元空间已用字节，JVM没有Metaspace内存池时为-1
+    int64_t loadedClasses;     // 当前已加载的类数量
+    int64_t unloadedClasses;   // 累计卸载的类数量
+    int64_t gcCount;           // 所有收集器的累计GC次数
+    int64_t gcTimeMs;          // 所有收集器的累计GC耗时（毫秒）
+    
+    JvmMemorySample() : heapUsed(0), heapCommitted(0), metaspaceUsed(-1), loadedClasses(0),
+                        unloadedClasses(0), gcCount(0), gcTimeMs(0) {}
+};
+
+// 通过平台MXBean采样JVM内存、类加载与GC计数
+//
+// 首次采样时解析MemoryMXBean、ClassLoadingMXBean、Metaspace内存池和所有
+// GarbageCollectorMXBean，保存为全局引用并缓存方法ID，之后每次采样只有几次JNI调用。
+// 不加锁，由调用者串行化（JarLoader在jniMutex_下调用）。
+class JvmTelemetry {
+public:
+    JvmTelemetry();
+    ~JvmTelemetry() = default;
+    
+    JvmTelemetry(const JvmTelemetry&) = delete;
+    JvmTelemetry& operator=(const JvmTelemetry&) = delete;
+    
+    // 采样；首次调用时解析MXBean，失败后不再重试
+    bool Sample(JNIEnv* env, JvmMemorySample& sample);
+    
+    // 释放缓存的全局引用（JVM仍可用时调用）
+    void Release(JNIEnv* env);
+
+private:
+    bool resolved_;
+    bool failed_;
+    jobject memoryBean_;          // MemoryMXBean
+    jobject classLoadingBean_;    // ClassLoadingMXBean
+    jobject metaspacePool_;       // MemoryPoolMXBean，可能为空
+    std::vector<jobject> gcBeans_;  // GarbageCollectorMXBean
+    jmethodID getHeapUsage_;
+    jmethodID getPoolUsage_;
+    jmethodID getUsed_;
+    jmethodID getCommitted_;
+    jmethodID getLoadedClassCount_;
+    jmethodID getUnloadedClassCount_;
+    jmethodID getCollectionCount_;
+    jmethodID getCollectionTime_;
+    
+    // 解析MXBean与方法ID（局部引用在返回前释放）
+    bool Resolve(JNIEnv* env);
+    
+    // 读取MemoryUsage的used与committed
+    bool ReadUsage(JNIEnv* env, jobject usage, int64_t& used, int64_t* committed);
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.h"
+#include <jni.h>
+#include <unordered_map>
+#include <unordered_set>
+
+// 按代缓存的MethodHandle调用器
+//
+// 每个(类, 方法)在一代中只解析一次：Java端的dllinject.HandleInvoker把目标方法适配为
+// 固定签名 (Object[])void 的MethodHandle（实例方法绑定接收者，或在句柄内折叠构造器），
+// 之后每次调用只需一次CallVoidMethod进入Java，由invokeExact分派。
+// JNI不能直接调用签名多态的invokeExact，HandleInvoker被编译后嵌入DLL，首次解析时定义到
+// 系统类加载器中。调用器持有目标类，切换类加载器时必须Clear，否则旧的一代无法被回收。
+// 不加锁，由调用者串行化（JarLoader在jniMutex_下调用）。
+class MethodHandleCache {
+public:
+    static constexpr const char* INVOKER_CLASS_NAME = "dllinject/HandleInvoker";
+    
+    MethodHandleCache();
+    ~MethodHandleCache() = default;
+    
+    MethodHandleCache(const MethodHandleCache&) = delete;
+    MethodHandleCache& operator=(const MethodHandleCache&) = delete;
+    
+    // 查找已缓存的调用器（全局引用），不存在时返回nullptr
+    jobject Find(const std::string& key) const;
+    
+    // 解析后缓存：stringArgs为true时目标方法接受String[]，receiver为实例方法绑定的实例，
+    // 为空时每次调用创建新实例。失败的键被记住，同一代内不再重试
+    jobject Resolve(JNIEnv* env, const std::string& key, jclass clazz, const std::string& methodName,
+                    bool stringArgs, jobject receiver);
+    
+    // 该键在本代是否已解析失败
+    bool IsUnsupported(const std::string& key) const { return unsupported_.count(key) != 0; }
+    
+    // 调用；args为String[]或空，Java异常留给调用者检查
+    void Invoke(JNIEnv* env, jobject invoker, jobjectArray args);
+    
+    // 释放本代的调用器（切换或卸载类加载器时调用）
+    void Clear(JNIEnv* env);
+    
+    // 释放键以suffix结尾的调用器（线程结束时释放绑定了每线程实例的调用器）
+    void RemoveBySuffix(JNIEnv* env, const std::string& suffix);
+    
+    // 与另一个缓存交换调用器（保留备用的一代时使用），调用器类不交换
+    void SwapEntries(MethodHandleCache& other);
+    
+    // 释放调用器与调用器类（JVM仍可用时调用）
+    void Release(JNIEnv* env);
+    
+    size_t GetCount() const { return invokers_.size(); }
+
+private:
+    jclass invokerClass_;   // 全局引用
+    jmethodID create_;
+    jmethodID invoke_;
+    bool defineFailed_;
+    std::unordered_map<std::string, jobject> invokers_;  // 键 -> HandleInvoker（全局引用）
+    std::unordered_set<std::string> unsupported_;
+    
+    // 定义嵌入的HandleInvoker类并解析方法ID
+    bool DefineInvokerClass(JNIEnv* env);
+};
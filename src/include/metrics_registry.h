@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common.h"
+#include <cstdint>
+#include <map>
+#include <utility>
+
+// 进程内指标注册表
+//
+// 以名称登记int64计数器与测量值，供控制通道查询和日志输出。
+// 名称使用点分小写形式，如 reload.count、reload.last_duration_us。
+class MetricsRegistry {
+public:
+    static MetricsRegistry& GetInstance();
+    
+    // 计数器累加
+    void Increment(const std::string& name, int64_t delta = 1);
+    
+    // 设置测量值
+    void Set(const std::string& name, int64_t value);
+    
+    // 读取指标，不存在时返回0
+    int64_t Get(const std::string& name) const;
+    
+    // 所有指标的快照，按名称排序
+    std::vector<std::pair<std::string, int64_t>> Snapshot() const;
+    
+    // 清空所有指标
+    void Reset();
+
+private:
+    MetricsRegistry() = default;
+    
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    
+    mutable std::mutex mutex_;
+    std::map<std::string, int64_t> values_;
+};
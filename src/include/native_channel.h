@@ -0,0 +1,66 @@
+#pragma once
+
+#include "common.h"
+#include "shared_ring_buffer.h"
+#include <functional>
+
+// 通道记录类型（与Java端NativeChannel保持一致）
+enum class ChannelRecordType : uint32_t {
+    LOG = 1,       // UTF-16文本日志
+    METRIC = 2,    // int64数值 + UTF-16指标名
+    PAYLOAD = 3    // 任意二进制数据
+};
+
+// Java与本地代码之间的批量数据通道
+// 每个方向一个SharedRingBuffer：toNative由Java写、本地消费线程读；toJava由本地写、Java读。
+class NativeChannel {
+public:
+    using RecordHandler = std::function<void(uint32_t type, const uint8_t* data, uint32_t length)>;
+    
+    static NativeChannel& GetInstance();
+    
+    // 打开通道（重复调用返回已有通道）
+    ErrorCode Open(uint32_t capacity);
+    
+    // 停止消费线程并等待其退出。共享内存保留到进程退出，因为Java端可能仍持有DirectByteBuffer
+    // 必须在普通线程上调用（不能在DllMain中），析构函数不等待线程
+    void Close();
+    
+    bool IsOpen() const { return running_; }
+    
+    SharedRingBuffer* GetToNativeBuffer() const { return toNative_.get(); }
+    SharedRingBuffer* GetToJavaBuffer() const { return toJava_.get(); }
+    
+    // 本地 -> Java 发送一条记录
+    bool Send(ChannelRecordType type, const void* data, uint32_t length);
+    
+    // 设置非日志记录的处理器
+    void SetRecordHandler(RecordHandler handler);
+    
+    uint64_t GetRecordsReceived() const { return recordsReceived_; }
+    uint64_t GetRecordsDropped() const { return recordsDropped_; }
+
+private:
+    NativeChannel() : running_(false), recordsReceived_(0), recordsDropped_(0) {}
+    ~NativeChannel();
+    
+    NativeChannel(const NativeChannel&) = delete;
+    NativeChannel& operator=(const NativeChannel&) = delete;
+    
+    std::unique_ptr<SharedRingBuffer> toNative_;
+    std::unique_ptr<SharedRingBuffer> toJava_;
+    std::atomic<bool> running_;
+    std::thread consumerThread_;
+    std::mutex channelMutex_;
+    std::mutex handlerMutex_;
+    std::mutex sendMutex_;
+    RecordHandler recordHandler_;
+    std::atomic<uint64_t> recordsReceived_;
+    std::atomic<uint64_t> recordsDropped_;
+    
+    // 消费线程函数
+    void ConsumerThreadFunc();
+    
+    // 分发一条Java写入的记录
+    void Dispatch(uint32_t type, const uint8_t* data, uint32_t length);
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// 平台层：与操作系统相关的基础操作
+//
+// 实现分别在platform_win32.cpp与platform_posix.cpp中，由构建按目标平台选择其一。
+// 接口只使用标准类型，不包含windows.h或common.h，不依赖日志，解析器等独立模块也可以使用。
+// 失败的原因由调用者通过GetLastSystemError读取并记录。
+namespace Platform {
+
+// UTF-8与宽字符串互相转换（Windows的wchar_t为UTF-16，POSIX为UTF-32）
+// 无效的输入序列替换为U+FFFD
+std::wstring Utf8ToWide(const std::string& text);
+std::string WideToUtf8(const std::wstring& text);
+
+// Java字符串（UTF-16）与宽字符串互相转换
+// Windows上逐单元拷贝；POSIX上合并或拆分代理对，不成对的代理替换为U+FFFD
+// Utf16ToWide不分配内存：target至少需要length个字符，返回写入的字符数
+size_t Utf16ToWide(const char16_t* source, size_t length, wchar_t* target);
+std::u16string WideToUtf16(const std::wstring& text);
+
+// 类路径等路径列表的分隔符与目录分隔符
+#ifdef _WIN32
+constexpr wchar_t PATH_LIST_SEPARATOR = L';';
+constexpr wchar_t PATH_SEPARATOR = L'\\';
+#else
+constexpr wchar_t PATH_LIST_SEPARATOR = L':';
+constexpr wchar_t PATH_SEPARATOR = L'/';
+#endif
+
+// 宽字符串路径与std::filesystem::path互相转换
+// POSIX上路径按UTF-8编码，不依赖进程的locale
+std::filesystem::path ToFilesystemPath(const std::wstring& path);
+std::wstring FromFilesystemPath(const std::filesystem::path& path);
+
+// 按文件系统的习惯比较文件名：Windows忽略大小写，其他平台区分大小写
+bool FileNameEquals(const std::wstring& left, const std::wstring& right);
+
+uint32_t GetCurrentProcessId();
+uint32_t GetCurrentThreadId();
+
+// 处理器与物理内存信息，读取失败的字段为0
+struct SystemInfo {
+    uint32_t processorCount;
+    uint32_t pageSize;
+    uint64_t totalPhysicalMemory;       // 字节
+    uint64_t availablePhysicalMemory;   // 字节
+};
+
+SystemInfo QuerySystemInfo();
+
+// 最近一次失败的系统调用的错误码（GetLastError或errno）
+uint32_t GetLastSystemError();
+
+// 包含指定地址的模块（DLL或共享库）的完整路径，失败时返回空字符串
+std::wstring GetModulePath(const void* address);
+
+// 按路径读取的文件标识，文件被替换后fileId改变，被修改后size或modifyTime改变
+struct FileIdentity {
+    uint64_t device;        // 卷序列号或st_dev
+    uint64_t fileId;        // 文件索引或inode
+    uint64_t size;
+    uint64_t modifyTime;    // 平台相关的单位，只用于比较
+    
+    FileIdentity() : device(0), fileId(0), size(0), modifyTime(0) {}
+    
+    bool operator==(const FileIdentity& other) const {
+        return device == other.device && fileId == other.fileId &&
+               size == other.size && modifyTime == other.modifyTime;
+    }
+    bool operator!=(const FileIdentity& other) const { return !(*this == other); }
+};
+
+// 只读取属性，不妨碍其他进程写入、替换或删除文件；文件不存在时返回false
+bool QueryFileIdentity(const std::wstring& path, FileIdentity& identity);
+
+// 通过块克隆创建目标文件（与来源共享数据块，几乎不复制数据）
+// 文件系统不支持时返回false且不留下目标文件，调用者回退到普通复制
+// Windows：ReFS与Dev Drive上的FSCTL_DUPLICATE_EXTENTS_TO_FILE；Linux：Btrfs、XFS等的FICLONE
+bool CloneFile(const std::wstring& sourcePath, const std::wstring& targetPath);
+
+// 按页分配已清零的可读写内存，失败时返回nullptr
+void* AllocatePages(size_t size);
+
+// 将AllocatePages分配的内存改为只读
+bool ProtectPagesReadOnly(void* memory, size_t size);
+
+void FreePages(void* memory, size_t size);
+
+// 单个目录的变更通知与停止信号
+//
+// 监控线程在Wait中等待，其他线程调用Stop立即唤醒它。目录通知只说明目录中有文件的
+// 名称、大小或写入发生了变化，调用者需自行检查关心的文件。
+// Windows使用FindFirstChangeNotification与事件，Linux使用inotify与管道。
+class DirectoryMonitor {
+public:
+    enum class WaitResult {
+        STOPPED,    // Stop已被调用（或等待失败）
+        CHANGED,    // 目录发生了变化
+        TIMEOUT
+    };
+    
+    DirectoryMonitor();
+    ~DirectoryMonitor();
+    
+    DirectoryMonitor(const DirectoryMonitor&) = delete;
+    DirectoryMonitor& operator=(const DirectoryMonitor&) = delete;
+    
+    // 创建停止信号，失败时返回false
+    bool Create();
+    
+    // 开始接收目录通知；不可用时（如部分网络共享）返回false，之后Wait只按超时返回
+    bool Watch(const std::wstring& directory);
+    
+    // 目录通知是否仍然可用，通知出错后自动关闭
+    bool IsWatching() const;
+    
+    WaitResult Wait(uint32_t timeoutMs);
+    
+    // 只等待停止信号，已停止时返回true
+    bool WaitForStop(uint32_t timeoutMs);
+    
+    // 设置停止信号，可以从其他线程调用；之后所有等待都立即返回
+    void Stop();
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+} // namespace Platform
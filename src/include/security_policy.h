@@ -0,0 +1,153 @@
+#pragma once
+
+#include "common.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 大小写无关的多模式子串匹配（Aho–Corasick）
+//
+// 构建时把模式折叠为大写并编译为确定性自动机：字符先映射到字符类，再按
+// 状态×字符类的转移表前进，匹配时每个输入字符只做一次查表，与模式数量无关。
+// 自动机编译为不含指针的32位字映像，可放入只读映射内存，由多个线程共享。
+class PatternMatcher {
+public:
+    PatternMatcher();
+    
+    PatternMatcher(const PatternMatcher&) = delete;
+    PatternMatcher& operator=(const PatternMatcher&) = delete;
+    
+    // 编译模式集合为映像，空模式被忽略
+    static std::vector<uint32_t> Compile(const std::vector<std::wstring>& patterns);
+    
+    // 使用调用者持有的映像，映像须在本对象使用期间有效；格式不符时返回false
+    bool Attach(const uint32_t* image, size_t wordCount);
+    
+    // 编译并使用自有映像
+    void Build(const std::vector<std::wstring>& patterns);
+    
+    // 文本中是否出现任一模式
+    bool Matches(const std::wstring& text) const;
+    
+    size_t GetPatternCount() const { return patternCount_; }
+    size_t GetStateCount() const { return stateCount_; }
+
+private:
+    static wchar_t Fold(wchar_t c);
+    uint32_t ClassOf(wchar_t c) const;
+    
+    // 转移目标的最高位表示目标状态为接受状态
+    static const uint32_t ACCEPTING = 0x80000000u;
+    
+    std::vector<uint32_t> image_;      // Build时的自有映像
+    
+    // 折叠后小于256的字符直接查表，其余字符在有序的(字符, 类)数组中二分查找；0表示不出现在任何模式中
+    const uint32_t* latinClasses_;
+    const uint32_t* wideClasses_;
+    size_t wideClassCount_;
+    
+    // transitions_[state * classCount_ + class]
+    const uint32_t* transitions_;
+    size_t classCount_;
+    size_t stateCount_;
+    size_t patternCount_;
+};
+
+// 大小写无关的精确名称集合（完美哈希）
+//
+// 构建时搜索一个哈希种子，使所有名称落在互不冲突的槽位上；查找时边折叠边
+// 计算哈希，只比较一个槽位，不分配内存。与PatternMatcher一样编译为32位字映像。
+class ExactNameSet {
+public:
+    ExactNameSet();
+    
+    ExactNameSet(const ExactNameSet&) = delete;
+    ExactNameSet& operator=(const ExactNameSet&) = delete;
+    
+    // 编译名称集合为映像，重复名称（忽略大小写）只保留一个
+    static std::vector<uint32_t> Compile(const std::vector<std::wstring>& names);
+    
+    // 使用调用者持有的映像，映像须在本对象使用期间有效；格式不符时返回false
+    bool Attach(const uint32_t* image, size_t wordCount);
+    
+    // 编译并使用自有映像
+    void Build(const std::vector<std::wstring>& names);
+    
+    bool Contains(const std::wstring& name) const;
+    
+    size_t GetNameCount() const { return nameCount_; }
+
+private:
+    static wchar_t Fold(wchar_t c);
+    static uint32_t Hash(const std::wstring& name, uint32_t seed);
+    
+    std::vector<uint32_t> image_;      // Build时的自有映像
+    
+    // slots_[i] = (名称在characters_中的偏移, 长度)，长度为0表示空槽
+    const uint32_t* slots_;
+    const uint32_t* characters_;       // 折叠后的字符，每个字符一个字
+    size_t characterCount_;
+    uint32_t seed_;
+    uint32_t mask_;
+    size_t nameCount_;
+};
+
+// 安全策略：禁止的路径模式与系统关键进程
+//
+// 策略文件为UTF-8文本，按节列出规则，'#'开头的行为注释：
+//
+//   [forbidden_paths]
+//   \Windows\Tasks
+//   [critical_processes]
+//   csrss.exe
+//
+// 文件中的规则追加在内置规则之后，只能收紧而不能放宽检查。
+//
+// 策略加载时一次编译为单块映像，复制到页面文件支持的内存映射中并只保留只读视图，
+// 此后不可修改；映射失败时退回堆内存。更新策略时编译新的实例再整体替换。
+class SecurityPolicy {
+public:
+    ~SecurityPolicy();
+    
+    SecurityPolicy(const SecurityPolicy&) = delete;
+    SecurityPolicy& operator=(const SecurityPolicy&) = delete;
+    
+    // 由规则列表编译策略
+    static std::unique_ptr<SecurityPolicy> Compile(const std::vector<std::wstring>& forbiddenPathPatterns,
+                                                   const std::vector<std::wstring>& criticalProcesses);
+    
+    // 解析策略文件，把其中的规则追加到给定列表
+    static ErrorCode ParseFile(const std::wstring& policyPath,
+                               std::vector<std::wstring>& forbiddenPathPatterns,
+                               std::vector<std::wstring>& criticalProcesses);
+    
+    bool MatchesForbiddenPath(const std::wstring& path) const {
+        return forbiddenPaths_.Matches(path);
+    }
+    
+    bool IsCriticalProcess(const std::wstring& processName) const {
+        return criticalProcesses_.Contains(processName);
+    }
+    
+    size_t GetForbiddenPathCount() const { return forbiddenPaths_.GetPatternCount(); }
+    size_t GetCriticalProcessCount() const { return criticalProcesses_.GetNameCount(); }
+    
+    // 映像大小（字节），以及是否位于只读内存映射中
+    size_t GetImageSize() const { return imageWords_ * sizeof(uint32_t); }
+    bool IsMapped() const { return mappedView_ != nullptr; }
+
+private:
+    SecurityPolicy();
+    
+    // 把映像放入只读内存，返回映像起始地址
+    const uint32_t* Publish(const std::vector<uint32_t>& image);
+    
+    PatternMatcher forbiddenPaths_;
+    ExactNameSet criticalProcesses_;
+    void* mappedView_;                 // 只读页面中的映像，未分配时为空
+    std::vector<uint32_t> heapImage_;  // 映射失败时的映像
+    size_t imageWords_;
+};
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "common.h"
+#include "java_name_validator.h"
+#include "char_class_scanner.h"
+#include "security_policy.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <regex>
 
 class SecurityUtils {
 public:
@@ -14,14 +21,24 @@ public:
     static bool ValidateDllPath(const std::wstring& dllPath);
     
     // 验证JAR路径是否安全
+    // 通过验证的路径按规范化路径缓存文件标识，再次验证时只重新读取文件标识并比较，
+    // 文件被替换、修改或删除，或安全策略重新加载后，缓存项失效并重新完整验证
     static bool ValidateJarPath(const std::wstring& jarPath);
     
+    // 使JAR路径的验证缓存失效（同时清除指向同一文件的其他路径）
+    static void InvalidateJarPathCache(const std::wstring& jarPath);
+    static void ClearJarPathCache();
+    
     // 验证Java类名是否安全
     static bool ValidateClassName(const std::string& className);
     
     // 验证Java方法名是否安全
     static bool ValidateMethodName(const std::string& methodName);
     
+    // 批量验证类名（如JAR索引中的全部类名），返回不合法名称的下标
+    // 判定结果与逐个调用ValidateClassName一致，但不为每个名称记录日志
+    static std::vector<size_t> FindInvalidClassNames(const std::vector<std::string_view>& classNames);
+    
     // 验证字符串是否包含危险字符
     static bool ContainsDangerousChars(const std::string& input);
     static bool ContainsDangerousChars(const std::wstring& input);
@@ -33,9 +50,13 @@ public:
     static bool HasSufficientPrivileges();
     
     // 检查目标进程是否为系统关键进程
-    static bool IsSystemCriticalProcess(DWORD processId);
+    static bool IsSystemCriticalProcess(uint32_t processId);
     static bool IsSystemCriticalProcess(const std::wstring& processName);
     
+    // 从策略文件加载额外的禁止路径与关键进程规则（追加在内置规则之后）
+    // 新策略编译完成后原子替换当前策略，进行中的验证继续使用旧策略；文件无效时保留当前策略
+    static ErrorCode LoadSecurityPolicy(const std::wstring& policyPath);
+    
     // 验证文件签名（如果需要）
     static bool VerifyFileSignature(const std::wstring& filePath);
     
@@ -47,10 +68,12 @@ public:
 
 private:
     // 危险字符列表
-    static const std::string DANGEROUS_CHARS;
-    static const std::wstring DANGEROUS_WCHARS;
+    static const CharClassScanner DANGEROUS_CHAR_SCANNER;
     
-    // 系统关键进程列表
+    // 类名中允许出现的字符 [A-Za-z0-9_.]
+    static const CharClassScanner CLASS_NAME_CHAR_SCANNER;
+    
+    // 系统关键进程列表（以下按平台定义的表与函数在security_utils_win32.cpp/security_utils_posix.cpp中）
     static const std::vector<std::wstring> SYSTEM_CRITICAL_PROCESSES;
     
     // 允许的文件扩展名
@@ -60,6 +83,30 @@ private:
     // 禁止的路径模式
     static const std::vector<std::wstring> FORBIDDEN_PATH_PATTERNS;
     
+    // 由规则编译的当前策略，首次使用时按内置规则构建；验证只原子读取指针，不加锁
+    static std::atomic<const SecurityPolicy*> securityPolicy_;
+    static const SecurityPolicy* GetSecurityPolicy();
+    
+    // 所有发布过的策略。读取方不持有引用计数，无法得知旧策略何时不再被使用，
+    // 因此被替换的策略保留到模块卸载（每个策略只有几KB）
+    static std::mutex policyMutex_;
+    static std::vector<std::unique_ptr<const SecurityPolicy>> policies_;
+    static const SecurityPolicy* PublishSecurityPolicy(std::unique_ptr<const SecurityPolicy> policy);
+    
+    // 缓存项记录验证时的文件标识与安全策略；策略从不释放，按指针比较即可，
+    // 重新加载策略后旧策略下的缓存项在下次查找时视为未命中，加载策略无需获取缓存锁
+    struct JarPathCacheEntry {
+        Platform::FileIdentity identity;
+        const SecurityPolicy* policy;
+    };
+    
+    // JAR路径验证缓存，键为规范化路径（Windows上转换为大写）
+    static std::mutex jarPathCacheMutex_;
+    static std::unordered_map<std::wstring, JarPathCacheEntry> jarPathCache_;
+    
+    // 生成缓存键
+    static std::wstring MakeJarPathCacheKey(const std::wstring& path);
+    
     // 检查文件扩展名
     static bool HasValidExtension(const std::wstring& filePath, const std::vector<std::wstring>& allowedExtensions);
     
@@ -68,4 +115,10 @@ private:
     
     // 规范化路径
     static std::wstring NormalizePath(const std::wstring& path);
+    
+    // 规范化后的路径是否为本平台的绝对路径（Windows要求盘符，不接受UNC路径）
+    static bool IsAbsolutePath(const std::wstring& normalizedPath);
+    
+    // 类名各段以字母或'_'开头且不为空（字符集已检查过）
+    static bool HasValidClassNameSegments(std::string_view className);
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// SHA-256
+//
+// 使用系统的密码库：Windows为CNG（BCrypt），其他平台为OpenSSL的libcrypto。
+// 实现分别在sha256_win32.cpp与sha256_posix.cpp中，由构建按目标平台选择其一。
+// 一个对象可以连续计算多个摘要（Finish之后重新开始），但不能被多个线程同时使用。
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+    
+    Sha256();
+    ~Sha256();
+    
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+    
+    // 哈希对象是否创建成功
+    bool IsValid() const { return state_ != nullptr; }
+    
+    bool Update(const uint8_t* data, size_t size);
+    
+    // 输出摘要并重置，之后可以计算下一个摘要
+    bool Finish(Digest& digest);
+    
+    // 计算一段内存的摘要
+    static bool Hash(const uint8_t* data, size_t size, Digest& digest);
+
+private:
+    void* state_;   // BCRYPT_HASH_HANDLE或EVP_MD_CTX*
+};
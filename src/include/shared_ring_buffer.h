@@ -0,0 +1,124 @@
+#pragma once
+
+#include "common.h"
+#include <cstdint>
+#include <cstring>
+
+// 单生产者/单消费者共享环形缓冲区
+//
+// 内存由本地代码分配，通过NewDirectByteBuffer暴露给Java，两端直接读写同一块内存，
+// 不经过JNI调用也不产生拷贝。布局必须与Java端NativeChannel保持一致：
+//   [0,   64)  头部：magic(4) capacity(4) 保留
+//   [64,  128) 写位置 writePos（int64，单调递增，仅生产者写）
+//   [128, 192) 读位置 readPos （int64，单调递增，仅消费者写）
+//   [192, 192 + capacity) 数据区
+// 记录格式：length(4) type(4) payload(length)，整体按8字节对齐；
+// length为PADDING_RECORD表示数据区尾部的回绕填充。
+class SharedRingBuffer {
+public:
+    static constexpr uint32_t MAGIC = 0x52494E47; // "RING"
+    static constexpr uint32_t HEADER_SIZE = 192;
+    static constexpr uint32_t WRITE_POS_OFFSET = 64;
+    static constexpr uint32_t READ_POS_OFFSET = 128;
+    static constexpr uint32_t RECORD_HEADER_SIZE = 8;
+    static constexpr int32_t PADDING_RECORD = -1;
+    static constexpr uint32_t MIN_CAPACITY = 4096;
+    static constexpr uint32_t MAX_CAPACITY = 64 * 1024 * 1024;
+    
+    // capacity会向上取整为2的幂
+    explicit SharedRingBuffer(uint32_t capacity);
+    ~SharedRingBuffer();
+    
+    SharedRingBuffer(const SharedRingBuffer&) = delete;
+    SharedRingBuffer& operator=(const SharedRingBuffer&) = delete;
+    
+    bool IsValid() const { return memory_ != nullptr; }
+    
+    // 整块共享内存（头部+数据区），用于创建DirectByteBuffer
+    void* GetMemory() const { return memory_; }
+    size_t GetMemorySize() const { return HEADER_SIZE + static_cast<size_t>(capacity_); }
+    uint32_t GetCapacity() const { return capacity_; }
+    
+    // 单条记录允许的最大负载
+    uint32_t GetMaxPayload() const { return capacity_ / 2 - RECORD_HEADER_SIZE; }
+    
+    // 生产者：写入一条记录，空间不足时返回false
+    bool TryWrite(uint32_t type, const void* data, uint32_t length);
+    
+    // 消费者：读取一条记录，回调在负载仍位于缓冲区内时调用（零拷贝）
+    // 回调签名：void(uint32_t type, const uint8_t* payload, uint32_t length)
+    template<typename Handler>
+    bool TryRead(Handler&& handler);
+    
+    // 消费者：最多读取maxRecords条记录，返回实际读取数
+    template<typename Handler>
+    size_t Drain(Handler&& handler, size_t maxRecords = SIZE_MAX);
+    
+    // 当前未读取的字节数
+    uint64_t GetUsedBytes() const;
+    
+    // 计算一条记录占用的字节数
+    static uint32_t RecordSize(uint32_t length) {
+        return (RECORD_HEADER_SIZE + length + 7u) & ~7u;
+    }
+
+private:
+    uint8_t* memory_;
+    uint8_t* data_;
+    uint32_t capacity_;
+    
+    std::atomic<int64_t>* WritePos() const {
+        return reinterpret_cast<std::atomic<int64_t>*>(memory_ + WRITE_POS_OFFSET);
+    }
+    
+    std::atomic<int64_t>* ReadPos() const {
+        return reinterpret_cast<std::atomic<int64_t>*>(memory_ + READ_POS_OFFSET);
+    }
+};
+
+template<typename Handler>
+bool SharedRingBuffer::TryRead(Handler&& handler) {
+    if (!memory_) {
+        return false;
+    }
+    
+    int64_t read = ReadPos()->load(std::memory_order_relaxed);
+    int64_t write = WritePos()->load(std::memory_order_acquire);
+    
+    while (read != write) {
+        uint32_t offset = static_cast<uint32_t>(read) & (capacity_ - 1);
+        int32_t length = 0;
+        uint32_t type = 0;
+        memcpy(&length, data_ + offset, sizeof(length));
+        memcpy(&type, data_ + offset + 4, sizeof(type));
+        
+        if (length == PADDING_RECORD) {
+            // 跳过尾部填充，回到数据区起点
+            read += capacity_ - offset;
+            ReadPos()->store(read, std::memory_order_release);
+            continue;
+        }
+        
+        if (length < 0 || static_cast<uint32_t>(length) > GetMaxPayload()) {
+            // 记录头损坏：丢弃全部未读数据，避免越界读取
+            LOG_ERROR(L"Corrupted ring buffer record, length: " << length);
+            ReadPos()->store(write, std::memory_order_release);
+            return false;
+        }
+        
+        handler(type, data_ + offset + RECORD_HEADER_SIZE, static_cast<uint32_t>(length));
+        ReadPos()->store(read + RecordSize(static_cast<uint32_t>(length)), std::memory_order_release);
+        return true;
+    }
+    
+    return false;
+}
+
+template<typename Handler>
+size_t SharedRingBuffer::Drain(Handler&& handler, size_t maxRecords) {
+    size_t count = 0;
+    while (count < maxRecords && TryRead(handler)) {
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common.h"
+#include "jar_archive.h"
+#include <jni.h>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+// JAR内存快照注册表与SnapshotClassLoader的本地支持
+//
+// 快照是JAR文件的一份只读内存副本（JarArchive::OpenSnapshot），以句柄的形式交给
+// Java端的dllinject.SnapshotClassLoader。加载器的findClass通过native方法按条目名
+// 取得指向快照内存的DirectByteBuffer，STORED条目零拷贝定义，DEFLATED条目在Java端解压。
+// 快照在加载器close()或被回收时释放，加载器的读写锁保证释放时没有进行中的查找。
+class SnapshotRegistry {
+public:
+    static constexpr const char* LOADER_CLASS_NAME = "dllinject/SnapshotClassLoader";
+    
+    static SnapshotRegistry& GetInstance();
+    
+    SnapshotRegistry(const SnapshotRegistry&) = delete;
+    SnapshotRegistry& operator=(const SnapshotRegistry&) = delete;
+    
+    // 登记已打开的快照，返回句柄（单调递增，不复用），失败返回0
+    jlong Register(std::unique_ptr<JarArchive> archive);
+    
+    // 释放快照，句柄不存在时忽略
+    void Release(jlong handle);
+    
+    // 查找条目并定位其原始数据
+    bool FindEntry(jlong handle, std::string_view name, const JarEntry*& entry,
+                   const uint8_t*& data, uint64_t& size);
+    
+    // 当前持有的快照数量与字节数
+    size_t GetSnapshotCount();
+    size_t GetSnapshotBytes();
+    
+    // 为快照创建SnapshotClassLoader实例，返回局部引用；parent为空时使用系统类加载器
+    // 首次调用时在JVM中定义嵌入的加载器类并注册native方法
+    jobject CreateClassLoader(JNIEnv* env, jlong handle, const std::wstring& source, jobject parent);
+
+private:
+    SnapshotRegistry();
+    
+    struct Snapshot {
+        std::unique_ptr<JarArchive> archive;
+        std::unordered_map<std::string_view, const JarEntry*> entries;  // 名称指向快照内存
+    };
+    
+    std::mutex mutex_;
+    std::unordered_map<jlong, std::unique_ptr<Snapshot>> snapshots_;
+    jlong nextHandle_;
+    jclass loaderClass_;            // 全局引用
+    jmethodID loaderConstructor_;
+    
+    // 定义嵌入的加载器类并注册native方法（调用者持有mutex_）
+    bool DefineLoaderClass(JNIEnv* env);
+};
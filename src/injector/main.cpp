@@ -1,4 +1,10 @@
 #include "../include/dll_injector.h"
+#include "../include/jar_archive.h"
+#include "../include/class_index.h"
+#include "../include/jar_verifier.h"
+#include "../include/jvm_discovery.h"
+#include "../include/control_channel.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 
@@ -9,6 +15,197 @@ void PrintUsage() {
     std::wcout << L"  method_name: Java method name (default: main)" << std::endl;
     std::wcout << L"  enable_hot_reload: Enable hot reload (default: true)" << std::endl;
     std::wcout << L"Example: injector.exe test.jar com.example.Main main true" << std::endl;
+    std::wcout << L"       injector.exe --list-classes <jar_path>" << std::endl;
+    std::wcout << L"  --list-classes: List entry point candidates in the JAR and exit" << std::endl;
+    std::wcout << L"       injector.exe --jar-digest <jar_path>" << std::endl;
+    std::wcout << L"  --jar-digest: Print the JAR integrity digest (for <jar_path>.digests) and exit" << std::endl;
+    std::wcout << L"       injector.exe --list-jvms" << std::endl;
+    std::wcout << L"  --list-jvms: List running JVMs (PID, main class, uptime) and exit" << std::endl;
+    std::wcout << L"       injector.exe --target <main_class> <jar_path> [class_name] [method_name] [enable_hot_reload]" << std::endl;
+    std::wcout << L"  --target: Inject into the JVM running <main_class> (full or simple name, or JAR file name)" << std::endl;
+    std::wcout << L"       injector.exe --control <pid> <command> [arguments]" << std::endl;
+    std::wcout << L"  --control: Send a command to an injected process: ping, reload, metrics," << std::endl;
+    std::wcout << L"             invoke <class_name> <method_name> [args...], log-level <debug|info|warning|error|critical>" << std::endl;
+}
+
+// 列出JAR中的入口点候选类
+int ListClasses(const std::wstring& jarPath) {
+    JarArchive archive;
+    if (archive.Open(jarPath) != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Invalid JAR file: " << jarPath << L" (" << archive.GetLastErrorMessage() << L")");
+        return 1;
+    }
+    
+    ClassIndex index;
+    index.Build(archive);
+    
+    std::wcout << index.GetClassCount() << L" classes in " << index.GetPackageCount() << L" packages" << std::endl;
+    
+    // 注入时类名须通过安全验证，无法作为入口点的候选单独标出
+    std::vector<std::string> candidates = index.GetEntryPointCandidates();
+    std::vector<std::string_view> candidateViews(candidates.begin(), candidates.end());
+    std::vector<size_t> invalidIndices = SecurityUtils::FindInvalidClassNames(candidateViews);
+    size_t nextInvalid = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        bool rejected = nextInvalid < invalidIndices.size() && invalidIndices[nextInvalid] == i;
+        if (rejected) {
+            ++nextInvalid;
+        }
+        std::wcout << L"  " << StringToWString(candidates[i]) << (rejected ? L" (rejected by name validation)" : L"") << std::endl;
+    }
+    return 0;
+}
+
+// 输出JAR完整性摘要，格式与可信摘要列表一致
+int PrintJarDigest(const std::wstring& jarPath) {
+    JarVerifier verifier;
+    JarVerificationResult result;
+    if (verifier.Verify(jarPath, result) != ErrorCode::SUCCESS) {
+        return 1;
+    }
+    
+    std::wcout << StringToWString(result.digest) << L"  " << std::filesystem::path(jarPath).filename().wstring() << std::endl;
+    return 0;
+}
+
+// 打印一个JVM的摘要
+void PrintJvm(const JvmProcessInfo& jvm) {
+    std::wcout << L"PID: " << jvm.processId << L"  " << StringToWString(jvm.mainClass)
+               << L"  (up " << jvm.uptimeMillis / 1000 << L"s)";
+    if (!jvm.jvmArgs.empty()) {
+        std::wcout << L"  " << StringToWString(jvm.jvmArgs);
+    }
+    std::wcout << std::endl;
+}
+
+// 列出本机JVM
+int ListJvms() {
+    std::vector<JvmProcessInfo> jvms = JvmDiscovery::FindJvms();
+    std::wcout << jvms.size() << L" JVMs found" << std::endl;
+    for (const auto& jvm : jvms) {
+        std::wcout << L"  ";
+        PrintJvm(jvm);
+    }
+    return 0;
+}
+
+// 向已注入的进程发送控制命令
+int SendControlCommand(int argc, wchar_t* argv[]) {
+    DWORD processId = static_cast<DWORD>(wcstoul(argv[0], nullptr, 10));
+    std::wstring command = argv[1];
+    if (processId == 0) {
+        LOG_ERROR(L"Invalid process ID: " << argv[0]);
+        return 1;
+    }
+    
+    ControlClient client;
+    if (client.Connect(ControlServer::GetEndpointName(processId)) != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Process " << processId << L" has no control endpoint (not injected?)");
+        return 1;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    ErrorCode result;
+    std::vector<std::pair<std::string, int64_t>> metrics;
+    if (command == L"ping") {
+        result = client.Ping();
+    } else if (command == L"reload") {
+        result = client.Reload();
+    } else if (command == L"metrics") {
+        result = client.GetMetrics(metrics);
+    } else if (command == L"invoke" && argc >= 4) {
+        std::vector<std::string> args;
+        for (int i = 4; i < argc; ++i) {
+            args.push_back(WStringToString(argv[i]));
+        }
+        result = client.Invoke(WStringToString(argv[2]), WStringToString(argv[3]), args);
+    } else if (command == L"log-level" && argc >= 3) {
+        static const std::pair<const wchar_t*, LogLevel> levels[] = {
+            {L"debug", LogLevel::DEBUG}, {L"info", LogLevel::INFO}, {L"warning", LogLevel::WARNING},
+            {L"error", LogLevel::ERROR}, {L"critical", LogLevel::CRITICAL}
+        };
+        auto level = std::find_if(std::begin(levels), std::end(levels), [&argv](const auto& entry) {
+            return _wcsicmp(entry.first, argv[2]) == 0;
+        });
+        if (level == std::end(levels)) {
+            LOG_ERROR(L"Unknown log level: " << argv[2]);
+            return 1;
+        }
+        result = client.SetLogLevel(level->second);
+    } else {
+        PrintUsage();
+        return 1;
+    }
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    
+    if (result != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Command " << command << L" failed: [" << static_cast<int>(result) << L"] "
+                  << StringToWString(client.GetLastErrorMessage()));
+        return 1;
+    }
+    
+    for (const auto& metric : metrics) {
+        std::wcout << L"  " << StringToWString(metric.first) << L" = " << metric.second << std::endl;
+    }
+    std::wcout << command << L" OK (" << elapsedUs << L" us)" << std::endl;
+    return 0;
+}
+
+// 选择目标进程：优先通过hsperfdata按主类选择，没有性能数据时回退到按进程名查找javaw.exe
+// 返回0表示没有可用的目标
+DWORD SelectTargetProcess(DllInjector& injector, const std::wstring& targetMainClass) {
+    std::vector<JvmProcessInfo> jvms = JvmDiscovery::FindJvms();
+    if (!targetMainClass.empty()) {
+        std::string mainClass = WStringToString(targetMainClass);
+        jvms.erase(std::remove_if(jvms.begin(), jvms.end(), [&mainClass](const JvmProcessInfo& jvm) {
+            return !JvmDiscovery::MatchesMainClass(jvm, mainClass);
+        }), jvms.end());
+        
+        if (jvms.empty()) {
+            LOG_ERROR(L"No JVM found running main class: " << targetMainClass);
+            return 0;
+        }
+    }
+    
+    std::vector<std::wstring> descriptions;
+    std::vector<DWORD> processIds;
+    for (const auto& jvm : jvms) {
+        processIds.push_back(jvm.processId);
+        descriptions.push_back(StringToWString(jvm.mainClass) + L" (up " + std::to_wstring(jvm.uptimeMillis / 1000) + L"s)");
+    }
+    
+    // 以-XX:-UsePerfData启动的JVM没有性能数据
+    if (processIds.empty()) {
+        processIds = injector.FindProcessByName(L"javaw.exe");
+        descriptions.assign(processIds.size(), L"javaw.exe");
+    }
+    
+    if (processIds.empty()) {
+        LOG_ERROR(L"No JVM processes found. Please start a Java application first.");
+        return 0;
+    }
+    
+    // 如果找到多个进程，让用户选择
+    if (processIds.size() == 1) {
+        LOG_INFO(L"Found single JVM process: " << processIds[0] << L" " << descriptions[0]);
+        return processIds[0];
+    }
+    
+    std::wcout << L"Multiple JVM processes found:" << std::endl;
+    for (size_t i = 0; i < processIds.size(); ++i) {
+        std::wcout << L"  " << i + 1 << L". PID: " << processIds[i] << L"  " << descriptions[i] << std::endl;
+    }
+    std::wcout << L"Select process (1-" << processIds.size() << L"): ";
+    
+    int selection;
+    std::wcin >> selection;
+    
+    if (selection < 1 || selection > static_cast<int>(processIds.size())) {
+        LOG_ERROR(L"Invalid selection");
+        return 0;
+    }
+    
+    return processIds[selection - 1];
 }
 
 int wmain(int argc, wchar_t* argv[]) {
@@ -20,6 +217,46 @@ int wmain(int argc, wchar_t* argv[]) {
         return 1;
     }
 
+    if (wcscmp(argv[1], L"--list-classes") == 0) {
+        if (argc < 3) {
+            PrintUsage();
+            return 1;
+        }
+        return ListClasses(argv[2]);
+    }
+    
+    if (wcscmp(argv[1], L"--jar-digest") == 0) {
+        if (argc < 3) {
+            PrintUsage();
+            return 1;
+        }
+        return PrintJarDigest(argv[2]);
+    }
+    
+    if (wcscmp(argv[1], L"--list-jvms") == 0) {
+        return ListJvms();
+    }
+    
+    if (wcscmp(argv[1], L"--control") == 0) {
+        if (argc < 4) {
+            PrintUsage();
+            return 1;
+        }
+        return SendControlCommand(argc - 2, argv + 2);
+    }
+    
+    // --target <main_class>位于其余参数之前
+    std::wstring targetMainClass;
+    if (wcscmp(argv[1], L"--target") == 0) {
+        if (argc < 4) {
+            PrintUsage();
+            return 1;
+        }
+        targetMainClass = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+    
     // 解析命令行参数
     std::wstring jarPath = argv[1];
     std::wstring className = argc > 2 ? argv[2] : L"Main";
@@ -32,6 +269,22 @@ int wmain(int argc, wchar_t* argv[]) {
         return 1;
     }
 
+    // 注入前确认JAR结构有效且包含目标类
+    {
+        JarArchive archive;
+        if (archive.Open(jarPath) != ErrorCode::SUCCESS) {
+            LOG_ERROR(L"Invalid JAR file: " << jarPath << L" (" << archive.GetLastErrorMessage() << L")");
+            return 1;
+        }
+        
+        ClassIndex index;
+        index.Build(archive);
+        if (!index.ContainsClass(WStringToString(className))) {
+            LOG_ERROR(L"Class not found in JAR: " << className);
+            return 1;
+        }
+    }
+    
     // 获取当前目录下的DLL路径
     wchar_t currentDir[MAX_PATH];
     GetCurrentDirectoryW(MAX_PATH, currentDir);
@@ -42,6 +295,13 @@ int wmain(int argc, wchar_t* argv[]) {
         return 1;
     }
 
+    // DLL同目录下的security.policy可追加禁止路径与关键进程规则
+    std::wstring policyPath = std::wstring(currentDir) + L"\\security.policy";
+    if (FileExists(policyPath) && SecurityUtils::LoadSecurityPolicy(policyPath) != ErrorCode::SUCCESS) {
+        LOG_ERROR(L"Invalid security policy: " << policyPath);
+        return 1;
+    }
+    
     // 创建注入数据
     InjectionData injectionData = {};
     wcscpy_s(injectionData.jarPath, jarPath.c_str());
@@ -52,36 +312,12 @@ int wmain(int argc, wchar_t* argv[]) {
     // 创建DLL注入器
     DllInjector injector;
 
-    // 查找javaw.exe进程
-    std::vector<DWORD> processIds = injector.FindProcessByName(L"javaw.exe");
-    if (processIds.empty()) {
-        LOG_ERROR(L"No javaw.exe processes found. Please start a Java application first.");
+    // 查找目标JVM
+    DWORD targetProcessId = SelectTargetProcess(injector, targetMainClass);
+    if (targetProcessId == 0) {
         return 1;
     }
 
-    // 如果找到多个进程，让用户选择
-    DWORD targetProcessId;
-    if (processIds.size() == 1) {
-        targetProcessId = processIds[0];
-        LOG_INFO(L"Found single javaw.exe process: " << targetProcessId);
-    } else {
-        std::wcout << L"Multiple javaw.exe processes found:" << std::endl;
-        for (size_t i = 0; i < processIds.size(); ++i) {
-            std::wcout << L"  " << i + 1 << L". PID: " << processIds[i] << std::endl;
-        }
-        std::wcout << L"Select process (1-" << processIds.size() << L"): ";
-        
-        int selection;
-        std::wcin >> selection;
-        
-        if (selection < 1 || selection > static_cast<int>(processIds.size())) {
-            LOG_ERROR(L"Invalid selection");
-            return 1;
-        }
-        
-        targetProcessId = processIds[selection - 1];
-    }
-
     // 执行注入
     LOG_INFO(L"Injecting JAR: " << jarPath);
     LOG_INFO(L"Target Class: " << className);
@@ -0,0 +1,81 @@
+package dllinject;
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Method;
+import java.lang.reflect.Modifier;
+
+/**
+ * 持有一个适配为固定签名 (Object[])void 的MethodHandle，供本地代码重复调用
+ * 本地代码按代缓存调用器并通过invoke进入Java，之后的分派由invokeExact完成，
+ * 不再经过JNI的方法查找、参数检查与实例创建。JNI不能直接调用签名多态的invokeExact，
+ * 因此需要这个Java端的中转。该类被编译后嵌入注入DLL，由本地代码通过DefineClass定义。
+ */
+public final class HandleInvoker {
+
+    private static final MethodType INVOKER_TYPE = MethodType.methodType(void.class, Object[].class);
+    
+    private final MethodHandle target;
+    
+    private HandleInvoker(MethodHandle target) {
+        this.target = target;
+    }
+    
+    /**
+     * 为方法创建调用器，签名规则与本地的JNI路径一致：main接受String[]，其他方法无参数
+     *
+     * @param owner      方法所在的类
+     * @param name       方法名
+     * @param stringArgs 方法是否接受String[]参数
+     * @param receiver   实例方法绑定的实例；为null时每次调用用无参构造器创建新实例，静态方法忽略
+     */
+    public static HandleInvoker create(Class<?> owner, String name, boolean stringArgs, Object receiver)
+            throws ReflectiveOperationException {
+        Class<?>[] parameters = stringArgs ? new Class<?>[] { String[].class } : new Class<?>[0];
+        Method method = findMethod(owner, name, parameters);
+        method.setAccessible(true);
+        MethodHandles.Lookup lookup = MethodHandles.lookup();
+        MethodHandle handle = lookup.unreflect(method);
+        
+        if (!Modifier.isStatic(method.getModifiers())) {
+            if (receiver != null) {
+                handle = handle.bindTo(receiver);
+            } else {
+                // 构造器的结果作为接收者插入：(Object[])void 每次调用创建一个实例
+                Constructor<?> constructor = owner.getDeclaredConstructor();
+                constructor.setAccessible(true);
+                MethodHandle factory = lookup.unreflectConstructor(constructor)
+                        .asType(MethodType.methodType(method.getDeclaringClass()));
+                MethodHandle withArray = stringArgs ? handle : MethodHandles.dropArguments(handle, 1, Object[].class);
+                return new HandleInvoker(MethodHandles.foldArguments(withArray, factory).asType(INVOKER_TYPE));
+            }
+        }
+        
+        // String[]参数由asType转换为对Object[]的强制类型转换，无参方法丢弃数组参数
+        if (!stringArgs) {
+            handle = MethodHandles.dropArguments(handle, 0, Object[].class);
+        }
+        return new HandleInvoker(handle.asType(INVOKER_TYPE));
+    }
+    
+    /**
+     * 调用目标方法，args为main方法的String[]参数，无参方法传null
+     */
+    public void invoke(Object[] args) throws Throwable {
+        target.invokeExact(args);
+    }
+    
+    // 与JNI的GetMethodID一致：沿父类查找，包括非public方法
+    private static Method findMethod(Class<?> owner, String name, Class<?>[] parameters) throws NoSuchMethodException {
+        for (Class<?> type = owner; type != null; type = type.getSuperclass()) {
+            try {
+                return type.getDeclaredMethod(name, parameters);
+            } catch (NoSuchMethodException e) {
+                // 继续查找父类
+            }
+        }
+        throw new NoSuchMethodException(owner.getName() + "." + name);
+    }
+}
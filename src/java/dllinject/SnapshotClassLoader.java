@@ -0,0 +1,172 @@
+package dllinject;
+
+import java.io.ByteArrayInputStream;
+import java.io.Closeable;
+import java.io.InputStream;
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.util.concurrent.locks.ReentrantReadWriteLock;
+import java.util.zip.DataFormatException;
+import java.util.zip.Inflater;
+
+/**
+ * 从本地JAR快照加载类的类加载器
+ * 类字节由本地代码从不可变的内存快照中直接提供，不打开JAR文件、不持有文件句柄。
+ * 该类被编译后嵌入注入DLL，由本地代码通过DefineClass定义并注册native方法。
+ */
+public final class SnapshotClassLoader extends ClassLoader implements Closeable {
+
+    private static final int METHOD_STORED = 0;
+    private static final int METHOD_DEFLATED = 8;
+    private static final long MAX_ENTRY_SIZE = 64L * 1024 * 1024;
+    private static final Cleaner CLEANER = Cleaner.create();
+    
+    static {
+        registerAsParallelCapable();
+    }
+    
+    private final long handle;
+    private final String source;
+    private final ReentrantReadWriteLock lock = new ReentrantReadWriteLock();
+    private final Cleaner.Cleanable cleanable;
+    private boolean closed;
+    
+    /**
+     * @param handle 本地快照句柄
+     * @param source 快照来源（JAR路径），仅用于诊断
+     * @param parent 父加载器
+     */
+    public SnapshotClassLoader(long handle, String source, ClassLoader parent) {
+        super("snapshot:" + source, parent);
+        this.handle = handle;
+        this.source = source;
+        
+        // 加载器不可达时释放本地快照；清理动作不能引用加载器本身
+        // （使用lambda而不是嵌套类，保证编译结果只有一个class文件便于嵌入）
+        this.cleanable = CLEANER.register(this, () -> release(handle));
+    }
+    
+    @Override
+    protected Class<?> findClass(String name) throws ClassNotFoundException {
+        String entryName = name.replace('.', '/').concat(".class");
+        
+        lock.readLock().lock();
+        try {
+            if (closed) {
+                throw new ClassNotFoundException(name + " (loader closed: " + source + ")");
+            }
+            
+            long[] info = new long[2];
+            ByteBuffer data = findEntry(handle, entryName, info);
+            if (data == null) {
+                throw new ClassNotFoundException(name);
+            }
+            
+            // STORED条目直接从快照内存定义，不产生拷贝
+            if (info[0] == METHOD_STORED) {
+                return defineClass(name, data, null);
+            }
+            byte[] bytes = inflate(name, data, info);
+            return defineClass(name, bytes, 0, bytes.length);
+        } finally {
+            lock.readLock().unlock();
+        }
+    }
+    
+    @Override
+    public InputStream getResourceAsStream(String name) {
+        InputStream parentStream = getParent() != null ? getParent().getResourceAsStream(name) : null;
+        if (parentStream != null) {
+            return parentStream;
+        }
+        
+        lock.readLock().lock();
+        try {
+            if (closed) {
+                return null;
+            }
+            
+            long[] info = new long[2];
+            ByteBuffer data = findEntry(handle, name, info);
+            if (data == null) {
+                return null;
+            }
+            
+            byte[] bytes;
+            if (info[0] == METHOD_STORED) {
+                bytes = new byte[data.remaining()];
+                data.get(bytes);
+            } else {
+                bytes = inflate(name, data, info);
+            }
+            return new ByteArrayInputStream(bytes);
+        } catch (ClassFormatError e) {
+            return null;
+        } finally {
+            lock.readLock().unlock();
+        }
+    }
+    
+    /**
+     * 立即释放本地快照，之后无法再加载新的类
+     * 会等待正在进行的类加载结束
+     */
+    @Override
+    public void close() {
+        lock.writeLock().lock();
+        try {
+            if (!closed) {
+                closed = true;
+                cleanable.clean();
+            }
+        } finally {
+            lock.writeLock().unlock();
+        }
+    }
+    
+    public String getSource() {
+        return source;
+    }
+    
+    private static byte[] inflate(String name, ByteBuffer data, long[] info) {
+        if (info[0] != METHOD_DEFLATED || info[1] < 0 || info[1] > MAX_ENTRY_SIZE) {
+            throw new ClassFormatError("Unsupported JAR entry: " + name);
+        }
+        
+        byte[] bytes = new byte[(int) info[1]];
+        Inflater inflater = new Inflater(true);
+        try {
+            inflater.setInput(data);
+            int offset = 0;
+            while (offset < bytes.length) {
+                int count = inflater.inflate(bytes, offset, bytes.length - offset);
+                if (count == 0 && (inflater.finished() || inflater.needsInput() || inflater.needsDictionary())) {
+                    break;
+                }
+                offset += count;
+            }
+            if (offset != bytes.length) {
+                throw new ClassFormatError("Truncated JAR entry: " + name);
+            }
+            return bytes;
+        } catch (DataFormatException e) {
+            throw new ClassFormatError("Corrupted JAR entry: " + name);
+        } finally {
+            inflater.end();
+        }
+    }
+    
+    /**
+     * 查找快照中的条目
+     * @param handle 快照句柄
+     * @param entryName 条目名（斜杠形式）
+     * @param info 输出：[0]压缩方法，[1]解压后大小
+     * @return 指向快照内存的DirectByteBuffer（内存只读，不可写入），未找到时返回null
+     */
+    private static native ByteBuffer findEntry(long handle, String entryName, long[] info);
+    
+    /**
+     * 释放快照
+     */
+    private static native void release(long handle);
+}
@@ -0,0 +1,101 @@
+// 并行类预加载基准：每种线程数各用新的类加载器加载JAR中的全部类，报告每秒加载的类数量
+//
+//   class_preload_bench <jar_path> [--threads=1,2,4,8] [--rounds=3] [--snapshot]
+// 每轮都创建新的类加载器，因此每次都是真实的加载、验证与链接，不包含静态初始化。
+// 每种线程数取最快的一轮，加速比相对于第一种线程数计算。
+#include "../../src/include/jar_loader.h"
+#include "../../src/include/common.h"
+#include "bench_main.h"
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::vector<size_t> ParseThreadCounts(const std::wstring& value) {
+    std::vector<size_t> counts;
+    std::wstringstream stream(value);
+    std::wstring item;
+    while (std::getline(stream, item, L',')) {
+        size_t count = static_cast<size_t>(std::wcstoul(item.c_str(), nullptr, 10));
+        if (count > 0) {
+            counts.push_back(count);
+        }
+    }
+    return counts;
+}
+
+} // namespace
+
+int BenchMain(const std::vector<std::wstring>& args) {
+    if (args.size() < 2) {
+        std::cout << "Usage: class_preload_bench <jar_path> [--threads=1,2,4,8] [--rounds=3] [--snapshot]" << std::endl;
+        return 1;
+    }
+    
+    Logger::GetInstance().SetLogLevel(LogLevel::WARNING);
+    
+    std::wstring jarPath = args[1];
+    std::vector<size_t> threadCounts = {1, 2, 4, 8};
+    int rounds = 3;
+    bool snapshot = false;
+    for (size_t i = 2; i < args.size(); ++i) {
+        const std::wstring& arg = args[i];
+        if (arg.rfind(L"--threads=", 0) == 0) {
+            threadCounts = ParseThreadCounts(arg.substr(10));
+        } else if (arg.rfind(L"--rounds=", 0) == 0) {
+            rounds = std::max(1, static_cast<int>(std::wcstol(arg.substr(9).c_str(), nullptr, 10)));
+        } else if (arg == L"--snapshot") {
+            snapshot = true;
+        }
+    }
+    if (threadCounts.empty()) {
+        std::cout << "No valid thread counts" << std::endl;
+        return 1;
+    }
+    
+    JarLoader loader;
+    if (loader.InitializeJVM() != ErrorCode::SUCCESS) {
+        std::cout << "Failed to initialize JVM" << std::endl;
+        return 1;
+    }
+    loader.SetClassLoaderMode(snapshot ? ClassLoaderMode::SNAPSHOT : ClassLoaderMode::URL);
+    
+    WarmUpOptions options;
+    options.initializeClasses = false;
+    options.replayInvocations = false;
+    
+    double baselineMs = 0;
+    for (size_t threads : threadCounts) {
+        options.preloadThreads = threads;
+        double bestMs = 0;
+        WarmUpResult best;
+        for (int round = 0; round < rounds; ++round) {
+            if (loader.PrepareJar(jarPath) != ErrorCode::SUCCESS) {
+                std::cout << "Failed to prepare JAR: " << WStringToString(jarPath) << std::endl;
+                return 1;
+            }
+            WarmUpResult result;
+            if (loader.WarmUpPreparedJar(options, result) != ErrorCode::SUCCESS) {
+                std::cout << "Warm-up failed" << std::endl;
+                return 1;
+            }
+            loader.DiscardPreparedJar();
+            if (round == 0 || result.preloadMs < bestMs) {
+                bestMs = result.preloadMs;
+                best = result;
+            }
+        }
+        if (baselineMs == 0) {
+            baselineMs = bestMs;
+        }
+        
+        double classesPerSecond = bestMs > 0 ? best.classesLoaded * 1000.0 / bestMs : 0;
+        std::cout << "threads=" << best.preloadThreads
+                  << " classes=" << best.classesLoaded
+                  << " failed=" << best.classesFailed
+                  << " best_ms=" << bestMs
+                  << " classes_per_sec=" << static_cast<uint64_t>(classesPerSecond)
+                  << " speedup=" << (bestMs > 0 ? baselineMs / bestMs : 0) << std::endl;
+    }
+    return 0;
+}
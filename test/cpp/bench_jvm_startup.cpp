@@ -0,0 +1,86 @@
+// 嵌入式JVM冷启动基准：测量从InitializeJVM到首次CallJavaMethod完成的耗时
+//
+// 每个进程只能创建一次JVM，因此每种配置需要单独运行一次：
+//   jvm_startup_bench <jar_path> [class_name] [method_name] [--cds=off|auto|dump|use] [--archive=<path>]
+// 典型流程：
+//   1. --cds=off                    基线
+//   2. --cds=dump --archive=app.jsa 生成归档（本次耗时不具参考价值）
+//   3. --cds=use  --archive=app.jsa 使用归档
+#include "../../src/include/jar_loader.h"
+#include "../../src/include/common.h"
+#include "bench_main.h"
+#include <iostream>
+
+namespace {
+
+bool ParseCdsMode(const std::wstring& value, CdsMode& mode) {
+    if (value == L"off") { mode = CdsMode::DISABLED; return true; }
+    if (value == L"auto") { mode = CdsMode::AUTO; return true; }
+    if (value == L"dump") { mode = CdsMode::DUMP; return true; }
+    if (value == L"use") { mode = CdsMode::USE; return true; }
+    return false;
+}
+
+} // namespace
+
+int BenchMain(const std::vector<std::wstring>& args) {
+    if (args.size() < 2) {
+        std::cout << "Usage: jvm_startup_bench <jar_path> [class_name] [method_name] "
+                  << "[--cds=off|auto|dump|use] [--archive=<path>]" << std::endl;
+        return 1;
+    }
+    
+    Logger::GetInstance().SetLogLevel(LogLevel::WARNING);
+    
+    std::wstring jarPath = args[1];
+    std::wstring className = L"Main";
+    std::wstring methodName = L"main";
+    JvmStartupOptions options;
+    // 基准测量包含插件类在内的归档效果，显式允许JAR在类路径上（不能热重载）
+    options.classPath = jarPath;
+    options.allowPluginOnClassPath = true;
+    
+    int positional = 0;
+    for (size_t i = 2; i < args.size(); ++i) {
+        const std::wstring& arg = args[i];
+        if (arg.rfind(L"--cds=", 0) == 0) {
+            if (!ParseCdsMode(arg.substr(6), options.cdsMode)) {
+                std::cout << "Unknown CDS mode: " << WStringToString(arg) << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind(L"--archive=", 0) == 0) {
+            options.cdsArchivePath = arg.substr(10);
+        } else if (positional == 0) {
+            className = arg;
+            ++positional;
+        } else {
+            methodName = arg;
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    JarLoader loader;
+    loader.SetJvmStartupOptions(options);
+    
+    if (loader.InitializeJVM() != ErrorCode::SUCCESS) {
+        std::cout << "Failed to initialize JVM" << std::endl;
+        return 1;
+    }
+    double initMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    if (loader.LoadJar(jarPath) != ErrorCode::SUCCESS) {
+        std::cout << "Failed to load JAR: " << WStringToString(jarPath) << std::endl;
+        return 1;
+    }
+    
+    if (loader.CallJavaMethod(WStringToString(className), WStringToString(methodName)) != ErrorCode::SUCCESS) {
+        std::cout << "Failed to call " << WStringToString(className) << "." << WStringToString(methodName) << std::endl;
+        return 1;
+    }
+    
+    std::cout << "cds_mode=" << static_cast<int>(options.cdsMode)
+              << " jvm_init_ms=" << initMs
+              << " time_to_first_call_ms=" << loader.GetTimeToFirstCallMs() << std::endl;
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../../src/include/common.h"
+#include <string>
+#include <vector>
+
+// 基准程序的入口：参数统一转换为宽字符串后调用BenchMain
+//
+// Windows上由wmain直接传入，其他平台的main参数按UTF-8转换。
+// 基准的输出与日志一样使用窄字符（UTF-8）：glibc的stdout不能混用窄字符与宽字符输出。
+// 每个基准程序只包含一次。
+int BenchMain(const std::vector<std::wstring>& args);
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t* argv[]) {
+    return BenchMain(std::vector<std::wstring>(argv, argv + argc));
+}
+#else
+int main(int argc, char* argv[]) {
+    std::vector<std::wstring> args;
+    for (int i = 0; i < argc; ++i) {
+        args.push_back(StringToWString(argv[i]));
+    }
+    return BenchMain(args);
+}
+#endif
@@ -0,0 +1,95 @@
+// Java方法调用路径基准：比较JNI路径与缓存的MethodHandle路径每秒的调用次数
+//
+//   method_invoke_bench <jar_path> <class_name> <method_name> [--calls=100000] [--rounds=5]
+// 目标方法应是无副作用的轻量方法（例如空的静态或实例方法）。两条路径先各预热一轮，
+// 让JIT编译调用链，之后每轮连续调用calls次，取最快的一轮。
+#include "../../src/include/jar_loader.h"
+#include "../../src/include/common.h"
+#include "bench_main.h"
+#include <iostream>
+
+namespace {
+
+// 连续调用并返回耗时（毫秒），失败返回负数
+double RunCalls(JarLoader& loader, const std::string& className, const std::string& methodName, int calls) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        if (loader.CallJavaMethod(className, methodName) != ErrorCode::SUCCESS) {
+            return -1;
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int BenchMain(const std::vector<std::wstring>& args) {
+    if (args.size() < 4) {
+        std::cout << "Usage: method_invoke_bench <jar_path> <class_name> <method_name> [--calls=100000] [--rounds=5]" << std::endl;
+        return 1;
+    }
+    
+    // 成功调用在INFO级别记录日志，基准只测量调用本身
+    Logger::GetInstance().SetLogLevel(LogLevel::WARNING);
+    
+    std::wstring jarPath = args[1];
+    std::string className = WStringToString(args[2]);
+    std::string methodName = WStringToString(args[3]);
+    int calls = 100000;
+    int rounds = 5;
+    for (size_t i = 4; i < args.size(); ++i) {
+        const std::wstring& arg = args[i];
+        if (arg.rfind(L"--calls=", 0) == 0) {
+            calls = std::max(1, static_cast<int>(std::wcstol(arg.substr(8).c_str(), nullptr, 10)));
+        } else if (arg.rfind(L"--rounds=", 0) == 0) {
+            rounds = std::max(1, static_cast<int>(std::wcstol(arg.substr(9).c_str(), nullptr, 10)));
+        }
+    }
+    
+    JarLoader loader;
+    if (loader.InitializeJVM() != ErrorCode::SUCCESS) {
+        std::cout << "Failed to initialize JVM" << std::endl;
+        return 1;
+    }
+    if (loader.LoadJar(jarPath) != ErrorCode::SUCCESS) {
+        std::cout << "Failed to load JAR: " << WStringToString(jarPath) << std::endl;
+        return 1;
+    }
+    
+    double baselinePerSecond = 0;
+    for (InvocationPath path : {InvocationPath::JNI, InvocationPath::METHOD_HANDLE}) {
+        loader.SetInvocationPath(path);
+        const char* pathName = path == InvocationPath::JNI ? "jni" : "method_handle";
+        
+        if (RunCalls(loader, className, methodName, calls) < 0) {
+            std::cout << "Call failed on " << pathName << " path, error " << static_cast<int>(loader.GetLastError()) << std::endl;
+            return 1;
+        }
+        
+        double bestMs = 0;
+        for (int round = 0; round < rounds; ++round) {
+            double ms = RunCalls(loader, className, methodName, calls);
+            if (ms < 0) {
+                std::cout << "Call failed on " << pathName << " path" << std::endl;
+                return 1;
+            }
+            if (round == 0 || ms < bestMs) {
+                bestMs = ms;
+            }
+        }
+        
+        double callsPerSecond = bestMs > 0 ? calls * 1000.0 / bestMs : 0;
+        if (baselinePerSecond == 0) {
+            baselinePerSecond = callsPerSecond;
+        }
+        std::cout << "path=" << pathName
+                  << " calls=" << calls
+                  << " best_ms=" << bestMs
+                  << " calls_per_sec=" << static_cast<uint64_t>(callsPerSecond)
+                  << " ns_per_call=" << (bestMs * 1e6 / calls)
+                  << " speedup=" << (baselinePerSecond > 0 ? callsPerSecond / baselinePerSecond : 0) << std::endl;
+    }
+    
+    loader.UnloadJar();
+    return 0;
+}
@@ -0,0 +1,82 @@
+// 类名/方法名校验基准：每次调用构造std::regex（原实现）、预编译std::regex与表驱动扫描；
+// 危险字符检查：find_first_of与字符类位图向量化扫描
+#include <benchmark/benchmark.h>
+#include "../../src/include/java_name_validator.h"
+#include "../../src/include/char_class_scanner.h"
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const CLASS_NAME_PATTERN = R"(^[a-zA-Z_$][a-zA-Z0-9_$]*(\.[a-zA-Z_$][a-zA-Z0-9_$]*)*$)";
+const char* const DANGEROUS_CHARS = ";<>|&$`\"'\\*?[]{}()";
+
+const std::vector<std::string>& SampleNames() {
+    static const std::vector<std::string> names = {
+        "Main",
+        "com.example.Main",
+        "org.springframework.boot.autoconfigure.SpringBootApplication",
+        "com.example.service.impl.UserAccountServiceImplementation",
+        "com..Invalid",
+        "bad name"
+    };
+    return names;
+}
+
+bool ValidateWithRegex(const std::string& name, const std::regex& pattern) {
+    if (name.empty() || name.length() > MAX_CLASS_NAME_LENGTH || name.find_first_of(DANGEROUS_CHARS) != std::string::npos) {
+        return false;
+    }
+    return std::regex_match(name, pattern);
+}
+
+void BM_RegexPerCall(benchmark::State& state) {
+    const auto& names = SampleNames();
+    size_t index = 0;
+    for (auto _ : state) {
+        std::regex pattern(CLASS_NAME_PATTERN);
+        benchmark::DoNotOptimize(ValidateWithRegex(names[index++ % names.size()], pattern));
+    }
+}
+BENCHMARK(BM_RegexPerCall);
+
+void BM_RegexPrecompiled(benchmark::State& state) {
+    const auto& names = SampleNames();
+    const std::regex pattern(CLASS_NAME_PATTERN);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ValidateWithRegex(names[index++ % names.size()], pattern));
+    }
+}
+BENCHMARK(BM_RegexPrecompiled);
+
+void BM_TableDriven(benchmark::State& state) {
+    const auto& names = SampleNames();
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JavaNameValidator::CheckClassName(names[index++ % names.size()]));
+    }
+}
+BENCHMARK(BM_TableDriven);
+
+void BM_DangerousFindFirstOf(benchmark::State& state) {
+    const std::string text(static_cast<size_t>(state.range(0)), 'a');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(text.find_first_of(DANGEROUS_CHARS));
+    }
+}
+BENCHMARK(BM_DangerousFindFirstOf)->Arg(16)->Arg(64)->Arg(260);
+
+void BM_DangerousCharClassScanner(benchmark::State& state) {
+    const std::string text(static_cast<size_t>(state.range(0)), 'a');
+    const CharClassScanner scanner(DANGEROUS_CHARS);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scanner.FindFirstOf(text));
+    }
+}
+BENCHMARK(BM_DangerousCharClassScanner)->Arg(16)->Arg(64)->Arg(260);
+
+} // namespace
+
+BENCHMARK_MAIN();
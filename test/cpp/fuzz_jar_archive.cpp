@@ -0,0 +1,23 @@
+// JarArchive解析器的libFuzzer入口
+// 构建：cmake -DBUILD_FUZZERS=ON（需要clang，-fsanitize=fuzzer,address）
+#include "../../src/include/jar_archive.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    JarArchive archive;
+    if (archive.Parse(data, size) != ErrorCode::SUCCESS) {
+        return 0;
+    }
+    
+    // 解析成功时遍历所有条目并定位数据，确保不会越界
+    for (const auto& entry : archive) {
+        const uint8_t* entryData = nullptr;
+        uint64_t entrySize = 0;
+        if (archive.GetEntryData(entry, entryData, entrySize) && entrySize > 0) {
+            volatile uint8_t first = entryData[0];
+            volatile uint8_t last = entryData[entrySize - 1];
+            (void)first;
+            (void)last;
+        }
+    }
+    return 0;
+}
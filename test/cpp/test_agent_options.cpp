@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "../../src/include/agent_options.h"
+#include "../../src/include/common.h"
+
+TEST(AgentOptionsTest, Parse_AppliesDefaults) {
+    InjectionData data;
+    ASSERT_EQ(AgentOptions::Parse("jar=/opt/app/plugin.jar", data), ErrorCode::SUCCESS);
+    EXPECT_STREQ(data.jarPath, L"/opt/app/plugin.jar");
+    EXPECT_STREQ(data.className, L"Main");
+    EXPECT_STREQ(data.methodName, L"main");
+    EXPECT_TRUE(data.enableHotReload);
+}
+
+TEST(AgentOptionsTest, Parse_AllOptions) {
+    InjectionData data;
+    ASSERT_EQ(AgentOptions::Parse("class=com.example.Plugin,jar=C:\\plugins\\a b.jar,method=start,hotReload=FALSE", data),
+              ErrorCode::SUCCESS);
+    EXPECT_STREQ(data.jarPath, L"C:\\plugins\\a b.jar");
+    EXPECT_STREQ(data.className, L"com.example.Plugin");
+    EXPECT_STREQ(data.methodName, L"start");
+    EXPECT_FALSE(data.enableHotReload);
+    
+    ASSERT_EQ(AgentOptions::Parse("jar=plugin.jar,hotReload=true", data), ErrorCode::SUCCESS);
+    EXPECT_TRUE(data.enableHotReload);
+}
+
+TEST(AgentOptionsTest, Parse_RejectsInvalidOptions) {
+    InjectionData data;
+    ASSERT_EQ(AgentOptions::Parse("jar=original.jar", data), ErrorCode::SUCCESS);
+    
+    const char* invalidOptions[] = {
+        "",
+        "class=Main",                              // 缺少jar
+        "jar=plugin.jar,",                         // 空选项
+        "jar=plugin.jar,jar=other.jar",            // 重复键
+        "jar=plugin.jar,mode=fast",                // 未知键
+        "jar=",                                    // 空值
+        "=plugin.jar",
+        "jar=plugin.jar,hotReload=yes",
+        "jar=plugin.jar,class=com..Bad",
+        "jar=plugin.jar,class=Main;calc",
+        "jar=plugin.jar,method=1start",
+    };
+    for (const char* options : invalidOptions) {
+        EXPECT_EQ(AgentOptions::Parse(options, data), ErrorCode::INVALID_PARAMETER) << options;
+    }
+    
+    // 超出InjectionData缓冲区的值
+    EXPECT_EQ(AgentOptions::Parse("jar=" + std::string(MAX_PATH_LENGTH, 'a'), data), ErrorCode::INVALID_PARAMETER);
+    
+    // 失败时不修改输出
+    EXPECT_STREQ(data.jarPath, L"original.jar");
+}
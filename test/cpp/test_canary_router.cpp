@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "../../src/include/canary_router.h"
+#include <thread>
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndBounded) {
+    // 小于子桶数的值精确记录，之后每个桶的上界紧接下一个桶的下界
+    for (uint64_t value = 0; value < 8; ++value) {
+        EXPECT_EQ(LatencyHistogram::BucketIndex(value), value);
+    }
+    for (size_t index = 8; index < 200; ++index) {
+        uint64_t upper = LatencyHistogram::BucketUpperBound(index);
+        EXPECT_EQ(LatencyHistogram::BucketIndex(upper), index);
+        EXPECT_EQ(LatencyHistogram::BucketIndex(upper + 1), index + 1);
+    }
+    EXPECT_LT(LatencyHistogram::BucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.Percentile(0.99), 0u);
+    
+    for (uint64_t micros = 1; micros <= 1000; ++micros) {
+        histogram.Record(micros);
+    }
+    EXPECT_EQ(histogram.GetCount(), 1000u);
+    EXPECT_EQ(histogram.GetMax(), 1000u);
+    
+    uint64_t p50 = histogram.Percentile(0.5);
+    uint64_t p99 = histogram.Percentile(0.99);
+    EXPECT_GE(p50, 500u);
+    EXPECT_LE(p50, 500u + 500u / 8);
+    EXPECT_GE(p99, 990u);
+    EXPECT_LE(p99, 1000u);
+    EXPECT_EQ(histogram.Percentile(1.0), 1000u);
+    
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+}
+
+TEST(CanaryRouterTest, RoutesConfiguredFraction) {
+    CanaryOptions options;
+    options.fraction = 0.25;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    int canaryCalls = 0;
+    for (int i = 0; i < 100; ++i) {
+        canaryCalls += router.RouteToCanary() ? 1 : 0;
+    }
+    EXPECT_EQ(canaryCalls, 25);
+}
+
+TEST(CanaryRouterTest, PromotesWithinBudgetAtWindowEnd) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.windowMs = 60000;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    for (int i = 0; i < 20; ++i) {
+        router.Record(false, 1000, true);
+        router.Record(true, 1100, true);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::PENDING);
+    EXPECT_EQ(router.Evaluate(true), CanaryVerdict::PROMOTE);
+    
+    CanaryReport report = router.GetReport();
+    EXPECT_EQ(report.baseline.generation, 1u);
+    EXPECT_EQ(report.canary.generation, 2u);
+    EXPECT_EQ(report.canary.calls, 20u);
+    EXPECT_EQ(report.canary.errors, 0u);
+}
+
+TEST(CanaryRouterTest, RollsBackWithInsufficientSamplesAtWindowEnd) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    // 没有足够调用不能证明新的一代可用
+    for (int i = 0; i < 5; ++i) {
+        router.Record(true, 1000, true);
+    }
+    EXPECT_EQ(router.Evaluate(true), CanaryVerdict::ROLLBACK);
+    EXPECT_NE(router.GetReport().reason.find("insufficient"), std::string::npos);
+}
+
+TEST(CanaryRouterTest, ExtendsWindowUntilEnoughSamples) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.windowMs = 1;
+    options.maxWindowExtensions = 100000;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    for (int i = 0; i < 5; ++i) {
+        router.Record(false, 1000, true);
+        router.Record(true, 1000, true);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::PENDING);
+    
+    for (int i = 0; i < 5; ++i) {
+        router.Record(false, 1000, true);
+        router.Record(true, 1000, true);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::PROMOTE);
+}
+
+TEST(CanaryRouterTest, RollsBackWhenExtensionsRunOut) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.windowMs = 1;
+    options.maxWindowExtensions = 1;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    // 没有流量时延长的窗口到期后回滚，不会一直停留在灰度
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::ROLLBACK);
+}
+
+TEST(CanaryRouterTest, SupersededWithoutVerdictIsNotRollback) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    CanaryRouter router;
+    EXPECT_EQ(router.Supersede(), CanaryVerdict::PENDING);
+    router.Start(options, 1, 2);
+    
+    // 样本不足时被取代不能说明新的一代不可用
+    for (int i = 0; i < 5; ++i) {
+        router.Record(true, 1000, true);
+    }
+    EXPECT_EQ(router.Supersede(), CanaryVerdict::SUPERSEDED);
+    EXPECT_NE(router.GetReport().reason.find("superseded"), std::string::npos);
+    
+    // 已超出预算的灰度被取代时仍报告回滚
+    router.Start(options, 2, 3);
+    for (int i = 0; i < 10; ++i) {
+        router.Record(false, 1000, true);
+        router.Record(true, 1000, false);
+    }
+    EXPECT_EQ(router.Supersede(), CanaryVerdict::ROLLBACK);
+}
+
+TEST(CanaryRouterTest, RollsBackSlowCanaryBeforeWindowEnds) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.maxLatencyRatio = 1.5;
+    options.latencySlackUs = 200;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    for (int i = 0; i < 10; ++i) {
+        router.Record(false, 1000, true);
+        router.Record(true, 3000, true);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::ROLLBACK);
+    EXPECT_NE(router.GetReport().reason.find("p99"), std::string::npos);
+}
+
+TEST(CanaryRouterTest, RollsBackOnErrorBudget) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.maxErrorRateDelta = 0.05;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    // 旧的一代样本不足时仍检查错误率
+    router.Record(false, 1000, true);
+    for (int i = 0; i < 10; ++i) {
+        router.Record(true, 1000, i != 0);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::ROLLBACK);
+    EXPECT_NE(router.GetReport().reason.find("error rate"), std::string::npos);
+}
+
+TEST(CanaryRouterTest, SlackAbsorbsSubMillisecondJitter) {
+    CanaryOptions options;
+    options.minCalls = 10;
+    options.maxLatencyRatio = 1.5;
+    options.latencySlackUs = 200;
+    CanaryRouter router;
+    router.Start(options, 1, 2);
+    
+    for (int i = 0; i < 10; ++i) {
+        router.Record(false, 20, true);
+        router.Record(true, 100, true);
+    }
+    EXPECT_EQ(router.Evaluate(false), CanaryVerdict::PENDING);
+}
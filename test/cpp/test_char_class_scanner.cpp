@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "../../src/include/char_class_scanner.h"
+#include "../../src/include/security_utils.h"
+#include "../../src/include/common.h"
+#include <random>
+
+class CharClassScannerTest : public ::testing::Test {
+protected:
+    CharClassScannerTest() : dangerous_(JAVA_NAME_DANGEROUS_CHARS) {}
+    
+    // 覆盖向量宽度的各种长度，目标字符出现在块首、块尾与跨块位置
+    template<typename CharT>
+    void ExpectMatchesReference(const std::basic_string<CharT>& alphabet) {
+        const std::basic_string<CharT> members(JAVA_NAME_DANGEROUS_CHARS, JAVA_NAME_DANGEROUS_CHARS + sizeof(JAVA_NAME_DANGEROUS_CHARS) - 1);
+        std::mt19937 random(7);
+        std::uniform_int_distribution<size_t> charDistribution(0, alphabet.size() - 1);
+        
+        for (size_t length = 0; length <= 100; ++length) {
+            for (int round = 0; round < 50; ++round) {
+                std::basic_string<CharT> text(length, CharT('a'));
+                for (auto& c : text) {
+                    c = alphabet[charDistribution(random)];
+                }
+                std::basic_string_view<CharT> view(text);
+                ASSERT_EQ(dangerous_.FindFirstOf(view), ToScannerPos(text.find_first_of(members)));
+                ASSERT_EQ(dangerous_.FindFirstNotOf(view), ToScannerPos(text.find_first_not_of(members)));
+            }
+        }
+    }
+    
+    static size_t ToScannerPos(size_t pos) {
+        return pos == std::string::npos ? CharClassScanner::npos : pos;
+    }
+    
+    CharClassScanner dangerous_;
+};
+
+TEST_F(CharClassScannerTest, Membership) {
+    EXPECT_TRUE(dangerous_.IsMember(';'));
+    EXPECT_TRUE(dangerous_.IsMember('$'));
+    EXPECT_TRUE(dangerous_.IsMember('\\'));
+    EXPECT_FALSE(dangerous_.IsMember('a'));
+    EXPECT_FALSE(dangerous_.IsMember('.'));
+    EXPECT_FALSE(dangerous_.IsMember(0));
+    EXPECT_FALSE(dangerous_.IsMember(0x13B));
+    
+    // 非ASCII与'\0'不能成为成员
+    CharClassScanner scanner(std::string_view("a\0\x80\xFF", 4));
+    EXPECT_TRUE(scanner.IsMember('a'));
+    EXPECT_FALSE(scanner.IsMember(0));
+    EXPECT_FALSE(scanner.IsMember(0x80));
+    EXPECT_FALSE(scanner.IsMember(0xFF));
+}
+
+TEST_F(CharClassScannerTest, NarrowMatchesFindFirstOf) {
+    // 含非ASCII字节，其低4位与危险字符相同
+    ExpectMatchesReference(std::string("abcXYZ019_.;$(\xBB\xA4\x80\xFF") + '\0');
+    ExpectMatchesReference(std::string("abcdefgh;"));
+    ExpectMatchesReference(std::string(";<>|&$`\"'\\*?[]{}()x"));
+}
+
+TEST_F(CharClassScannerTest, WideMatchesFindFirstOf) {
+    // 高字节非零的字符饱和压缩后不能被误判为ASCII危险字符
+    std::wstring alphabet = L"abcXYZ019_.;$(";
+    alphabet += static_cast<wchar_t>(0x013B);
+    alphabet += static_cast<wchar_t>(0x7F24);
+    alphabet += static_cast<wchar_t>(0x803B);
+    alphabet += static_cast<wchar_t>(0xFF28);
+    alphabet += static_cast<wchar_t>(0x00BB);
+    alphabet += L'\0';
+    ExpectMatchesReference(alphabet);
+    ExpectMatchesReference(std::wstring(L"abcdefgh;"));
+}
+
+TEST_F(CharClassScannerTest, LongInputs) {
+    std::string text(4096, 'a');
+    EXPECT_EQ(dangerous_.FindFirstOf(text), CharClassScanner::npos);
+    text[4095] = '|';
+    EXPECT_EQ(dangerous_.FindFirstOf(text), 4095u);
+    text[33] = '(';
+    EXPECT_EQ(dangerous_.FindFirstOf(text), 33u);
+    EXPECT_EQ(dangerous_.FindFirstNotOf(text), 0u);
+    
+    std::wstring wide(4096, L'a');
+    wide[2049] = L'"';
+    EXPECT_EQ(dangerous_.FindFirstOf(wide), 2049u);
+    
+    EXPECT_NE(std::string(CharClassScanner::GetInstructionSet()), "");
+}
+
+TEST_F(CharClassScannerTest, SecurityUtils_ContainsDangerousChars) {
+    EXPECT_TRUE(SecurityUtils::ContainsDangerousChars(std::string("java.exe;calc")));
+    EXPECT_FALSE(SecurityUtils::ContainsDangerousChars(std::string("com.example.Main")));
+    EXPECT_TRUE(SecurityUtils::ContainsDangerousChars(std::wstring(L"notepad.exe & calc.exe")));
+    EXPECT_FALSE(SecurityUtils::ContainsDangerousChars(std::wstring(L"notepad.exe")));
+}
+
+TEST_F(CharClassScannerTest, SecurityUtils_FindInvalidClassNamesMatchesValidateClassName) {
+    std::vector<std::string> names = {
+        "Main", "com.example.Main", "com.example.Outer$Inner", "com..Main", ".Main", "Main.",
+        "com.1example.Main", "_Main", "com.example.Main;calc", "com.exa mple", "", "a.b.c.d.e",
+        std::string(MAX_CLASS_NAME_LENGTH, 'a'), std::string(MAX_CLASS_NAME_LENGTH + 1, 'a'),
+        "org.springframework.boot.autoconfigure.SpringBootApplication", "caf\xC3\xA9.Main"
+    };
+    
+    std::mt19937 random(11);
+    const std::string alphabet = "ab9_..$;";
+    std::uniform_int_distribution<size_t> lengthDistribution(1, 40);
+    std::uniform_int_distribution<size_t> charDistribution(0, alphabet.size() - 1);
+    for (int i = 0; i < 5000; ++i) {
+        std::string name(lengthDistribution(random), ' ');
+        for (auto& c : name) {
+            c = alphabet[charDistribution(random)];
+        }
+        names.push_back(name);
+    }
+    
+    std::vector<std::string_view> views(names.begin(), names.end());
+    std::vector<size_t> invalid = SecurityUtils::FindInvalidClassNames(views);
+    
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (JavaNameValidator::CheckClassName(names[i]) != JavaNameValidator::Result::VALID) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(invalid, expected);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../../src/include/class_index.h"
+#include "zip_test_utils.h"
+
+class ClassIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ZipBuilder builder;
+        builder.Add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n")
+               .Add("Main.class", "")
+               .Add("com/example/App.class", "")
+               .Add("com/example/App$Inner.class", "")
+               .Add("com/example/util/Strings.class", "")
+               .Add("com/example/package-info.class", "")
+               .Add("module-info.class", "")
+               .Add("META-INF/versions/11/com/example/App.class", "")
+               .Add("META-INF/versions/11/com/example/Java11Only.class", "")
+               .Add("com/example/resources/config.properties", "");
+        data_ = builder.Build();
+        ASSERT_EQ(archive_.Parse(data_.data(), data_.size()), ErrorCode::SUCCESS);
+        index_.Build(archive_);
+    }
+    
+    std::vector<uint8_t> data_;
+    JarArchive archive_;
+    ClassIndex index_;
+};
+
+TEST_F(ClassIndexTest, EmptyIndexIsNotBuilt) {
+    ClassIndex index;
+    EXPECT_FALSE(index.IsBuilt());
+    EXPECT_FALSE(index.ContainsClass("Main"));
+    EXPECT_FALSE(index.ContainsPackage(""));
+}
+
+TEST_F(ClassIndexTest, ContainsClass_DotAndSlashForms) {
+    EXPECT_TRUE(index_.IsBuilt());
+    EXPECT_TRUE(index_.ContainsClass("Main"));
+    EXPECT_TRUE(index_.ContainsClass("com.example.App"));
+    EXPECT_TRUE(index_.ContainsClass("com/example/App"));
+    EXPECT_TRUE(index_.ContainsClass("com.example.App$Inner"));
+    EXPECT_TRUE(index_.ContainsClass("com.example.util.Strings"));
+    
+    EXPECT_FALSE(index_.ContainsClass("com.example.Missing"));
+    EXPECT_FALSE(index_.ContainsClass("com.example"));
+    EXPECT_FALSE(index_.ContainsClass("MANIFEST"));
+}
+
+TEST_F(ClassIndexTest, MultiReleaseEntriesMapToBaseName) {
+    EXPECT_TRUE(index_.ContainsClass("com.example.Java11Only"));
+    
+    // 重复的多版本类只计一次
+    size_t appCount = 0;
+    index_.ForEachClass([&appCount](std::string_view name) {
+        if (name == "com.example.App") {
+            ++appCount;
+        }
+    });
+    EXPECT_EQ(appCount, 1u);
+    EXPECT_EQ(index_.GetClassCount(), 7u);
+}
+
+TEST_F(ClassIndexTest, ContainsPackage) {
+    EXPECT_TRUE(index_.ContainsPackage(""));
+    EXPECT_TRUE(index_.ContainsPackage("com.example"));
+    EXPECT_TRUE(index_.ContainsPackage("com/example/util"));
+    
+    // 只含资源、不含类的目录不算包
+    EXPECT_FALSE(index_.ContainsPackage("com.example.resources"));
+    EXPECT_FALSE(index_.ContainsPackage("com"));
+    EXPECT_EQ(index_.GetPackageCount(), 3u);
+}
+
+TEST_F(ClassIndexTest, PackageOf) {
+    EXPECT_EQ(ClassIndex::PackageOf("com.example.App"), "com.example");
+    EXPECT_EQ(ClassIndex::PackageOf("com/example/App"), "com/example");
+    EXPECT_EQ(ClassIndex::PackageOf("Main"), "");
+}
+
+TEST_F(ClassIndexTest, EntryPointCandidatesAreSortedTopLevelClasses) {
+    std::vector<std::string> expected = {
+        "Main",
+        "com.example.App",
+        "com.example.Java11Only",
+        "com.example.util.Strings"
+    };
+    EXPECT_EQ(index_.GetEntryPointCandidates(), expected);
+}
+
+TEST_F(ClassIndexTest, LargeArchive) {
+    ZipBuilder builder;
+    for (int i = 0; i < 5000; ++i) {
+        builder.Add("pkg" + std::to_string(i % 50) + "/Class" + std::to_string(i) + ".class", "");
+    }
+    std::vector<uint8_t> data = builder.Build();
+    
+    JarArchive archive;
+    ASSERT_EQ(archive.Parse(data.data(), data.size()), ErrorCode::SUCCESS);
+    ClassIndex index;
+    index.Build(archive);
+    
+    EXPECT_EQ(index.GetClassCount(), 5000u);
+    EXPECT_EQ(index.GetPackageCount(), 50u);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(index.ContainsClass("pkg" + std::to_string(i % 50) + ".Class" + std::to_string(i)));
+    }
+    EXPECT_FALSE(index.ContainsClass("pkg0.Class1"));
+}
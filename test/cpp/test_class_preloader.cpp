@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "../../src/include/class_preloader.h"
+#include "../../src/include/common.h"
+#include <algorithm>
+
+TEST(ClassPreloaderTest, PartitionByPackage_GroupsAndSplitsPackages) {
+    std::vector<std::string> classNames = {
+        "com.example.A", "Main", "com.example.util.X", "com.example.B",
+        "com.example.C", "Helper", "com.example.util.Y", "com.example.D"
+    };
+    
+    auto batches = ClassPreloader::PartitionByPackage(classNames, 3);
+    
+    // com.example有4个类，拆成3+1；util与默认包各一批
+    ASSERT_EQ(batches.size(), 4u);
+    EXPECT_EQ(batches[0], (std::vector<uint32_t>{0, 3, 4}));
+    EXPECT_EQ(batches[1], (std::vector<uint32_t>{1, 5}));
+    EXPECT_EQ(batches[2], (std::vector<uint32_t>{2, 6}));
+    EXPECT_EQ(batches[3], (std::vector<uint32_t>{7}));
+    
+    // 每个类恰好出现一次
+    std::vector<uint32_t> all;
+    for (const auto& batch : batches) {
+        all.insert(all.end(), batch.begin(), batch.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), classNames.size());
+    for (uint32_t i = 0; i < all.size(); ++i) {
+        EXPECT_EQ(all[i], i);
+    }
+}
+
+TEST(ClassPreloaderTest, PartitionByPackage_EmptyInput) {
+    EXPECT_TRUE(ClassPreloader::PartitionByPackage({}).empty());
+}
+
+TEST(ClassPreloaderTest, Start_RequiresJVM) {
+    ClassPreloader preloader;
+    EXPECT_EQ(preloader.Start(nullptr), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_FALSE(preloader.IsRunning());
+    
+    // 未启动时不执行任何加载
+    PreloadResult result = preloader.Preload(nullptr, {"com.example.A"});
+    EXPECT_EQ(result.loaded, 0u);
+    EXPECT_EQ(result.threads, 0u);
+    preloader.Stop();
+}
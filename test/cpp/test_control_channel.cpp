@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include "../../src/include/control_channel.h"
+#include "../../src/include/metrics_registry.h"
+#include "../../src/include/common.h"
+
+class ControlChannelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previousLevel_ = Logger::GetInstance().GetLogLevel();
+        MetricsRegistry::GetInstance().Reset();
+    }
+    
+    void TearDown() override {
+        Logger::GetInstance().SetLogLevel(previousLevel_);
+        MetricsRegistry::GetInstance().Reset();
+    }
+    
+    static ControlMessage Request(ControlCommand command, std::vector<uint8_t> payload = {}) {
+        ControlMessage request;
+        request.command = command;
+        request.requestId = 42;
+        request.payload = std::move(payload);
+        return request;
+    }
+    
+    static std::string ErrorMessage(const ControlMessage& response) {
+        std::string message;
+        PayloadReader reader(response.payload);
+        reader.ReadString(message);
+        return message;
+    }
+    
+    LogLevel previousLevel_;
+};
+
+TEST_F(ControlChannelTest, Protocol_RoundTripsMessages) {
+    ControlMessage message;
+    message.command = ControlCommand::INVOKE;
+    message.requestId = 0x01020304;
+    message.status = static_cast<int32_t>(ErrorCode::JAVA_EXCEPTION);
+    message.payload = {1, 2, 3};
+    
+    std::vector<uint8_t> data = ControlProtocol::Encode(message);
+    ASSERT_EQ(data.size(), ControlProtocol::HEADER_SIZE + 3);
+    EXPECT_EQ(data[0], 'J');
+    EXPECT_EQ(data[3], 'L');
+    
+    ControlMessage decoded;
+    uint32_t payloadLength = 0;
+    ASSERT_EQ(ControlProtocol::DecodeHeader(data.data(), decoded, payloadLength), ErrorCode::SUCCESS);
+    EXPECT_EQ(decoded.command, ControlCommand::INVOKE);
+    EXPECT_EQ(decoded.requestId, 0x01020304u);
+    EXPECT_EQ(decoded.status, static_cast<int32_t>(ErrorCode::JAVA_EXCEPTION));
+    EXPECT_EQ(payloadLength, 3u);
+    
+    // 魔数、版本或负载长度无效的消息头被拒绝
+    std::vector<uint8_t> badMagic = data;
+    badMagic[0] = 'X';
+    EXPECT_EQ(ControlProtocol::DecodeHeader(badMagic.data(), decoded, payloadLength), ErrorCode::INVALID_PARAMETER);
+    
+    std::vector<uint8_t> badVersion = data;
+    badVersion[4] = 2;
+    EXPECT_EQ(ControlProtocol::DecodeHeader(badVersion.data(), decoded, payloadLength), ErrorCode::INVALID_PARAMETER);
+    
+    std::vector<uint8_t> oversized = data;
+    oversized[19] = 0x7F;
+    EXPECT_EQ(ControlProtocol::DecodeHeader(oversized.data(), decoded, payloadLength), ErrorCode::INVALID_PARAMETER);
+}
+
+TEST_F(ControlChannelTest, Payload_ReadsAreBoundsChecked) {
+    PayloadWriter writer;
+    writer.WriteString("com.example.Plugin");
+    writer.WriteInt64(-1234567890123);
+    writer.WriteUInt32(7);
+    std::vector<uint8_t> data = writer.GetData();
+    
+    PayloadReader reader(data);
+    std::string text;
+    int64_t longValue = 0;
+    uint32_t intValue = 0;
+    ASSERT_TRUE(reader.ReadString(text));
+    EXPECT_EQ(text, "com.example.Plugin");
+    ASSERT_TRUE(reader.ReadInt64(longValue));
+    EXPECT_EQ(longValue, -1234567890123);
+    ASSERT_TRUE(reader.ReadUInt32(intValue));
+    EXPECT_EQ(intValue, 7u);
+    EXPECT_TRUE(reader.AtEnd());
+    EXPECT_FALSE(reader.ReadUInt32(intValue));
+    
+    // 字符串长度超出负载或上限
+    PayloadReader truncated(data.data(), 10);
+    EXPECT_FALSE(truncated.ReadString(text));
+    PayloadReader limited(data);
+    EXPECT_FALSE(limited.ReadString(text, 4));
+    EXPECT_TRUE(limited.ReadString(text));
+}
+
+TEST_F(ControlChannelTest, HandleRequest_InvokesWithArguments) {
+    std::string invokedClass;
+    std::string invokedMethod;
+    std::vector<std::string> invokedArgs;
+    ControlServer server;
+    ControlHandlers handlers;
+    handlers.invoke = [&](const std::string& className, const std::string& methodName, const std::vector<std::string>& args) {
+        invokedClass = className;
+        invokedMethod = methodName;
+        invokedArgs = args;
+        return methodName == "fail" ? ErrorCode::JAVA_EXCEPTION : ErrorCode::SUCCESS;
+    };
+    server.SetHandlers(handlers);
+    
+    PayloadWriter writer;
+    writer.WriteString("com.example.Plugin");
+    writer.WriteString("main");
+    writer.WriteUInt32(2);
+    writer.WriteString("--mode");
+    writer.WriteString("fast");
+    
+    ControlMessage response = server.HandleRequest(Request(ControlCommand::INVOKE, writer.GetData()));
+    EXPECT_EQ(response.command, ControlCommand::INVOKE);
+    EXPECT_EQ(response.requestId, 42u);
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::SUCCESS));
+    EXPECT_EQ(invokedClass, "com.example.Plugin");
+    EXPECT_EQ(invokedMethod, "main");
+    EXPECT_EQ(invokedArgs, (std::vector<std::string>{"--mode", "fast"}));
+    
+    // Java端失败时返回其错误码
+    PayloadWriter failing;
+    failing.WriteString("com.example.Plugin");
+    failing.WriteString("fail");
+    failing.WriteUInt32(0);
+    response = server.HandleRequest(Request(ControlCommand::INVOKE, failing.GetData()));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::JAVA_EXCEPTION));
+    EXPECT_EQ(ErrorMessage(response), "invoke com.example.Plugin.fail failed");
+    
+    // 参数个数与实际不符
+    PayloadWriter malformed;
+    malformed.WriteString("com.example.Plugin");
+    malformed.WriteString("main");
+    malformed.WriteUInt32(3);
+    malformed.WriteString("only-one");
+    invokedClass.clear();
+    response = server.HandleRequest(Request(ControlCommand::INVOKE, malformed.GetData()));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::INVALID_PARAMETER));
+    EXPECT_TRUE(invokedClass.empty());
+    
+    EXPECT_EQ(MetricsRegistry::GetInstance().Get("control.commands"), 3);
+    EXPECT_EQ(MetricsRegistry::GetInstance().Get("control.errors"), 2);
+}
+
+TEST_F(ControlChannelTest, HandleRequest_ReloadRequiresHandler) {
+    ControlServer server;
+    ControlMessage response = server.HandleRequest(Request(ControlCommand::RELOAD));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::INVALID_PARAMETER));
+    EXPECT_EQ(ErrorMessage(response), "hot reload is not enabled");
+    
+    int reloads = 0;
+    ControlHandlers handlers;
+    handlers.reload = [&reloads]() { ++reloads; return ErrorCode::SUCCESS; };
+    server.SetHandlers(handlers);
+    response = server.HandleRequest(Request(ControlCommand::RELOAD));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::SUCCESS));
+    EXPECT_EQ(reloads, 1);
+    
+    EXPECT_EQ(server.HandleRequest(Request(ControlCommand::PING)).status, static_cast<int32_t>(ErrorCode::SUCCESS));
+    EXPECT_EQ(server.HandleRequest(Request(static_cast<ControlCommand>(99))).status, static_cast<int32_t>(ErrorCode::INVALID_PARAMETER));
+}
+
+TEST_F(ControlChannelTest, HandleRequest_ReturnsMetricsAndSetsLogLevel) {
+    ControlServer server;
+    MetricsRegistry::GetInstance().Increment("reload.count", 3);
+    MetricsRegistry::GetInstance().Set("reload.last_duration_us", 1500);
+    
+    ControlMessage response = server.HandleRequest(Request(ControlCommand::GET_METRICS));
+    ASSERT_EQ(response.status, static_cast<int32_t>(ErrorCode::SUCCESS));
+    
+    PayloadReader reader(response.payload);
+    uint32_t count = 0;
+    ASSERT_TRUE(reader.ReadUInt32(count));
+    std::map<std::string, int64_t> metrics;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        int64_t value = 0;
+        ASSERT_TRUE(reader.ReadString(name));
+        ASSERT_TRUE(reader.ReadInt64(value));
+        metrics[name] = value;
+    }
+    EXPECT_TRUE(reader.AtEnd());
+    EXPECT_EQ(metrics["reload.count"], 3);
+    EXPECT_EQ(metrics["reload.last_duration_us"], 1500);
+    EXPECT_EQ(metrics.count("log.dropped_records"), 1u);
+    
+    PayloadWriter level;
+    level.WriteUInt32(static_cast<uint32_t>(LogLevel::ERROR));
+    response = server.HandleRequest(Request(ControlCommand::SET_LOG_LEVEL, level.GetData()));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::SUCCESS));
+    EXPECT_EQ(Logger::GetInstance().GetLogLevel(), LogLevel::ERROR);
+    
+    PayloadWriter invalidLevel;
+    invalidLevel.WriteUInt32(17);
+    response = server.HandleRequest(Request(ControlCommand::SET_LOG_LEVEL, invalidLevel.GetData()));
+    EXPECT_EQ(response.status, static_cast<int32_t>(ErrorCode::INVALID_PARAMETER));
+    EXPECT_EQ(Logger::GetInstance().GetLogLevel(), LogLevel::ERROR);
+}
+
+TEST_F(ControlChannelTest, Endpoint_RoundTripsCommandsAndStopsPromptly) {
+    std::wstring endpoint = ControlServer::GetEndpointName(Platform::GetCurrentProcessId()) + L"-test";
+    std::vector<std::string> invokedArgs;
+    std::atomic<int> threadExits(0);
+    ControlHandlers handlers;
+    handlers.invoke = [&invokedArgs](const std::string& className, const std::string& methodName,
+                                     const std::vector<std::string>& args) {
+        invokedArgs = args;
+        return className == "com.example.Plugin" ? ErrorCode::SUCCESS : ErrorCode::CLASS_NOT_FOUND;
+    };
+    handlers.threadExit = [&threadExits]() { ++threadExits; };
+    
+    ControlServer server;
+    ASSERT_EQ(server.Start(endpoint, handlers), ErrorCode::SUCCESS);
+    EXPECT_TRUE(server.IsRunning());
+    
+    // 同名端点只能有一个服务端
+    ControlServer duplicate;
+    EXPECT_NE(duplicate.Start(endpoint, ControlHandlers()), ErrorCode::SUCCESS);
+    
+    ControlClient client;
+    ASSERT_EQ(client.Connect(endpoint), ErrorCode::SUCCESS);
+    EXPECT_EQ(client.Ping(), ErrorCode::SUCCESS);
+    EXPECT_EQ(client.Invoke("com.example.Plugin", "main", {"--mode", "fast"}), ErrorCode::SUCCESS);
+    EXPECT_EQ(invokedArgs, (std::vector<std::string>{"--mode", "fast"}));
+    
+    // 失败的命令带回错误描述，连接保持可用
+    EXPECT_EQ(client.Invoke("com.example.Missing", "main", {}), ErrorCode::CLASS_NOT_FOUND);
+    EXPECT_EQ(client.GetLastErrorMessage(), "invoke com.example.Missing.main failed");
+    EXPECT_EQ(client.Reload(), ErrorCode::INVALID_PARAMETER);
+    EXPECT_EQ(client.GetLastErrorMessage(), "hot reload is not enabled");
+    
+    std::vector<std::pair<std::string, int64_t>> metrics;
+    ASSERT_EQ(client.GetMetrics(metrics), ErrorCode::SUCCESS);
+    bool foundCommands = false;
+    for (const auto& metric : metrics) {
+        if (metric.first == "control.commands") {
+            foundCommands = true;
+            EXPECT_EQ(metric.second, 4);
+        }
+    }
+    EXPECT_TRUE(foundCommands);
+    
+    // 客户端断开后服务端接受下一个客户端
+    client.Disconnect();
+    ControlClient second;
+    ASSERT_EQ(second.Connect(endpoint), ErrorCode::SUCCESS);
+    EXPECT_EQ(second.SetLogLevel(LogLevel::WARNING), ErrorCode::SUCCESS);
+    EXPECT_EQ(Logger::GetInstance().GetLogLevel(), LogLevel::WARNING);
+    
+    // 客户端仍连接且服务线程正等待读取时，Stop取消I/O并等待线程退出
+    auto start = std::chrono::steady_clock::now();
+    server.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_FALSE(server.IsRunning());
+    EXPECT_EQ(threadExits.load(), 1);
+    EXPECT_NE(second.Ping(), ErrorCode::SUCCESS);
+    
+    // 端点已关闭，可以重新启动
+    ASSERT_EQ(server.Start(endpoint, ControlHandlers()), ErrorCode::SUCCESS);
+    server.Stop();
+}
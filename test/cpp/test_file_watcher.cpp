@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "../../src/include/file_watcher.h"
+#include "../../src/include/common.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        watchedPath_ = L"file_watcher_test.txt";
+        WriteFile("initial");
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove(watchedPath_);
+    }
+    
+    // 写入内容并把修改时间推后，避免文件系统时间精度导致漏检
+    void WriteFile(const std::string& content) {
+        std::filesystem::path path(watchedPath_);
+        bool existed = std::filesystem::exists(path);
+        auto previous = existed ? std::filesystem::last_write_time(path) : std::filesystem::file_time_type();
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file << content;
+        }
+        if (existed) {
+            std::filesystem::last_write_time(path, previous + std::chrono::seconds(2));
+        }
+    }
+    
+    // 等待条件成立，最多等待2秒
+    template<typename Predicate>
+    static bool WaitUntil(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+    
+    std::wstring watchedPath_;
+};
+
+TEST_F(FileWatcherTest, DetectsModification) {
+    std::atomic<int> changes(0);
+    FileWatcher watcher;
+    ASSERT_EQ(watcher.Start(watchedPath_, [&changes]() { ++changes; }, 10, 10), ErrorCode::SUCCESS);
+    EXPECT_TRUE(watcher.IsWatching());
+    EXPECT_EQ(watcher.GetPath(), watchedPath_);
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(changes.load(), 0);
+    
+    WriteFile("first change");
+    EXPECT_TRUE(WaitUntil([&changes]() { return changes.load() == 1; }));
+    
+    WriteFile("second change");
+    EXPECT_TRUE(WaitUntil([&changes]() { return changes.load() == 2; }));
+    
+    watcher.Stop();
+    EXPECT_FALSE(watcher.IsWatching());
+}
+
+TEST_F(FileWatcherTest, DetectsReplaceByRename) {
+    std::atomic<int> changes(0);
+    FileWatcher watcher;
+    ASSERT_EQ(watcher.Start(watchedPath_, [&changes]() { ++changes; }, 10, 10), ErrorCode::SUCCESS);
+    
+    // 编辑器与部署脚本常用的原子保存：写入临时文件后重命名覆盖
+    std::filesystem::path temporary(watchedPath_ + L".tmp");
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << "replaced by rename";
+    }
+    std::filesystem::rename(temporary, std::filesystem::path(watchedPath_));
+    EXPECT_TRUE(WaitUntil([&changes]() { return changes.load() == 1; }));
+    
+    // 重命名后的文件继续被监控
+    WriteFile("modified after rename");
+    EXPECT_TRUE(WaitUntil([&changes]() { return changes.load() == 2; }));
+}
+
+TEST_F(FileWatcherTest, StopWaitsForRunningCallback) {
+    std::atomic<bool> entered(false);
+    std::atomic<bool> finished(false);
+    FileWatcher watcher;
+    ASSERT_EQ(watcher.Start(watchedPath_, [&entered, &finished]() {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        finished = true;
+    }, 10, 10), ErrorCode::SUCCESS);
+    
+    WriteFile("slow callback");
+    ASSERT_TRUE(WaitUntil([&entered]() { return entered.load(); }));
+    
+    // Stop返回后回调不再运行，捕获的对象可以安全销毁
+    watcher.Stop();
+    EXPECT_TRUE(finished.load());
+}
+
+TEST_F(FileWatcherTest, IdleCallbackRunsWithoutChanges) {
+    std::atomic<int> changes(0);
+    std::atomic<int> idle(0);
+    FileWatcher watcher;
+    watcher.SetIdleCallback([&idle]() { ++idle; });
+    ASSERT_EQ(watcher.Start(watchedPath_, [&changes]() { ++changes; }, 10, 10), ErrorCode::SUCCESS);
+    
+    // 文件不变时每次唤醒都调用，不触发变化回调
+    EXPECT_TRUE(WaitUntil([&idle]() { return idle.load() >= 3; }));
+    EXPECT_EQ(changes.load(), 0);
+    watcher.Stop();
+}
+
+TEST_F(FileWatcherTest, StopIsPromptAndRestartable) {
+    FileWatcher watcher;
+    ASSERT_EQ(watcher.Start(watchedPath_, []() {}, 5000), ErrorCode::SUCCESS);
+    EXPECT_EQ(watcher.Start(watchedPath_, []() {}), ErrorCode::INVALID_PARAMETER);
+    
+    // 轮询等待可被Stop立即唤醒，不必等到间隔结束
+    auto start = std::chrono::steady_clock::now();
+    watcher.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    
+    std::atomic<int> changes(0);
+    ASSERT_EQ(watcher.Start(watchedPath_, [&changes]() { ++changes; }, 10, 10), ErrorCode::SUCCESS);
+    WriteFile("changed after restart");
+    EXPECT_TRUE(WaitUntil([&changes]() { return changes.load() == 1; }));
+}
+
+TEST_F(FileWatcherTest, RejectsInvalidArguments) {
+    FileWatcher watcher;
+    EXPECT_EQ(watcher.Start(L"missing_watched_file.txt", []() {}), ErrorCode::INVALID_PARAMETER);
+    EXPECT_EQ(watcher.Start(watchedPath_, nullptr), ErrorCode::INVALID_PARAMETER);
+    EXPECT_FALSE(watcher.IsWatching());
+    
+    // 未启动时停止不做任何事
+    watcher.Stop();
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "../../src/include/jar_archive.h"
+#include "zip_test_utils.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+class JarArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testJarPath_ = L"archive_test.jar";
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove(testJarPath_);
+    }
+    
+    static ZipBuilder SampleJar() {
+        ZipBuilder builder;
+        builder.Add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\nMain-Class: Main\r\n")
+               .Add("Main.class", "\xCA\xFE\xBA\xBE main")
+               .Add("com/example/Helper.class", "\xCA\xFE\xBA\xBE helper")
+               .Add("com/example/", "");
+        return builder;
+    }
+    
+    std::wstring testJarPath_;
+};
+
+TEST_F(JarArchiveTest, Open_RejectsNonZipContent) {
+    std::ofstream jarFile{std::filesystem::path(testJarPath_)};
+    jarFile << "dummy jar content";
+    jarFile.close();
+    
+    JarArchive archive;
+    EXPECT_EQ(archive.Open(testJarPath_), ErrorCode::JAR_INVALID_FORMAT);
+    EXPECT_FALSE(archive.IsOpen());
+    EXPECT_FALSE(archive.GetLastErrorMessage().empty());
+}
+
+TEST_F(JarArchiveTest, Open_NonExistentFile) {
+    JarArchive archive;
+    EXPECT_EQ(archive.Open(L"non_existent.jar"), ErrorCode::JAR_NOT_FOUND);
+}
+
+TEST_F(JarArchiveTest, Open_ValidArchiveListsEntries) {
+    SampleJar().WriteTo(testJarPath_);
+    
+    JarArchive archive;
+    ASSERT_EQ(archive.Open(testJarPath_), ErrorCode::SUCCESS);
+    ASSERT_EQ(archive.GetEntryCount(), 4u);
+    
+    size_t classCount = 0;
+    for (const auto& entry : archive) {
+        if (entry.IsClass()) {
+            ++classCount;
+        }
+    }
+    EXPECT_EQ(classCount, 2u);
+    EXPECT_TRUE(archive.GetEntry(3).IsDirectory());
+}
+
+TEST_F(JarArchiveTest, OpenSnapshot_DoesNotHoldSourceFile) {
+    SampleJar().WriteTo(testJarPath_);
+    
+    JarArchive archive;
+    ASSERT_EQ(archive.OpenSnapshot(testJarPath_), ErrorCode::SUCCESS);
+    EXPECT_TRUE(archive.IsSnapshot());
+    
+    // 快照读取后源文件可被删除，快照内容不受影响
+    EXPECT_TRUE(std::filesystem::remove(testJarPath_));
+    
+    const JarEntry* entry = archive.FindEntry("Main.class");
+    ASSERT_NE(entry, nullptr);
+    const uint8_t* entryData = nullptr;
+    uint64_t entrySize = 0;
+    ASSERT_TRUE(archive.GetEntryData(*entry, entryData, entrySize));
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(entryData), entrySize), "\xCA\xFE\xBA\xBE main");
+}
+
+TEST_F(JarArchiveTest, GetEntryData_ReturnsStoredBytes) {
+    std::vector<uint8_t> data = SampleJar().Build();
+    
+    JarArchive archive;
+    ASSERT_EQ(archive.Parse(data.data(), data.size()), ErrorCode::SUCCESS);
+    
+    const JarEntry* entry = archive.FindEntry("com/example/Helper.class");
+    ASSERT_NE(entry, nullptr);
+    
+    const uint8_t* entryData = nullptr;
+    uint64_t entrySize = 0;
+    ASSERT_TRUE(archive.GetEntryData(*entry, entryData, entrySize));
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(entryData), entrySize), "\xCA\xFE\xBA\xBE helper");
+}
+
+TEST_F(JarArchiveTest, Parse_Zip64EndOfCentralDirectory) {
+    std::vector<uint8_t> data = SampleJar().Build(true);
+    
+    JarArchive archive;
+    ASSERT_EQ(archive.Parse(data.data(), data.size()), ErrorCode::SUCCESS);
+    EXPECT_EQ(archive.GetEntryCount(), 4u);
+}
+
+TEST_F(JarArchiveTest, Parse_RejectsTruncatedArchive) {
+    std::vector<uint8_t> data = SampleJar().Build();
+    
+    // 任意截断都不应被接受，也不应越界读取
+    for (size_t length = 0; length < data.size(); ++length) {
+        JarArchive archive;
+        EXPECT_NE(archive.Parse(data.data(), length), ErrorCode::SUCCESS) << "length " << length;
+    }
+}
+
+TEST_F(JarArchiveTest, Parse_RejectsCentralDirectoryOutOfBounds) {
+    std::vector<uint8_t> data = SampleJar().Build();
+    
+    // 将EOCD中的中央目录偏移改为超出文件范围
+    size_t eocd = data.size() - 22;
+    data[eocd + 16] = 0xFF;
+    data[eocd + 17] = 0xFF;
+    data[eocd + 18] = 0x00;
+    data[eocd + 19] = 0x00;
+    
+    JarArchive archive;
+    EXPECT_EQ(archive.Parse(data.data(), data.size()), ErrorCode::JAR_INVALID_FORMAT);
+}
+
+// 轻量随机变异测试，完整模糊测试见fuzz_jar_archive.cpp
+TEST_F(JarArchiveTest, Parse_SurvivesRandomMutations) {
+    std::vector<uint8_t> original = SampleJar().Build(true);
+    std::mt19937 rng(12345);
+    
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        std::vector<uint8_t> data = original;
+        int mutations = 1 + static_cast<int>(rng() % 8);
+        for (int i = 0; i < mutations; ++i) {
+            data[rng() % data.size()] = static_cast<uint8_t>(rng());
+        }
+        
+        JarArchive archive;
+        if (archive.Parse(data.data(), data.size()) == ErrorCode::SUCCESS) {
+            for (const auto& entry : archive) {
+                const uint8_t* entryData = nullptr;
+                uint64_t entrySize = 0;
+                if (archive.GetEntryData(entry, entryData, entrySize)) {
+                    EXPECT_GE(entryData, data.data());
+                    EXPECT_LE(entryData + entrySize, data.data() + data.size());
+                }
+            }
+        }
+    }
+}
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include "../../src/include/jar_loader.h"
+#include "../../src/include/hot_reload.h"
+#include "../../src/include/platform.h"
 #include "../../src/include/common.h"
+#include "zip_test_utils.h"
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <thread>
 
 class JarLoaderTest : public ::testing::Test {
 protected:
@@ -11,7 +16,7 @@ protected:
         
         // 创建测试JAR文件
         testJarPath_ = L"test.jar";
-        std::ofstream jarFile(testJarPath_);
+        std::ofstream jarFile(Platform::ToFilesystemPath(testJarPath_));
         jarFile << "dummy jar content";
         jarFile.close();
     }
@@ -21,6 +26,202 @@ protected:
         std::filesystem::remove(testJarPath_);
     }
     
+    // 最小的类文件：public class SoakPlugin { public static void main(String[] args) {} }
+    static std::string SoakPluginClass() {
+        static const uint8_t bytes[] = {
+            0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34,           // 魔数、版本52
+            0x00, 0x08,                                               // 常量池7项
+            0x07, 0x00, 0x02,                                         // #1 Class #2
+            0x01, 0x00, 0x0A, 'S', 'o', 'a', 'k', 'P', 'l', 'u', 'g', 'i', 'n',
+            0x07, 0x00, 0x04,                                         // #3 Class #4
+            0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'O', 'b', 'j', 'e', 'c', 't',
+            0x01, 0x00, 0x04, 'm', 'a', 'i', 'n',
+            0x01, 0x00, 0x16, '(', '[', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/',
+                              'S', 't', 'r', 'i', 'n', 'g', ';', ')', 'V',
+            0x01, 0x00, 0x04, 'C', 'o', 'd', 'e',
+            0x00, 0x21, 0x00, 0x01, 0x00, 0x03,                       // public super, this #1, super #3
+            0x00, 0x00, 0x00, 0x00,                                   // 无接口、无字段
+            0x00, 0x01,                                               // 1个方法
+            0x00, 0x09, 0x00, 0x05, 0x00, 0x06, 0x00, 0x01,           // public static main, 1个属性
+            0x00, 0x07, 0x00, 0x00, 0x00, 0x0D,                       // Code，长度13
+            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0xB1,     // max_stack 0, max_locals 1, return
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x00                                                // 无类属性
+        };
+        return std::string(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+    
+    // public class StatefulPlugin {
+    //     static ByteBuffer state;
+    //     public static ByteBuffer onUnload() { return ByteBuffer.allocateDirect(16); }
+    //     public static void onLoad(ByteBuffer b) { state = b; }
+    // }
+    static std::string StatefulPluginClass() {
+        static const uint8_t bytes[] = {
+            0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34,           // 魔数、版本52
+            0x00, 0x14,                                               // 常量池19项
+            0x07, 0x00, 0x02,                                         // #1 Class #2
+            0x01, 0x00, 0x0E, 'S', 't', 'a', 't', 'e', 'f', 'u', 'l', 'P', 'l', 'u', 'g', 'i', 'n',
+            0x07, 0x00, 0x04,                                         // #3 Class #4
+            0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'O', 'b', 'j', 'e', 'c', 't',
+            0x01, 0x00, 0x05, 's', 't', 'a', 't', 'e',
+            0x01, 0x00, 0x15, 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';',
+            0x01, 0x00, 0x08, 'o', 'n', 'U', 'n', 'l', 'o', 'a', 'd',
+            0x01, 0x00, 0x17, '(', ')', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';',
+            0x01, 0x00, 0x06, 'o', 'n', 'L', 'o', 'a', 'd',
+            0x01, 0x00, 0x18, '(', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';', ')', 'V',
+            0x01, 0x00, 0x04, 'C', 'o', 'd', 'e',
+            0x07, 0x00, 0x0D,                                         // #12 Class #13
+            0x01, 0x00, 0x13, 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r',
+            0x01, 0x00, 0x0E, 'a', 'l', 'l', 'o', 'c', 'a', 't', 'e', 'D', 'i', 'r', 'e', 'c', 't',
+            0x01, 0x00, 0x18, '(', 'I', ')', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';',
+            0x0C, 0x00, 0x0E, 0x00, 0x0F,                             // #16 NameAndType #14 #15
+            0x0A, 0x00, 0x0C, 0x00, 0x10,                             // #17 Methodref ByteBuffer.allocateDirect
+            0x0C, 0x00, 0x05, 0x00, 0x06,                             // #18 NameAndType #5 #6
+            0x09, 0x00, 0x01, 0x00, 0x12,                             // #19 Fieldref StatefulPlugin.state
+            0x00, 0x21, 0x00, 0x01, 0x00, 0x03,                       // public super, this #1, super #3
+            0x00, 0x00,                                               // 无接口
+            0x00, 0x01, 0x00, 0x08, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, // 1个字段：static state
+            0x00, 0x02,                                               // 2个方法
+            0x00, 0x09, 0x00, 0x07, 0x00, 0x08, 0x00, 0x01,           // public static onUnload，1个属性
+            0x00, 0x0B, 0x00, 0x00, 0x00, 0x12,                       // Code，长度18
+            0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,           // max_stack 1, max_locals 0
+            0x10, 0x10, 0xB8, 0x00, 0x11, 0xB0,                       // bipush 16, invokestatic #17, areturn
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x09, 0x00, 0x09, 0x00, 0x0A, 0x00, 0x01,           // public static onLoad，1个属性
+            0x00, 0x0B, 0x00, 0x00, 0x00, 0x11,                       // Code，长度17
+            0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05,           // max_stack 1, max_locals 1
+            0x2A, 0xB3, 0x00, 0x13, 0xB1,                             // aload_0, putstatic #19, return
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x00                                                // 无类属性
+        };
+        return std::string(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+    
+    // public class HandoffProbe {
+    //     public static ByteBuffer onUnload() { return ByteBuffer.allocateDirect(16); }
+    //     public static void onLoad(ByteBuffer b) { System.setProperty("HandoffProbe.onLoad", "called"); }
+    //     public static void main(String[] args) {}                     // failingMain时为 throw null
+    // }
+    static std::string HandoffProbeClass(bool failingMain) {
+        static const uint8_t bytes[] = {
+            0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34,           // 魔数、版本52
+            0x00, 0x1C,                                               // 常量池27项
+            0x07, 0x00, 0x02,                                         // #1 Class #2
+            0x01, 0x00, 0x0C, 'H', 'a', 'n', 'd', 'o', 'f', 'f', 'P', 'r', 'o', 'b', 'e',
+            0x07, 0x00, 0x04,                                         // #3 Class #4
+            0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'O', 'b', 'j', 'e', 'c', 't',
+            0x01, 0x00, 0x08, 'o', 'n', 'U', 'n', 'l', 'o', 'a', 'd',
+            0x01, 0x00, 0x17, '(', ')', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';',
+            0x01, 0x00, 0x06, 'o', 'n', 'L', 'o', 'a', 'd',
+            0x01, 0x00, 0x18, '(', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';', ')', 'V',
+            0x01, 0x00, 0x04, 'm', 'a', 'i', 'n',
+            0x01, 0x00, 0x16, '(', '[', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/',
+                              'S', 't', 'r', 'i', 'n', 'g', ';', ')', 'V',
+            0x01, 0x00, 0x04, 'C', 'o', 'd', 'e',
+            0x07, 0x00, 0x0D,                                         // #12 Class #13
+            0x01, 0x00, 0x13, 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r',
+            0x01, 0x00, 0x0E, 'a', 'l', 'l', 'o', 'c', 'a', 't', 'e', 'D', 'i', 'r', 'e', 'c', 't',
+            0x01, 0x00, 0x18, '(', 'I', ')', 'L', 'j', 'a', 'v', 'a', '/', 'n', 'i', 'o', '/', 'B', 'y', 't', 'e', 'B', 'u', 'f', 'f', 'e', 'r', ';',
+            0x0C, 0x00, 0x0E, 0x00, 0x0F,                             // #16 NameAndType #14 #15
+            0x0A, 0x00, 0x0C, 0x00, 0x10,                             // #17 Methodref ByteBuffer.allocateDirect
+            0x07, 0x00, 0x13,                                         // #18 Class #19
+            0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'S', 'y', 's', 't', 'e', 'm',
+            0x01, 0x00, 0x0B, 's', 'e', 't', 'P', 'r', 'o', 'p', 'e', 'r', 't', 'y',
+            0x01, 0x00, 0x38, '(', 'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'S', 't', 'r', 'i', 'n', 'g', ';',
+                              'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'S', 't', 'r', 'i', 'n', 'g', ';', ')',
+                              'L', 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'S', 't', 'r', 'i', 'n', 'g', ';',
+            0x0C, 0x00, 0x14, 0x00, 0x15,                             // #22 NameAndType #20 #21
+            0x0A, 0x00, 0x12, 0x00, 0x16,                             // #23 Methodref System.setProperty
+            0x08, 0x00, 0x19,                                         // #24 String #25
+            0x01, 0x00, 0x13, 'H', 'a', 'n', 'd', 'o', 'f', 'f', 'P', 'r', 'o', 'b', 'e', '.', 'o', 'n', 'L', 'o', 'a', 'd',
+            0x08, 0x00, 0x1B,                                         // #26 String #27
+            0x01, 0x00, 0x06, 'c', 'a', 'l', 'l', 'e', 'd',
+            0x00, 0x21, 0x00, 0x01, 0x00, 0x03,                       // public super, this #1, super #3
+            0x00, 0x00, 0x00, 0x00,                                   // 无接口、无字段
+            0x00, 0x03,                                               // 3个方法
+            0x00, 0x09, 0x00, 0x05, 0x00, 0x06, 0x00, 0x01,           // public static onUnload，1个属性
+            0x00, 0x0B, 0x00, 0x00, 0x00, 0x12,                       // Code，长度18
+            0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,           // max_stack 1, max_locals 0
+            0x10, 0x10, 0xB8, 0x00, 0x11, 0xB0,                       // bipush 16, invokestatic #17, areturn
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x09, 0x00, 0x07, 0x00, 0x08, 0x00, 0x01,           // public static onLoad，1个属性
+            0x00, 0x0B, 0x00, 0x00, 0x00, 0x15,                       // Code，长度21
+            0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x09,           // max_stack 2, max_locals 1
+            0x12, 0x18, 0x12, 0x1A, 0xB8, 0x00, 0x17, 0x57, 0xB1,     // ldc #24, ldc #26, invokestatic #23, pop, return
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x09, 0x00, 0x09, 0x00, 0x0A, 0x00, 0x01,           // public static main，1个属性
+            0x00, 0x0B, 0x00, 0x00, 0x00, 0x0E,                       // Code，长度14
+            0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02,           // max_stack 1, max_locals 1
+            0x00, 0xB1,                                               // nop, return（倒数第8、7字节）
+            0x00, 0x00, 0x00, 0x00,                                   // 无异常表、无属性
+            0x00, 0x00                                                // 无类属性
+        };
+        std::string result(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        if (failingMain) {
+            result[result.size() - 8] = static_cast<char>(0x01);     // aconst_null
+            result[result.size() - 7] = static_cast<char>(0xBF);     // athrow
+        }
+        return result;
+    }
+    
+    // public class CounterPlugin { public void tick() {} }
+    static std::string CounterPluginClass() {
+        static const uint8_t bytes[] = {
+            0xCA, 0xFE, 0xBA, 0xBE, 0x00, 0x00, 0x00, 0x34,           // 魔数、版本52
+            0x00, 0x0B,                                               // 常量池10项
+            0x0A, 0x00, 0x03, 0x00, 0x08,                             // #1 Methodref #3.#8
+            0x07, 0x00, 0x09,                                         // #2 Class #9
+            0x07, 0x00, 0x0A,                                         // #3 Class #10
+            0x01, 0x00, 0x06, '<', 'i', 'n', 'i', 't', '>',
+            0x01, 0x00, 0x03, '(', ')', 'V',
+            0x01, 0x00, 0x04, 'C', 'o', 'd', 'e',
+            0x01, 0x00, 0x04, 't', 'i', 'c', 'k',
+            0x0C, 0x00, 0x04, 0x00, 0x05,                             // #8 NameAndType #4:#5
+            0x01, 0x00, 0x0D, 'C', 'o', 'u', 'n', 't', 'e', 'r', 'P', 'l', 'u', 'g', 'i', 'n',
+            0x01, 0x00, 0x10, 'j', 'a', 'v', 'a', '/', 'l', 'a', 'n', 'g', '/', 'O', 'b', 'j', 'e', 'c', 't',
+            0x00, 0x21, 0x00, 0x02, 0x00, 0x03,                       // public super, this #2, super #3
+            0x00, 0x00, 0x00, 0x00,                                   // 无接口、无字段
+            0x00, 0x02,                                               // 2个方法
+            0x00, 0x01, 0x00, 0x04, 0x00, 0x05, 0x00, 0x01,           // public <init>()V
+            0x00, 0x06, 0x00, 0x00, 0x00, 0x11,                       // Code，长度17
+            0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05,
+            0x2A, 0xB7, 0x00, 0x01, 0xB1,                             // aload_0, invokespecial #1, return
+            0x00, 0x00, 0x00, 0x00,
+            0x00, 0x01, 0x00, 0x07, 0x00, 0x05, 0x00, 0x01,           // public tick()V
+            0x00, 0x06, 0x00, 0x00, 0x00, 0x0D,                       // Code，长度13
+            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0xB1,     // return
+            0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00                                                // 无类属性
+        };
+        return std::string(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+    
+    // JVM当前已加载的类数量（ClassLoadingMXBean）
+    static jint LoadedClassCount(JNIEnv* env) {
+        jclass factory = env->FindClass("java/lang/management/ManagementFactory");
+        jmethodID getBean = env->GetStaticMethodID(factory, "getClassLoadingMXBean", "()Ljava/lang/management/ClassLoadingMXBean;");
+        jobject bean = env->CallStaticObjectMethod(factory, getBean);
+        jclass beanClass = env->FindClass("java/lang/management/ClassLoadingMXBean");
+        jint count = env->CallIntMethod(bean, env->GetMethodID(beanClass, "getLoadedClassCount", "()I"));
+        env->DeleteLocalRef(beanClass);
+        env->DeleteLocalRef(bean);
+        env->DeleteLocalRef(factory);
+        return count;
+    }
+    
+    // 当前线程的上下文类加载器（局部引用）
+    static jobject ContextClassLoaderOf(JNIEnv* env) {
+        jclass threadClass = env->FindClass("java/lang/Thread");
+        jobject thread = env->CallStaticObjectMethod(threadClass,
+            env->GetStaticMethodID(threadClass, "currentThread", "()Ljava/lang/Thread;"));
+        jobject loader = env->CallObjectMethod(thread,
+            env->GetMethodID(threadClass, "getContextClassLoader", "()Ljava/lang/ClassLoader;"));
+        env->DeleteLocalRef(thread);
+        env->DeleteLocalRef(threadClass);
+        return loader;
+    }
+    
     std::unique_ptr<JarLoader> jarLoader_;
     std::wstring testJarPath_;
 };
@@ -98,4 +299,536 @@ TEST_F(JarLoaderTest, Performance_MultipleMethodCalls) {
     
     // 验证性能在合理范围内（这里只是示例，实际阈值需要根据环境调整）
     EXPECT_LT(duration.count(), 5000); // 应该在5秒内完成
-}
\ No newline at end of file
+}
+
+TEST_F(JarLoaderTest, InstancePolicy_DefaultIsPerCall) {
+    EXPECT_EQ(jarLoader_->GetInstancePolicy("TestClass"), InstancePolicy::PER_CALL);
+    EXPECT_EQ(jarLoader_->GetCachedInstanceCount(), 0u);
+}
+
+TEST_F(JarLoaderTest, InstancePolicy_PerClassOverridesDefault) {
+    jarLoader_->SetDefaultInstancePolicy(InstancePolicy::PER_THREAD);
+    jarLoader_->SetInstancePolicy("TestClass", InstancePolicy::SINGLETON);
+    
+    EXPECT_EQ(jarLoader_->GetInstancePolicy("TestClass"), InstancePolicy::SINGLETON);
+    EXPECT_EQ(jarLoader_->GetInstancePolicy("OtherClass"), InstancePolicy::PER_THREAD);
+}
+
+TEST_F(JarLoaderTest, InstancePolicy_UnloadReleasesInstances) {
+    jarLoader_->SetInstancePolicy("TestClass", InstancePolicy::SINGLETON);
+    jarLoader_->UnloadJar();
+    EXPECT_EQ(jarLoader_->GetCachedInstanceCount(), 0u);
+}
+
+// 每线程实例在线程结束（DetachCurrentThread）时释放，而不是等到下一次重载
+TEST_F(JarLoaderTest, InstancePolicy_PerThreadReleasedOnThreadExit) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring pluginJarPath = L"counter_plugin.jar";
+    ZipBuilder().Add("CounterPlugin.class", CounterPluginClass()).WriteTo(pluginJarPath);
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    jarLoader_->SetInstancePolicy("CounterPlugin", InstancePolicy::PER_THREAD);
+    
+    ErrorCode result = ErrorCode::UNKNOWN_ERROR;
+    size_t cachedWhileRunning = 0;
+    std::thread worker([&]() {
+        result = jarLoader_->CallJavaMethod("CounterPlugin", "tick");
+        cachedWhileRunning = jarLoader_->GetCachedInstanceCount();
+        jarLoader_->DetachCurrentThread();
+    });
+    worker.join();
+    
+    EXPECT_EQ(result, ErrorCode::SUCCESS);
+    EXPECT_EQ(cachedWhileRunning, 1u);
+    EXPECT_EQ(jarLoader_->GetCachedInstanceCount(), 0u);
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(pluginJarPath);
+}
+
+TEST_F(JarLoaderTest, StartupOptions_TimeToFirstCallUnsetBeforeCall) {
+    JvmStartupOptions options;
+    options.cdsMode = CdsMode::AUTO;
+    options.cdsArchivePath = L"test_app.jsa";
+    options.options.push_back("-Xmx64m");
+    jarLoader_->SetJvmStartupOptions(options);
+    
+    EXPECT_LT(jarLoader_->GetTimeToFirstCallMs(), 0.0);
+}
+
+TEST_F(JarLoaderTest, StartupOptions_PluginNotAllowedOnClassPathByDefault) {
+    JvmStartupOptions options;
+    EXPECT_FALSE(options.allowPluginOnClassPath);
+}
+
+TEST_F(JarLoaderTest, ClassPathContainsJar_MatchesEntriesAndWildcards) {
+    const std::wstring separator(1, Platform::PATH_LIST_SEPARATOR);
+    const std::wstring classPath = L"/app/host.jar" + separator + separator + L"/libs/*";
+    
+    EXPECT_TRUE(JarLoader::ClassPathContainsJar(classPath, L"/app/host.jar"));
+    EXPECT_TRUE(JarLoader::ClassPathContainsJar(classPath, L"/app/../app/host.jar"));
+    EXPECT_TRUE(JarLoader::ClassPathContainsJar(classPath, L"/libs/plugin.jar"));
+    
+    EXPECT_FALSE(JarLoader::ClassPathContainsJar(classPath, L"/APP/Host.jar"));
+    EXPECT_FALSE(JarLoader::ClassPathContainsJar(classPath, L"/plugins/plugin.jar"));
+    EXPECT_FALSE(JarLoader::ClassPathContainsJar(classPath, L"/libs/sub/plugin.jar"));
+    EXPECT_FALSE(JarLoader::ClassPathContainsJar(L"", L"/app/host.jar"));
+    EXPECT_FALSE(JarLoader::ClassPathContainsJar(classPath, L""));
+}
+
+TEST_F(JarLoaderTest, LoadJar_RejectsNonZipContent) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    // 测试JAR内容不是ZIP，应在创建类加载器之前被拒绝
+    EXPECT_EQ(jarLoader_->LoadJar(testJarPath_), ErrorCode::JAR_INVALID_FORMAT);
+}
+
+TEST_F(JarLoaderTest, ClassLoaderMode_DefaultsToUrl) {
+    EXPECT_EQ(jarLoader_->GetClassLoaderMode(), ClassLoaderMode::URL);
+    
+    jarLoader_->SetClassLoaderMode(ClassLoaderMode::SNAPSHOT);
+    EXPECT_EQ(jarLoader_->GetClassLoaderMode(), ClassLoaderMode::SNAPSHOT);
+}
+
+TEST_F(JarLoaderTest, GenerationStats_EmptyBeforeFirstLoad) {
+    GenerationStats stats = jarLoader_->GetGenerationStats();
+    EXPECT_EQ(stats.current, 0u);
+    EXPECT_EQ(stats.retired, 0u);
+    EXPECT_EQ(stats.collected, 0u);
+    EXPECT_EQ(stats.leaked, 0u);
+}
+
+// 反复加载、调用、卸载后退役的代都应被回收，已加载类数量不随重载次数增长
+TEST_F(JarLoaderTest, Soak_RetiredGenerationsAreCollected) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring soakJarPath = L"soak_plugin.jar";
+    ZipBuilder().Add("SoakPlugin.class", SoakPluginClass()).WriteTo(soakJarPath);
+    
+    const int warmupRounds = 20;
+    const int soakRounds = 500;
+    auto reload = [&]() {
+        ASSERT_EQ(jarLoader_->LoadJar(soakJarPath), ErrorCode::SUCCESS);
+        ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    };
+    
+    for (int i = 0; i < warmupRounds; ++i) {
+        reload();
+    }
+    jarLoader_->CollectRetiredGenerations();
+    jint baseline = LoadedClassCount(jarLoader_->GetJNIEnv());
+    
+    // 另一个长期存活的线程加载并调用一代，之后由测试线程重载：
+    // 调用结束后该线程的上下文类加载器已恢复，不会阻止这一代被回收
+    std::promise<bool> workerLoaded;
+    std::promise<void> soakFinished;
+    std::thread worker([&]() {
+        JNIEnv* env = nullptr;
+        JavaVM* vm = jarLoader_->GetJVM();
+        if (vm->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr) != JNI_OK) {
+            workerLoaded.set_value(false);
+            return;
+        }
+        jobject before = ContextClassLoaderOf(env);
+        bool restored = jarLoader_->LoadJar(soakJarPath) == ErrorCode::SUCCESS &&
+                        jarLoader_->CallJavaMethod("SoakPlugin", "main") == ErrorCode::SUCCESS;
+        jobject after = ContextClassLoaderOf(env);
+        restored = restored && env->IsSameObject(before, after);
+        env->DeleteLocalRef(after);
+        env->DeleteLocalRef(before);
+        workerLoaded.set_value(restored);
+        
+        soakFinished.get_future().wait();
+        jarLoader_->DetachCurrentThread();
+        vm->DetachCurrentThread();
+    });
+    EXPECT_TRUE(workerLoaded.get_future().get());
+    
+    for (int i = 0; i < soakRounds; ++i) {
+        reload();
+    }
+    ErrorCode unloadResult = jarLoader_->UnloadJar();
+    
+    // 统计时工作线程仍然存活
+    GenerationStats stats = jarLoader_->CollectRetiredGenerations();
+    jint loadedClasses = LoadedClassCount(jarLoader_->GetJNIEnv());
+    soakFinished.set_value();
+    worker.join();
+    ASSERT_EQ(unloadResult, ErrorCode::SUCCESS);
+    
+    const uint64_t generations = warmupRounds + 1 + soakRounds;
+    EXPECT_EQ(stats.current, generations);
+    EXPECT_EQ(stats.leaked, 0u);
+    EXPECT_LE(stats.retired, 2u);
+    EXPECT_GE(stats.collected, generations - 2);
+    
+    // 每代加载一个SoakPlugin，旧代未卸载时类数量会增加soakRounds
+    EXPECT_LT(loadedClasses, baseline + 50);
+    
+    std::filesystem::remove(soakJarPath);
+}
+
+TEST_F(JarLoaderTest, JvmTelemetry_UnavailableWithoutJVM) {
+    JvmMemorySample sample;
+    EXPECT_FALSE(jarLoader_->SampleJvmTelemetry(sample));
+    
+    JvmTelemetry telemetry;
+    EXPECT_FALSE(telemetry.Sample(nullptr, sample));
+}
+
+TEST_F(JarLoaderTest, JvmTelemetry_SamplesPlatformMXBeans) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    JvmMemorySample first;
+    ASSERT_TRUE(jarLoader_->SampleJvmTelemetry(first));
+    EXPECT_GT(first.heapUsed, 0);
+    EXPECT_GE(first.heapCommitted, first.heapUsed);
+    EXPECT_GT(first.metaspaceUsed, 0);
+    EXPECT_GT(first.loadedClasses, 0);
+    
+    // System.gc()触发一次完整GC，累计GC次数增加
+    jarLoader_->CollectRetiredGenerations();
+    JvmMemorySample second;
+    ASSERT_TRUE(jarLoader_->SampleJvmTelemetry(second));
+    EXPECT_GT(second.gcCount, first.gcCount);
+    EXPECT_GE(second.gcTimeMs, first.gcTimeMs);
+}
+
+TEST_F(JarLoaderTest, PrepareJar_RequiresJVM) {
+    EXPECT_EQ(jarLoader_->PrepareJar(testJarPath_), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_EQ(jarLoader_->CommitPreparedJar(), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_FALSE(jarLoader_->HasPreparedJar());
+    
+    WarmUpResult result;
+    EXPECT_EQ(jarLoader_->WarmUpPreparedJar(WarmUpOptions(), result), ErrorCode::JVM_NOT_INITIALIZED);
+    
+    // 没有线程池时停止是空操作
+    jarLoader_->StopPreloader();
+}
+
+// 预热在新一代上加载类并重放记录的调用，切换前当前一代保持不变
+TEST_F(JarLoaderTest, WarmUp_PreloadsAndReplaysBeforeCommit) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring pluginJarPath = L"warmup_plugin.jar";
+    ZipBuilder().Add("SoakPlugin.class", SoakPluginClass()).WriteTo(pluginJarPath);
+    
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main", {"a"}), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main", {"a"}), ErrorCode::SUCCESS);
+    EXPECT_EQ(jarLoader_->GetRecordedInvocationCount(), 1u);
+    
+    // 不同参数分别记录，超过上限时淘汰最旧的
+    for (size_t i = 0; i <= JarLoader::MAX_RECORDED_INVOCATIONS; ++i) {
+        ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main", {std::to_string(i)}), ErrorCode::SUCCESS);
+    }
+    EXPECT_EQ(jarLoader_->GetRecordedInvocationCount(), JarLoader::MAX_RECORDED_INVOCATIONS);
+    
+    ASSERT_EQ(jarLoader_->PrepareJar(pluginJarPath), ErrorCode::SUCCESS);
+    EXPECT_TRUE(jarLoader_->HasPreparedJar());
+    EXPECT_EQ(jarLoader_->GetGeneration(), 1u);
+    
+    // 默认不重放
+    WarmUpOptions options;
+    WarmUpResult result;
+    ASSERT_EQ(jarLoader_->WarmUpPreparedJar(options, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.invocationsReplayed, 0u);
+    
+    // 开启重放但没有白名单时也不重放
+    options.replayInvocations = true;
+    options.replayIterations = 3;
+    ASSERT_EQ(jarLoader_->WarmUpPreparedJar(options, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.invocationsReplayed, 0u);
+    
+    options.replayFilter = [](const std::string& className, const std::string&) { return className == "SoakPlugin"; };
+    ASSERT_EQ(jarLoader_->WarmUpPreparedJar(options, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.classesLoaded, 1u);
+    EXPECT_EQ(result.classesFailed, 0u);
+    EXPECT_EQ(result.classesInitialized, 1u);
+    EXPECT_EQ(result.preloadThreads, 1u);
+    EXPECT_EQ(result.invocationsReplayed, 3 * JarLoader::MAX_RECORDED_INVOCATIONS);
+    EXPECT_EQ(result.invocationsFailed, 0u);
+    
+    // 不在白名单中的调用不重放
+    options.replayFilter = [](const std::string&, const std::string& methodName) { return methodName != "main"; };
+    ASSERT_EQ(jarLoader_->WarmUpPreparedJar(options, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.invocationsReplayed, 0u);
+    
+    // 线程池停止后，下一次预热重新创建
+    jarLoader_->StopPreloader();
+    ASSERT_EQ(jarLoader_->WarmUpPreparedJar(options, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.classesLoaded, 1u);
+    
+    ASSERT_EQ(jarLoader_->CommitPreparedJar(), ErrorCode::SUCCESS);
+    EXPECT_FALSE(jarLoader_->HasPreparedJar());
+    EXPECT_EQ(jarLoader_->GetGeneration(), 2u);
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(pluginJarPath);
+}
+
+TEST_F(JarLoaderTest, InvocationPath_DefaultsToJni) {
+    EXPECT_EQ(jarLoader_->GetInvocationPath(), InvocationPath::JNI);
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 0u);
+    
+    jarLoader_->SetInvocationPath(InvocationPath::METHOD_HANDLE);
+    EXPECT_EQ(jarLoader_->GetInvocationPath(), InvocationPath::METHOD_HANDLE);
+}
+
+// MethodHandle调用器每代解析一次，切换类加载器时释放；无法解析的方法回退到JNI路径
+TEST_F(JarLoaderTest, MethodHandle_CachesInvokerPerGeneration) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring pluginJarPath = L"handle_plugin.jar";
+    ZipBuilder().Add("SoakPlugin.class", SoakPluginClass()).WriteTo(pluginJarPath);
+    jarLoader_->SetInvocationPath(InvocationPath::METHOD_HANDLE);
+    
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main", {"a", "b"}), ErrorCode::SUCCESS);
+    }
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 1u);
+    EXPECT_EQ(jarLoader_->GetRecordedInvocationCount(), 1u);
+    
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "missing"), ErrorCode::JAVA_METHOD_NOT_FOUND);
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 1u);
+    
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 0u);
+    ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 1u);
+    
+    jarLoader_->UnloadJar();
+    EXPECT_EQ(jarLoader_->GetCachedMethodHandleCount(), 0u);
+    std::filesystem::remove(pluginJarPath);
+}
+
+TEST_F(JarLoaderTest, StateHandoff_RequiresJVM) {
+    StateHandoffResult result;
+    EXPECT_EQ(jarLoader_->CaptureHandoffState("StatefulPlugin", result), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_EQ(jarLoader_->DeliverHandoffState("StatefulPlugin", result), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_FALSE(jarLoader_->HasHandoffState());
+}
+
+// 旧的一代onUnload返回的直接缓冲区原样交给新的一代的onLoad；没有生命周期方法的类不交接
+TEST_F(JarLoaderTest, StateHandoff_PassesBufferToNextGeneration) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring pluginJarPath = L"stateful_plugin.jar";
+    ZipBuilder()
+        .Add("StatefulPlugin.class", StatefulPluginClass())
+        .Add("SoakPlugin.class", SoakPluginClass())
+        .WriteTo(pluginJarPath);
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    
+    StateHandoffResult unloaded;
+    ASSERT_EQ(jarLoader_->CaptureHandoffState("StatefulPlugin", unloaded), ErrorCode::SUCCESS);
+    EXPECT_TRUE(unloaded.supported);
+    EXPECT_TRUE(unloaded.hasState);
+    EXPECT_TRUE(unloaded.direct);
+    EXPECT_EQ(unloaded.bytes, 16);
+    EXPECT_TRUE(jarLoader_->HasHandoffState());
+    
+    ASSERT_EQ(jarLoader_->LoadJar(pluginJarPath), ErrorCode::SUCCESS);
+    StateHandoffResult loaded;
+    ASSERT_EQ(jarLoader_->DeliverHandoffState("StatefulPlugin", loaded), ErrorCode::SUCCESS);
+    EXPECT_TRUE(loaded.supported);
+    EXPECT_TRUE(loaded.hasState);
+    EXPECT_EQ(loaded.bytes, 16);
+    EXPECT_FALSE(jarLoader_->HasHandoffState());
+    
+    StateHandoffResult none;
+    ASSERT_EQ(jarLoader_->CaptureHandoffState("SoakPlugin", none), ErrorCode::SUCCESS);
+    EXPECT_FALSE(none.supported);
+    EXPECT_FALSE(jarLoader_->HasHandoffState());
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(pluginJarPath);
+}
+
+TEST_F(JarLoaderTest, StandbyGeneration_RequiresJVM) {
+    EXPECT_EQ(jarLoader_->ConfirmCommittedJar(), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_EQ(jarLoader_->RollbackCommittedJar(), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_FALSE(jarLoader_->HasStandbyGeneration());
+    EXPECT_TRUE(jarLoader_->GetJarFingerprint().empty());
+}
+
+// 保留备用代切换后回滚：恢复上一代的代号、路径与指纹，已解析的类无需重新加载
+TEST_F(JarLoaderTest, StandbyGeneration_RollbackRestoresPreviousGeneration) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring goodJarPath = L"standby_good.jar";
+    const std::wstring badJarPath = L"standby_bad.jar";
+    ZipBuilder().Add("SoakPlugin.class", SoakPluginClass()).WriteTo(goodJarPath);
+    ZipBuilder()
+        .Add("SoakPlugin.class", SoakPluginClass())
+        .Add("StatefulPlugin.class", StatefulPluginClass())
+        .WriteTo(badJarPath);
+    
+    ASSERT_EQ(jarLoader_->LoadJar(goodJarPath), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    uint64_t goodGeneration = jarLoader_->GetGeneration();
+    std::string goodFingerprint = jarLoader_->GetJarFingerprint();
+    EXPECT_EQ(goodFingerprint.size(), 64u);
+    EXPECT_FALSE(jarLoader_->HasStandbyGeneration());
+    EXPECT_EQ(jarLoader_->RollbackCommittedJar(), ErrorCode::INVALID_PARAMETER);
+    
+    ASSERT_EQ(jarLoader_->PrepareJar(badJarPath), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CommitPreparedJar(true), ErrorCode::SUCCESS);
+    EXPECT_TRUE(jarLoader_->HasStandbyGeneration());
+    EXPECT_GT(jarLoader_->GetGeneration(), goodGeneration);
+    EXPECT_NE(jarLoader_->GetJarFingerprint(), goodFingerprint);
+    
+    ASSERT_EQ(jarLoader_->RollbackCommittedJar(), ErrorCode::SUCCESS);
+    EXPECT_FALSE(jarLoader_->HasStandbyGeneration());
+    EXPECT_EQ(jarLoader_->GetGeneration(), goodGeneration);
+    EXPECT_EQ(jarLoader_->GetCurrentJarPath(), goodJarPath);
+    EXPECT_EQ(jarLoader_->GetJarFingerprint(), goodFingerprint);
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    
+    // 确认后备用代退役，下一次切换的代号继续递增
+    ASSERT_EQ(jarLoader_->PrepareJar(badJarPath), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CommitPreparedJar(true), ErrorCode::SUCCESS);
+    EXPECT_GT(jarLoader_->GetGeneration(), goodGeneration + 1);
+    ASSERT_EQ(jarLoader_->ConfirmCommittedJar(), ErrorCode::SUCCESS);
+    EXPECT_FALSE(jarLoader_->HasStandbyGeneration());
+    EXPECT_EQ(jarLoader_->GetCurrentJarPath(), badJarPath);
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(goodJarPath);
+    std::filesystem::remove(badJarPath);
+}
+
+TEST_F(JarLoaderTest, Canary_RequiresJVM) {
+    EXPECT_EQ(jarLoader_->StartCanary(CanaryOptions()), ErrorCode::JVM_NOT_INITIALIZED);
+    EXPECT_EQ(jarLoader_->EvaluateCanary(true), CanaryVerdict::PENDING);
+    EXPECT_FALSE(jarLoader_->IsCanaryActive());
+}
+
+// 灰度期间按比例在两代间分配调用；新的一代缺少被调用的类时超出错误预算并回滚
+TEST_F(JarLoaderTest, Canary_RoutesSampledCallsAndRollsBackOnErrors) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    const std::wstring baselineJarPath = L"canary_baseline.jar";
+    const std::wstring canaryJarPath = L"canary_candidate.jar";
+    ZipBuilder()
+        .Add("SoakPlugin.class", SoakPluginClass())
+        .Add("StatefulPlugin.class", StatefulPluginClass())
+        .WriteTo(baselineJarPath);
+    ZipBuilder().Add("StatefulPlugin.class", StatefulPluginClass()).WriteTo(canaryJarPath);
+    
+    ASSERT_EQ(jarLoader_->LoadJar(baselineJarPath), ErrorCode::SUCCESS);
+    uint64_t baselineGeneration = jarLoader_->GetGeneration();
+    EXPECT_EQ(jarLoader_->StartCanary(CanaryOptions()), ErrorCode::INVALID_PARAMETER);
+    
+    ASSERT_EQ(jarLoader_->PrepareJar(canaryJarPath), ErrorCode::SUCCESS);
+    ASSERT_EQ(jarLoader_->CommitPreparedJar(true), ErrorCode::SUCCESS);
+    
+    CanaryOptions options;
+    options.fraction = 0.5;
+    options.minCalls = 2;
+    options.maxErrorRateDelta = 0.1;
+    // onFinished在锁外调用，可以读取JarLoader的状态
+    CanaryReport finished;
+    uint64_t generationAtFinish = 0;
+    options.onFinished = [this, &finished, &generationAtFinish](const CanaryReport& report) {
+        finished = report;
+        generationAtFinish = jarLoader_->GetGeneration();
+    };
+    ASSERT_EQ(jarLoader_->StartCanary(options), ErrorCode::SUCCESS);
+    EXPECT_TRUE(jarLoader_->IsCanaryActive());
+    
+    // 第1次调用由旧的一代执行，第2次路由到缺少SoakPlugin的新的一代
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::JAVA_CLASS_NOT_FOUND);
+    CanaryReport report = jarLoader_->GetCanaryReport();
+    EXPECT_EQ(report.baseline.calls, 1u);
+    EXPECT_EQ(report.canary.calls, 1u);
+    EXPECT_EQ(report.canary.errors, 1u);
+    
+    // 再一次路由到新的一代后达到minCalls，超出错误预算立即回滚
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::JAVA_CLASS_NOT_FOUND);
+    EXPECT_FALSE(jarLoader_->IsCanaryActive());
+    EXPECT_EQ(finished.verdict, CanaryVerdict::ROLLBACK);
+    EXPECT_EQ(finished.canary.errors, 2u);
+    EXPECT_EQ(generationAtFinish, baselineGeneration);
+    EXPECT_EQ(jarLoader_->GetGeneration(), baselineGeneration);
+    EXPECT_FALSE(jarLoader_->HasStandbyGeneration());
+    EXPECT_EQ(jarLoader_->CallJavaMethod("SoakPlugin", "main"), ErrorCode::SUCCESS);
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(baselineJarPath);
+    std::filesystem::remove(canaryJarPath);
+}
+
+// 灰度切换时两代不交接状态；入口方法失败回滚时也不能把失败的一代onUnload的状态交给仍在服务的旧一代
+TEST_F(JarLoaderTest, HotReload_CanaryEntryFailureSkipsHandoff) {
+    if (jarLoader_->InitializeJVM() != ErrorCode::SUCCESS) {
+        GTEST_SKIP() << "Java runtime not available";
+    }
+    
+    JNIEnv* env = jarLoader_->GetJNIEnv();
+    jclass systemClass = env->FindClass("java/lang/System");
+    jmethodID getProperty = env->GetStaticMethodID(systemClass, "getProperty", "(Ljava/lang/String;)Ljava/lang/String;");
+    jmethodID clearProperty = env->GetStaticMethodID(systemClass, "clearProperty", "(Ljava/lang/String;)Ljava/lang/String;");
+    jstring propertyName = env->NewStringUTF("HandoffProbe.onLoad");
+    env->DeleteLocalRef(env->CallStaticObjectMethod(systemClass, clearProperty, propertyName));
+    
+    const std::wstring sourcePath = L"handoff_probe.jar";
+    const std::wstring cacheDirectory = L"handoff_probe_versions";
+    std::filesystem::remove_all(cacheDirectory);
+    ZipBuilder().Add("HandoffProbe.class", HandoffProbeClass(false)).WriteTo(sourcePath);
+    
+    {
+        HotReloadManager manager(jarLoader_.get());
+        ASSERT_EQ(manager.EnableVersionCache(cacheDirectory, sourcePath), ErrorCode::SUCCESS);
+        manager.EnableCanary(CanaryOptions());
+        ASSERT_EQ(manager.LoadCurrentVersion(sourcePath), ErrorCode::SUCCESS);
+        uint64_t baselineGeneration = jarLoader_->GetGeneration();
+        uint64_t baselineVersion = manager.GetCurrentVersion();
+        
+        // 新版本的入口方法抛出异常；先写入再开始监控，只由ReloadNow触发重载
+        ZipBuilder().Add("HandoffProbe.class", HandoffProbeClass(true)).WriteTo(sourcePath);
+        ASSERT_EQ(manager.StartMonitoring(sourcePath, "HandoffProbe", "main"), ErrorCode::SUCCESS);
+        EXPECT_EQ(manager.ReloadNow(), ErrorCode::JAR_LOAD_FAILED);
+        manager.StopMonitoring();
+        
+        EXPECT_FALSE(jarLoader_->IsCanaryActive());
+        EXPECT_EQ(jarLoader_->GetGeneration(), baselineGeneration);
+        EXPECT_EQ(manager.GetCurrentVersion(), baselineVersion);
+        EXPECT_FALSE(jarLoader_->HasHandoffState());
+    }
+    
+    jobject onLoadCalled = env->CallStaticObjectMethod(systemClass, getProperty, propertyName);
+    EXPECT_EQ(onLoadCalled, nullptr);
+    env->DeleteLocalRef(onLoadCalled);
+    env->DeleteLocalRef(propertyName);
+    env->DeleteLocalRef(systemClass);
+    
+    jarLoader_->UnloadJar();
+    std::filesystem::remove(sourcePath);
+    for (const auto& file : std::filesystem::directory_iterator(cacheDirectory)) {
+        std::filesystem::permissions(file.path(), std::filesystem::perms::owner_write, std::filesystem::perm_options::add);
+    }
+    std::filesystem::remove_all(cacheDirectory);
+}
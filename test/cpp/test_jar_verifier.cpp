@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "../../src/include/jar_verifier.h"
+#include "../../src/include/common.h"
+#include "zip_test_utils.h"
+#include <filesystem>
+#include <fstream>
+
+class JarVerifierTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testJarPath_ = L"verifier_test.jar";
+        cachePath_ = L"verifier_test.cache";
+        trustedListPath_ = L"verifier_test.digests";
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove(testJarPath_);
+        std::filesystem::remove(cachePath_);
+        std::filesystem::remove(trustedListPath_);
+    }
+    
+    // 条目数足够多，使多线程路径实际生效
+    static ZipBuilder LargeJar() {
+        ZipBuilder builder;
+        builder.Add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n");
+        for (int i = 0; i < 500; ++i) {
+            builder.Add("com/example/Class" + std::to_string(i) + ".class",
+                        "\xCA\xFE\xBA\xBE body " + std::string(static_cast<size_t>(i % 37), 'x'));
+        }
+        return builder;
+    }
+    
+    std::wstring testJarPath_;
+    std::wstring cachePath_;
+    std::wstring trustedListPath_;
+};
+
+TEST_F(JarVerifierTest, Verify_DigestIndependentOfThreadCount) {
+    LargeJar().WriteTo(testJarPath_);
+    
+    JarVerifier singleThreaded;
+    singleThreaded.SetThreadCount(1);
+    JarVerificationResult first;
+    ASSERT_EQ(singleThreaded.Verify(testJarPath_, first), ErrorCode::SUCCESS);
+    
+    JarVerifier parallel;
+    parallel.SetThreadCount(4);
+    JarVerificationResult second;
+    ASSERT_EQ(parallel.Verify(testJarPath_, second), ErrorCode::SUCCESS);
+    
+    EXPECT_EQ(first.digest.size(), 64u);
+    EXPECT_EQ(first.digest, second.digest);
+    EXPECT_EQ(first.entryCount, 501u);
+    EXPECT_FALSE(first.fromCache);
+    EXPECT_FALSE(first.trusted);
+}
+
+TEST_F(JarVerifierTest, Verify_DigestChangesWithContent) {
+    ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE one").WriteTo(testJarPath_);
+    JarVerifier verifier;
+    JarVerificationResult first;
+    ASSERT_EQ(verifier.Verify(testJarPath_, first), ErrorCode::SUCCESS);
+    
+    ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE two").WriteTo(testJarPath_);
+    JarVerificationResult second;
+    ASSERT_EQ(verifier.Verify(testJarPath_, second), ErrorCode::SUCCESS);
+    EXPECT_NE(first.digest, second.digest);
+}
+
+TEST_F(JarVerifierTest, Verify_DetectsCorruptedStoredEntry) {
+    std::vector<uint8_t> data = ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE main").Build();
+    
+    // 第一个条目的数据紧跟在本地文件头（30字节）和名称之后
+    data[30 + 10 + 4] ^= 0xFF;
+    {
+        std::ofstream file(std::filesystem::path(testJarPath_), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    
+    JarVerifier verifier;
+    JarVerificationResult result;
+    EXPECT_EQ(verifier.Verify(testJarPath_, result), ErrorCode::JAR_INVALID_FORMAT);
+}
+
+TEST_F(JarVerifierTest, Verify_UsesPersistentCache) {
+    LargeJar().WriteTo(testJarPath_);
+    
+    JarVerificationResult first;
+    {
+        JarVerifier verifier;
+        ASSERT_EQ(verifier.OpenCache(cachePath_), ErrorCode::SUCCESS);
+        ASSERT_EQ(verifier.Verify(testJarPath_, first), ErrorCode::SUCCESS);
+        EXPECT_FALSE(first.fromCache);
+        EXPECT_EQ(verifier.GetCacheSize(), 1u);
+    }
+    
+    // 新实例从磁盘载入缓存，未变化的JAR不重新计算
+    JarVerifier verifier;
+    ASSERT_EQ(verifier.OpenCache(cachePath_), ErrorCode::SUCCESS);
+    EXPECT_EQ(verifier.GetCacheSize(), 1u);
+    
+    JarVerificationResult second;
+    ASSERT_EQ(verifier.Verify(testJarPath_, second), ErrorCode::SUCCESS);
+    EXPECT_TRUE(second.fromCache);
+    EXPECT_EQ(first.digest, second.digest);
+}
+
+TEST_F(JarVerifierTest, Verify_EnforcesTrustedDigests) {
+    LargeJar().WriteTo(testJarPath_);
+    
+    JarVerifier verifier;
+    JarVerificationResult result;
+    ASSERT_EQ(verifier.Verify(testJarPath_, result), ErrorCode::SUCCESS);
+    std::string digest = result.digest;
+    
+    verifier.AddTrustedDigest(std::string(64, '0'));
+    EXPECT_TRUE(verifier.HasTrustedDigests());
+    EXPECT_EQ(verifier.Verify(testJarPath_, result), ErrorCode::SECURITY_CHECK_FAILED);
+    EXPECT_FALSE(result.trusted);
+    
+    {
+        std::ofstream list{std::filesystem::path(trustedListPath_)};
+        list << "# release digests\n" << digest << "  verifier_test.jar\n";
+    }
+    ASSERT_EQ(verifier.LoadTrustedDigests(trustedListPath_), ErrorCode::SUCCESS);
+    EXPECT_EQ(verifier.Verify(testJarPath_, result), ErrorCode::SUCCESS);
+    EXPECT_TRUE(result.trusted);
+}
+
+TEST_F(JarVerifierTest, VerifySnapshot_ChecksContentReadOnce) {
+    ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE trusted").WriteTo(testJarPath_);
+    
+    JarVerifier verifier;
+    JarVerificationResult fromFile;
+    ASSERT_EQ(verifier.Verify(testJarPath_, fromFile), ErrorCode::SUCCESS);
+    verifier.AddTrustedDigest(fromFile.digest);
+    
+    JarArchive snapshot;
+    ASSERT_EQ(snapshot.OpenSnapshot(testJarPath_), ErrorCode::SUCCESS);
+    
+    // 快照之后来源被替换，校验的仍是快照中的内容
+    ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE replaced").WriteTo(testJarPath_);
+    JarVerificationResult result;
+    ASSERT_EQ(verifier.Verify(snapshot, result), ErrorCode::SUCCESS);
+    EXPECT_EQ(result.digest, fromFile.digest);
+    EXPECT_TRUE(result.trusted);
+    EXPECT_EQ(verifier.GetCacheSize(), 1u);
+    
+    EXPECT_EQ(verifier.Verify(testJarPath_, result), ErrorCode::SECURITY_CHECK_FAILED);
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include "../../src/include/jar_version_cache.h"
+#include "../../src/include/common.h"
+#include "zip_test_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+class JarVersionCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cacheDirectory_ = L"jar_version_cache_test";
+        sourcePath_ = L"version_source.jar";
+        std::filesystem::remove_all(cacheDirectory_);
+    }
+    
+    void TearDown() override {
+        // 版本副本是只读的，删除前先恢复写权限
+        if (std::filesystem::exists(cacheDirectory_)) {
+            for (const auto& file : std::filesystem::directory_iterator(cacheDirectory_)) {
+                std::filesystem::permissions(file.path(), std::filesystem::perms::owner_write,
+                                             std::filesystem::perm_options::add);
+            }
+        }
+        std::filesystem::remove_all(cacheDirectory_);
+        std::filesystem::remove(sourcePath_);
+    }
+    
+    // 写入来源JAR，并把修改时间推进generation秒以模拟一次重新构建
+    void WriteSource(int generation) {
+        ZipBuilder builder;
+        builder.Add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n")
+               .Add("Main.class", "\xCA\xFE\xBA\xBE generation " + std::to_string(generation));
+        builder.WriteTo(sourcePath_);
+        
+        auto writeTime = std::filesystem::last_write_time(sourcePath_);
+        std::filesystem::last_write_time(sourcePath_, writeTime + std::chrono::seconds(generation));
+    }
+    
+    static std::string ReadAll(const std::wstring& path) {
+        std::ifstream file(std::filesystem::path(path), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    
+    std::wstring cacheDirectory_;
+    std::wstring sourcePath_;
+};
+
+TEST_F(JarVersionCacheTest, AddVersion_RequiresOpenCache) {
+    JarVersionCache cache;
+    JarVersionInfo info;
+    EXPECT_FALSE(cache.IsOpen());
+    EXPECT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::INVALID_PARAMETER);
+}
+
+TEST_F(JarVersionCacheTest, AddVersion_CreatesCompleteCopy) {
+    WriteSource(1);
+    
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+    
+    JarVersionInfo info;
+    ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    EXPECT_EQ(info.version, 1u);
+    EXPECT_EQ(info.sourcePath, sourcePath_);
+    EXPECT_NE(info.path, sourcePath_);
+    EXPECT_EQ(ReadAll(info.path), ReadAll(sourcePath_));
+    EXPECT_EQ(info.size, std::filesystem::file_size(sourcePath_));
+    EXPECT_EQ(cache.GetTotalBytes(), info.size);
+}
+
+TEST_F(JarVersionCacheTest, AddVersion_UnchangedSourceReusesVersion) {
+    WriteSource(1);
+    
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+    
+    JarVersionInfo first;
+    JarVersionInfo second;
+    ASSERT_EQ(cache.AddVersion(sourcePath_, first), ErrorCode::SUCCESS);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, second), ErrorCode::SUCCESS);
+    EXPECT_EQ(first.version, second.version);
+    EXPECT_EQ(cache.GetVersions().size(), 1u);
+    
+    WriteSource(2);
+    JarVersionInfo third;
+    ASSERT_EQ(cache.AddVersion(sourcePath_, third), ErrorCode::SUCCESS);
+    EXPECT_EQ(third.version, 2u);
+    
+    // 旧版本的内容保持不变
+    EXPECT_NE(ReadAll(first.path), ReadAll(third.path));
+    EXPECT_EQ(ReadAll(third.path), ReadAll(sourcePath_));
+}
+
+TEST_F(JarVersionCacheTest, AddVersion_RejectsIncompleteJar) {
+    // 模拟构建工具写到一半的JAR
+    std::vector<uint8_t> complete = ZipBuilder().Add("Main.class", "\xCA\xFE\xBA\xBE").Build();
+    {
+        std::ofstream file(std::filesystem::path(sourcePath_), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(complete.data()), static_cast<std::streamsize>(complete.size() / 2));
+    }
+    
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+    
+    JarVersionInfo info;
+    EXPECT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::JAR_INVALID_FORMAT);
+    EXPECT_TRUE(cache.GetVersions().empty());
+    EXPECT_TRUE(std::filesystem::is_empty(cacheDirectory_));
+}
+
+TEST_F(JarVersionCacheTest, Evict_KeepsCurrentVersion) {
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_, 2), ErrorCode::SUCCESS);
+    
+    JarVersionInfo info;
+    WriteSource(1);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    cache.SetCurrentVersion(info.version);
+    
+    for (int generation = 2; generation <= 4; ++generation) {
+        WriteSource(generation);
+        ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    }
+    
+    // 当前版本1受保护，其余按LRU淘汰到上限
+    auto versions = cache.GetVersions();
+    ASSERT_EQ(versions.size(), 2u);
+    EXPECT_EQ(versions[0].version, 4u);
+    EXPECT_EQ(versions[1].version, 1u);
+    EXPECT_EQ(cache.GetCurrentVersion(), 1u);
+    
+    JarVersionInfo evicted;
+    EXPECT_FALSE(cache.GetVersion(2, evicted));
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(cacheDirectory_),
+                            std::filesystem::directory_iterator()), 2);
+}
+
+TEST_F(JarVersionCacheTest, Open_RegistersExistingVersions) {
+    {
+        JarVersionCache cache;
+        ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+        
+        JarVersionInfo info;
+        WriteSource(1);
+        ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+        WriteSource(2);
+        ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    }
+    
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+    ASSERT_EQ(cache.GetVersions().size(), 2u);
+    
+    // 新版本号接续已有版本
+    JarVersionInfo info;
+    WriteSource(3);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    EXPECT_EQ(info.version, 3u);
+}
+
+TEST_F(JarVersionCacheTest, Evict_KeepsNewVersionUntilItBecomesCurrent) {
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_, 1), ErrorCode::SUCCESS);
+    
+    JarVersionInfo first;
+    WriteSource(1);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, first), ErrorCode::SUCCESS);
+    cache.SetCurrentVersion(first.version);
+    
+    // 上限为1时新版本在切换前既不能淘汰自己，也不能淘汰当前版本
+    JarVersionInfo second;
+    WriteSource(2);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, second), ErrorCode::SUCCESS);
+    EXPECT_EQ(cache.Evict(), 0u);
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(second.path)));
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(first.path)));
+    EXPECT_EQ(cache.GetVersions().size(), 2u);
+    
+    // 切换后再创建版本时，上一个版本被淘汰
+    cache.SetCurrentVersion(second.version);
+    JarVersionInfo third;
+    WriteSource(3);
+    ASSERT_EQ(cache.AddVersion(sourcePath_, third), ErrorCode::SUCCESS);
+    EXPECT_FALSE(cache.GetVersion(first.version, first));
+    EXPECT_TRUE(cache.GetVersion(second.version, second));
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(third.path)));
+}
+
+TEST_F(JarVersionCacheTest, Open_IgnoresVersionsOfOtherJars) {
+    {
+        JarVersionCache cache;
+        ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_), ErrorCode::SUCCESS);
+        JarVersionInfo info;
+        WriteSource(1);
+        ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+    }
+    
+    // 共用目录中其他来源的副本与临时文件
+    const std::filesystem::path foreignVersion = std::filesystem::path(cacheDirectory_) / "other_plugin.v000007.jar";
+    const std::filesystem::path foreignTemp = std::filesystem::path(cacheDirectory_) / "other_plugin.v000008.jar.tmp";
+    std::ofstream(foreignVersion) << "foreign";
+    std::ofstream(foreignTemp) << "foreign";
+    
+    JarVersionCache cache;
+    ASSERT_EQ(cache.Open(cacheDirectory_, sourcePath_, 1), ErrorCode::SUCCESS);
+    auto versions = cache.GetVersions();
+    ASSERT_EQ(versions.size(), 1u);
+    EXPECT_EQ(versions[0].version, 1u);
+    
+    JarVersionInfo info;
+    for (int generation = 2; generation <= 3; ++generation) {
+        WriteSource(generation);
+        ASSERT_EQ(cache.AddVersion(sourcePath_, info), ErrorCode::SUCCESS);
+        cache.SetCurrentVersion(info.version);
+    }
+    EXPECT_EQ(info.version, 3u);
+    EXPECT_TRUE(std::filesystem::exists(foreignVersion));
+    EXPECT_TRUE(std::filesystem::exists(foreignTemp));
+    
+    EXPECT_EQ(cache.AddVersion(L"other_plugin.jar", info), ErrorCode::INVALID_PARAMETER);
+}
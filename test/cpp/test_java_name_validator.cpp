@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "../../src/include/java_name_validator.h"
+#include "../../src/include/common.h"
+#include <random>
+#include <regex>
+
+// 原先基于std::regex的实现，作为等价性测试的参照
+class RegexNameValidator {
+public:
+    RegexNameValidator()
+        : classNamePattern_(R"(^[a-zA-Z_$][a-zA-Z0-9_$]*(\.[a-zA-Z_$][a-zA-Z0-9_$]*)*$)"),
+          methodNamePattern_(R"(^[a-zA-Z_$][a-zA-Z0-9_$]*$)") {}
+    
+    bool ValidateClassName(const std::string& name) const {
+        return Validate(name, MAX_CLASS_NAME_LENGTH, classNamePattern_);
+    }
+    
+    bool ValidateMethodName(const std::string& name) const {
+        return Validate(name, MAX_METHOD_NAME_LENGTH, methodNamePattern_);
+    }
+
+private:
+    std::regex classNamePattern_;
+    std::regex methodNamePattern_;
+    
+    static bool Validate(const std::string& name, size_t maxLength, const std::regex& pattern) {
+        if (name.empty() || name.length() > maxLength) {
+            return false;
+        }
+        if (name.find_first_of(";<>|&$`\"'\\*?[]{}()") != std::string::npos) {
+            return false;
+        }
+        return std::regex_match(name, pattern);
+    }
+};
+
+class JavaNameValidatorTest : public ::testing::Test {
+protected:
+    void ExpectEquivalent(const std::string& name) {
+        bool classValid = JavaNameValidator::CheckClassName(name) == JavaNameValidator::Result::VALID;
+        bool methodValid = JavaNameValidator::CheckMethodName(name) == JavaNameValidator::Result::VALID;
+        ASSERT_EQ(classValid, reference_.ValidateClassName(name)) << "class name: " << testing::PrintToString(name);
+        ASSERT_EQ(methodValid, reference_.ValidateMethodName(name)) << "method name: " << testing::PrintToString(name);
+    }
+    
+    RegexNameValidator reference_;
+};
+
+TEST_F(JavaNameValidatorTest, Results) {
+    using Result = JavaNameValidator::Result;
+    EXPECT_EQ(JavaNameValidator::CheckClassName("com.example.Main"), Result::VALID);
+    EXPECT_EQ(JavaNameValidator::CheckClassName(""), Result::INVALID_LENGTH);
+    EXPECT_EQ(JavaNameValidator::CheckClassName(std::string(MAX_CLASS_NAME_LENGTH + 1, 'a')), Result::INVALID_LENGTH);
+    EXPECT_EQ(JavaNameValidator::CheckClassName("Outer$Inner"), Result::DANGEROUS_CHARS);
+    EXPECT_EQ(JavaNameValidator::CheckClassName("1bad;"), Result::DANGEROUS_CHARS);
+    EXPECT_EQ(JavaNameValidator::CheckClassName("com.example."), Result::INVALID_FORMAT);
+    EXPECT_EQ(JavaNameValidator::CheckClassName(".Main"), Result::INVALID_FORMAT);
+    EXPECT_EQ(JavaNameValidator::CheckMethodName("run"), Result::VALID);
+    EXPECT_EQ(JavaNameValidator::CheckMethodName("a.b"), Result::INVALID_FORMAT);
+    EXPECT_EQ(JavaNameValidator::CheckMethodName(std::string(MAX_METHOD_NAME_LENGTH + 1, 'a')), Result::INVALID_LENGTH);
+}
+
+TEST_F(JavaNameValidatorTest, EquivalentToRegex_AllOneAndTwoByteStrings) {
+    for (int first = 0; first < 256; ++first) {
+        ExpectEquivalent(std::string(1, static_cast<char>(first)));
+        for (int second = 0; second < 256; ++second) {
+            std::string name{static_cast<char>(first), static_cast<char>(second)};
+            ExpectEquivalent(name);
+        }
+    }
+}
+
+TEST_F(JavaNameValidatorTest, EquivalentToRegex_ShortStringsOverCharacterClasses) {
+    // 每个字符类别取代表字符（字母、数字、'_'、'$'、'.'、危险字符、空白、控制字符、非ASCII）
+    const std::string alphabet = std::string("aZ0_$.;- ") + '\0' + "\x80\xFF";
+    for (size_t length = 3; length <= 5; ++length) {
+        std::vector<size_t> digits(length, 0);
+        while (true) {
+            std::string name;
+            for (size_t digit : digits) {
+                name.push_back(alphabet[digit]);
+            }
+            ExpectEquivalent(name);
+            
+            size_t position = 0;
+            while (position < length && ++digits[position] == alphabet.size()) {
+                digits[position++] = 0;
+            }
+            if (position == length) {
+                break;
+            }
+        }
+    }
+}
+
+TEST_F(JavaNameValidatorTest, EquivalentToRegex_LengthBoundaries) {
+    for (size_t length : {MAX_METHOD_NAME_LENGTH - 1, MAX_METHOD_NAME_LENGTH, MAX_METHOD_NAME_LENGTH + 1,
+                          MAX_CLASS_NAME_LENGTH - 1, MAX_CLASS_NAME_LENGTH, MAX_CLASS_NAME_LENGTH + 1}) {
+        ExpectEquivalent(std::string(length, 'a'));
+        ExpectEquivalent("a" + std::string(length - 1, '.'));
+        
+        std::string dotted;
+        while (dotted.size() < length) {
+            dotted += dotted.empty() ? "a" : ".b";
+        }
+        ExpectEquivalent(dotted.substr(0, length));
+    }
+}
+
+TEST_F(JavaNameValidatorTest, EquivalentToRegex_RandomNames) {
+    std::mt19937 random(12345);
+    const std::string alphabet = "abcXYZ019_$..;()";
+    std::uniform_int_distribution<size_t> lengthDistribution(1, 40);
+    std::uniform_int_distribution<size_t> charDistribution(0, alphabet.size() - 1);
+    
+    for (int i = 0; i < 20000; ++i) {
+        std::string name(lengthDistribution(random), ' ');
+        for (auto& c : name) {
+            c = alphabet[charDistribution(random)];
+        }
+        ExpectEquivalent(name);
+    }
+}
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include "../../src/include/jvm_discovery.h"
+#include <filesystem>
+#include <fstream>
+
+// 按HotSpot的布局生成性能数据
+class PerfDataBuilder {
+public:
+    explicit PerfDataBuilder(bool bigEndian = false) : bigEndian_(bigEndian), accessible_(true) {}
+    
+    PerfDataBuilder& AddString(const std::string& name, const std::string& value) {
+        std::string data = value;
+        data.resize(value.size() + 8, '\0');   // 与HotSpot一样预留空间
+        entries_.push_back({name, 'B', static_cast<uint32_t>(data.size()), data});
+        return *this;
+    }
+    
+    PerfDataBuilder& AddLong(const std::string& name, int64_t value) {
+        std::string data(8, '\0');
+        for (int i = 0; i < 8; ++i) {
+            int shift = bigEndian_ ? (7 - i) * 8 : i * 8;
+            data[i] = static_cast<char>((static_cast<uint64_t>(value) >> shift) & 0xFF);
+        }
+        entries_.push_back({name, 'J', 0, data});
+        return *this;
+    }
+    
+    PerfDataBuilder& SetAccessible(bool accessible) {
+        accessible_ = accessible;
+        return *this;
+    }
+    
+    std::vector<uint8_t> Build() const {
+        std::vector<uint8_t> out;
+        Put32(out, PerfData::MAGIC, true);
+        out.push_back(bigEndian_ ? 0 : 1);
+        out.push_back(2);
+        out.push_back(0);
+        out.push_back(accessible_ ? 1 : 0);
+        Put32(out, 0, bigEndian_);                  // used，稍后回填
+        Put32(out, 0, bigEndian_);                  // overflow
+        Put32(out, 0, bigEndian_);                  // mod_time_stamp
+        Put32(out, 0, bigEndian_);
+        Put32(out, static_cast<uint32_t>(PerfData::PROLOGUE_SIZE), bigEndian_);
+        Put32(out, static_cast<uint32_t>(entries_.size()), bigEndian_);
+        
+        for (const auto& entry : entries_) {
+            uint32_t nameOffset = static_cast<uint32_t>(PerfData::ENTRY_HEADER_SIZE);
+            uint32_t dataOffset = static_cast<uint32_t>((nameOffset + entry.name.size() + 1 + 7) & ~size_t(7));
+            uint32_t length = static_cast<uint32_t>((dataOffset + entry.data.size() + 7) & ~size_t(7));
+            
+            size_t start = out.size();
+            Put32(out, length, bigEndian_);
+            Put32(out, nameOffset, bigEndian_);
+            Put32(out, entry.vectorLength, bigEndian_);
+            out.push_back(static_cast<uint8_t>(entry.type));
+            out.push_back(0);
+            out.push_back(entry.type == 'B' ? 5 : 1);
+            out.push_back(1);
+            Put32(out, dataOffset, bigEndian_);
+            out.insert(out.end(), entry.name.begin(), entry.name.end());
+            out.resize(start + dataOffset, 0);
+            out.insert(out.end(), entry.data.begin(), entry.data.end());
+            out.resize(start + length, 0);
+        }
+        
+        uint32_t used = static_cast<uint32_t>(out.size());
+        for (int i = 0; i < 4; ++i) {
+            out[8 + i] = static_cast<uint8_t>(bigEndian_ ? used >> ((3 - i) * 8) : used >> (i * 8));
+        }
+        out.resize(out.size() + 64, 0);
+        return out;
+    }
+    
+    // 典型JVM的计数器
+    static PerfDataBuilder Jvm(const std::string& javaCommand, int64_t startTime, bool bigEndian = false) {
+        PerfDataBuilder builder(bigEndian);
+        builder.AddLong("sun.os.hrt.frequency", 10000000)
+               .AddString("java.rt.vmArgs", "-Xmx512m -Dapp.mode=test")
+               .AddString("java.rt.vmFlags", "")
+               .AddString("sun.rt.javaCommand", javaCommand)
+               .AddLong("sun.rt.createVmBeginTime", startTime);
+        return builder;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        char type;
+        uint32_t vectorLength;
+        std::string data;
+    };
+    
+    static void Put32(std::vector<uint8_t>& out, uint32_t value, bool bigEndian) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<uint8_t>(bigEndian ? value >> ((3 - i) * 8) : value >> (i * 8)));
+        }
+    }
+    
+    bool bigEndian_;
+    bool accessible_;
+    std::vector<Entry> entries_;
+};
+
+class JvmDiscoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tempDirectory_ = L"jvm_discovery_test";
+        std::filesystem::remove_all(tempDirectory_);
+        std::filesystem::create_directories(std::filesystem::path(tempDirectory_) / "hsperfdata_alice");
+        std::filesystem::create_directories(std::filesystem::path(tempDirectory_) / "hsperfdata_bob");
+        std::filesystem::create_directories(std::filesystem::path(tempDirectory_) / "unrelated");
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(tempDirectory_);
+    }
+    
+    void WritePerfFile(const std::string& relativePath, const std::vector<uint8_t>& data) {
+        std::ofstream file(std::filesystem::path(tempDirectory_) / relativePath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    
+    std::wstring tempDirectory_;
+};
+
+TEST_F(JvmDiscoveryTest, PerfData_ParsesBothByteOrders) {
+    for (bool bigEndian : {false, true}) {
+        std::vector<uint8_t> data = PerfDataBuilder::Jvm("com.example.Server --port 8080", 1700000000000, bigEndian).Build();
+        
+        PerfData perfData;
+        ASSERT_EQ(perfData.Parse(data.data(), data.size()), ErrorCode::SUCCESS) << perfData.GetLastErrorMessage();
+        EXPECT_TRUE(perfData.IsAccessible());
+        EXPECT_EQ(perfData.GetEntryCount(), 5u);
+        
+        std::string command;
+        EXPECT_TRUE(perfData.GetString("sun.rt.javaCommand", command));
+        EXPECT_EQ(command, "com.example.Server --port 8080");
+        
+        int64_t frequency = 0;
+        EXPECT_TRUE(perfData.GetLong("sun.os.hrt.frequency", frequency));
+        EXPECT_EQ(frequency, 10000000);
+        
+        // 类型不符或不存在的计数器
+        EXPECT_FALSE(perfData.GetLong("sun.rt.javaCommand", frequency));
+        EXPECT_FALSE(perfData.GetString("sun.os.hrt.frequency", command));
+        EXPECT_FALSE(perfData.GetString("missing", command));
+    }
+}
+
+TEST_F(JvmDiscoveryTest, PerfData_RejectsMalformedData) {
+    std::vector<uint8_t> valid = PerfDataBuilder::Jvm("Main", 1).Build();
+    PerfData perfData;
+    
+    EXPECT_EQ(perfData.Parse(valid.data(), 16), ErrorCode::INVALID_PARAMETER);
+    
+    std::vector<uint8_t> badMagic = valid;
+    badMagic[0] = 0;
+    EXPECT_EQ(perfData.Parse(badMagic.data(), badMagic.size()), ErrorCode::INVALID_PARAMETER);
+    
+    std::vector<uint8_t> badVersion = valid;
+    badVersion[5] = 1;
+    EXPECT_EQ(perfData.Parse(badVersion.data(), badVersion.size()), ErrorCode::INVALID_PARAMETER);
+    
+    // 条目数超出文件
+    std::vector<uint8_t> tooManyEntries = valid;
+    tooManyEntries[28] = 0xFF;
+    tooManyEntries[29] = 0xFF;
+    EXPECT_EQ(perfData.Parse(tooManyEntries.data(), tooManyEntries.size()), ErrorCode::INVALID_PARAMETER);
+    
+    // 第一个条目的长度越界
+    std::vector<uint8_t> badLength = valid;
+    badLength[32 + 3] = 0x7F;
+    EXPECT_EQ(perfData.Parse(badLength.data(), badLength.size()), ErrorCode::INVALID_PARAMETER);
+    EXPECT_EQ(perfData.GetEntryCount(), 0u);
+    
+    // 任意截断都不能越界读取
+    for (size_t size = 0; size < valid.size(); ++size) {
+        std::vector<uint8_t> truncated(valid.begin(), valid.begin() + size);
+        perfData.Parse(truncated.data(), truncated.size());
+    }
+}
+
+TEST_F(JvmDiscoveryTest, ParsePerfData_ExtractsJvmInfo) {
+    std::vector<uint8_t> data = PerfDataBuilder::Jvm("com.example.Server --port 8080", 1700000000000).Build();
+    
+    JvmProcessInfo info;
+    ASSERT_EQ(JvmDiscovery::ParsePerfData(data.data(), data.size(), 1700000042000, info), ErrorCode::SUCCESS);
+    EXPECT_EQ(info.mainClass, "com.example.Server");
+    EXPECT_EQ(info.mainArgs, "--port 8080");
+    EXPECT_EQ(info.jvmArgs, "-Xmx512m -Dapp.mode=test");
+    EXPECT_EQ(info.startTimeMillis, 1700000000000);
+    EXPECT_EQ(info.uptimeMillis, 42000);
+    EXPECT_EQ(info.GetShortName(), "Server");
+    
+    // 尚未初始化完成的JVM
+    std::vector<uint8_t> starting = PerfDataBuilder::Jvm("Main", 1).SetAccessible(false).Build();
+    EXPECT_EQ(JvmDiscovery::ParsePerfData(starting.data(), starting.size(), 2, info), ErrorCode::PROCESS_ACCESS_DENIED);
+}
+
+TEST_F(JvmDiscoveryTest, MatchesMainClass) {
+    JvmProcessInfo server;
+    server.mainClass = "com.example.Server";
+    EXPECT_TRUE(JvmDiscovery::MatchesMainClass(server, "com.example.Server"));
+    EXPECT_TRUE(JvmDiscovery::MatchesMainClass(server, "Server"));
+    EXPECT_FALSE(JvmDiscovery::MatchesMainClass(server, "example.Server"));
+    EXPECT_FALSE(JvmDiscovery::MatchesMainClass(server, ""));
+    
+    JvmProcessInfo jar;
+    jar.mainClass = "C:\\apps\\billing.jar";
+    EXPECT_EQ(jar.GetShortName(), "billing.jar");
+    EXPECT_TRUE(JvmDiscovery::MatchesMainClass(jar, "billing.jar"));
+    EXPECT_TRUE(JvmDiscovery::MatchesMainClass(jar, "C:\\apps\\billing.jar"));
+}
+
+TEST_F(JvmDiscoveryTest, FindJvms_ScansAllUserDirectories) {
+    WritePerfFile("hsperfdata_alice/4242", PerfDataBuilder::Jvm("com.example.Server", 1000).Build());
+    WritePerfFile("hsperfdata_bob/17", PerfDataBuilder::Jvm("worker.jar -q", 2000).Build());
+    
+    // 非进程ID的文件名、损坏文件、未初始化的JVM与无关目录都被跳过
+    WritePerfFile("hsperfdata_bob/notes.txt", PerfDataBuilder::Jvm("Ignored", 1).Build());
+    WritePerfFile("hsperfdata_bob/99", std::vector<uint8_t>(100, 0xAB));
+    WritePerfFile("hsperfdata_alice/100", PerfDataBuilder::Jvm("Starting", 1).SetAccessible(false).Build());
+    WritePerfFile("unrelated/55", PerfDataBuilder::Jvm("Elsewhere", 1).Build());
+    
+    std::vector<JvmProcessInfo> jvms = JvmDiscovery::FindJvms(tempDirectory_);
+    ASSERT_EQ(jvms.size(), 2u);
+    EXPECT_EQ(jvms[0].processId, 17u);
+    EXPECT_EQ(jvms[0].mainClass, "worker.jar");
+    EXPECT_EQ(jvms[0].mainArgs, "-q");
+    EXPECT_EQ(jvms[1].processId, 4242u);
+    EXPECT_EQ(jvms[1].mainClass, "com.example.Server");
+    EXPECT_GT(jvms[1].uptimeMillis, 0);
+    
+    EXPECT_TRUE(JvmDiscovery::FindJvms(L"jvm_discovery_missing_directory").empty());
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "../../src/include/common.h"
+#include <fstream>
+#include <string>
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previousLevel_ = Logger::GetInstance().GetLogLevel();
+    }
+    
+    void TearDown() override {
+        Logger::GetInstance().SetLogLevel(previousLevel_);
+    }
+    
+    static bool LogFileContains(const std::wstring& marker) {
+        // 日志文件按UTF-8写入
+        std::ifstream logFile("test_log.txt");
+        std::string line;
+        std::string utf8Marker = WStringToString(marker);
+        while (std::getline(logFile, line)) {
+            if (line.find(utf8Marker) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    LogLevel previousLevel_;
+};
+
+TEST_F(LoggerTest, Submit_WritesRecordAfterFlush) {
+    const std::wstring marker = L"submit-marker-" + std::to_wstring(Platform::GetCurrentProcessId());
+    Logger::GetInstance().Submit(LogLevel::INFO, marker.c_str(), marker.length(), L"Prefix: ");
+    Logger::GetInstance().Flush();
+    
+    EXPECT_TRUE(LogFileContains(L"Prefix: " + marker));
+}
+
+TEST_F(LoggerTest, Submit_RespectsLogLevel) {
+    Logger::GetInstance().SetLogLevel(LogLevel::ERROR);
+    const std::wstring marker = L"filtered-marker-" + std::to_wstring(Platform::GetCurrentProcessId());
+    Logger::GetInstance().Submit(LogLevel::INFO, marker.c_str(), marker.length());
+    Logger::GetInstance().Flush();
+    
+    EXPECT_FALSE(LogFileContains(marker));
+}
+
+TEST_F(LoggerTest, Submit_PreservesOrderWithinBatch) {
+    for (int i = 0; i < 1000; ++i) {
+        std::wstring text = L"order-" + std::to_wstring(i);
+        Logger::GetInstance().Submit(LogLevel::INFO, text.c_str(), text.length());
+    }
+    Logger::GetInstance().Flush();
+    
+    std::ifstream logFile("test_log.txt");
+    std::string line;
+    int expected = 0;
+    while (std::getline(logFile, line) && expected < 1000) {
+        if (line.find("order-" + std::to_string(expected)) != std::string::npos) {
+            ++expected;
+        }
+    }
+    EXPECT_EQ(expected, 1000);
+}
+
+TEST_F(LoggerTest, Flush_WaitsForQueuedRecordsAfterDrops) {
+    // 队列满时被丢弃的记录不能让Flush提前返回
+    const std::wstring prefix = L"drop-" + std::to_wstring(Platform::GetCurrentProcessId()) + L"-";
+    uint64_t droppedAtStart = Logger::GetInstance().GetDroppedRecordCount();
+    std::wstring lastAccepted;
+    for (int i = 0; i < 2000000; ++i) {
+        std::wstring text = prefix + std::to_wstring(i) + L"-end";
+        uint64_t droppedBefore = Logger::GetInstance().GetDroppedRecordCount();
+        Logger::GetInstance().Submit(LogLevel::INFO, text.c_str(), text.length());
+        if (Logger::GetInstance().GetDroppedRecordCount() == droppedBefore) {
+            lastAccepted = text;
+        } else if (droppedBefore - droppedAtStart >= 200000) {
+            break;
+        }
+    }
+    Logger::GetInstance().Flush();
+    
+    // 只检查Flush返回时已写入的部分，输出线程之后追加的内容不算
+    std::ifstream logFile("test_log.txt", std::ios::binary | std::ios::ate);
+    std::streamoff flushedSize = logFile.tellg();
+    std::string flushed(static_cast<size_t>(flushedSize), '\0');
+    logFile.seekg(0);
+    logFile.read(&flushed[0], flushedSize);
+    EXPECT_NE(flushed.find(WStringToString(lastAccepted)), std::string::npos);
+}
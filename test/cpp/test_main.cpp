@@ -1,5 +1,4 @@
 #include <gtest/gtest.h>
-#include <windows.h>
 #include "../../src/include/common.h"
 
 // 初始化测试环境
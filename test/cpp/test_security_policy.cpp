@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "../../src/include/security_policy.h"
+#include "../../src/include/security_utils.h"
+#include "../../src/include/file_watcher.h"
+#include "../../src/include/common.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+// 内置的系统关键进程之一
+#ifdef _WIN32
+static const wchar_t BUILT_IN_CRITICAL_PROCESS[] = L"csrss.exe";
+#else
+static const wchar_t BUILT_IN_CRITICAL_PROCESS[] = L"systemd";
+#endif
+
+class SecurityPolicyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        policyPath_ = L"security_policy_test.policy";
+    }
+    
+    void TearDown() override {
+        // 恢复为内置规则
+        WritePolicy("");
+        SecurityUtils::LoadSecurityPolicy(policyPath_);
+        std::filesystem::remove(policyPath_);
+    }
+    
+    void WritePolicy(const std::string& content) {
+        std::ofstream file{std::filesystem::path(policyPath_)};
+        file << content;
+    }
+    
+    // 原先的实现：逐个模式转换大小写后查找
+    static bool NaiveMatches(const std::vector<std::wstring>& patterns, const std::wstring& text) {
+        std::wstring upperText = text;
+        std::transform(upperText.begin(), upperText.end(), upperText.begin(), ::towupper);
+        for (const auto& pattern : patterns) {
+            std::wstring upperPattern = pattern;
+            std::transform(upperPattern.begin(), upperPattern.end(), upperPattern.begin(), ::towupper);
+            if (!upperPattern.empty() && upperText.find(upperPattern) != std::wstring::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    std::wstring policyPath_;
+};
+
+TEST_F(SecurityPolicyTest, PatternMatcher_OverlappingPatterns) {
+    PatternMatcher matcher;
+    matcher.Build({L"he", L"SHE", L"his", L"hers"});
+    
+    EXPECT_EQ(matcher.GetPatternCount(), 4u);
+    EXPECT_TRUE(matcher.Matches(L"uSHers"));
+    EXPECT_TRUE(matcher.Matches(L"xxhixhis"));
+    EXPECT_TRUE(matcher.Matches(L"sHe"));
+    EXPECT_FALSE(matcher.Matches(L"hi sh"));
+    EXPECT_FALSE(matcher.Matches(L""));
+    
+    PatternMatcher empty;
+    EXPECT_FALSE(empty.Matches(L"anything"));
+}
+
+TEST_F(SecurityPolicyTest, PatternMatcher_EquivalentToNaiveSearch) {
+    const std::vector<std::wstring> patterns = {
+        L"\\Windows\\System32\\", L"\\Windows\\SysWOW64\\", L"\\Windows\\WinSxS\\",
+        L"\\Program Files\\Windows Defender\\", L"\\$Recycle.Bin\\", L"ab", L"bab", L"abab"
+    };
+    PatternMatcher matcher;
+    matcher.Build(patterns);
+    
+    std::mt19937 random(2024);
+    const std::wstring alphabet = L"abAB\\WwINnDdOoSs32$";
+    std::uniform_int_distribution<size_t> lengthDistribution(0, 30);
+    std::uniform_int_distribution<size_t> charDistribution(0, alphabet.size() - 1);
+    for (int i = 0; i < 20000; ++i) {
+        std::wstring text(lengthDistribution(random), L' ');
+        for (auto& c : text) {
+            c = alphabet[charDistribution(random)];
+        }
+        ASSERT_EQ(matcher.Matches(text), NaiveMatches(patterns, text)) << WStringToString(text);
+    }
+    
+    for (const auto& pattern : patterns) {
+        EXPECT_TRUE(matcher.Matches(L"C:" + pattern + L"x.jar"));
+    }
+    EXPECT_TRUE(matcher.Matches(L"C:\\WINDOWS\\system32\\evil.dll"));
+    EXPECT_FALSE(matcher.Matches(L"C:\\Windows\\System\\x.dll"));
+}
+
+TEST_F(SecurityPolicyTest, ExactNameSet_CaseInsensitiveLookup) {
+    ExactNameSet names;
+    names.Build({L"csrss.exe", L"LSASS.EXE", L"lsass.exe", L"system", L""});
+    
+    EXPECT_EQ(names.GetNameCount(), 3u);
+    EXPECT_TRUE(names.Contains(L"CSRSS.exe"));
+    EXPECT_TRUE(names.Contains(L"lsass.exe"));
+    EXPECT_TRUE(names.Contains(L"System"));
+    EXPECT_FALSE(names.Contains(L"system.exe"));
+    EXPECT_FALSE(names.Contains(L"csrss"));
+    EXPECT_FALSE(names.Contains(L""));
+    
+    ExactNameSet empty;
+    EXPECT_FALSE(empty.Contains(L"csrss.exe"));
+}
+
+TEST_F(SecurityPolicyTest, ExactNameSet_ManyNames) {
+    std::vector<std::wstring> list;
+    for (int i = 0; i < 500; ++i) {
+        list.push_back(L"process" + std::to_wstring(i) + L".exe");
+    }
+    ExactNameSet names;
+    names.Build(list);
+    
+    for (const auto& name : list) {
+        EXPECT_TRUE(names.Contains(name));
+    }
+    EXPECT_FALSE(names.Contains(L"process500.exe"));
+}
+
+TEST_F(SecurityPolicyTest, CompiledImage_AttachValidatesLayout) {
+    const std::vector<std::wstring> patterns = {L"\\Windows\\System32\\", L"\\Secrets\\"};
+    std::vector<uint32_t> image = PatternMatcher::Compile(patterns);
+    
+    PatternMatcher matcher;
+    ASSERT_TRUE(matcher.Attach(image.data(), image.size()));
+    EXPECT_EQ(matcher.GetPatternCount(), 2u);
+    EXPECT_TRUE(matcher.Matches(L"D:\\SECRETS\\key.jar"));
+    EXPECT_FALSE(matcher.Matches(L"D:\\Public\\key.jar"));
+    
+    // 截断或越界的映像被拒绝，原视图保持不变
+    EXPECT_FALSE(matcher.Attach(image.data(), image.size() - 1));
+    std::vector<uint32_t> corrupted = image;
+    corrupted.back() = 0x7FFFFFFF;
+    EXPECT_FALSE(matcher.Attach(corrupted.data(), corrupted.size()));
+    EXPECT_TRUE(matcher.Matches(L"C:\\Windows\\System32\\x.dll"));
+    
+    std::vector<uint32_t> names = ExactNameSet::Compile({L"guard.exe", L"csrss.exe"});
+    ExactNameSet set;
+    ASSERT_TRUE(set.Attach(names.data(), names.size()));
+    EXPECT_TRUE(set.Contains(L"GUARD.exe"));
+    names[4] = 0xFFFF;
+    EXPECT_FALSE(set.Attach(names.data(), names.size()));
+}
+
+TEST_F(SecurityPolicyTest, CompiledPolicy_IsMappedReadOnly) {
+    std::unique_ptr<SecurityPolicy> policy = SecurityPolicy::Compile({L"\\Secrets\\"}, {L"guard.exe"});
+    ASSERT_TRUE(policy);
+    EXPECT_TRUE(policy->IsMapped());
+    EXPECT_GT(policy->GetImageSize(), 0u);
+    EXPECT_TRUE(policy->MatchesForbiddenPath(L"C:\\secrets\\a.jar"));
+    EXPECT_TRUE(policy->IsCriticalProcess(L"Guard.exe"));
+    EXPECT_FALSE(policy->IsCriticalProcess(L"csrss.exe"));
+}
+
+TEST_F(SecurityPolicyTest, ParseFile_AppendsRules) {
+    WritePolicy("# extra rules\r\n"
+                "[forbidden_paths]\r\n"
+                "  \\Secrets\\  \r\n"
+                "\n"
+                "[critical_processes]\n"
+                "guard.exe\n");
+    
+    std::vector<std::wstring> paths = {L"\\Windows\\Fonts\\"};
+    std::vector<std::wstring> processes;
+    ASSERT_EQ(SecurityPolicy::ParseFile(policyPath_, paths, processes), ErrorCode::SUCCESS);
+    EXPECT_EQ(paths, (std::vector<std::wstring>{L"\\Windows\\Fonts\\", L"\\Secrets\\"}));
+    EXPECT_EQ(processes, (std::vector<std::wstring>{L"guard.exe"}));
+}
+
+TEST_F(SecurityPolicyTest, ParseFile_RejectsInvalidFiles) {
+    std::vector<std::wstring> paths;
+    std::vector<std::wstring> processes;
+    EXPECT_EQ(SecurityPolicy::ParseFile(L"missing.policy", paths, processes), ErrorCode::INVALID_PARAMETER);
+    
+    WritePolicy("guard.exe\n");
+    EXPECT_EQ(SecurityPolicy::ParseFile(policyPath_, paths, processes), ErrorCode::INVALID_PARAMETER);
+    
+    WritePolicy("[unknown]\nguard.exe\n");
+    EXPECT_EQ(SecurityPolicy::ParseFile(policyPath_, paths, processes), ErrorCode::INVALID_PARAMETER);
+    EXPECT_TRUE(paths.empty());
+    EXPECT_TRUE(processes.empty());
+}
+
+TEST_F(SecurityPolicyTest, SecurityUtils_LoadSecurityPolicyExtendsBuiltInRules) {
+    EXPECT_FALSE(SecurityUtils::IsSystemCriticalProcess(L"guard.exe"));
+    
+    WritePolicy("[critical_processes]\nguard.exe\n");
+    ASSERT_EQ(SecurityUtils::LoadSecurityPolicy(policyPath_), ErrorCode::SUCCESS);
+    EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(L"GUARD.EXE"));
+    EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(BUILT_IN_CRITICAL_PROCESS));
+    EXPECT_FALSE(SecurityUtils::ValidateProcessName(L"guard.exe"));
+    
+    // 无效的策略文件不影响当前策略
+    WritePolicy("[critical_processes\n");
+    EXPECT_EQ(SecurityUtils::LoadSecurityPolicy(policyPath_), ErrorCode::INVALID_PARAMETER);
+    EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(L"guard.exe"));
+}
+
+TEST_F(SecurityPolicyTest, SecurityUtils_PolicyChangeInvalidatesPathCache) {
+    std::wstring jarPath = L"policy_test.jar";
+    std::ofstream(std::filesystem::path(jarPath)) << "dummy jar content";
+    ASSERT_TRUE(SecurityUtils::ValidateJarPath(jarPath));
+    
+    WritePolicy("[forbidden_paths]\npolicy_test\n");
+    ASSERT_EQ(SecurityUtils::LoadSecurityPolicy(policyPath_), ErrorCode::SUCCESS);
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(jarPath));
+    
+    std::filesystem::remove(jarPath);
+}
+
+TEST_F(SecurityPolicyTest, SecurityUtils_ReadersSeeConsistentPolicyDuringSwap) {
+    // 替换过程中，内置规则始终有效
+    std::atomic<bool> stop(false);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&stop, &failures]() {
+            while (!stop) {
+                if (!SecurityUtils::IsSystemCriticalProcess(BUILT_IN_CRITICAL_PROCESS)) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    
+    for (int i = 0; i < 50; ++i) {
+        WritePolicy(i % 2 == 0 ? "[critical_processes]\nguard.exe\n" : "[forbidden_paths]\n\\Secrets\\\n");
+        ASSERT_EQ(SecurityUtils::LoadSecurityPolicy(policyPath_), ErrorCode::SUCCESS);
+        EXPECT_EQ(SecurityUtils::IsSystemCriticalProcess(L"guard.exe"), i % 2 == 0);
+    }
+    
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(SecurityPolicyTest, SecurityUtils_PolicyFileChangeAppliedByWatcher) {
+    WritePolicy("[critical_processes]\nguard.exe\n");
+    ASSERT_EQ(SecurityUtils::LoadSecurityPolicy(policyPath_), ErrorCode::SUCCESS);
+    
+    FileWatcher watcher;
+    std::wstring policyPath = policyPath_;
+    ASSERT_EQ(watcher.Start(policyPath_, [policyPath]() {
+        SecurityUtils::LoadSecurityPolicy(policyPath);
+    }, 10, 10), ErrorCode::SUCCESS);
+    
+    auto modifyTime = std::filesystem::last_write_time(std::filesystem::path(policyPath_));
+    WritePolicy("[critical_processes]\nwatchdog.exe\n");
+    std::filesystem::last_write_time(std::filesystem::path(policyPath_), modifyTime + std::chrono::seconds(2));
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!SecurityUtils::IsSystemCriticalProcess(L"watchdog.exe") && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(L"watchdog.exe"));
+    EXPECT_FALSE(SecurityUtils::IsSystemCriticalProcess(L"guard.exe"));
+    watcher.Stop();
+}
@@ -8,23 +8,28 @@ class SecurityUtilsTest : public ::testing::Test {
 protected:
     void SetUp() override {
         // 创建测试文件
+#ifdef _WIN32
         testDllPath_ = L"test_dll.dll";
+#else
+        testDllPath_ = L"test_dll.so";
+#endif
         testJarPath_ = L"test_jar.jar";
         
         // 创建临时测试文件
-        std::ofstream dllFile(testDllPath_);
+        std::ofstream dllFile(Platform::ToFilesystemPath(testDllPath_));
         dllFile << "dummy dll content";
         dllFile.close();
         
-        std::ofstream jarFile(testJarPath_);
+        std::ofstream jarFile(Platform::ToFilesystemPath(testJarPath_));
         jarFile << "dummy jar content";
         jarFile.close();
     }
     
     void TearDown() override {
         // 清理测试文件
-        std::filesystem::remove(testDllPath_);
-        std::filesystem::remove(testJarPath_);
+        std::filesystem::remove(Platform::ToFilesystemPath(testDllPath_));
+        std::filesystem::remove(Platform::ToFilesystemPath(testJarPath_));
+        SecurityUtils::ClearJarPathCache();
     }
     
     std::wstring testDllPath_;
@@ -55,6 +60,50 @@ TEST_F(SecurityUtilsTest, ValidateJarPath_EmptyPath) {
     EXPECT_FALSE(SecurityUtils::ValidateJarPath(L""));
 }
 
+TEST_F(SecurityUtilsTest, ValidateJarPath_CachesValidatedPath) {
+    ASSERT_TRUE(SecurityUtils::ValidateJarPath(testJarPath_));
+    EXPECT_TRUE(SecurityUtils::ValidateJarPath(testJarPath_));
+    
+    // 命中缓存时仍比较文件标识，文件被删除后不再通过
+    std::filesystem::remove(Platform::ToFilesystemPath(testJarPath_));
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(testJarPath_));
+}
+
+#ifdef _WIN32
+TEST_F(SecurityUtilsTest, ValidateJarPath_EquivalentPathsRecheckIdentity) {
+    std::wstring upperCasePath = L"TEST_JAR.JAR";
+    ASSERT_TRUE(SecurityUtils::ValidateJarPath(testJarPath_));
+    EXPECT_TRUE(SecurityUtils::ValidateJarPath(upperCasePath));
+    
+    // 大小写不同的路径共享同一缓存项，命中时同样比较文件标识
+    std::filesystem::remove(testJarPath_);
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(upperCasePath));
+    
+    SecurityUtils::InvalidateJarPathCache(upperCasePath);
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(testJarPath_));
+}
+#else
+TEST_F(SecurityUtilsTest, ValidateJarPath_CaseDistinctPathsAreSeparate) {
+    // 文件系统区分大小写，大小写不同的路径是另一个（不存在的）文件
+    ASSERT_TRUE(SecurityUtils::ValidateJarPath(testJarPath_));
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(L"TEST_JAR.JAR"));
+    
+    // 等价的路径写法共享同一缓存项，命中时同样比较文件标识
+    std::wstring equivalentPath = L"./" + testJarPath_;
+    EXPECT_TRUE(SecurityUtils::ValidateJarPath(equivalentPath));
+    std::filesystem::remove(Platform::ToFilesystemPath(testJarPath_));
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(equivalentPath));
+}
+#endif
+
+TEST_F(SecurityUtilsTest, ValidateJarPath_FailuresAreNotCached) {
+    EXPECT_FALSE(SecurityUtils::ValidateJarPath(L"late_jar.jar"));
+    
+    std::ofstream(Platform::ToFilesystemPath(L"late_jar.jar")) << "dummy jar content";
+    EXPECT_TRUE(SecurityUtils::ValidateJarPath(L"late_jar.jar"));
+    std::filesystem::remove(Platform::ToFilesystemPath(L"late_jar.jar"));
+}
+
 TEST_F(SecurityUtilsTest, ValidateProcessName_ValidName) {
     EXPECT_TRUE(SecurityUtils::ValidateProcessName(L"notepad.exe"));
     EXPECT_TRUE(SecurityUtils::ValidateProcessName(L"test_process.exe"));
@@ -89,17 +138,21 @@ TEST_F(SecurityUtilsTest, ValidateMethodName_InvalidName) {
 }
 
 TEST_F(SecurityUtilsTest, IsSystemCriticalProcess_KnownSystemProcess) {
+#ifdef _WIN32
     EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(4)); // System process
+#else
+    EXPECT_TRUE(SecurityUtils::IsSystemCriticalProcess(1)); // init
+#endif
 }
 
 TEST_F(SecurityUtilsTest, IsSystemCriticalProcess_RegularProcess) {
-    DWORD currentPid = GetCurrentProcessId();
+    uint32_t currentPid = Platform::GetCurrentProcessId();
     EXPECT_FALSE(SecurityUtils::IsSystemCriticalProcess(currentPid));
 }
 
-TEST_F(SecurityUtilsTest, IsRunningAsAdmin) {
+TEST_F(SecurityUtilsTest, HasSufficientPrivileges) {
     // 这个测试的结果取决于当前进程的权限
-    bool isAdmin = SecurityUtils::IsRunningAsAdmin();
+    bool privileged = SecurityUtils::HasSufficientPrivileges();
     // 只验证函数不会崩溃，不验证具体结果
-    EXPECT_TRUE(isAdmin || !isAdmin);
+    EXPECT_TRUE(privileged || !privileged);
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "../../src/include/shared_ring_buffer.h"
+#include "../../src/include/common.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+class SharedRingBufferTest : public ::testing::Test {
+protected:
+    static std::string ReadOne(SharedRingBuffer& ring, uint32_t& type) {
+        std::string result;
+        bool ok = ring.TryRead([&](uint32_t t, const uint8_t* data, uint32_t length) {
+            type = t;
+            result.assign(reinterpret_cast<const char*>(data), length);
+        });
+        EXPECT_TRUE(ok);
+        return result;
+    }
+};
+
+TEST_F(SharedRingBufferTest, Constructor_RoundsCapacityToPowerOfTwo) {
+    SharedRingBuffer ring(5000);
+    ASSERT_TRUE(ring.IsValid());
+    EXPECT_EQ(ring.GetCapacity(), 8192u);
+    EXPECT_EQ(ring.GetMemorySize(), SharedRingBuffer::HEADER_SIZE + 8192u);
+}
+
+TEST_F(SharedRingBufferTest, WriteAndRead_SingleRecord) {
+    SharedRingBuffer ring(4096);
+    const std::string payload = "hello ring";
+    ASSERT_TRUE(ring.TryWrite(3, payload.data(), static_cast<uint32_t>(payload.size())));
+    
+    uint32_t type = 0;
+    EXPECT_EQ(ReadOne(ring, type), payload);
+    EXPECT_EQ(type, 3u);
+    EXPECT_EQ(ring.GetUsedBytes(), 0u);
+}
+
+TEST_F(SharedRingBufferTest, TryRead_EmptyReturnsFalse) {
+    SharedRingBuffer ring(4096);
+    EXPECT_FALSE(ring.TryRead([](uint32_t, const uint8_t*, uint32_t) {}));
+}
+
+TEST_F(SharedRingBufferTest, TryWrite_RejectsOversizedRecord) {
+    SharedRingBuffer ring(4096);
+    std::vector<char> payload(ring.GetMaxPayload() + 1, 'x');
+    EXPECT_FALSE(ring.TryWrite(1, payload.data(), static_cast<uint32_t>(payload.size())));
+}
+
+TEST_F(SharedRingBufferTest, TryWrite_FailsWhenFull) {
+    SharedRingBuffer ring(4096);
+    std::vector<char> payload(1000, 'x');
+    int written = 0;
+    while (ring.TryWrite(1, payload.data(), static_cast<uint32_t>(payload.size()))) {
+        ++written;
+    }
+    EXPECT_EQ(written, 4);
+}
+
+TEST_F(SharedRingBufferTest, WrapAround_PreservesRecordOrder) {
+    SharedRingBuffer ring(4096);
+    std::vector<char> payload(900, 'a');
+    
+    // 反复写读，使记录跨越数据区末尾
+    for (int round = 0; round < 50; ++round) {
+        payload[0] = static_cast<char>('a' + round % 26);
+        ASSERT_TRUE(ring.TryWrite(1, payload.data(), static_cast<uint32_t>(payload.size())));
+        ASSERT_TRUE(ring.TryWrite(2, payload.data(), static_cast<uint32_t>(payload.size())));
+        
+        uint32_t type = 0;
+        std::string first = ReadOne(ring, type);
+        EXPECT_EQ(type, 1u);
+        EXPECT_EQ(first[0], payload[0]);
+        std::string second = ReadOne(ring, type);
+        EXPECT_EQ(type, 2u);
+        EXPECT_EQ(second.size(), payload.size());
+    }
+}
+
+TEST_F(SharedRingBufferTest, Concurrent_ProducerConsumer) {
+    SharedRingBuffer ring(64 * 1024);
+    const uint64_t recordCount = 200000;
+    
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < recordCount; ++i) {
+            while (!ring.TryWrite(1, &i, sizeof(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    
+    uint64_t expected = 0;
+    bool ordered = true;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (expected < recordCount) {
+        ring.Drain([&](uint32_t, const uint8_t* data, uint32_t length) {
+            uint64_t value = 0;
+            memcpy(&value, data, sizeof(value));
+            ordered = ordered && length == sizeof(value) && value == expected;
+            ++expected;
+        });
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    producer.join();
+    
+    EXPECT_TRUE(ordered);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    LOG_INFO(L"Ring buffer throughput: " << (recordCount * 1000000.0 / std::max<long long>(1, micros)) << L" records/s");
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "../../src/include/snapshot_class_loader.h"
+#include "zip_test_utils.h"
+#include <filesystem>
+
+class SnapshotRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testJarPath_ = L"snapshot_test.jar";
+        ZipBuilder builder;
+        builder.Add("com/example/App.class", "\xCA\xFE\xBA\xBE app")
+               .Add("com/example/", "")
+               .Add("config.properties", "key=value");
+        builder.WriteTo(testJarPath_);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove(testJarPath_);
+    }
+    
+    std::wstring testJarPath_;
+};
+
+TEST_F(SnapshotRegistryTest, Register_RejectsUnopenedArchive) {
+    EXPECT_EQ(SnapshotRegistry::GetInstance().Register(nullptr), 0);
+    EXPECT_EQ(SnapshotRegistry::GetInstance().Register(std::make_unique<JarArchive>()), 0);
+}
+
+TEST_F(SnapshotRegistryTest, FindEntry_ServesSnapshotBytes) {
+    auto archive = std::make_unique<JarArchive>();
+    ASSERT_EQ(archive->OpenSnapshot(testJarPath_), ErrorCode::SUCCESS);
+    
+    SnapshotRegistry& registry = SnapshotRegistry::GetInstance();
+    size_t countBefore = registry.GetSnapshotCount();
+    jlong handle = registry.Register(std::move(archive));
+    ASSERT_NE(handle, 0);
+    EXPECT_EQ(registry.GetSnapshotCount(), countBefore + 1);
+    
+    const JarEntry* entry = nullptr;
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+    ASSERT_TRUE(registry.FindEntry(handle, "com/example/App.class", entry, data, size));
+    EXPECT_EQ(entry->method, JarArchive::METHOD_STORED);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), size), "\xCA\xFE\xBA\xBE app");
+    
+    // 目录条目与不存在的条目都不返回
+    EXPECT_FALSE(registry.FindEntry(handle, "com/example/", entry, data, size));
+    EXPECT_FALSE(registry.FindEntry(handle, "com/example/Missing.class", entry, data, size));
+    
+    registry.Release(handle);
+    EXPECT_EQ(registry.GetSnapshotCount(), countBefore);
+    EXPECT_FALSE(registry.FindEntry(handle, "com/example/App.class", entry, data, size));
+}
+
+TEST_F(SnapshotRegistryTest, HandlesAreNotReused) {
+    SnapshotRegistry& registry = SnapshotRegistry::GetInstance();
+    
+    auto first = std::make_unique<JarArchive>();
+    ASSERT_EQ(first->OpenSnapshot(testJarPath_), ErrorCode::SUCCESS);
+    jlong firstHandle = registry.Register(std::move(first));
+    registry.Release(firstHandle);
+    
+    auto second = std::make_unique<JarArchive>();
+    ASSERT_EQ(second->OpenSnapshot(testJarPath_), ErrorCode::SUCCESS);
+    jlong secondHandle = registry.Register(std::move(second));
+    EXPECT_NE(firstHandle, secondHandle);
+    registry.Release(secondHandle);
+    
+    // 重复释放被忽略
+    registry.Release(secondHandle);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// 测试用的最小ZIP构造器：只生成带CRC32的STORED条目，可选ZIP64结束记录
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ZipBuilder {
+public:
+    ZipBuilder& Add(const std::string& name, const std::string& content) {
+        entries_.emplace_back(name, content);
+        return *this;
+    }
+    
+    std::vector<uint8_t> Build(bool zip64 = false) const {
+        std::vector<uint8_t> out;
+        std::vector<uint32_t> offsets;
+        
+        for (const auto& entry : entries_) {
+            offsets.push_back(static_cast<uint32_t>(out.size()));
+            Put32(out, 0x04034b50);
+            Put16(out, 20); Put16(out, 0); Put16(out, 0);   // version, flags, method
+            Put16(out, 0); Put16(out, 0);                   // time, date
+            Put32(out, Crc32(entry.second));
+            Put32(out, static_cast<uint32_t>(entry.second.size()));
+            Put32(out, static_cast<uint32_t>(entry.second.size()));
+            Put16(out, static_cast<uint16_t>(entry.first.size())); Put16(out, 0);
+            out.insert(out.end(), entry.first.begin(), entry.first.end());
+            out.insert(out.end(), entry.second.begin(), entry.second.end());
+        }
+        
+        uint64_t cdOffset = out.size();
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            const auto& entry = entries_[i];
+            Put32(out, 0x02014b50);
+            Put16(out, 20); Put16(out, 20); Put16(out, 0); Put16(out, 0);
+            Put16(out, 0); Put16(out, 0);
+            Put32(out, Crc32(entry.second));
+            Put32(out, static_cast<uint32_t>(entry.second.size()));
+            Put32(out, static_cast<uint32_t>(entry.second.size()));
+            Put16(out, static_cast<uint16_t>(entry.first.size()));
+            Put16(out, 0); Put16(out, 0); Put16(out, 0); Put16(out, 0);
+            Put32(out, 0);
+            Put32(out, offsets[i]);
+            out.insert(out.end(), entry.first.begin(), entry.first.end());
+        }
+        uint64_t cdSize = out.size() - cdOffset;
+        
+        if (zip64) {
+            uint64_t zip64EocdOffset = out.size();
+            Put32(out, 0x06064b50);
+            Put64(out, 44);
+            Put16(out, 45); Put16(out, 45);
+            Put32(out, 0); Put32(out, 0);
+            Put64(out, entries_.size()); Put64(out, entries_.size());
+            Put64(out, cdSize); Put64(out, cdOffset);
+            
+            Put32(out, 0x07064b50);
+            Put32(out, 0);
+            Put64(out, zip64EocdOffset);
+            Put32(out, 1);
+        }
+        
+        Put32(out, 0x06054b50);
+        Put16(out, 0); Put16(out, 0);
+        Put16(out, zip64 ? 0xFFFF : static_cast<uint16_t>(entries_.size()));
+        Put16(out, zip64 ? 0xFFFF : static_cast<uint16_t>(entries_.size()));
+        Put32(out, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(cdSize));
+        Put32(out, zip64 ? 0xFFFFFFFF : static_cast<uint32_t>(cdOffset));
+        Put16(out, 0);
+        return out;
+    }
+    
+    void WriteTo(const std::wstring& path, bool zip64 = false) const {
+        std::vector<uint8_t> data = Build(zip64);
+        std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    static uint32_t Crc32(const std::string& content) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (unsigned char c : content) {
+            crc ^= c;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+private:
+    std::vector<std::pair<std::string, std::string>> entries_;
+    
+    static void Put16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(static_cast<uint8_t>(v));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+    }
+    
+    static void Put32(std::vector<uint8_t>& out, uint32_t v) {
+        Put16(out, static_cast<uint16_t>(v));
+        Put16(out, static_cast<uint16_t>(v >> 16));
+    }
+    
+    static void Put64(std::vector<uint8_t>& out, uint64_t v) {
+        Put32(out, static_cast<uint32_t>(v));
+        Put32(out, static_cast<uint32_t>(v >> 32));
+    }
+};
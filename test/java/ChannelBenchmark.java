@@ -0,0 +1,51 @@
+/**
+ * 共享内存通道与logMessage路径的吞吐量对比
+ * 在注入后的进程中调用 ChannelBenchmark.main 运行
+ */
+public class ChannelBenchmark {
+
+    private static final int DEFAULT_MESSAGES = 100_000;
+    private static final int CHANNEL_CAPACITY = 4 * 1024 * 1024;
+
+    public static void main(String[] args) {
+        int messages = args != null && args.length > 0 ? Integer.parseInt(args[0]) : DEFAULT_MESSAGES;
+        String message = "benchmark message payload 0123456789";
+
+        System.out.println("=== Channel Benchmark (" + messages + " messages) ===");
+
+        // 基线：每条消息一次JNI调用
+        long start = System.nanoTime();
+        for (int i = 0; i < messages; i++) {
+            NativeBridge.logMessage(message);
+        }
+        long logMessageNanos = System.nanoTime() - start;
+
+        NativeChannel channel = NativeChannel.open(CHANNEL_CAPACITY);
+        if (channel == null) {
+            System.out.println("Native channel not available");
+            return;
+        }
+
+        // 共享内存通道：缓冲区满时自旋等待本地消费者
+        long retries = 0;
+        start = System.nanoTime();
+        for (int i = 0; i < messages; i++) {
+            while (!channel.log(message)) {
+                retries++;
+                Thread.onSpinWait();
+            }
+        }
+        long channelNanos = System.nanoTime() - start;
+
+        report("logMessage", messages, logMessageNanos);
+        report("NativeChannel", messages, channelNanos);
+        System.out.println("Channel full retries: " + retries);
+        System.out.printf("Speedup: %.1fx%n", (double) logMessageNanos / Math.max(1, channelNanos));
+    }
+
+    private static void report(String name, int messages, long nanos) {
+        double seconds = nanos / 1_000_000_000.0;
+        System.out.printf("%-14s %10.0f msg/s  %8.1f ns/msg%n",
+                name, messages / seconds, (double) nanos / messages);
+    }
+}
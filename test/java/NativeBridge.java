@@ -20,6 +20,12 @@ public class NativeBridge {
      */
     public static native void logMessage(String message);
     
+    /**
+     * 批量发送日志消息，整批只产生一次JNI调用
+     * @param messages 要记录的消息
+     */
+    public static native void logMessages(String[] messages);
+    
     /**
      * 获取系统信息
      * @return 系统信息字符串
@@ -52,6 +58,18 @@ public class NativeBridge {
      */
     public static native int getCurrentThreadId();
     
+    /**
+     * 打开共享内存通道
+     * @param capacity 每个方向环形缓冲区的容量（字节，向上取整为2的幂）
+     * @return {toNative, toJava} 两个DirectByteBuffer，布局见NativeChannel
+     */
+    public static native java.nio.ByteBuffer[] openChannel(int capacity);
+    
+    /**
+     * 关闭共享内存通道（停止本地消费线程）
+     */
+    public static native void closeChannel();
+    
     /**
      * 测试本地方法调用
      */
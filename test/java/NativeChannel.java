@@ -0,0 +1,198 @@
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Java端的共享内存通道
+ * 与本地SharedRingBuffer共享同一块内存，写入/读取记录不经过JNI调用，也不产生拷贝
+ *
+ * 布局：
+ *   [0, 64)    头部：magic(4) capacity(4)
+ *   [64, 128)  writePos（long）
+ *   [128, 192) readPos（long）
+ *   [192, ...) 数据区，记录为 length(4) type(4) payload，按8字节对齐
+ *
+ * 每个方向都是单生产者/单消费者：写入位置由写入方以普通读-改-写推进，没有CAS。
+ * log、metric、payload不是线程安全的，同一时刻只能有一个Java线程写入，
+ * 多个线程需要写入时由调用者串行化（例如在同一把锁下调用）；poll同样只能由一个线程调用。
+ * 本地端的toJava写入已在Send中串行化。
+ */
+public class NativeChannel {
+
+    public static final int TYPE_LOG = 1;
+    public static final int TYPE_METRIC = 2;
+    public static final int TYPE_PAYLOAD = 3;
+
+    private static final int MAGIC = 0x52494E47;
+    private static final int HEADER_SIZE = 192;
+    private static final int WRITE_POS_OFFSET = 64;
+    private static final int READ_POS_OFFSET = 128;
+    private static final int RECORD_HEADER_SIZE = 8;
+    private static final int PADDING_RECORD = -1;
+
+    // 以acquire/release语义访问读写位置，与本地std::atomic配对
+    private static final VarHandle LONGS =
+            MethodHandles.byteBufferViewVarHandle(long[].class, ByteOrder.nativeOrder());
+
+    /**
+     * 记录处理器
+     */
+    public interface RecordHandler {
+        void onRecord(int type, ByteBuffer payload);
+    }
+
+    private final ByteBuffer toNative;
+    private final ByteBuffer toJava;
+    private final int capacity;
+
+    private NativeChannel(ByteBuffer toNative, ByteBuffer toJava) {
+        this.toNative = toNative.order(ByteOrder.nativeOrder());
+        this.toJava = toJava.order(ByteOrder.nativeOrder());
+        if (this.toNative.getInt(0) != MAGIC) {
+            throw new IllegalStateException("Invalid native channel buffer");
+        }
+        this.capacity = this.toNative.getInt(4);
+    }
+
+    /**
+     * 打开通道
+     * @param capacity 每个方向的容量（字节）
+     * @return 通道实例，失败时返回null
+     */
+    public static NativeChannel open(int capacity) {
+        ByteBuffer[] buffers = NativeBridge.openChannel(capacity);
+        if (buffers == null || buffers.length != 2) {
+            return null;
+        }
+        return new NativeChannel(buffers[0], buffers[1]);
+    }
+
+    /**
+     * 写入一条日志记录
+     * @return 缓冲区已满时返回false
+     */
+    public boolean log(String message) {
+        int length = message.length() * 2;
+        int offset = reserve(length);
+        if (offset < 0) {
+            return false;
+        }
+        int dataOffset = HEADER_SIZE + offset + RECORD_HEADER_SIZE;
+        for (int i = 0; i < message.length(); i++) {
+            toNative.putChar(dataOffset + i * 2, message.charAt(i));
+        }
+        commit(offset, TYPE_LOG, length);
+        return true;
+    }
+
+    /**
+     * 写入一条指标记录
+     */
+    public boolean metric(String name, long value) {
+        int length = 8 + name.length() * 2;
+        int offset = reserve(length);
+        if (offset < 0) {
+            return false;
+        }
+        int dataOffset = HEADER_SIZE + offset + RECORD_HEADER_SIZE;
+        toNative.putLong(dataOffset, value);
+        for (int i = 0; i < name.length(); i++) {
+            toNative.putChar(dataOffset + 8 + i * 2, name.charAt(i));
+        }
+        commit(offset, TYPE_METRIC, length);
+        return true;
+    }
+
+    /**
+     * 写入一条二进制负载记录
+     */
+    public boolean payload(ByteBuffer data) {
+        int length = data.remaining();
+        int offset = reserve(length);
+        if (offset < 0) {
+            return false;
+        }
+        ByteBuffer target = toNative.duplicate();
+        target.position(HEADER_SIZE + offset + RECORD_HEADER_SIZE);
+        target.put(data.duplicate());
+        commit(offset, TYPE_PAYLOAD, length);
+        return true;
+    }
+
+    /**
+     * 读取本地写入的记录
+     * @param handler 处理器，payload为指向共享内存的只读视图，仅在回调期间有效
+     * @param maxRecords 最多读取的记录数
+     * @return 实际读取的记录数
+     */
+    public int poll(RecordHandler handler, int maxRecords) {
+        int count = 0;
+        long read = (long) LONGS.getOpaque(toJava, READ_POS_OFFSET);
+        long write = (long) LONGS.getAcquire(toJava, WRITE_POS_OFFSET);
+
+        while (read != write && count < maxRecords) {
+            int offset = (int) (read & (capacity - 1));
+            int length = toJava.getInt(HEADER_SIZE + offset);
+            if (length == PADDING_RECORD) {
+                read += capacity - offset;
+                LONGS.setRelease(toJava, READ_POS_OFFSET, read);
+                continue;
+            }
+            int type = toJava.getInt(HEADER_SIZE + offset + 4);
+
+            ByteBuffer view = toJava.asReadOnlyBuffer().order(ByteOrder.nativeOrder());
+            int start = HEADER_SIZE + offset + RECORD_HEADER_SIZE;
+            view.limit(start + length).position(start);
+            handler.onRecord(type, view.slice().order(ByteOrder.nativeOrder()));
+
+            read += recordSize(length);
+            LONGS.setRelease(toJava, READ_POS_OFFSET, read);
+            count++;
+        }
+        return count;
+    }
+
+    public void close() {
+        NativeBridge.closeChannel();
+    }
+
+    private static int recordSize(int length) {
+        return (RECORD_HEADER_SIZE + length + 7) & ~7;
+    }
+
+    // 预留一条记录的空间，返回数据区偏移；空间不足返回-1
+    private int reserve(int length) {
+        int size = recordSize(length);
+        if (size > capacity / 2) {
+            return -1;
+        }
+
+        long write = (long) LONGS.getOpaque(toNative, WRITE_POS_OFFSET);
+        long read = (long) LONGS.getAcquire(toNative, READ_POS_OFFSET);
+        long used = write - read;
+        int offset = (int) (write & (capacity - 1));
+        int contiguous = capacity - offset;
+
+        if (size > contiguous) {
+            if (used + contiguous + size > capacity) {
+                return -1;
+            }
+            toNative.putInt(HEADER_SIZE + offset, PADDING_RECORD);
+            LONGS.setRelease(toNative, WRITE_POS_OFFSET, write + contiguous);
+            return 0;
+        }
+
+        if (used + size > capacity) {
+            return -1;
+        }
+        return offset;
+    }
+
+    private void commit(int offset, int type, int length) {
+        toNative.putInt(HEADER_SIZE + offset, length);
+        toNative.putInt(HEADER_SIZE + offset + 4, type);
+        long write = (long) LONGS.getOpaque(toNative, WRITE_POS_OFFSET);
+        LONGS.setRelease(toNative, WRITE_POS_OFFSET, write + recordSize(length));
+    }
+}